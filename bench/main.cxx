@@ -0,0 +1,853 @@
+/*
+ * Polylib - Polygon Management Library
+ *
+ * Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+ * All rights reserved.
+ *
+ * Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// 性能測定プログラム
+///     合成形状（球面/地形/ランダム三角形）または風車のSTLを入力として、
+///     ロード、KD木構築、矩形/最近傍/レイ検索、移動+再構築、
+///     (MPI)PE間移動、保存の処理時間を計測し、JSON形式で出力する
+///
+////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "Polylib.h"
+
+using namespace PolylibNS;
+using namespace std;
+
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "../examples/windmill/WL3000"
+#endif
+
+#ifndef PAI
+#define PAI 3.14159265358979323846       /* πの値 */
+#endif
+
+/// モデル空間の各方向のボクセル数（MPI時はX方向をランク数で分割）
+#define BENCH_NUM_CELL  36
+
+/// 矩形検索の選択率（検索領域の体積/担当領域の体積）
+static const double bench_selectivity[] = { 0.0001, 0.001, 0.01, 0.1 };
+#define BENCH_NUM_SELECTIVITY   4
+
+/// 検索対象のグループ名
+#define BENCH_GROUP_NAME "bench"
+
+//----------------------------------------------------
+//  実行条件
+//----------------------------------------------------
+struct BenchOption {
+    std::string mesh;       // sphere/terrain/soup/windmill
+    long        num_tri;    // 合成形状の三角形数
+    int         num_query;  // 検索の回数（検索種類毎）
+    int         num_build;  // KD木構築の回数
+    int         num_step;   // 移動の回数
+    unsigned    seed;       // 乱数の種
+    std::string data_dir;   // 風車のSTLのディレクトリ
+    std::string out_file;   // 結果の出力ファイル名
+    std::string stats_file; // StatsRegistryの出力ファイル名（空:出力しない）
+    bool        save;       // 保存を計測するか
+};
+
+//----------------------------------------------------
+//  計測結果
+//----------------------------------------------------
+struct BenchResult {
+    std::string name;       // 計測項目
+    double      param;      // パラメタ（矩形検索の選択率）。ない場合は負
+    long        count;      // 実行回数
+    double      time;       // 合計処理時間(秒)
+    double      hits;       // 合計ヒット数（検索結果の三角形数など）
+};
+
+//----------------------------------------------------
+//  モデル空間と担当領域
+//----------------------------------------------------
+struct BenchDomain {
+    PL_REAL     org[3];     // モデル空間の最小位置
+    PL_REAL     len;        // モデル空間の１辺の長さ
+    PL_REAL     dx;         // ボクセル１辺の長さ
+    PL_REAL     amin[3];    // 自ランクの担当領域の最小位置
+    PL_REAL     amax[3];    // 自ランクの担当領域の最大位置
+    unsigned    bpos_cell;  // 自ランクの担当領域のX方向の開始ボクセル
+    unsigned    num_cell;   // 自ランクの担当領域のX方向のボクセル数
+};
+
+static int  g_myrank   = 0;
+static int  g_num_rank = 1;
+
+//----------------------------------------------------
+//  乱数（線形合同法。実行環境によらず同じ系列とするため）
+//----------------------------------------------------
+static unsigned g_rand_state = 1;
+
+static double bench_rand( void )
+{
+    g_rand_state = g_rand_state * 1103515245u + 12345u;
+    return (double)((g_rand_state >> 8) & 0xffffff) / (double)0x1000000;
+}
+
+//----------------------------------------------------
+//  バイナリSTLの出力
+//----------------------------------------------------
+static bool write_stl_b(
+        const std::string&      fname,
+        const vector<float>&    vtx     // 三角形毎に9個
+    )
+{
+    ofstream ofs( fname.c_str(), ios::out | ios::binary );
+    if( !ofs ) {
+        return false;
+    }
+    char header[80];
+    memset( header, 0, sizeof(header) );
+    strncpy( header, "Polylib benchmark", sizeof(header)-1 );
+    ofs.write( header, sizeof(header) );
+
+    unsigned int num = (unsigned int)(vtx.size() / 9);
+    ofs.write( (const char*)&num, sizeof(num) );
+
+    for( unsigned int i=0; i<num; i++ ) {
+        const float *v = &vtx[i*9];
+        float e1[3], e2[3], nrm[3];
+        for( int j=0; j<3; j++ ) {
+            e1[j] = v[3+j] - v[j];
+            e2[j] = v[6+j] - v[j];
+        }
+        nrm[0] = e1[1]*e2[2] - e1[2]*e2[1];
+        nrm[1] = e1[2]*e2[0] - e1[0]*e2[2];
+        nrm[2] = e1[0]*e2[1] - e1[1]*e2[0];
+        float len = sqrtf( nrm[0]*nrm[0] + nrm[1]*nrm[1] + nrm[2]*nrm[2] );
+        if( len > 0.0f ) {
+            nrm[0] /= len;  nrm[1] /= len;  nrm[2] /= len;
+        }
+        unsigned short attr = 0;
+        ofs.write( (const char*)nrm, sizeof(nrm) );
+        ofs.write( (const char*)v, sizeof(float)*9 );
+        ofs.write( (const char*)&attr, sizeof(attr) );
+    }
+    return ofs.good();
+}
+
+//----------------------------------------------------
+//  合成形状の作成
+//----------------------------------------------------
+
+//  球面（緯度経度分割）。極では三角形１枚
+static void make_sphere( const BenchDomain& dom, long num_tri, vector<float>& vtx )
+{
+    int nlat = (int)sqrt( (double)num_tri / 4.0 );
+    if( nlat < 2 )  nlat = 2;
+    int nlon = 2 * nlat;
+    double r = 0.4 * dom.len;
+    double c[3];
+    for( int k=0; k<3; k++ ) {
+        c[k] = dom.org[k] + 0.5 * dom.len;
+    }
+
+    vector<float> pt( (nlat+1) * (nlon+1) * 3 );
+    for( int i=0; i<=nlat; i++ ) {
+        double th = PAI * i / nlat;
+        for( int j=0; j<=nlon; j++ ) {
+            double ph = 2.0 * PAI * j / nlon;
+            float *p = &pt[ (i*(nlon+1) + j) * 3 ];
+            p[0] = (float)( c[0] + r * sin(th) * cos(ph) );
+            p[1] = (float)( c[1] + r * sin(th) * sin(ph) );
+            p[2] = (float)( c[2] + r * cos(th) );
+        }
+    }
+
+    vtx.clear();
+    for( int i=0; i<nlat; i++ ) {
+        for( int j=0; j<nlon; j++ ) {
+            const float *p00 = &pt[ ( i   *(nlon+1) + j  ) * 3 ];
+            const float *p01 = &pt[ ( i   *(nlon+1) + j+1) * 3 ];
+            const float *p10 = &pt[ ((i+1)*(nlon+1) + j  ) * 3 ];
+            const float *p11 = &pt[ ((i+1)*(nlon+1) + j+1) * 3 ];
+            if( i != 0 ) {
+                vtx.insert( vtx.end(), p00, p00+3 );
+                vtx.insert( vtx.end(), p10, p10+3 );
+                vtx.insert( vtx.end(), p01, p01+3 );
+            }
+            if( i != nlat-1 ) {
+                vtx.insert( vtx.end(), p01, p01+3 );
+                vtx.insert( vtx.end(), p10, p10+3 );
+                vtx.insert( vtx.end(), p11, p11+3 );
+            }
+        }
+    }
+}
+
+//  地形（格子状の高さ場）
+static void make_terrain( const BenchDomain& dom, long num_tri, vector<float>& vtx )
+{
+    int n = (int)sqrt( (double)num_tri / 2.0 );
+    if( n < 1 )     n = 1;
+    double h = dom.len / n;
+
+    vector<float> pt( (n+1) * (n+1) * 3 );
+    for( int i=0; i<=n; i++ ) {
+        for( int j=0; j<=n; j++ ) {
+            double u = (double)i / n;
+            double v = (double)j / n;
+            float *p = &pt[ (i*(n+1) + j) * 3 ];
+            p[0] = (float)( dom.org[0] + h * i );
+            p[1] = (float)( dom.org[1] + h * j );
+            p[2] = (float)( dom.org[2] + dom.len * ( 0.4
+                        + 0.10 * sin( 2.0*PAI*3.0*u ) * cos( 2.0*PAI*2.0*v )
+                        + 0.03 * sin( 2.0*PAI*17.0*u + 2.0*PAI*13.0*v ) ) );
+        }
+    }
+
+    vtx.clear();
+    for( int i=0; i<n; i++ ) {
+        for( int j=0; j<n; j++ ) {
+            const float *p00 = &pt[ ( i   *(n+1) + j  ) * 3 ];
+            const float *p01 = &pt[ ( i   *(n+1) + j+1) * 3 ];
+            const float *p10 = &pt[ ((i+1)*(n+1) + j  ) * 3 ];
+            const float *p11 = &pt[ ((i+1)*(n+1) + j+1) * 3 ];
+            vtx.insert( vtx.end(), p00, p00+3 );
+            vtx.insert( vtx.end(), p10, p10+3 );
+            vtx.insert( vtx.end(), p11, p11+3 );
+            vtx.insert( vtx.end(), p00, p00+3 );
+            vtx.insert( vtx.end(), p11, p11+3 );
+            vtx.insert( vtx.end(), p01, p01+3 );
+        }
+    }
+}
+
+//  ランダムな三角形の集合（重なりあり）
+static void make_soup( const BenchDomain& dom, long num_tri, vector<float>& vtx )
+{
+    double s = dom.len / pow( (double)num_tri, 1.0/3.0 );   // 三角形の大きさ
+    double lo = 0.05 * dom.len;
+    double w  = 0.90 * dom.len;
+
+    vtx.resize( num_tri * 9 );
+    for( long i=0; i<num_tri; i++ ) {
+        double c[3];
+        for( int k=0; k<3; k++ ) {
+            c[k] = dom.org[k] + lo + w * bench_rand();
+        }
+        for( int j=0; j<3; j++ ) {
+            for( int k=0; k<3; k++ ) {
+                vtx[i*9 + j*3 + k] = (float)( c[k] + s * (bench_rand() - 0.5) );
+            }
+        }
+    }
+}
+
+//----------------------------------------------------
+//  入力データ（設定ファイルとSTL）の作成
+//      合成形状はランク0で作成する
+//----------------------------------------------------
+static bool make_input(
+        const BenchOption&  opt,
+        const BenchDomain&  dom,
+        std::string&        config_name
+    )
+{
+    config_name = "bench_config.tp";
+    bool ok = true;
+
+    if( g_myrank == 0 ) {
+        ofstream ofs( config_name.c_str() );
+        ofs << "polylib {" << endl;
+        ofs << "    " << BENCH_GROUP_NAME << " {" << endl;
+        if( opt.mesh == "windmill" ) {
+            ofs << "        spinner {" << endl;
+            ofs << "            filepath = \"" << opt.data_dir << "/WL3000_WLsolid-spinner.stl\"" << endl;
+            ofs << "            movable = \"true\"" << endl;
+            ofs << "        }" << endl;
+            ofs << "        blades {" << endl;
+            ofs << "            filepath = \"" << opt.data_dir << "/WL3000_WLsolid-blades.stl\"" << endl;
+            ofs << "            movable = \"true\"" << endl;
+            ofs << "        }" << endl;
+        } else {
+            std::string stl_name = "bench_" + opt.mesh + ".stl";
+            ofs << "        " << opt.mesh << " {" << endl;
+            ofs << "            filepath = \"" << stl_name << "\"" << endl;
+            ofs << "            movable = \"true\"" << endl;
+            ofs << "        }" << endl;
+
+            vector<float> vtx;
+            g_rand_state = opt.seed;
+            if( opt.mesh == "sphere" ) {
+                make_sphere( dom, opt.num_tri, vtx );
+            } else if( opt.mesh == "terrain" ) {
+                make_terrain( dom, opt.num_tri, vtx );
+            } else {
+                make_soup( dom, opt.num_tri, vtx );
+            }
+            if( !write_stl_b( stl_name, vtx ) ) {
+                PL_ERROSH << "[ERROR] can't write " << stl_name << endl;
+                ok = false;
+            }
+        }
+        ofs << "    }" << endl;
+        ofs << "}" << endl;
+        if( !ofs ) {
+            PL_ERROSH << "[ERROR] can't write " << config_name << endl;
+            ok = false;
+        }
+    }
+
+#ifdef MPI_PL
+    int iok = ok ? 1 : 0;
+    MPI_Bcast( &iok, 1, MPI_INT, 0, MPI_COMM_WORLD );
+    ok = (iok != 0);
+#endif
+    return ok;
+}
+
+//----------------------------------------------------
+//  モデル空間と担当領域の設定
+//      X方向をランク数で分割する
+//----------------------------------------------------
+static void set_domain( const BenchOption& opt, BenchDomain& dom )
+{
+    if( opt.mesh == "windmill" ) {
+        // 回転を考慮した風車全体のモデル空間（examples/windmillと同じ）
+        dom.org[0] = dom.org[1] = dom.org[2] = -1800.0;
+        dom.len = 3600.0;
+    } else {
+        dom.org[0] = dom.org[1] = dom.org[2] = 0.0;
+        dom.len = 100.0;
+    }
+    dom.dx = dom.len / BENCH_NUM_CELL;
+
+    unsigned c0 = (unsigned)( (long)BENCH_NUM_CELL *  g_myrank      / g_num_rank );
+    unsigned c1 = (unsigned)( (long)BENCH_NUM_CELL * (g_myrank + 1) / g_num_rank );
+    dom.bpos_cell = c0;
+    dom.num_cell  = c1 - c0;
+
+    for( int k=0; k<3; k++ ) {
+        dom.amin[k] = dom.org[k];
+        dom.amax[k] = dom.org[k] + dom.len;
+    }
+    dom.amin[0] = dom.org[0] + dom.dx * c0;
+    dom.amax[0] = dom.org[0] + dom.dx * c1;
+}
+
+//----------------------------------------------------
+//  担当領域内の乱数の位置
+//----------------------------------------------------
+static Vec3<PL_REAL> random_point( const BenchDomain& dom )
+{
+    PL_REAL p[3];
+    for( int k=0; k<3; k++ ) {
+        p[k] = dom.amin[k] + (dom.amax[k] - dom.amin[k]) * (PL_REAL)bench_rand();
+    }
+    return Vec3<PL_REAL>( p );
+}
+
+//----------------------------------------------------
+//  三角形と半直線の交差判定 (Moller-Trumbore)
+//----------------------------------------------------
+static bool ray_hit(
+        const Triangle*         tri,
+        const Vec3<PL_REAL>&    org,
+        const Vec3<PL_REAL>&    dir
+    )
+{
+    const double EPS = 1.0e-12;
+    const Vec3<PL_REAL>* v = tri->get_vertexes();
+    double e1[3], e2[3], s[3], p[3], q[3];
+    for( int k=0; k<3; k++ ) {
+        e1[k] = (double)((const PL_REAL*)v[1])[k] - ((const PL_REAL*)v[0])[k];
+        e2[k] = (double)((const PL_REAL*)v[2])[k] - ((const PL_REAL*)v[0])[k];
+        s[k]  = (double)((const PL_REAL*)org)[k]  - ((const PL_REAL*)v[0])[k];
+    }
+    const PL_REAL *d = dir;
+    p[0] = d[1]*e2[2] - d[2]*e2[1];
+    p[1] = d[2]*e2[0] - d[0]*e2[2];
+    p[2] = d[0]*e2[1] - d[1]*e2[0];
+    double det = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+    if( fabs(det) < EPS )   return false;
+
+    double u = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2]) / det;
+    if( u < 0.0 || u > 1.0 )    return false;
+
+    q[0] = s[1]*e1[2] - s[2]*e1[1];
+    q[1] = s[2]*e1[0] - s[0]*e1[2];
+    q[2] = s[0]*e1[1] - s[1]*e1[0];
+    double v2 = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2]) / det;
+    if( v2 < 0.0 || u + v2 > 1.0 )  return false;
+
+    double t = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2]) / det;
+    return t >= 0.0;
+}
+
+//----------------------------------------------------
+//  移動関数
+//      params.m_params[0]だけX方向に平行移動する
+//----------------------------------------------------
+static void move_func(
+        PolygonGroup*       pg,
+        PolylibMoveParams*  params
+    )
+{
+    PL_REAL mat[4][4];
+    memset( mat, 0, sizeof(mat) );
+    for( int i=0; i<4; i++ ) {
+        mat[i][i] = 1.0;
+    }
+    mat[3][0] = params->m_params[0];
+    pg->transform( mat, false, false );
+}
+
+//----------------------------------------------------
+//  計測結果の追加
+//----------------------------------------------------
+static void add_result(
+        vector<BenchResult>&    results,
+        const std::string&      name,
+        double                  param,
+        long                    count,
+        double                  time,
+        double                  hits
+    )
+{
+    BenchResult r;
+    r.name  = name;
+    r.param = param;
+    r.count = count;
+    r.time  = time;
+    r.hits  = hits;
+    results.push_back( r );
+
+    if( g_myrank == 0 ) {
+        ostringstream oss;
+        oss << name;
+        if( param >= 0.0 )  oss << "(" << param << ")";
+        cout << "bench: " << oss.str() << " count=" << count << " time=" << time << endl;
+    }
+}
+
+//----------------------------------------------------
+//  全ランクの処理結果の確認
+//      1ランクでもエラーの場合はfalse（MPI環境では全ランクで呼び出すこと）
+//----------------------------------------------------
+static bool all_rank_ok(
+        POLYLIB_STAT    ret
+    )
+{
+    int err = ( ret != PLSTAT_OK ) ? 1 : 0;
+#ifdef MPI_PL
+    int err_all = 0;
+    MPI_Allreduce( &err, &err_all, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+    err = err_all;
+#endif
+    return err == 0;
+}
+
+//----------------------------------------------------
+//  計測結果のJSON出力
+//      処理時間は全ランクの最大、ヒット数は全ランクの合計
+//      三角形数は全ランクの合計（ガイドセル領域の重複を含む）
+//----------------------------------------------------
+static bool write_result(
+        const BenchOption&          opt,
+        const vector<BenchResult>&  results,
+        long long                   num_tri
+    )
+{
+    size_t num = results.size();
+    vector<double> tmax( num ), tmin( num ), hsum( num );
+    for( size_t i=0; i<num; i++ ) {
+        tmax[i] = tmin[i] = results[i].time;
+        hsum[i] = results[i].hits;
+    }
+#ifdef MPI_PL
+    if( num > 0 ) {
+        vector<double> work( num );
+        MPI_Allreduce( &tmax[0], &work[0], (int)num, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+        tmax = work;
+        MPI_Allreduce( &tmin[0], &work[0], (int)num, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD );
+        tmin = work;
+        MPI_Allreduce( &hsum[0], &work[0], (int)num, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        hsum = work;
+    }
+    long long ntri = num_tri;
+    MPI_Allreduce( &num_tri, &ntri, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD );
+    num_tri = ntri;
+#endif
+    if( g_myrank != 0 ) {
+        return true;
+    }
+
+    ofstream ofs( opt.out_file.c_str() );
+    if( !ofs ) {
+        PL_ERROSH << "[ERROR] can't open " << opt.out_file << endl;
+        return false;
+    }
+    ofs << setprecision( 9 );
+    ofs << "{" << endl;
+    ofs << "  \"version\": \"" << Polylib::get_instance()->getVersionInfo() << "\"," << endl;
+    ofs << "  \"mesh\": \"" << opt.mesh << "\"," << endl;
+    ofs << "  \"num_tri\": " << num_tri << "," << endl;
+    ofs << "  \"num_rank\": " << g_num_rank << "," << endl;
+    ofs << "  \"real\": \"" << ( sizeof(PL_REAL) == sizeof(double) ? "double" : "float" ) << "\"," << endl;
+    ofs << "  \"num_query\": " << opt.num_query << "," << endl;
+    ofs << "  \"seed\": " << opt.seed << "," << endl;
+    ofs << "  \"results\": [" << endl;
+    for( size_t i=0; i<num; i++ ) {
+        const BenchResult& r = results[i];
+        double cnt  = (r.count > 0) ? (double)r.count : 1.0;
+        double hcnt = cnt * g_num_rank;     // 全ランクの実行回数
+        ofs << "    { \"name\": \"" << r.name << "\"";
+        if( r.param >= 0.0 ) {
+            ofs << ", \"selectivity\": " << r.param;
+        }
+        ofs << ", \"count\": " << r.count
+            << ", \"time\": " << tmax[i]
+            << ", \"time_min_rank\": " << tmin[i]
+            << ", \"time_avg\": " << tmax[i] / cnt
+            << ", \"hits\": " << hsum[i]
+            << ", \"hits_avg\": " << hsum[i] / hcnt
+            << " }" << ( i < num-1 ? "," : "" ) << endl;
+    }
+    ofs << "  ]" << endl;
+    ofs << "}" << endl;
+    return ofs.good();
+}
+
+//----------------------------------------------------
+//  使用方法
+//----------------------------------------------------
+static void usage( const char* prog )
+{
+    if( g_myrank != 0 )     return;
+    cerr << "usage: " << prog << " [options]" << endl
+        << "  -mesh sphere|terrain|soup|windmill  input mesh [sphere]" << endl
+        << "  -n NUM        number of triangles of synthetic mesh [100000]" << endl
+        << "  -q NUM        number of queries per query type [1000]" << endl
+        << "  -build NUM    number of tree builds [3]" << endl
+        << "  -steps NUM    number of move steps [10]" << endl
+        << "  -seed NUM     random seed [1]" << endl
+        << "  -data DIR     windmill STL directory [" << BENCH_DATA_DIR << "]" << endl
+        << "  -o FILE       result file [bench_result.json]" << endl
+        << "  -stats FILE   write Polylib stats (StatsRegistry) to FILE" << endl
+        << "  -nosave       skip save benchmark" << endl;
+}
+
+//----------------------------------------------------
+//  引数の解析
+//----------------------------------------------------
+static bool parse_option( int argc, char** argv, BenchOption& opt )
+{
+    opt.mesh      = "sphere";
+    opt.num_tri   = 100000;
+    opt.num_query = 1000;
+    opt.num_build = 3;
+    opt.num_step  = 10;
+    opt.seed      = 1;
+    opt.data_dir  = BENCH_DATA_DIR;
+    opt.out_file  = "bench_result.json";
+    opt.save      = true;
+
+    for( int i=1; i<argc; i++ ) {
+        std::string a = argv[i];
+        bool has_val = (i+1 < argc);
+        if( a == "-nosave" ) {
+            opt.save = false;
+        } else if( a == "-mesh" && has_val ) {
+            opt.mesh = argv[++i];
+        } else if( a == "-n" && has_val ) {
+            opt.num_tri = atol( argv[++i] );
+        } else if( a == "-q" && has_val ) {
+            opt.num_query = atoi( argv[++i] );
+        } else if( a == "-build" && has_val ) {
+            opt.num_build = atoi( argv[++i] );
+        } else if( a == "-steps" && has_val ) {
+            opt.num_step = atoi( argv[++i] );
+        } else if( a == "-seed" && has_val ) {
+            opt.seed = (unsigned)atol( argv[++i] );
+        } else if( a == "-data" && has_val ) {
+            opt.data_dir = argv[++i];
+        } else if( a == "-o" && has_val ) {
+            opt.out_file = argv[++i];
+        } else if( a == "-stats" && has_val ) {
+            opt.stats_file = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if( opt.mesh != "sphere" && opt.mesh != "terrain" && opt.mesh != "soup"
+     && opt.mesh != "windmill" ) {
+        return false;
+    }
+    if( opt.num_tri < 1 || opt.num_query < 0 || opt.num_build < 0 || opt.num_step < 0 ) {
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------
+//  メインルーチン
+//----------------------------------------------------
+
+int main(int argc, char** argv )
+{
+    POLYLIB_STAT ret;
+    BenchOption  opt;
+    BenchDomain  dom;
+    vector<BenchResult> results;
+    double t0;
+
+#ifdef MPI_PL
+    MPI_Init( &argc, &argv );
+    MPI_Comm_size( MPI_COMM_WORLD, &g_num_rank );
+    MPI_Comm_rank( MPI_COMM_WORLD, &g_myrank );
+#endif
+
+    if( !parse_option( argc, argv, opt ) ) {
+        usage( argv[0] );
+#ifdef MPI_PL
+        MPI_Finalize();
+#endif
+        return 1;
+    }
+    set_domain( opt, dom );
+
+    Polylib* p_polylib = Polylib::get_instance();
+    if( !opt.stats_file.empty() ) {
+        StatsRegistry::set_enable( true );
+    }
+
+#ifdef MPI_PL
+    if( dom.num_cell == 0 ) {
+        PL_ERROSH << "[ERROR] too many ranks. max=" << BENCH_NUM_CELL << endl;
+        MPI_Abort( MPI_COMM_WORLD, 1 );
+    }
+    PL_REAL      bpos[3]   = { dom.amin[0], dom.amin[1], dom.amin[2] };
+    unsigned int bbsize[3] = { dom.num_cell, BENCH_NUM_CELL, BENCH_NUM_CELL };
+    unsigned int gcsize[3] = { 1, 1, 1 };
+    PL_REAL      dx[3]     = { dom.dx, dom.dx, dom.dx };
+    ret = p_polylib->init_parallel_info( MPI_COMM_WORLD, bpos, bbsize, gcsize, dx );
+    if( ret != PLSTAT_OK ) {
+        PL_ERROSH << "[ERROR] init_parallel_info() ret=" << ret << endl;
+        MPI_Abort( MPI_COMM_WORLD, 1 );
+    }
+#endif
+
+    //-------------------------------------------
+    //  入力データ作成・ロード
+    //-------------------------------------------
+    std::string config_name;
+    if( !make_input( opt, dom, config_name ) ) {
+#ifdef MPI_PL
+        MPI_Abort( MPI_COMM_WORLD, 1 );
+#endif
+        return 1;
+    }
+
+#ifdef MPI_PL
+    MPI_Barrier( MPI_COMM_WORLD );
+#endif
+    t0 = get_wall_time();
+    ret = p_polylib->load( config_name );
+    if( ret != PLSTAT_OK ) {
+        PL_ERROSH << "[ERROR] load() ret=" << ret << endl;
+#ifdef MPI_PL
+        MPI_Abort( MPI_COMM_WORLD, 1 );
+#endif
+        return 1;
+    }
+    add_result( results, "load", -1.0, 1, get_wall_time() - t0, 0.0 );
+
+    std::vector<PolygonGroup*>* leaf_list = p_polylib->get_leaf_groups();
+    long long num_tri = 0;
+    for( size_t i=0; i<leaf_list->size(); i++ ) {
+        num_tri += (long long)(*leaf_list)[i]->get_triangles()->size();
+    }
+
+    //-------------------------------------------
+    //  KD木構築
+    //-------------------------------------------
+    t0 = get_wall_time();
+    for( int n=0; n<opt.num_build; n++ ) {
+        for( size_t i=0; i<leaf_list->size(); i++ ) {
+            (*leaf_list)[i]->build_polygon_tree();
+        }
+    }
+    add_result( results, "build", -1.0, opt.num_build, get_wall_time() - t0, 0.0 );
+
+    //-------------------------------------------
+    //  矩形検索（選択率毎）
+    //      検索領域は担当領域と相似な直方体
+    //-------------------------------------------
+    std::vector<Triangle*> tri_list;
+    for( int s=0; s<BENCH_NUM_SELECTIVITY; s++ ) {
+        double scale = pow( bench_selectivity[s], 1.0/3.0 );
+        PL_REAL half[3];
+        for( int k=0; k<3; k++ ) {
+            half[k] = (PL_REAL)( 0.5 * scale * (dom.amax[k] - dom.amin[k]) );
+        }
+
+        g_rand_state = opt.seed + 100 + s;
+        double hits = 0.0;
+        t0 = get_wall_time();
+        for( int q=0; q<opt.num_query; q++ ) {
+            Vec3<PL_REAL> c = random_point( dom );
+            PL_REAL bmin[3], bmax[3];
+            for( int k=0; k<3; k++ ) {
+                const PL_REAL *pc = c;
+                bmin[k] = pc[k] - half[k];
+                bmax[k] = pc[k] + half[k];
+                if( bmin[k] < dom.amin[k] )     bmin[k] = dom.amin[k];
+                if( bmax[k] > dom.amax[k] )     bmax[k] = dom.amax[k];
+            }
+            tri_list.clear();
+            p_polylib->search_polygons( tri_list, BENCH_GROUP_NAME,
+                                        Vec3<PL_REAL>(bmin), Vec3<PL_REAL>(bmax), false );
+            hits += (double)tri_list.size();
+        }
+        add_result( results, "search_box", bench_selectivity[s], opt.num_query,
+                    get_wall_time() - t0, hits );
+    }
+
+    //-------------------------------------------
+    //  最近傍検索
+    //-------------------------------------------
+    {
+        g_rand_state = opt.seed + 200;
+        double hits = 0.0;
+        t0 = get_wall_time();
+        for( int q=0; q<opt.num_query; q++ ) {
+            Triangle* tri = NULL;
+            p_polylib->search_nearest_polygon( tri, BENCH_GROUP_NAME, random_point( dom ) );
+            if( tri != NULL )   hits += 1.0;
+        }
+        add_result( results, "search_nearest", -1.0, opt.num_query,
+                    get_wall_time() - t0, hits );
+    }
+
+    //-------------------------------------------
+    //  レイ検索
+    //      座標軸方向のレイの通過領域（幅0の矩形領域）で候補を検索し、
+    //      三角形との交差判定を行う
+    //-------------------------------------------
+    {
+        g_rand_state = opt.seed + 300;
+        double hits = 0.0;
+        t0 = get_wall_time();
+        for( int q=0; q<opt.num_query; q++ ) {
+            int axis = q % 3;
+            Vec3<PL_REAL> org = random_point( dom );
+            PL_REAL *po = &org.x;
+            po[axis] = dom.amin[axis];
+            Vec3<PL_REAL> dir( 0.0, 0.0, 0.0 );
+            (&dir.x)[axis] = 1.0;
+            Vec3<PL_REAL> end = org;
+            (&end.x)[axis] = dom.amax[axis];
+
+            tri_list.clear();
+            p_polylib->search_polygons( tri_list, BENCH_GROUP_NAME, org, end, false );
+            for( size_t i=0; i<tri_list.size(); i++ ) {
+                if( ray_hit( tri_list[i], org, dir ) )  hits += 1.0;
+            }
+        }
+        add_result( results, "search_ray", -1.0, opt.num_query,
+                    get_wall_time() - t0, hits );
+    }
+
+    //-------------------------------------------
+    //  移動+再構築、PE間移動
+    //      ボクセル幅の1/4ずつ往復させる
+    //-------------------------------------------
+    for( size_t i=0; i<leaf_list->size(); i++ ) {
+        (*leaf_list)[i]->set_move_func( move_func );
+    }
+    {
+        PolylibMoveParams params;
+        memset( params.m_params, 0x00, 10*sizeof(PL_REAL) );
+        double t_move = 0.0, t_rebuild = 0.0, t_migrate = 0.0;
+        for( int istep=0; istep<opt.num_step; istep++ ) {
+            params.m_current_step = istep;
+            params.m_next_step    = istep + 1;
+            params.m_delta_t      = 1.0;
+            params.m_params[0]    = (PL_REAL)( (istep % 2 == 0) ? 0.25 : -0.25 ) * dom.dx;
+
+            t0 = get_wall_time();
+            ret = p_polylib->move( params );
+            t_move += get_wall_time() - t0;
+            if( ret != PLSTAT_OK ) {
+                PL_ERROSH << "[ERROR] move() ret=" << ret << endl;
+            }
+            // 全ランク揃って中断する
+            if( !all_rank_ok( ret ) )   break;
+            for( size_t i=0; i<leaf_list->size(); i++ ) {
+                double tm, tr;
+                (*leaf_list)[i]->get_move_time( tm, tr );
+                t_rebuild += tr;
+            }
+#ifdef MPI_PL
+            t0 = get_wall_time();
+            ret = p_polylib->migrate();
+            t_migrate += get_wall_time() - t0;
+            if( ret != PLSTAT_OK ) {
+                PL_ERROSH << "[ERROR] migrate() ret=" << ret << endl;
+            }
+            if( !all_rank_ok( ret ) )   break;
+#endif
+        }
+        add_result( results, "move", -1.0, opt.num_step, t_move, 0.0 );
+        add_result( results, "rebuild", -1.0, opt.num_step, t_rebuild, 0.0 );
+#ifdef MPI_PL
+        add_result( results, "migrate", -1.0, opt.num_step, t_migrate, 0.0 );
+#else
+        (void)t_migrate;
+#endif
+    }
+    delete leaf_list;
+
+    //-------------------------------------------
+    //  保存
+    //-------------------------------------------
+    if( opt.save ) {
+        std::string config_out;
+#ifdef MPI_PL
+        MPI_Barrier( MPI_COMM_WORLD );
+#endif
+        t0 = get_wall_time();
+        ret = p_polylib->save( config_out, "stl_b", "bench" );
+        add_result( results, "save", -1.0, 1, get_wall_time() - t0, 0.0 );
+        if( ret != PLSTAT_OK ) {
+            PL_ERROSH << "[ERROR] save() ret=" << ret << endl;
+        }
+    }
+
+    //-------------------------------------------
+    //  結果出力
+    //-------------------------------------------
+    int iret = 0;
+    if( !write_result( opt, results, num_tri ) ) {
+        iret = 1;
+    }
+    if( !opt.stats_file.empty() ) {
+        if( p_polylib->write_stats_json( opt.stats_file ) != PLSTAT_OK ) {
+            iret = 1;
+        }
+    }
+
+#ifdef MPI_PL
+    MPI_Finalize();
+#endif
+    return iret;
+}
@@ -218,32 +218,11 @@ void move_func_funnel(
          );
 
 
-    std::vector<Triangle* > *tri_list =  pg->get_triangles();
-#if 0
-    std::string pg_name = pg->get_name();
-    PL_DBGOSH << "move polygon group:  name="<<pg_name<<" tri_list->size()="<<tri_list->size() <<endl;
-#endif
-
     // 三角リスト内の全ての三角形について頂点座標を更新する
     //   回転軸を中心として回転させる
-    for(int i=0; i<tri_list->size(); i++ ) {
-        Vec3<PL_REAL>* vertex = (*tri_list)[i]->get_vertexes();
-
-        for( int j=0; j<3; j++ ) {
-            PL_REAL  pos[4],pos_o[4];
-            pos[0]=vertex[j].x; pos[1]=vertex[j].y; pos[2]=vertex[j].z; pos[3]=1.0;
-            // 座標を回転させる
-            Calc_3dMat4Multi14( pos, mat_yaw, pos_o );
-            // 座標更新
-            vertex[j].x=pos_o[0]; vertex[j].y=pos_o[1]; vertex[j].z=pos_o[2];
-            // 法線ベクトル更新・面積非更新
-            (*tri_list)[i]->update( true, false );
-        }
-    }
-
-    // 頂点座標が移動したことにより、KD木の再構築が必要
-    // 再構築フラグを立てる
-    pg->set_need_rebuild();
+    //   法線ベクトル更新・面積非更新
+    //   頂点座標が移動したことにより、KD木の再構築フラグも立てる
+    pg->transform( mat_yaw, true, false );
 
     //PL_DBGOSH << "----- move_func_funnel() end   -----" << endl;
 }
@@ -297,12 +276,6 @@ void move_func_blades(
     Calc_3dMat4Multi44( mat_roll, mat_yaw, mat );
 
 
-    std::vector<Triangle* > *tri_list =  pg->get_triangles();
-#if 0
-    std::string pg_name = pg->get_name();
-    PL_DBGOSH << "move polygon group:  name="<<pg_name<<" tri_list->size()="<<tri_list->size() <<endl;
-#endif
-
 #ifdef DEBUG
     // 頂点が隣接セルよりも遠くへ移動した三角形情報チェック（前処理）
     //  デバッグ用
@@ -310,25 +283,10 @@ void move_func_blades(
 #endif
 
     // 三角リスト内の全ての三角形について頂点座標を更新する
-    //   回転軸を中心として回転させる
-    for(int i=0; i<tri_list->size(); i++ ) {
-        Vec3<PL_REAL>* vertex = (*tri_list)[i]->get_vertexes();
-
-        for( int j=0; j<3; j++ ) {
-            PL_REAL  pos[4],pos_o[4];
-            pos[0]=vertex[j].x; pos[1]=vertex[j].y; pos[2]=vertex[j].z; pos[3]=1.0;
-            // 座標を回転させる
-            Calc_3dMat4Multi14( pos, mat, pos_o );  // 行ベクトル系
-            // 座標更新
-            vertex[j].x=pos_o[0]; vertex[j].y=pos_o[1]; vertex[j].z=pos_o[2];
-            // 法線ベクトル更新・面積非更新
-            (*tri_list)[i]->update( true, false );
-        }
-    }
-
-    // 頂点座標が移動したことにより、KD木の再構築が必要
-    // 再構築フラグを立てる
-    pg->set_need_rebuild();
+    //   回転軸を中心として回転させる（行ベクトル系）
+    //   法線ベクトル更新・面積非更新
+    //   頂点座標が移動したことにより、KD木の再構築フラグも立てる
+    pg->transform( mat, true, false );
 
 #ifdef DEBUG
     // 頂点が隣接セルよりも遠くへ移動した三角形情報チェック（後処理）
@@ -14,6 +14,7 @@
 #define polylib_h
 #include <string>
 #include <vector>
+#include <map>
 #include <iostream>
 #include "polygons/Triangle.h"
 #include "polygons/NptTriangle.h"
@@ -25,6 +26,7 @@
 #include "common/BBox.h"
 #include "common/Vec3.h"
 #include "Polylib_func.h"
+#include "util/StatsRegistry.h"
 
 #include "TextParser.h"
 #include "polyVersion.h"
@@ -44,6 +46,12 @@
 #include "mpi.h"
 #endif
 
+// 非同期保存用スレッド(スレッドが使用できない環境では同期的に保存する)
+#if !defined(_WIN32) && !defined(WIN32)
+#define PL_ASYNC_SAVE_THREAD
+#include <pthread.h>
+#endif
+
 using namespace Vec3class;
 
 namespace PolylibNS {
@@ -133,6 +141,89 @@ public:
     PL_REAL m_params[10];
 };
 
+////////////////////////////////////////////////////////////////////////////
+///
+/// クラス:PolylibSearchHandle
+/// Polylib::create_search_handle()で作成するポリゴン検索用ハンドルです。
+///     グループ名から解決したグループと、その配下のリーフグループの
+///     リストを保持する。ハンドルによる検索では、グループ名の照合と
+///     子孫グループの探索を行わない
+///     グループ階層が変更された場合は、Polylib::refresh_search_handle()
+///     でリストを作成し直す。作成し直すまでの検索は、ハンドルを変更せずに
+///     配下のリーフグループを探索する
+///
+////////////////////////////////////////////////////////////////////////////
+class PolylibSearchHandle {
+public:
+    ///
+    /// コンストラクタ
+    ///
+    PolylibSearchHandle()
+    {
+        m_group    = NULL;
+        m_revision = 0;
+    }
+
+    ///
+    /// グループが設定済みか
+    ///
+    ///  @return    true:設定済み
+    ///
+    bool is_valid() const
+    {
+        return m_group != NULL;
+    }
+
+    ///
+    /// 検索対象グループの取得
+    ///
+    ///  @return    グループのポインタ。未設定時はNULL
+    ///
+    PolygonGroup* get_group() const
+    {
+        return m_group;
+    }
+
+    ///
+    /// 検索対象のリーフグループのリストの取得
+    ///
+    ///  @return    リーフグループのリスト
+    ///
+    const std::vector<PolygonGroup*>& get_leaf_groups() const
+    {
+        return m_leaf;
+    }
+
+private:
+    friend class Polylib;
+
+    /// 検索対象グループ
+    PolygonGroup*                       m_group;
+
+    /// 検索対象のリーフグループ
+    std::vector<PolygonGroup*>  m_leaf;
+
+    /// m_leaf作成時のグループ階層の更新番号
+    unsigned int                m_revision;
+};
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// クラス:PolylibSearchResult
+/// 検索対象グループと検索結果を保持する、再利用可能な検索結果カーソルです。
+///     C言語/Fortran用の検索結果カーソル(PL_RES_TAG)の実体
+///     検索の度に結果リストを空にするが、領域は解放しない
+///
+////////////////////////////////////////////////////////////////////////////
+class PolylibSearchResult {
+public:
+    /// 検索対象グループ
+    PolylibSearchHandle     m_handle;
+
+    /// 検索されたポリゴンリスト
+    std::vector<Triangle*>  m_tri_list;
+};
+
 ////////////////////////////////////////////////////////////////////////////
 ///
 /// クラス:Polylib
@@ -170,6 +261,65 @@ public:
     ///                          false : 3角形平面で検索
     static bool get_srch_mode();
 
+    ///
+    /// ポリゴンの並べ替えモードの指定
+    /// KD木作成時に、グループ内のポリゴンを重心のMorton符号（空間充填曲線）
+    /// 順に並べ替えるかどうかを指定する。近傍のポリゴンがリスト上でも近くなり、
+    /// 検索結果や保存ファイル・通信バッファが空間的にまとまる
+    ///  @param[in] morton   並べ替え指定
+    ///                          true  : Morton符号順に並べ替える
+    ///                          false : 読み込み順のまま(デフォルト)
+    ///  @attention  並べ替え前の順序はPolygonGroup::get_tri_order()で取得する
+    static void set_sort_mode( bool morton );
+
+    ///
+    /// ポリゴンの並べ替えモードの取得
+    ///
+    ///  @return   並べ替えモード
+    ///                          true  : Morton符号順に並べ替える
+    ///                          false : 読み込み順のまま
+    static bool get_sort_mode();
+
+    ///
+    /// グループ単位の並列移動モードの指定
+    /// move()で、各グループの移動関数の呼び出しとKD木の再構築を
+    /// グループ毎にOpenMPのスレッドで並列に実行するかどうかを指定する
+    ///  @param[in] parallel   並列移動指定
+    ///                          true  : グループ毎に並列に実行する
+    ///                          false : グループ毎に順に実行する(デフォルト)
+    ///  @attention  移動関数がスレッドセーフな場合（他のグループや共有データを
+    ///             変更しない場合）のみ指定すること
+    ///             OpenMPを有効にしてビルドしていない場合は順に実行する
+    static void set_parallel_move( bool parallel );
+
+    ///
+    /// グループ単位の並列移動モードの取得
+    ///
+    ///  @return   並列移動モード
+    ///                          true  : グループ毎に並列に実行する
+    ///                          false : グループ毎に順に実行する
+    static bool get_parallel_move();
+
+    ///
+    /// インデックスキャッシュディレクトリの指定
+    /// 設定した場合、ポリゴンファイル読み込み時に、読み込んだポリゴンとKD木を
+    /// Polylibバイナリファイル(plb)としてキャッシュし、次回以降はキャッシュより
+    /// 読み込む。キャッシュはファイルパス・サイズ・更新時刻、縮尺率、
+    /// 検索モード・並べ替えモードをキーとする。
+    /// 並べ替えモード(set_sort_mode)が有効な場合、キャッシュは使用しない
+    /// （get_tri_orderの並べ替え前の順序はキャッシュに保存されないため）。
+    /// 設定ファイルではPolylib直下のcachedirで指定する
+    ///  @param[in] dir   キャッシュディレクトリ(既存であること)
+    ///                      空文字列の場合、キャッシュを使用しない(デフォルト)
+    static void set_cache_dir( const std::string& dir );
+
+    ///
+    /// インデックスキャッシュディレクトリの取得
+    ///
+    ///  @return   キャッシュディレクトリ
+    ///                      空文字列の場合、キャッシュを使用しない
+    static std::string get_cache_dir();
+
 #ifdef MPI_PL
     ///
     /// MPIのコミュニケータを返す
@@ -258,7 +408,229 @@ public:
         return &m_other_procs_area;
     }
 
+    ///
+    /// ポリゴンの再分散（ロードバランス）
+    /// (各ランクが１領域を担当している場合）
+    /// 新しい担当領域を全rankで各々設定し、全ポリゴングループのポリゴンを
+    /// 新しい担当領域に従って再分散する。
+    ///
+    ///  @param[in] bpos    自PE新担当領域の基点座標
+    ///  @param[in] bbsize  同、計算領域のボクセル数
+    ///  @param[in] gcsize  同、ガイドセルのボクセル数
+    ///  @param[in] dx      同、ボクセル１辺の長さ
+    ///  @return POLYLIB_STATで定義される値が返る。
+    ///  @attention 全rankで呼び出すこと（集団通信）
+    ///
+    POLYLIB_STAT
+        rebalance(
+        PL_REAL bpos[3],
+        unsigned int bbsize[3],
+        unsigned int gcsize[3],
+        PL_REAL dx[3]
+    );
+
+    ///
+    /// ポリゴンの再分散（ロードバランス）
+    /// (各ランクが複数領域を担当している場合）
+    /// 新しい担当領域を全rankで各々設定し、全ポリゴングループのポリゴンを
+    /// 新しい担当領域に従って再分散する。
+    /// ポリゴン情報は送信先ランクとの1対1通信でまとめて交換する。
+    ///
+    ///  @param[in] bboxes  自PE新担当領域（複数）
+    ///  @return POLYLIB_STATで定義される値が返る。
+    ///  @attention 全rankで呼び出すこと（集団通信）
+    ///             担当領域の分割方法はアプリケーション側で決定する。
+    ///             再分散の要否はget_load_info_procs()の結果で判断する。
+    ///
+    POLYLIB_STAT
+        rebalance(
+        const std::vector<ParallelBbox>&  bboxes
+    );
+
+    ///
+    /// 全ランクの負荷情報の取得
+    ///     各ランクのポリゴン数（リーフグループの合計）と
+    ///     search_polygons()の累積処理時間を全ランク分収集する
+    ///
+    ///  @param[out] num_tria_procs     ランク毎のポリゴン数
+    ///  @param[out] search_time_procs  ランク毎の検索累積時間(秒)
+    ///  @return POLYLIB_STATで定義される値が返る。
+    ///  @attention 全rankで呼び出すこと（集団通信）
+    ///             全rankに同じ値が返る
+    ///
+    POLYLIB_STAT
+        get_load_info_procs(
+        std::vector<int>&     num_tria_procs,
+        std::vector<double>&  search_time_procs
+    );
+
+    ///
+    /// ポリゴン通信量統計情報の取得
+    ///     scatter/gather/migrate/rebalanceで送信したポリゴンデータ量と、
+    ///     ポリゴン毎のシリアライズ形式（旧形式）と比べて削減されたデータ量を返す
+    ///
+    ///  @param[out] bytes        送信データ量(byte)
+    ///  @param[out] bytes_saved  旧形式に対する削減量(byte)
+    ///  @return 戻り値なし
+    ///  @attention 自ランク分の値
+    ///
+    void get_comm_stats(
+        long long int&  bytes,
+        long long int&  bytes_saved
+    ) const
+    {
+        bytes       = m_comm_bytes;
+        bytes_saved = m_comm_bytes_saved;
+    }
+
+    ///
+    /// ポリゴン通信量統計情報のリセット
+    ///
+    ///  @return 戻り値なし
+    ///
+    void reset_comm_stats( void )
+    {
+        m_comm_bytes       = 0;
+        m_comm_bytes_saved = 0;
+    }
+
+    ///
+    /// ポリゴン通信量統計情報の加算
+    ///
+    ///  @param[in] bytes         送信データ量(byte)
+    ///  @param[in] bytes_legacy  旧形式の場合のデータ量(byte)
+    ///  @return 戻り値なし
+    ///  @attention 一般ユーザ使用不可
+    ///
+    void add_comm_stats(
+        size_t  bytes,
+        size_t  bytes_legacy
+    )
+    {
+        m_comm_bytes       += bytes;
+        m_comm_bytes_saved += (long long int)bytes_legacy - (long long int)bytes;
+    }
+
+#endif
+
+    ///
+    /// 検索統計情報の取得
+    ///     search_polygons()の呼び出し回数と累積処理時間を返す
+    ///
+    ///  @param[out] count  呼び出し回数
+    ///  @param[out] time   累積処理時間(秒)
+    ///  @return 戻り値なし
+    ///  @attention MPI環境の場合、自ランク分の値
+    ///
+    void get_search_stats(
+        long long int&  count,
+        double&         time
+    ) const
+    {
+#ifdef _OPENMP
+#pragma omp critical (polylib_search_stats)
 #endif
+        {
+            count = m_search_count;
+            time  = m_search_time;
+        }
+    }
+
+    ///
+    /// 検索統計情報のリセット
+    ///
+    ///  @return 戻り値なし
+    ///
+    void reset_search_stats( void )
+    {
+#ifdef _OPENMP
+#pragma omp critical (polylib_search_stats)
+#endif
+        {
+            m_search_count = 0;
+            m_search_time  = 0.0;
+        }
+    }
+
+    ///
+    /// ポリゴンファイル書き出し統計情報の取得
+    ///     save()/save_parallel()で書き出したポリゴンファイルの総量と
+    ///     累積書き出し時間を返す。bytes/timeが書き出しスループットとなる
+    ///
+    ///  @param[out] bytes  書き出しデータ量(byte)
+    ///  @param[out] time   累積書き出し時間(秒)
+    ///  @return 戻り値なし
+    ///  @attention MPI環境の場合、自ランク分の値
+    ///
+    void get_save_stats(
+        long long int&  bytes,
+        double&         time
+    ) const
+    {
+        bytes = m_save_bytes;
+        time  = m_save_time;
+    }
+
+    ///
+    /// ポリゴンファイル書き出し統計情報のリセット
+    ///
+    ///  @return 戻り値なし
+    ///
+    void reset_save_stats( void )
+    {
+        m_save_bytes = 0;
+        m_save_time  = 0.0;
+    }
+
+    ///
+    /// ポリゴンファイル書き出し統計情報の加算
+    ///
+    ///  @param[in] bytes  書き出しデータ量(byte)
+    ///  @param[in] time   書き出し時間(秒)
+    ///  @return 戻り値なし
+    ///  @attention 一般ユーザ使用不可
+    ///
+    void add_save_stats(
+        long long int   bytes,
+        double          time
+    )
+    {
+        m_save_bytes += bytes;
+        m_save_time  += time;
+    }
+
+    ///
+    /// 処理統計情報の全ランク集計
+    ///     StatsRegistryの集計値（StatsRegistry::get_values()の並び）の
+    ///     全ランクの最小・最大・平均を求める
+    ///
+    ///  @param[out] vmin   最小値
+    ///  @param[out] vmax   最大値
+    ///  @param[out] vavg   平均値
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention MPI環境の場合、全rankで呼び出すこと（集団通信）
+    ///             非MPI環境の場合、自プロセスの値をvmin・vmax・vavgの全てに
+    ///             返す（最小＝最大＝平均）
+    ///
+    POLYLIB_STAT reduce_stats(
+        std::vector<double>&    vmin,
+        std::vector<double>&    vmax,
+        std::vector<double>&    vavg
+        );
+
+    ///
+    /// 処理統計情報のJSONファイル出力
+    ///     ランク毎のStatsRegistryの集計値と、全ランクの最小・最大・平均を
+    ///     1つのJSONファイルに出力する
+    ///
+    ///  @param[in] fname   出力ファイル名
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention MPI環境の場合、全rankで呼び出すこと（集団通信）
+    ///             ファイルはランク0が出力する
+    ///
+    POLYLIB_STAT write_stats_json(
+        const std::string&      fname
+        );
 
     ///
     /// PolygoGroup、三角形ポリゴン情報の読み込み。
@@ -328,10 +700,64 @@ public:
 
 #endif
 
+    ///
+    /// PolygoGroupツリー、三角形ポリゴン情報の非同期保存。
+    /// 三角形ポリゴン情報のスナップショットを作成した時点で戻り、
+    /// STL/NPTファイル、設定ファイルの書き出しはバックグラウンドスレッドで行う。
+    /// 保存結果(設定ファイル名)はwait_save()で取得する。
+    ///
+    ///  @param[in]  file_format      PolygonIO.hクラスで定義されているSTL/NPTファイルの
+    ///                               フォーマット
+    ///  @param[in]  extend           ファイルに付加する文字列。省略可。
+    ///                               save()と同じ。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention ファイル名命名規約はsave()と同じ。
+    ///         実行中の非同期保存がある場合は、その完了を待ってから開始する。
+    ///         wait_save()を呼ぶまでグループツリーの変更は行わないこと。
+    ///         MPI環境の場合、ランク0へのポリゴン集約は本メソッド内で行う。
+    ///
+    POLYLIB_STAT save_async(
+        const std::string&      file_format,
+        std::string             extend = ""
+        );
+
+#ifdef MPI_PL
+    ///
+    /// 全rank並列でのデータ非同期保存。
+    /// save_parallel()の非同期版。ファイル命名規則はsave_parallel()と同じ。
+    ///
+    /// @param[in] file_format  STL/NPTファイルフォーマット。
+    /// @param[in] extend       ファイル名に付加する文字列。省略可。
+    /// @return POLYLIB_STATで定義される値が返る。
+    /// @attention 保存結果(設定ファイル名)はwait_save()で取得する。
+    ///
+    POLYLIB_STAT
+        save_parallel_async(
+        const std::string& file_format,
+        std::string extend = ""
+        );
+#endif
+
+    ///
+    /// 非同期保存の完了待ち。
+    /// save_async()/save_parallel_async()で開始した保存の完了を待つ。
+    ///
+    ///  @param[out] config_name_out  保存した設定ファイル名の返却用。
+    ///  @return    非同期保存の結果(POLYLIB_STATで定義される値)が返る。
+    ///             実行中の保存がない場合はPLSTAT_OKが返る。
+    ///  @attention load()/save()/save_parallel()およびデストラクタは
+    ///             内部で本メソッドを呼び出す。
+    ///
+    POLYLIB_STAT wait_save(
+        std::string&            config_name_out
+        );
+
     ///
     /// 三角形ポリゴン座標の移動
     /// 本クラスインスタンス配下の全PolygonGroupのmoveメソッドが呼び出される。
     /// moveメソッドは、PolygonGroupクラスを拡張したクラスに利用者が記述する。
+    ///     set_parallel_move(true)の場合、グループ毎に並列に実行する
+    ///     グループ毎の処理時間はPolygonGroup::get_move_time()で取得する
     ///
     ///  @param[in] params  Polylib.hで宣言された移動計算パラメータセット。
     ///  @return    POLYLIB_STATで定義される値が返る。
@@ -396,6 +822,286 @@ public:
         const bool              every
         ) const;
 
+    ///
+    /// 詳細度レベルを指定したポリゴンの検索
+    /// 位置ベクトルmin_posとmax_posにより特定される矩形領域に含まれる、
+    /// 指定レベルの簡略化ポリゴンをgroup_nameで指定されたグループの下から探索する
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///                                 ポリゴンが追加されて返される
+    ///  @param[in]     group_name  抽出グループ名
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:3頂点の一部でも検索領域と重なるものを抽出
+    ///  @param[in]     level       詳細度レベル（0:元のポリゴン）
+    ///                             グループ毎の作成済みレベル数を超える場合は
+    ///                             最も粗いレベルを検索する
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention tri_list内のポリゴン要素は、削除不可
+    ///             簡略化ポリゴンは事前にbuild_lod()で作成しておくこと
+    ///             元の三角形IDはPolygonGroup::get_lod_source_ids()で取得する
+    ///
+    POLYLIB_STAT search_polygons(
+        std::vector<Triangle*>& tri_list,
+        const std::string&      group_name, 
+        const Vec3<PL_REAL>&    min_pos, 
+        const Vec3<PL_REAL>&    max_pos, 
+        bool                    every,
+        int                     level
+        ) const;
+
+    ///
+    /// 三角形と矩形領域の厳密な交差判定によるポリゴンの検索
+    /// 位置ベクトルmin_posとmax_posにより特定される矩形領域と交差する
+    /// ポリゴンをgroup_nameで指定されたグループの下から探索する
+    ///     search_polygons(every=false)の結果から、BBoxのみ重なり
+    ///     三角形は矩形領域と交差しないポリゴンを除いたものとなる
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///                                 ポリゴンが追加されて返される
+    ///  @param[in]     group_name  抽出グループ名
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention tri_list内のポリゴン要素は、削除不可
+    ///             長田パッチも平面三角形として判定する
+    ///
+    POLYLIB_STAT search_polygons_exact(
+        std::vector<Triangle*>& tri_list,
+        const std::string&      group_name, 
+        const Vec3<PL_REAL>&    min_pos, 
+        const Vec3<PL_REAL>&    max_pos
+        ) const;
+
+    ///
+    /// ポリゴン検索用ハンドルの作成
+    ///     group_nameを解決し、配下のリーフグループのリストを保持する
+    ///     同じグループを繰り返し検索する場合に使用する
+    ///
+    ///  @param[in]  group_name  抽出グループ名
+    ///  @param[out] handle      検索用ハンドル
+    ///  @return    POLYLIB_STATで定義される値
+    ///
+    POLYLIB_STAT create_search_handle(
+        const std::string&      group_name,
+        PolylibSearchHandle&    handle
+        ) const;
+
+    ///
+    /// 検索用ハンドルのリーフグループのリストを作成し直す
+    ///     グループ階層が変更されている場合のみ作成し直す
+    ///     検索関数はハンドルを変更しないため、グループ階層の変更後は
+    ///     検索の前に本関数を呼び出す
+    ///
+    ///  @param[in,out] handle  create_search_handle()で作成したハンドル
+    ///  @return    POLYLIB_STATで定義される値
+    ///
+    POLYLIB_STAT refresh_search_handle(
+        PolylibSearchHandle&    handle
+        ) const;
+
+    ///
+    /// グループ名の索引とグループ単位BVHを作成し直す
+    ///     PolygonGroup::set_name()等でグループ名・親子関係を直接変更した
+    ///     後に呼び出す。呼び出すまでの検索は、索引を使わずにグループを
+    ///     線形探索し、グループ単位BVHを使わずにリーフグループを検索する
+    ///  @attention 検索関数(const)は索引・BVHを変更しないため、複数スレッド
+    ///             から同時に呼び出せる。本関数は検索と同時に呼び出さないこと
+    ///
+    void update_search_index();
+
+    ///
+    /// 検索用ハンドルを指定したポリゴンの検索
+    ///     search_polygons(tri_list,group_name,...)と同じ結果となる
+    ///     グループ名の照合、子孫グループの探索、作業領域の確保を行わない
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///                                 ポリゴンが追加されて返される
+    ///  @param[in]     handle      create_search_handle()で作成したハンドル
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:3頂点の一部でも検索領域と重なるものを抽出
+    ///  @param[in]     level       詳細度レベル（0:元のポリゴン）
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention tri_list内のポリゴン要素は、削除不可
+    ///
+    POLYLIB_STAT search_polygons(
+        std::vector<Triangle*>&     tri_list,
+        const PolylibSearchHandle&  handle, 
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos, 
+        bool                        every,
+        int                         level = 0
+        ) const;
+
+    ///
+    /// 検索用ハンドルを指定した、三角形と矩形領域の厳密な交差判定による
+    /// ポリゴンの検索
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///                                 ポリゴンが追加されて返される
+    ///  @param[in]     handle      create_search_handle()で作成したハンドル
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention tri_list内のポリゴン要素は、削除不可
+    ///
+    POLYLIB_STAT search_polygons_exact(
+        std::vector<Triangle*>&     tri_list,
+        const PolylibSearchHandle&  handle, 
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos
+        ) const;
+
+    ///
+    /// グループIDを付けたポリゴンの検索
+    ///     search_polygons(tri_list,group_name,...)の結果に加え、
+    ///     各ポリゴンが属するリーフグループのIDを返す
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///                                 ポリゴンが追加されて返される
+    ///  @param[in,out] group_ids   tri_listの各ポリゴンのグループID
+    ///                                 tri_listと同じ数になるよう追加される
+    ///  @param[in]     group_name  抽出グループ名
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:3頂点の一部でも検索領域と重なるものを抽出
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention グループIDはPolygonGroup::get_internal_id()の値
+    ///             呼び出し前のtri_listとgroup_idsは同じ数であること
+    ///
+    POLYLIB_STAT search_polygons(
+        std::vector<Triangle*>& tri_list,
+        std::vector<int>&       group_ids,
+        const std::string&      group_name, 
+        const Vec3<PL_REAL>&    min_pos, 
+        const Vec3<PL_REAL>&    max_pos, 
+        bool                    every
+        ) const;
+
+    ///
+    /// 検索用ハンドルを指定した、グループIDを付けたポリゴンの検索
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///                                 ポリゴンが追加されて返される
+    ///  @param[in,out] group_ids   tri_listの各ポリゴンのグループID
+    ///                                 tri_listと同じ数になるよう追加される
+    ///  @param[in]     handle      create_search_handle()で作成したハンドル
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:3頂点の一部でも検索領域と重なるものを抽出
+    ///  @return    POLYLIB_STATで定義される値
+    ///
+    POLYLIB_STAT search_polygons(
+        std::vector<Triangle*>&     tri_list,
+        std::vector<int>&           group_ids,
+        const PolylibSearchHandle&  handle, 
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos, 
+        bool                        every
+        ) const;
+
+    ///
+    /// 検索結果カーソルへのポリゴンの検索
+    ///     result.m_handleのグループを検索し、result.m_tri_listを
+    ///     検索結果で置き換える
+    ///
+    ///  @param[in,out] result      検索結果カーソル
+    ///  @param[in]     min_pos     抽出する矩形領域の最小値
+    ///  @param[in]     max_pos     抽出する矩形領域の最大値
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:3頂点の一部でも検索領域と重なるものを抽出
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention result.m_handleはcreate_search_handle()で設定しておくこと
+    ///
+    POLYLIB_STAT search_polygons(
+        PolylibSearchResult&        result,
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos, 
+        bool                        every
+        ) const;
+
+    ///
+    /// 詳細度レベル（LOD）ごとの簡略化ポリゴンを作成する
+    ///     group_name以下のリーフグループ毎にPolygonGroup::build_lod()を実行する
+    ///
+    ///  @param[in] group_name  グループ名
+    ///  @param[in] num_level   作成するレベル数
+    ///  @param[in] ratio       レベル毎の三角形数の縮小率 (0<ratio<1)
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention MPI並列時は各ランクの担当ポリゴンのみで作成する（通信なし）
+    ///
+    POLYLIB_STAT build_lod(
+        const std::string&      group_name,
+        int                     num_level,
+        PL_REAL                 ratio = 0.25
+        );
+
+    ///
+    /// ボクセル格子インデックスを作成する
+    ///     group_name以下のリーフグループ毎に、既存の格子を削除して
+    ///     PolygonGroup::add_voxel_index()を実行する
+    ///     以後、ボクセル境界に揃った矩形領域のsearch_polygons()は格子で検索する
+    ///
+    ///  @param[in] group_name  グループ名
+    ///  @param[in] org         格子の基点座標（セル(0,0,0)の最小位置）
+    ///  @param[in] dx          セル１辺の長さ
+    ///  @param[in] num         各方向のセル数
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention セル毎のポリゴンリストはPolygonGroup::get_voxel_index()で取得する
+    ///
+    POLYLIB_STAT build_voxel_index(
+        const std::string&      group_name,
+        const PL_REAL           org[3],
+        const PL_REAL           dx[3],
+        const int               num[3]
+        );
+
+#ifdef MPI_PL
+    ///
+    /// 自PE担当領域のボクセル格子インデックスを作成する
+    ///     init_parallel_info()で設定した担当領域（複数）毎に、
+    ///     ガイドセルを含めたボクセルを格子のセルとする
+    ///
+    ///  @param[in] group_name  グループ名
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention init_parallel_info()/rebalance()の後に呼び出すこと（通信なし）
+    ///
+    POLYLIB_STAT build_voxel_index(
+        const std::string&      group_name
+        );
+#endif
+
+    ///
+    /// グループ単位BVHを作成する
+    ///     group_name配下のリーフグループのBBoxを上位階層とする二段構成BVHを
+    ///     作成し、以後のgroup_nameを指定した検索ではBBoxが重なる
+    ///     リーフグループのみを検索する
+    ///     リーフグループの移動（KD木の再構築）時はBBoxのみ更新する
+    ///
+    ///  @param[in] group_name  グループ名（子グループを持つグループ）
+    ///  @return    POLYLIB_STATで定義される値
+    ///  @attention 詳細度レベル(level>0)の検索では使用しない
+    ///             グループ階層を変更した場合は、次回検索時に作成し直す
+    ///
+    POLYLIB_STAT build_group_bvh(
+        const std::string&      group_name
+        );
+
+    ///
+    /// グループ単位BVHを削除する
+    ///
+    ///  @param[in] group_name  グループ名
+    ///  @return    POLYLIB_STATで定義される値
+    ///
+    POLYLIB_STAT clear_group_bvh(
+        const std::string&      group_name
+        );
+
     ///
     /// 長田パッチポリゴンの検索
     /// 位置ベクトルmin_posとmax_posにより特定される矩形領域に含まれる、
@@ -559,6 +1265,10 @@ public:
     ///
     /// グループの取得。
     /// nameで与えられた名前のPolygonGroupを返す。
+    ///     フルパス名、グループ名の順に索引から検索する
+    ///     同名のグループが複数ある場合は、先に登録されたものを返す
+    ///     索引作成後にグループ階層が変更されている場合は、索引を変更せずに
+    ///     グループリストを線形探索する
     ///  @param[in] name グループ名
     ///  @return    ポリゴングループクラスのポインタ。エラー時はNULLが返る。
     ///  @attention オーバーロードメソッドあり。
@@ -605,6 +1315,37 @@ protected:
                  ParallelAreaInfo& myproc_area,
                  std::vector<ParallelAreaInfo>& all_procs_area
              );
+
+    ///
+    /// 担当領域情報の設定
+    ///     自PE担当領域を設定し、全PEの担当領域の収集、
+    ///     自PEを除く全PE・隣接PE担当領域情報リストの再設定を行う
+    ///
+    ///  @param[in]  bboxes         自PE担当領域（複数）
+    ///  @param[out] all_procs_area 全PEの担当領域
+    ///  @return POLYLIB_STATで定義される値が返る。
+    ///  @attention init_parallel_info()/rebalance()から呼ばれる
+    ///
+    POLYLIB_STAT
+        set_parallel_area(
+                 const std::vector<ParallelBbox>& bboxes,
+                 std::vector<ParallelAreaInfo>&   all_procs_area
+             );
+
+    ///
+    /// 自PE領域と隣接するPEの検索
+    ///     全PEの担当領域をKD木に登録し、自PEの担当領域（複数）と
+    ///     交差するPEを検索する
+    ///
+    ///  @param[in]  all_procs_area 全PEの担当領域
+    ///  @param[out] neibour_flags  ランク番号毎の隣接フラグ(自PEを含む)
+    ///  @return POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT
+        search_neibour_procs(
+                 std::vector<ParallelAreaInfo>& all_procs_area,
+                 std::vector<bool>&             neibour_flags
+             );
 #endif
 
     ///
@@ -735,6 +1476,91 @@ protected:
 
 #endif
 
+    ///
+    /// 非同期保存対象ポリゴングループ
+    ///   ポリゴンはserialize_polygons()形式のスナップショット、
+    ///   または集約済みポリゴンリストのいずれかで保持する
+    ///
+    struct SaveJobGroup {
+        PolygonGroup*           pg;         ///< 保存するポリゴングループ
+        std::vector<Triangle*>* tri_list;   ///< 集約済みポリゴンリスト(所有)。NULL可
+        std::vector<char>       buff;       ///< ポリゴンのスナップショット
+        int                     pl_type;    ///< ポリゴンタイプ
+        int                     numAtrI;    ///< ユーザ定義属性数（整数型）
+        int                     numAtrR;    ///< ユーザ定義属性数（実数型）
+        int                     num_tri;    ///< スナップショットのポリゴン数
+    };
+
+    ///
+    /// 非同期保存ジョブ
+    ///
+    struct SaveJob {
+        std::string                 rank_no;        ///< ファイル名に付加するランク番号
+        std::string                 extend;         ///< ファイル名に付加する文字列
+        std::string                 format;         ///< ファイルフォーマット
+        std::vector<SaveJobGroup>   groups;         ///< 保存対象ポリゴングループ
+        std::string                 config_name;    ///< 保存した設定ファイル名
+        POLYLIB_STAT                stat;           ///< 保存結果
+        long long int               save_bytes;     ///< 書き出しデータ量(byte)
+        std::vector<double>         save_times;     ///< ファイル毎の書き出し時間(秒)
+    };
+
+    ///
+    /// 非同期保存ジョブへのポリゴングループのスナップショット追加
+    ///
+    ///  @param[in,out] job     非同期保存ジョブ
+    ///  @param[in]     pg      ポリゴングループ
+    ///  @param[in]     tri_list 集約済みポリゴンリスト。NULLの場合はpgが持つ
+    ///                          ポリゴンリストのスナップショットを作成する
+    ///
+    void add_save_job_group(
+        SaveJob*                job,
+        PolygonGroup*           pg,
+        std::vector<Triangle*>* tri_list
+        );
+
+    ///
+    /// 非同期保存ジョブの開始
+    ///   スレッドが使用できない場合はその場で実行する
+    ///
+    ///  @param[in] job     非同期保存ジョブ
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT start_save_job(
+        SaveJob*    job
+        );
+
+    ///
+    /// 非同期保存ジョブの実行（ファイル、設定ファイルの書き出し）
+    ///
+    ///  @param[in,out] job     非同期保存ジョブ
+    ///
+    void exec_save_job(
+        SaveJob*    job
+        );
+
+    ///
+    /// 実行中の非同期保存の完了待ち（load()/save()等の内部用）
+    ///     非同期保存が失敗していた場合はエラーを出力する
+    ///
+    ///  @param[in] func_name   呼び出し元の関数名（エラー出力用）
+    ///
+    void wait_save_internal(
+        const char* func_name
+        );
+
+#ifdef PL_ASYNC_SAVE_THREAD
+    ///
+    /// 非同期保存スレッドのエントリ
+    ///
+    ///  @param[in] arg     Polylibクラスのポインタ
+    ///  @return    NULL
+    ///
+    static void* save_thread_main(
+        void*       arg
+        );
+#endif
+
 
 private:
 
@@ -749,6 +1575,68 @@ private:
         std::vector<PolygonGroup*>  *pg
         ) const;
 
+    ///
+    /// 検索用ハンドルのリーフグループのリストの取得
+    ///     グループ階層が変更されている場合は、ハンドルを変更せずに
+    ///     作業領域へリーフグループを抽出する
+    ///  @param[in]  handle 検索用ハンドル
+    ///  @param[out] work   作業領域
+    ///  @return    リーフグループのリスト（handle.m_leafまたはwork）
+    ///
+    const std::vector<PolygonGroup*>& get_handle_leaf_groups(
+        const PolylibSearchHandle&  handle,
+        std::vector<PolygonGroup*>& work
+        ) const;
+
+    ///
+    /// 検索用ハンドルによるポリゴンの検索
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///  @param[in,out] group_ids   各ポリゴンのグループID（NULL:設定しない）
+    ///  @param[in]     handle      検索用ハンドル
+    ///  @param[in]     bbox        検索範囲
+    ///  @param[in]     every       検索モード
+    ///  @param[in]     level       詳細度レベル
+    ///  @return    POLYLIB_STATで定義される値
+    ///
+    POLYLIB_STAT search_handle_groups(
+        std::vector<Triangle*>&     tri_list,
+        std::vector<int>*           group_ids,
+        const PolylibSearchHandle&  handle,
+        const BBox&                 bbox,
+        bool                        every,
+        int                         level
+        ) const;
+
+    ///
+    /// 検索統計情報の加算
+    ///     StatsRegistryの集計が有効な場合は、処理時間と検索結果数も加算する
+    ///
+    ///  @param[in] wt_start    検索開始時刻(get_wall_time()の値)
+    ///  @param[in] num_result  検索結果のポリゴン数
+    ///
+    void add_search_stats(
+        double                      wt_start,
+        size_t                      num_result
+        ) const;
+
+    ///
+    /// 検索に使用できるグループ単位BVHの取得
+    ///     グループ階層が変更されている場合は使用しない(NULLを返す)
+    ///     作成し直しはupdate_search_index()で行う
+    ///
+    ///  @param[in] pg      グループ
+    ///  @return    グループ単位BVH。未作成の場合はNULL
+    ///
+    GroupBVH* get_valid_group_bvh(
+        PolygonGroup    *pg
+        ) const;
+
+    ///
+    /// グループ名の索引を作成し直す。
+    ///
+    void update_group_index();
+
     ///
     /// 設定ファイルの保存。 PolylibConfig 内部にあったものをここへ。
     //  暫定措置
@@ -769,13 +1657,30 @@ private:
 #ifdef MPI_PL
 
     ///
-    /// 移動除外三角形IDリストの作成
+    /// 三角形が懸かっている隣接PE領域(ガイドセル含)のビットマスクを算出
+    ///    ビット位置はm_neibour_procs_areaの順番。
+    ///    M_GHOST_MASK_BITS番目以降の隣接PEは対象外
     ///
-    /// @return POLYLIB_STATで定義される値が返る。
+    ///  @param[in] tri     三角形
+    ///  @return    ビットマスク
+    ///
+    unsigned long long int calc_ghost_mask(
+        Triangle* tri
+        );
+
+    ///
+    /// ポリゴングループ内の全三角形の隣接PE領域ビットマスクを更新
+    ///
+    ///  @param[in] p_pg    ポリゴングループ
+    ///  @param[in] gain    true:新たに懸かった隣接PE領域を移動対象として記録する
+    ///                     false:ビットマスクの初期化のみ
+    ///  @return POLYLIB_STATで定義される値が返る。
     ///
     POLYLIB_STAT
-        //select_excluded_trias( PolygonGroup *p_pg );
-        select_excluded_trias( void );
+        update_ghost_masks(
+            PolygonGroup*   p_pg,
+            bool            gain
+        );
 
 #endif
 
@@ -788,6 +1693,18 @@ protected:
     /// 全てのポリゴングループリスト
     std::vector<PolygonGroup*>  m_pg_list;
 
+    /// フルパス名からポリゴングループへの索引
+    std::map<std::string, PolygonGroup*>    m_pg_path_index;
+
+    /// グループ名からポリゴングループへの索引
+    std::map<std::string, PolygonGroup*>    m_pg_name_index;
+
+    /// 索引作成時のグループ階層の更新番号
+    unsigned int                m_pg_index_revision;
+
+    /// 索引が作成済みか
+    bool                        m_pg_index_valid;
+
     /// TextParser へのポインタ
     TextParser* tp;
 
@@ -805,11 +1722,20 @@ protected:
     //std::vector<ParallelInfo*> m_neibour_procs;
     std::vector<ParallelAreaInfo> m_neibour_procs_area; // ポインタを止める
     
-    /// migrate除外三角形IDマップ(k:グループID, v:三角形IDリスト)
-    ///    一時情報  m_neibour_procs_area数分あり(順番も同一）
-    //     ここに必要かどうか実装時に再検討。削除可能であれば削除する
-    std::vector< std::map< int, std::vector<long long int> > > m_exclusion_map_procs;
-           //              grp_id           polygon_id
+    /// 三角形の隣接PE領域ビットマスクが有効かどうか
+    ///    隣接PEが変わった場合、ポリゴンをロードした場合はfalse
+    ///    false の場合、次回move()実行前に全三角形のビットマスクを再設定する
+    bool m_ghost_mask_valid;
+
+    /// ビットマスク対象外の隣接PEがある旨を出力済みかどうか
+    ///    隣接PEが変わった場合はfalse
+    bool m_ghost_mask_overflow_logged;
+
+    /// ポリゴン送信データ量(byte)
+    long long int m_comm_bytes;
+
+    /// ポリゴン送信データ量の旧形式に対する削減量(byte)
+    long long int m_comm_bytes_saved;
 
     /// 自プロセスのランクNo
     int m_myrank;
@@ -825,6 +1751,29 @@ protected:
     /// MAXメモリーサイズ(MB)
     int m_max_memory_size_mb;
 
+    /// search_polygons()の呼び出し回数
+    mutable long long int m_search_count;
+
+    /// search_polygons()の累積処理時間(秒)
+    mutable double m_search_time;
+
+    /// ポリゴンファイル書き出しデータ量(byte)
+    long long int m_save_bytes;
+
+    /// ポリゴンファイル累積書き出し時間(秒)
+    double m_save_time;
+
+    /// 非同期保存ジョブ(未回収の場合NULL以外)
+    SaveJob* m_save_job;
+
+#ifdef PL_ASYNC_SAVE_THREAD
+    /// 非同期保存スレッド
+    pthread_t m_save_thread;
+
+    /// 非同期保存スレッドが起動中かどうか
+    bool m_save_thread_running;
+#endif
+
 
 };
 
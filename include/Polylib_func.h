@@ -15,6 +15,8 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <string.h>
+#include <climits>
 #include "polygons/Triangle.h"
 #include "polygons/NptTriangle.h"
 #include "groups/PolygonGroup.h"
@@ -23,8 +25,18 @@
 #include "common/BBox.h"
 #include "common/Vec3.h"
 
+#ifdef MPI_PL
+#include "mpi.h"
+#endif
+
 #define INLINE inline
 
+#ifdef MPI_PL
+/// 大容量通信用派生データ型のブロックサイズ(byte)
+///   int型の要素数上限(2^31-1)を超える通信はこのブロック単位で行う
+#define PL_MPI_LARGE_BLOCK_SIZE (1<<30)
+#endif
+
 using namespace Vec3class;
 
 namespace PolylibNS {
@@ -52,6 +64,201 @@ INLINE Triangle* deserialize_polygon(
     }
 }
 
+///
+/// ポリゴン（複数）の一括シリアライズ時のバッファサイズ
+///   serialize_polygons()で使用する列指向（カラム）形式のサイズ
+///
+/// @param[in]  pl_type   ポリゴンタイプ(PL_TYPE_TRIANGLE/PL_TYPE_NPT)
+/// @param[in]  numAtrI   ユーザ定義属性数（整数型）
+/// @param[in]  numAtrR   ユーザ定義属性数（実数型）
+/// @param[in]  num_tri   ポリゴン数
+/// @return バッファサイズ(byte)
+///
+INLINE size_t serialized_size_polygons(
+           int     pl_type,
+           int     numAtrI,
+           int     numAtrR,
+           size_t  num_tri
+         )
+{
+    size_t size = sizeof(long long int)       // ID
+                + 9*sizeof(PL_REAL)           // ３頂点座標
+                + numAtrR*sizeof(PL_REAL)     // ユーザ定義属性（実数型）
+                + numAtrI*sizeof(int)         // ユーザ定義属性（整数型）
+                + sizeof(short int);          // ユーザ定義ID
+    if( pl_type == PL_TYPE_NPT ) {
+        size += 21*sizeof(PL_REAL);           // 長田パッチパラメータ
+    }
+    return num_tri*size;
+}
+
+///
+/// ポリゴン（複数）の一括シリアライズ
+///   グループ単位の列指向（カラム）形式で格納する
+///     ID列、頂点座標列、（長田パッチパラメータ列）、実数属性列、整数属性列、
+///     ユーザ定義ID列の順
+///   ポリゴンタイプ、属性数はポリゴン毎には格納しないため、
+///   通信ヘッダ等で別途受け渡すこと
+///
+/// @param[in]  tri       ポリゴン配列先頭ポインタ
+/// @param[in]  num_tri   ポリゴン数
+/// @param[in]  pl_type   ポリゴンタイプ(PL_TYPE_TRIANGLE/PL_TYPE_NPT)
+/// @param[in]  numAtrI   ユーザ定義属性数（整数型）
+/// @param[in]  numAtrR   ユーザ定義属性数（実数型）
+/// @param[in]  pbuff     バッファ格納位置先頭ポインタ
+/// @return 次のバッファ格納位置ポインタ
+/// @attention バッファサイズはserialized_size_polygons()で求めること
+///
+INLINE char* serialize_polygons(
+           Triangle* const* tri,
+           int         num_tri,
+           int         pl_type,
+           int         numAtrI,
+           int         numAtrR,
+           char*       pbuff
+         )
+{
+    char* p = pbuff;
+
+    // ID列
+    for( int i=0; i<num_tri; i++ ) {
+        long long int id = tri[i]->get_id();
+        memcpy( p, &id, sizeof(long long int) );
+        p += sizeof(long long int);
+    }
+
+    // 頂点座標列
+    for( int i=0; i<num_tri; i++ ) {
+        PL_REAL vtx[9];
+        VEC3_3_TO_REAL9( tri[i]->get_vertexes(), vtx );
+        memcpy( p, vtx, 9*sizeof(PL_REAL) );
+        p += 9*sizeof(PL_REAL);
+    }
+
+    // 長田パッチパラメータ列
+    if( pl_type == PL_TYPE_NPT ) {
+        for( int i=0; i<num_tri; i++ ) {
+            NptTriangle* pNpt = dynamic_cast<NptTriangle*>(tri[i]);
+            PL_REAL cp[21];
+            NPATCH_PARAM_TO_REAL21( (*pNpt->get_npatch_param()), cp );
+            memcpy( p, cp, 21*sizeof(PL_REAL) );
+            p += 21*sizeof(PL_REAL);
+        }
+    }
+
+    // ユーザ定義属性（実数型）列
+    if( numAtrR > 0 ) {
+        for( int i=0; i<num_tri; i++ ) {
+            int n = tri[i]->get_num_atrR();
+            if( n > numAtrR ) n = numAtrR;
+            if( n > 0 ) memcpy( p, tri[i]->get_pAtrR(), n*sizeof(PL_REAL) );
+            if( n < numAtrR ) memset( p+n*sizeof(PL_REAL), 0, (numAtrR-n)*sizeof(PL_REAL) );
+            p += numAtrR*sizeof(PL_REAL);
+        }
+    }
+
+    // ユーザ定義属性（整数型）列
+    if( numAtrI > 0 ) {
+        for( int i=0; i<num_tri; i++ ) {
+            int n = tri[i]->get_num_atrI();
+            if( n > numAtrI ) n = numAtrI;
+            if( n > 0 ) memcpy( p, tri[i]->get_pAtrI(), n*sizeof(int) );
+            if( n < numAtrI ) memset( p+n*sizeof(int), 0, (numAtrI-n)*sizeof(int) );
+            p += numAtrI*sizeof(int);
+        }
+    }
+
+    // ユーザ定義ID列
+    for( int i=0; i<num_tri; i++ ) {
+        short int exid = (short int)tri[i]->get_exid();
+        memcpy( p, &exid, sizeof(short int) );
+        p += sizeof(short int);
+    }
+
+    return p;
+}
+
+///
+/// ポリゴン（複数）の一括デシリアライズ
+///   serialize_polygons()で格納されたデータよりオブジェクトを生成し、追加する
+///
+/// @param[in]     pl_type   ポリゴンタイプ(PL_TYPE_TRIANGLE/PL_TYPE_NPT)
+/// @param[in]     numAtrI   ユーザ定義属性数（整数型）
+/// @param[in]     numAtrR   ユーザ定義属性数（実数型）
+/// @param[in]     num_tri   ポリゴン数
+/// @param[in]     pbuff     バッファ格納位置先頭ポインタ
+/// @param[in,out] tri_list  生成したオブジェクト(Triangle/NptTriangle)の追加先
+/// @return 次のバッファ格納位置ポインタ
+///
+INLINE const char* deserialize_polygons(
+           int         pl_type,
+           int         numAtrI,
+           int         numAtrR,
+           int         num_tri,
+           const char* pbuff,
+           std::vector<Triangle*>& tri_list
+         )
+{
+    if( num_tri <= 0 ) return pbuff;
+
+    // 各列の先頭位置
+    const char* p_id   = pbuff;
+    const char* p_vtx  = p_id  + num_tri*sizeof(long long int);
+    const char* p_npt  = p_vtx + num_tri*9*sizeof(PL_REAL);
+    const char* p_atrR = p_npt;
+    if( pl_type == PL_TYPE_NPT ) {
+        p_atrR += num_tri*21*sizeof(PL_REAL);
+    }
+    const char* p_atrI = p_atrR + (size_t)num_tri*numAtrR*sizeof(PL_REAL);
+    const char* p_exid = p_atrI + (size_t)num_tri*numAtrI*sizeof(int);
+
+    std::vector<int>     atrI( numAtrI>0 ? numAtrI : 1 );
+    std::vector<PL_REAL> atrR( numAtrR>0 ? numAtrR : 1 );
+
+    tri_list.reserve( tri_list.size() + num_tri );
+    for( int i=0; i<num_tri; i++ ) {
+        long long int id;
+        memcpy( &id, p_id, sizeof(long long int) );
+        p_id += sizeof(long long int);
+
+        PL_REAL vtx[9];
+        Vec3<PL_REAL> vertex[3];
+        memcpy( vtx, p_vtx, 9*sizeof(PL_REAL) );
+        REAL9_TO_VEC3_3( vtx, vertex );
+        p_vtx += 9*sizeof(PL_REAL);
+
+        if( numAtrR > 0 ) {
+            memcpy( &atrR[0], p_atrR, numAtrR*sizeof(PL_REAL) );
+            p_atrR += numAtrR*sizeof(PL_REAL);
+        }
+        if( numAtrI > 0 ) {
+            memcpy( &atrI[0], p_atrI, numAtrI*sizeof(int) );
+            p_atrI += numAtrI*sizeof(int);
+        }
+
+        short int exid;
+        memcpy( &exid, p_exid, sizeof(short int) );
+        p_exid += sizeof(short int);
+
+        // 面積と法線はコンストラクタ内で計算される
+        Triangle* pTri;
+        if( pl_type == PL_TYPE_NPT ) {
+            PL_REAL cp[21];
+            NpatchParam param;
+            memcpy( cp, p_npt, 21*sizeof(PL_REAL) );
+            REAL21_TO_NPATCH_PARAM( cp, param );
+            p_npt += 21*sizeof(PL_REAL);
+            pTri = new NptTriangle( vertex, param, id, numAtrI, numAtrR, &atrI[0], &atrR[0] );
+        } else {
+            pTri = new Triangle( vertex, id, numAtrI, numAtrR, &atrI[0], &atrR[0] );
+        }
+        pTri->set_exid( exid );
+        tri_list.push_back( pTri );
+    }
+
+    return p_exid;
+}
+
 ///
 /// ポリゴンの複製
 ///   ポリゴンの種別(Triangle/NptTrinangle)を判別し、適正なポリゴンを生成する
@@ -216,6 +423,272 @@ INLINE void free_array_2d ( void** x )
     free( x ); 
 }
 
+///
+/// 3次元Morton符号（Zオーダー）の作成
+///   各軸21bitに量子化した座標のビットを交互に並べる
+///
+///  @param[in]   pos       座標
+///  @param[in]   bbox      座標の範囲
+///  @return Morton符号(63bit)
+///  @attention  範囲外の座標は範囲の端として扱う
+///
+INLINE unsigned long long int morton_code (
+        const Vec3<PL_REAL>&    pos,
+        const BBox&             bbox
+    )
+{
+    const PL_REAL *p   = pos;
+    const PL_REAL *min = bbox.min;
+    const PL_REAL *max = bbox.max;
+    unsigned long long int code = 0;
+    for( int axis=0; axis<3; axis++ ) {
+        double len = max[axis] - min[axis];
+        double t   = (len > 0.0) ? (p[axis] - min[axis]) / len : 0.0;
+        if( t < 0.0 )   t = 0.0;
+        if( t > 1.0 )   t = 1.0;
+        unsigned long long int v = (unsigned long long int)( t * 2097151.0 );  // 2^21-1
+        // 3bit毎にビットを分散
+        v = (v | (v << 32)) & 0x1f00000000ffffULL;
+        v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+        v = (v | (v <<  8)) & 0x100f00f00f00f00fULL;
+        v = (v | (v <<  4)) & 0x10c30c30c30c30c3ULL;
+        v = (v | (v <<  2)) & 0x1249249249249249ULL;
+        code |= v << axis;
+    }
+    return code;
+}
+
+///
+/// 三角形と直方体の交差判定
+///   分離軸（直方体の3軸、三角形の法線、辺と直方体の軸の外積9軸）で判定する
+///   境界で接する場合は交差とする
+///
+///  @param[in]   v         三角形の3頂点
+///  @param[in]   center    直方体の中心
+///  @param[in]   half      直方体の各辺の長さの半分
+///  @return true:交差する
+///
+INLINE bool tri_box_overlap (
+        const Vec3<PL_REAL>     v[3],
+        const Vec3<PL_REAL>&    center,
+        const Vec3<PL_REAL>&    half
+    )
+{
+    double p[3][3], e[3][3], h[3];
+    for( int i=0; i<3; i++ ) {
+        const PL_REAL *vi = v[i];
+        const PL_REAL *c  = center;
+        for( int j=0; j<3; j++ )    p[i][j] = (double)vi[j] - (double)c[j];
+    }
+    const PL_REAL *hp = half;
+    for( int j=0; j<3; j++ ) {
+        h[j] = hp[j];
+        e[0][j] = p[1][j] - p[0][j];
+        e[1][j] = p[2][j] - p[1][j];
+        e[2][j] = p[0][j] - p[2][j];
+    }
+
+    // 直方体の3軸
+    for( int j=0; j<3; j++ ) {
+        double mn = p[0][j], mx = p[0][j];
+        for( int i=1; i<3; i++ ) {
+            if( p[i][j] < mn )  mn = p[i][j];
+            if( p[i][j] > mx )  mx = p[i][j];
+        }
+        if( mn > h[j] || mx < -h[j] )   return false;
+    }
+
+    // 辺と直方体の軸の外積
+    for( int i=0; i<3; i++ ) {
+        for( int j=0; j<3; j++ ) {
+            // a = x_j × e_i
+            double a[3] = { 0.0, 0.0, 0.0 };
+            int j1 = (j+1)%3, j2 = (j+2)%3;
+            a[j1] = -e[i][j2];
+            a[j2] =  e[i][j1];
+            double d0 = a[j1]*p[0][j1] + a[j2]*p[0][j2];
+            double d1 = a[j1]*p[1][j1] + a[j2]*p[1][j2];
+            double d2 = a[j1]*p[2][j1] + a[j2]*p[2][j2];
+            double mn = d0, mx = d0;
+            if( d1 < mn )   mn = d1;
+            if( d1 > mx )   mx = d1;
+            if( d2 < mn )   mn = d2;
+            if( d2 > mx )   mx = d2;
+            double r = h[j1]*fabs(a[j1]) + h[j2]*fabs(a[j2]);
+            if( mn > r || mx < -r )     return false;
+        }
+    }
+
+    // 三角形の法線
+    double n[3];
+    n[0] = e[0][1]*e[1][2] - e[0][2]*e[1][1];
+    n[1] = e[0][2]*e[1][0] - e[0][0]*e[1][2];
+    n[2] = e[0][0]*e[1][1] - e[0][1]*e[1][0];
+    double d = n[0]*p[0][0] + n[1]*p[0][1] + n[2]*p[0][2];
+    double r = h[0]*fabs(n[0]) + h[1]*fabs(n[1]) + h[2]*fabs(n[2]);
+    if( d > r || d < -r )   return false;
+
+    return true;
+}
+
+#ifdef MPI_PL
+///
+/// 大容量通信用派生データ型の作成
+///   nbyte分のMPI_BYTEと同じ型シグネチャを持つデータ型を作成する
+///     (PL_MPI_LARGE_BLOCK_SIZE byteのブロック × n ＋ 端数)
+///
+///  @param[in]   nbyte     データサイズ(byte)
+///  @param[out]  newtype   作成したデータ型（コミット済み）
+///  @return MPI関数の戻り値
+///  @attention  使用後MPI_Type_free()で解放すること
+///
+INLINE int create_mpi_byte_type (
+           size_t         nbyte,
+           MPI_Datatype*  newtype
+         )
+{
+    int iret;
+    int nblk = (int)( nbyte / PL_MPI_LARGE_BLOCK_SIZE );
+    int nrem = (int)( nbyte % PL_MPI_LARGE_BLOCK_SIZE );
+    MPI_Datatype blk_type, blks_type;
+
+    iret = MPI_Type_contiguous( PL_MPI_LARGE_BLOCK_SIZE, MPI_BYTE, &blk_type );
+    if( iret != MPI_SUCCESS ) return iret;
+    iret = MPI_Type_contiguous( nblk, blk_type, &blks_type );
+    if( iret != MPI_SUCCESS ) {
+        MPI_Type_free( &blk_type );
+        return iret;
+    }
+
+    int          blens[2] = { 1, nrem };
+    MPI_Aint     displs[2] = { 0, (MPI_Aint)nblk*(MPI_Aint)PL_MPI_LARGE_BLOCK_SIZE };
+    MPI_Datatype types[2] = { blks_type, MPI_BYTE };
+    iret = MPI_Type_create_struct( 2, blens, displs, types, newtype );
+    if( iret == MPI_SUCCESS ) {
+        iret = MPI_Type_commit( newtype );
+        if( iret != MPI_SUCCESS ) {
+            MPI_Type_free( newtype );
+        }
+    }
+
+    // 中間のデータ型はエラー時も含め解放する
+    MPI_Type_free( &blk_type );
+    MPI_Type_free( &blks_type );
+    return iret;
+}
+
+///
+/// バイト列の非同期送信（大容量対応）
+///   nbyteがint型の上限を超える場合は派生データ型で１回の送信とする
+///
+///  @param[in]   buff   送信バッファ
+///  @param[in]   nbyte  送信サイズ(byte)
+///  @param[in]   dest   送信先ランク
+///  @param[in]   tag    タグ
+///  @param[in]   comm   コミュニケータ
+///  @param[out]  req    リクエスト
+///  @return MPI関数の戻り値
+///
+INLINE int mpi_isend_bytes (
+           const void*   buff,
+           size_t        nbyte,
+           int           dest,
+           int           tag,
+           MPI_Comm      comm,
+           MPI_Request*  req
+         )
+{
+    if( nbyte <= (size_t)INT_MAX ) {
+        return MPI_Isend( const_cast<void*>(buff), (int)nbyte, MPI_BYTE, dest, tag, comm, req );
+    }
+    MPI_Datatype dtype;
+    int iret = create_mpi_byte_type( nbyte, &dtype );
+    if( iret != MPI_SUCCESS ) return iret;
+    iret = MPI_Isend( const_cast<void*>(buff), 1, dtype, dest, tag, comm, req );
+    MPI_Type_free( &dtype );    // 通信完了までは保持される
+    return iret;
+}
+
+///
+/// バイト列の非同期受信（大容量対応）
+///
+///  @param[out]  buff   受信バッファ
+///  @param[in]   nbyte  受信サイズ(byte)
+///  @param[in]   src    送信元ランク
+///  @param[in]   tag    タグ
+///  @param[in]   comm   コミュニケータ
+///  @param[out]  req    リクエスト
+///  @return MPI関数の戻り値
+///
+INLINE int mpi_irecv_bytes (
+           void*         buff,
+           size_t        nbyte,
+           int           src,
+           int           tag,
+           MPI_Comm      comm,
+           MPI_Request*  req
+         )
+{
+    if( nbyte <= (size_t)INT_MAX ) {
+        return MPI_Irecv( buff, (int)nbyte, MPI_BYTE, src, tag, comm, req );
+    }
+    MPI_Datatype dtype;
+    int iret = create_mpi_byte_type( nbyte, &dtype );
+    if( iret != MPI_SUCCESS ) return iret;
+    iret = MPI_Irecv( buff, 1, dtype, src, tag, comm, req );
+    MPI_Type_free( &dtype );    // 通信完了までは保持される
+    return iret;
+}
+
+///
+/// バイト列の送信（大容量対応）
+///
+///  @param[in]   buff   送信バッファ
+///  @param[in]   nbyte  送信サイズ(byte)
+///  @param[in]   dest   送信先ランク
+///  @param[in]   tag    タグ
+///  @param[in]   comm   コミュニケータ
+///  @return MPI関数の戻り値
+///
+INLINE int mpi_send_bytes (
+           const void*   buff,
+           size_t        nbyte,
+           int           dest,
+           int           tag,
+           MPI_Comm      comm
+         )
+{
+    MPI_Request req;
+    int iret = mpi_isend_bytes( buff, nbyte, dest, tag, comm, &req );
+    if( iret != MPI_SUCCESS ) return iret;
+    return MPI_Wait( &req, MPI_STATUS_IGNORE );
+}
+
+///
+/// バイト列の受信（大容量対応）
+///
+///  @param[out]  buff   受信バッファ
+///  @param[in]   nbyte  受信サイズ(byte)
+///  @param[in]   src    送信元ランク
+///  @param[in]   tag    タグ
+///  @param[in]   comm   コミュニケータ
+///  @return MPI関数の戻り値
+///
+INLINE int mpi_recv_bytes (
+           void*         buff,
+           size_t        nbyte,
+           int           src,
+           int           tag,
+           MPI_Comm      comm
+         )
+{
+    MPI_Request req;
+    int iret = mpi_irecv_bytes( buff, nbyte, src, tag, comm, &req );
+    if( iret != MPI_SUCCESS ) return iret;
+    return MPI_Wait( &req, MPI_STATUS_IGNORE );
+}
+#endif
+
 
 } //namespace PolylibNS
 
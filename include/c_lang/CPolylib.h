@@ -222,6 +222,18 @@ POLYLIB_STAT polylib_move(
                           PolylibMoveParamsStruct* param
                           );
 
+///
+/// グループ単位の並列移動モードの指定
+///   Polylib::set_parallel_moveメソッドのラッパー関数
+/// polylib_move()で、各グループの移動関数とKD木の再構築を並列に実行する
+///
+///  @param[in]     parallel    1:グループ毎に並列に実行する 0:順に実行する(デフォルト)
+///  @attention 移動関数がスレッドセーフな場合のみ指定すること
+///
+void polylib_set_parallel_move(
+                          int parallel
+                          );
+
 
 #ifdef MPI_PL
 ///
@@ -372,6 +384,116 @@ POLYLIB_STAT polylib_search_nearest_polygon(
         PL_REAL     pos[3]
     );
 
+///
+/// 検索結果カーソルの作成
+///     group_nameを解決して保持し、以後の検索ではグループ名の照合を行わない
+///     検索結果はカーソル内に保持し、利用者が確保した配列へ取り出す
+///     （検索結果の領域確保・二重検索が不要）
+///  @param[out]    res         検索結果カーソルのタグ
+///  @param[in]     group_name  抽出グループ名。
+///  @return    POLYLIB_STATで定義される値が返る
+///  @attention 不要になったらpolylib_result_delete()で削除すること
+///
+POLYLIB_STAT polylib_result_create(
+        PL_RES_TAG  *res,
+        char*       group_name
+    );
+
+///
+/// 検索結果カーソルの削除
+///  @param[in]     res         検索結果カーソルのタグ
+///
+void polylib_result_delete(
+        PL_RES_TAG  res
+    );
+
+///
+/// 検索結果カーソルへのポリゴンの検索
+///     前回の検索結果は置き換えられる
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[in]     min_pos     抽出する矩形領域の最小値。(x,y,z順の配列)
+///  @param[in]     max_pos     抽出する矩形領域の最大値。(x,y,z順の配列)
+///  @param[in]     every       抽出オプション。
+///   1：3頂点が全て検索領域に含まれるポリゴンを抽出する。
+///   0：三角形のBBoxが一部でも検索領域と交差するものを抽出する
+///  @param[out]    num         抽出された三角形ポリゴン数
+///  @return    POLYLIB_STATで定義される値が返る
+///
+POLYLIB_STAT polylib_result_search(
+        PL_RES_TAG  res,
+        PL_REAL     min_pos[3],
+        PL_REAL     max_pos[3],
+        int         every,
+        int         *num
+    );
+
+///
+/// 検索結果の三角形ポリゴン数の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @return    三角形ポリゴン数
+///
+int polylib_result_get_num(
+        PL_RES_TAG  res
+    );
+
+///
+/// 検索結果の三角形ポリゴンのタグの取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[out]    tags        三角形ポリゴンのタグ（ポリゴン数分確保済みであること）
+///
+void polylib_result_get_tags(
+        PL_RES_TAG  res,
+        PL_ELM_TAG  *tags
+    );
+
+///
+/// 検索結果の三角形ポリゴンの頂点座標の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[out]    vertex      頂点座標 vertex[9*i+3*j+k]
+///                                 （ポリゴンi,頂点j,成分k、9*ポリゴン数分確保済み）
+///
+void polylib_result_get_vertexes(
+        PL_RES_TAG  res,
+        PL_REAL     *vertex
+    );
+
+///
+/// 検索結果の三角形ポリゴンの法線ベクトルの取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[out]    normal      法線ベクトル normal[3*i+k]
+///                                 （3*ポリゴン数分確保済み）
+///
+void polylib_result_get_normals(
+        PL_RES_TAG  res,
+        PL_REAL     *normal
+    );
+
+///
+/// 検索結果の三角形ポリゴンのユーザ定義属性（整数型）の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]（num_atr*ポリゴン数分確保済み）
+///                                 ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void polylib_result_get_atrI(
+        PL_RES_TAG  res,
+        int         num_atr,
+        int         *atr
+    );
+
+///
+/// 検索結果の三角形ポリゴンのユーザ定義属性（実数型）の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]（num_atr*ポリゴン数分確保済み）
+///                                 ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void polylib_result_get_atrR(
+        PL_RES_TAG  res,
+        int         num_atr,
+        PL_REAL     *atr
+    );
+
 ///
 /// Polylib::show_group_hierarchyメソッドのラッパー関数。
 /// グループ階層構造リストを標準出力に出力する。
@@ -537,6 +659,41 @@ POLYLIB_STAT polylib_group_set_move_func_c(
 ///
 void polylib_group_set_need_rebuild( PL_GRP_TAG tag );
 
+///
+/// 直前のpolylib_move()での処理時間の取得
+///     PolygonGroup::get_move_timeのラッパー関数
+///
+///  @param[in]  tag            PolygonGroupを操作するためのタグ
+///  @param[out] move_time      移動関数の処理時間(秒)
+///  @param[out] rebuild_time   KD木再構築の処理時間(秒)
+///  @return    戻り値なし
+///
+void polylib_group_get_move_time(
+            PL_GRP_TAG  tag,
+            double      *move_time,
+            double      *rebuild_time
+         );
+
+///
+/// グループ内の全ポリゴンのアフィン変換
+///     PolygonGroup::transformのラッパー関数
+///     ユーザ定義の移動関数から呼び出す
+///     KD木の再構築フラグも設定する
+///
+///  @param[in] tag             PolygonGroupを操作するためのタグ
+///  @param[in] mat             ４×４変換マトリクス（行ベクトル系）
+///                                 (x',y',z',1) = (x,y,z,1) * mat
+///  @param[in] update_normal   法線ベクトルを更新するか？ 1:する 0:しない
+///  @param[in] update_area     面積を更新するか？ 1:する 0:しない
+///  @return    POLYLIB_STATで定義される値が返る
+///
+POLYLIB_STAT polylib_group_transform(
+            PL_GRP_TAG  tag,
+            PL_REAL     mat[4][4],
+            int         update_normal,
+            int         update_area
+         );
+
 
 //----------------------------------------------
 // setter / getter
@@ -743,6 +900,267 @@ PL_REAL* polylib_triangle_get_pAtrR(
                 PL_ELM_TAG tag
             );
 
+//----------------------------------------------
+//  複数ポリゴンの一括操作
+//    配列はFortranの vertex(3,3,N), normal(3,N), atr(num_atr,N) と同じ並び
+//----------------------------------------------
+
+///
+/// 頂点座標の一括取得（タグ配列指定）
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[out]    vertex      頂点座標 vertex[9*i+3*j+k]（9*num個確保済み）
+///
+void polylib_triangles_get_vertexes(
+            int         num,
+            PL_ELM_TAG  *tags,
+            PL_REAL     *vertex
+            );
+
+///
+/// 法線ベクトルの一括取得（タグ配列指定）
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[out]    normal      法線ベクトル normal[3*i+k]（3*num個確保済み）
+///
+void polylib_triangles_get_normals(
+            int         num,
+            PL_ELM_TAG  *tags,
+            PL_REAL     *normal
+            );
+
+///
+/// ユーザ定義属性（整数型）の一括取得（タグ配列指定）
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]（num_atr*num個確保済み）
+///                                 ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void polylib_triangles_get_atrI(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            int         *atr
+            );
+
+///
+/// ユーザ定義属性（実数型）の一括取得（タグ配列指定）
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]（num_atr*num個確保済み）
+///                                 ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void polylib_triangles_get_atrR(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            PL_REAL     *atr
+            );
+
+///
+/// 頂点座標の一括設定（タグ配列指定）
+///     法線ベクトル,面積も内部で設定する
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[in]     vertex      頂点座標 vertex[9*i+3*j+k]
+///  @attention KD木は更新しない。移動後はpolylib_group_set_need_rebuild()で
+///             再構築を指示すること
+///
+void polylib_triangles_set_vertexes(
+            int         num,
+            PL_ELM_TAG  *tags,
+            PL_REAL     *vertex
+            );
+
+///
+/// ユーザ定義属性（整数型）の一括設定（タグ配列指定）
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[in]     atr         属性 atr[num_atr*i+j]
+///                                 ポリゴンの属性数を超える分は無視する
+///
+void polylib_triangles_set_atrI(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            int         *atr
+            );
+
+///
+/// ユーザ定義属性（実数型）の一括設定（タグ配列指定）
+///  @param[in]     num         ポリゴン数
+///  @param[in]     tags        三角形ポリゴンのタグ配列
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[in]     atr         属性 atr[num_atr*i+j]
+///                                 ポリゴンの属性数を超える分は無視する
+///
+void polylib_triangles_set_atrR(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            PL_REAL     *atr
+            );
+
+///
+/// 頂点座標の一括取得（グループ指定）
+///     並びはpolylib_group_get_triangles()で得られるタグの順
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[out]    vertex      頂点座標 vertex[9*i+3*j+k]
+///                                 （9*polylib_group_get_num_triangles()個確保済み）
+///  @attention KD木の再構築でポリゴンの順序が変わる場合がある
+///
+void polylib_group_get_vertexes(
+            PL_GRP_TAG  tag_pg,
+            PL_REAL     *vertex
+            );
+
+///
+/// 法線ベクトルの一括取得（グループ指定）
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[out]    normal      法線ベクトル normal[3*i+k]
+///                                 （3*polylib_group_get_num_triangles()個確保済み）
+///
+void polylib_group_get_normals(
+            PL_GRP_TAG  tag_pg,
+            PL_REAL     *normal
+            );
+
+///
+/// ユーザ定義属性（整数型）の一括取得（グループ指定）
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]
+///                                 ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void polylib_group_get_atrI(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            int         *atr
+            );
+
+///
+/// ユーザ定義属性（実数型）の一括取得（グループ指定）
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]
+///                                 ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void polylib_group_get_atrR(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            PL_REAL     *atr
+            );
+
+///
+/// 頂点座標の一括設定（グループ指定）
+///     法線ベクトル,面積も内部で設定する
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[in]     vertex      頂点座標 vertex[9*i+3*j+k]
+///  @attention KD木は更新しない。移動後はpolylib_group_set_need_rebuild()で
+///             再構築を指示すること
+///
+void polylib_group_set_vertexes(
+            PL_GRP_TAG  tag_pg,
+            PL_REAL     *vertex
+            );
+
+///
+/// ユーザ定義属性（整数型）の一括設定（グループ指定）
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[in]     atr         属性 atr[num_atr*i+j]
+///
+void polylib_group_set_atrI(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            int         *atr
+            );
+
+///
+/// ユーザ定義属性（実数型）の一括設定（グループ指定）
+///  @param[in]     tag_pg      PolygonGroupのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[in]     atr         属性 atr[num_atr*i+j]
+///
+void polylib_group_set_atrR(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            PL_REAL     *atr
+            );
+
+//----------------------------------------------
+//  処理統計情報
+//    処理区分・カウンタ区分はPolylibDefine.hのPL_STATS_*
+//----------------------------------------------
+
+///
+/// 処理統計情報の集計の有効/無効の設定
+///   StatsRegistry::set_enableメソッドのラッパー関数
+///  @param[in]     enable      1:集計する 0:集計しない(デフォルト)
+///
+void polylib_stats_set_enable(
+            int         enable
+            );
+
+///
+/// 処理統計情報のリセット
+///   StatsRegistry::resetメソッドのラッパー関数
+///
+void polylib_stats_reset( void );
+
+///
+/// 処理区分の呼び出し回数と累積処理時間の取得（自ランク分）
+///  @param[in]     phase       処理区分 PL_STATS_LOAD〜PL_STATS_SAVE
+///  @param[out]    calls       呼び出し回数
+///  @param[out]    time        累積処理時間(秒)
+///
+void polylib_stats_get_time(
+            int             phase,
+            long long int   *calls,
+            double          *time
+            );
+
+///
+/// カウンタの取得（自ランク分）
+///  @param[in]     counter     カウンタ区分 PL_STATS_SEARCH_NODES〜PL_STATS_SAVE_BYTES
+///  @param[out]    count       カウンタ値
+///
+void polylib_stats_get_count(
+            int             counter,
+            long long int   *count
+            );
+
+///
+/// 処理統計情報の全ランク集計
+///   Polylib::reduce_statsメソッドのラッパー関数
+///   配列の並びは累積処理時間、呼び出し回数（各PL_STATS_NUM_PHASE個）、
+///   カウンタ（PL_STATS_NUM_COUNTER個）
+///  @param[out]    vmin        最小値（2*PL_STATS_NUM_PHASE+PL_STATS_NUM_COUNTER個確保済み）
+///  @param[out]    vmax        最大値（同上）
+///  @param[out]    vavg        平均値（同上）
+///  @return    POLYLIB_STATで定義される値が返る
+///  @attention MPI環境の場合、全rankで呼び出すこと（集団通信）
+///
+POLYLIB_STAT polylib_stats_reduce(
+            double      *vmin,
+            double      *vmax,
+            double      *vavg
+            );
+
+///
+/// 処理統計情報のJSONファイル出力
+///   Polylib::write_stats_jsonメソッドのラッパー関数
+///  @param[in]     fname       出力ファイル名
+///  @return    POLYLIB_STATで定義される値が返る
+///  @attention MPI環境の場合、全rankで呼び出すこと（集団通信）
+///
+POLYLIB_STAT polylib_stats_write_json(
+            char        *fname
+            );
+
 #ifdef __cplusplus
 } // extern "C" or extern
 #else
@@ -66,6 +66,11 @@
 //              有効期間が短いことに注意
 #define PL_ELM_TAG   long long int 
 
+// 検索結果カーソル用のタグ
+//      タグとしてPolylibSearchResult用のポインタを使う
+//      polylib_result_create()で作成し、polylib_result_delete()で削除する
+#define PL_RES_TAG   long long int 
+
 // 無効タグ
 #define PL_NULL_TAG  0
 
@@ -78,6 +83,48 @@
 #define PL_TYPE_NPT         2
 
 
+// ポリゴン検索用の木構造のタイプ
+//      グループの設定ファイルでは index = "vtree" / "lbvh" で指定する
+        // KD木(VTree)
+#define PL_INDEX_VTREE      0
+        // Morton符号による線形BVH(LBVH)
+#define PL_INDEX_LBVH       1
+
+
+// 処理統計情報（StatsRegistry）の処理区分
+//      処理区分は入れ子になる場合がある（LOAD,MOVEはBUILDを、BUILDはREFITを含む）
+        // Polylib::load()
+#define PL_STATS_LOAD       0
+        // PolygonGroup::build_polygon_tree()
+#define PL_STATS_BUILD      1
+        // 上位グループのBVHのBBox更新
+#define PL_STATS_REFIT      2
+        // Polylib::search_polygons()/search_polygons_exact()
+#define PL_STATS_SEARCH     3
+        // Polylib::move()
+#define PL_STATS_MOVE       4
+        // Polylib::migrate()
+#define PL_STATS_MIGRATE    5
+        // ポリゴンファイルの書き出し（ファイル毎）
+#define PL_STATS_SAVE       6
+#define PL_STATS_NUM_PHASE  7
+
+// 処理統計情報（StatsRegistry）のカウンタ区分
+        // 検索で訪れた木構造のノード数
+#define PL_STATS_SEARCH_NODES   0
+        // 検索で判定したリーフ要素数
+#define PL_STATS_SEARCH_LEAVES  1
+        // 検索結果のポリゴン数
+#define PL_STATS_SEARCH_RESULTS 2
+        // migrate()の送信データ量(byte)
+#define PL_STATS_MIGRATE_BYTES  3
+        // migrate()の送信メッセージ数
+#define PL_STATS_MIGRATE_MSGS   4
+        // 書き出したポリゴンファイルのサイズ(byte)
+#define PL_STATS_SAVE_BYTES     5
+#define PL_STATS_NUM_COUNTER    6
+
+
 // 集合演算のタイプ
 //    MPI_ReduceのMPI_SUM,MPI_MAX,MPI_MINに相当する
 typedef enum {
@@ -104,6 +151,9 @@ typedef enum {
                                 //  長田パッチ バイナリファイル
 #define FILE_FMT_NPT_B  "npt_b"
 
+                                //  Polylibバイナリファイル(KD木付き)
+#define FILE_FMT_PLB    "plb"
+
                                 //  デフォルトファイル形式
 #define FILE_FMT_DEFAULT    FILE_FMT_STL_B
 
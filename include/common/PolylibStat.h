@@ -29,8 +29,9 @@ typedef enum {
     PLSTAT_CONFIG_ERROR         = 10,  ///< 定義ファイルでエラー発生
     PLSTAT_STL_IO_ERROR         = 11,  ///< STLファイルIOエラー
     PLSTAT_NPT_IO_ERROR         = 12,  ///< 長田パッチファイルIOエラー
-    PLSTAT_UNKNOWN_FILE_FORMAT  = 13,  ///< ファイルが.stla、.stlb、.stl、.npta、.nptb、.npt以外。
+    PLSTAT_UNKNOWN_FILE_FORMAT  = 13,  ///< ファイルが.stla、.stlb、.stl、.npta、.nptb、.npt、.plb以外。
     PLSTAT_LACK_OF_LOAD_MEMORY  = 14,  ///< ロード処理時のメモリ不足（メモリ削減版使用時）
+    PLSTAT_PLB_IO_ERROR         = 15,  ///< Polylibバイナリファイル(plb)IOエラー
     PLSTAT_FILE_NOT_SET         = 20,  ///< リーフグループにファイル名が未設定。
     PLSTAT_GROUP_NOT_FOUND      = 21,  ///< グループ名がPolylibに未登録。
     PLSTAT_GROUP_NAME_EMPTY     = 22,  ///< グループ名が空である。
@@ -83,6 +84,7 @@ public:
         else if (stat == PLSTAT_NPT_IO_ERROR)           return "PLSTAT_NPT_IO_ERROR";
         else if (stat == PLSTAT_UNKNOWN_FILE_FORMAT)    return "PLSTAT_UNKNOWN_FILE_FORMAT";
         else if (stat == PLSTAT_LACK_OF_LOAD_MEMORY)    return "PLSTAT_LACK_OF_LOAD_MEMORY";
+        else if (stat == PLSTAT_PLB_IO_ERROR)           return "PLSTAT_PLB_IO_ERROR";
         else if (stat == PLSTAT_FILE_NOT_SET)           return "PLSTAT_FILE_NOT_SET";
         else if (stat == PLSTAT_GROUP_NOT_FOUND)        return "PLSTAT_GROUP_NOT_FOUND";
         else if (stat == PLSTAT_GROUP_NAME_EMPTY)       return "PLSTAT_GROUP_NAME_EMPTY";
@@ -234,6 +234,16 @@ void fpolylib_move_ (
                           POLYLIB_STAT* ret
                     );
 
+///
+/// グループ単位の並列移動モードの指定
+///   Polylib::set_parallel_moveメソッドのラッパー関数
+///  @param[in]     parallel    1:グループ毎に並列に実行する 0:順に実行する(デフォルト)
+///  @attention 移動関数がスレッドセーフな場合のみ指定すること
+///
+void fpolylib_set_parallel_move_ (
+                          int* parallel
+                    );
+
 
 #ifdef MPI_PL
 ///
@@ -388,6 +398,110 @@ void fpolylib_search_nearest_polygon_ (
         POLYLIB_STAT* ret
     );
 
+///
+/// 検索結果カーソルの作成
+///     group_nameを解決して保持し、以後の検索ではグループ名の照合を行わない
+///     検索結果はカーソル内に保持し、利用者が確保した配列へ取り出す
+///     （fpolylib_search_polygons_num_()による二重検索が不要）
+///  @param[out] res         検索結果カーソルのタグ
+///                                integer*8
+///  @param[in]  group_name  抽出グループ名
+///                             Fortran型の文字列(長さPL_GRP_PATH_LEN)
+///                                character(len=PL_GRP_PATH_LEN), character*256
+///  @param[out] ret     POLYLIB_STAT(integer)で定義される値が返る
+///  @attention 不要になったらfpolylib_result_delete()で削除すること
+///
+void fpolylib_result_create_ (
+        PL_RES_TAG  *res,
+        char*       group_name,
+        POLYLIB_STAT* ret
+    );
+
+///
+/// 検索結果カーソルの削除
+///  @param[in]  res         検索結果カーソルのタグ
+///
+void fpolylib_result_delete_ (
+        PL_RES_TAG  *res
+    );
+
+///
+/// 検索結果カーソルへのポリゴンの検索
+///     前回の検索結果は置き換えられる
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[in]  min_pos     抽出する矩形領域の最小値。(x,y,z順の配列)
+///  @param[in]  max_pos     抽出する矩形領域の最大値。(x,y,z順の配列)
+///  @param[in]  every       抽出オプション。
+///   1：3頂点が全て検索領域に含まれるポリゴンを抽出する。
+///   0：三角形のBBoxが一部でも検索領域と交差するものを抽出する。
+///  @param[out] num         抽出された三角形ポリゴン数
+///  @param[out] ret     POLYLIB_STAT(integer)で定義される値が返る
+///
+void fpolylib_result_search_ (
+        PL_RES_TAG  *res,
+        PL_REAL     min_pos[3],
+        PL_REAL     max_pos[3],
+        int         *every,
+        int         *num,
+        POLYLIB_STAT* ret
+    );
+
+///
+/// 検索結果の三角形ポリゴンのタグの取得
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[out] tags        三角形ポリゴンのタグ  integer*8 tags(num)
+///
+void fpolylib_result_get_tags_ (
+        PL_RES_TAG  *res,
+        PL_ELM_TAG  *tags
+    );
+
+///
+/// 検索結果の三角形ポリゴンの頂点座標の取得
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[out] vertex      頂点座標  vertex(3,3,num)
+///
+void fpolylib_result_get_vertexes_ (
+        PL_RES_TAG  *res,
+        PL_REAL     *vertex
+    );
+
+///
+/// 検索結果の三角形ポリゴンの法線ベクトルの取得
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[out] normal      法線ベクトル  normal(3,num)
+///
+void fpolylib_result_get_normals_ (
+        PL_RES_TAG  *res,
+        PL_REAL     *normal
+    );
+
+///
+/// 検索結果の三角形ポリゴンのユーザ定義属性（整数型）の取得
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[out] atr         属性  atr(num_atr,num)
+///                             ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void fpolylib_result_get_atrI_ (
+        PL_RES_TAG  *res,
+        int         *num_atr,
+        int         *atr
+    );
+
+///
+/// 検索結果の三角形ポリゴンのユーザ定義属性（実数型）の取得
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[out] atr         属性  atr(num_atr,num)
+///                             ポリゴンの属性数がnum_atrより少ない場合は0を設定
+///
+void fpolylib_result_get_atrR_ (
+        PL_RES_TAG  *res,
+        int         *num_atr,
+        PL_REAL     *atr
+    );
+
 ///
 /// Polylib::show_group_hierarchyメソッドのラッパー関数。
 /// グループ階層構造リストを標準出力に出力する。
@@ -546,6 +660,40 @@ void fpolylib_group_get_polygons_reduce_atrR_ (
 /// 
 void fpolylib_group_set_need_rebuild_ ( PL_GRP_TAG* tag_pg );
 
+///
+/// 直前のfpolylib_move()での処理時間の取得
+///
+///  @param[in]  tag_pg         PolygonGroupを操作するためのタグ
+///  @param[out] move_time      移動関数の処理時間(秒)  real*8
+///  @param[out] rebuild_time   KD木再構築の処理時間(秒)  real*8
+///
+void fpolylib_group_get_move_time_ (
+            PL_GRP_TAG*     tag_pg,
+            double*         move_time,
+            double*         rebuild_time
+    );
+
+///
+/// グループ内の全ポリゴンのアフィン変換
+///     ユーザ定義の移動関数から呼び出す
+///     KD木の再構築フラグも設定する
+///
+///  @param[in]  tag_pg         PolygonGroupを操作するためのタグ
+///  @param[in]  mat            ４×４変換マトリクス  mat(4,4)
+///                                 Fortranでは列ベクトル系
+///                                 (x',y',z',1) = matmul( mat, (x,y,z,1) )
+///  @param[in]  update_normal  法線ベクトルを更新するか？ 1:する 0:しない
+///  @param[in]  update_area    面積を更新するか？ 1:する 0:しない
+///  @param[out] ret            POLYLIB_STATで定義される値が返る
+///
+void fpolylib_group_transform_ (
+            PL_GRP_TAG*     tag_pg,
+            PL_REAL*        mat,
+            int*            update_normal,
+            int*            update_area,
+            POLYLIB_STAT*   ret
+    );
+
 
 //----------------------------------------------
 // setter / getter
@@ -868,6 +1016,249 @@ void fpolylib_triangle_set_atrR_ (
             PL_REAL*    val
             );
 
+//----------------------------------------------
+//  複数ポリゴンの一括操作
+//----------------------------------------------
+
+///
+/// 頂点座標の一括取得（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[out] vertex      頂点座標  vertex(3,3,num)
+///
+void fpolylib_triangles_get_vertexes_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        PL_REAL     *vertex
+    );
+
+///
+/// 法線ベクトルの一括取得（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[out] normal      法線ベクトル  normal(3,num)
+///
+void fpolylib_triangles_get_normals_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        PL_REAL     *normal
+    );
+
+///
+/// ユーザ定義属性（整数型）の一括取得（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[out] atr         属性  atr(num_atr,num)
+///
+void fpolylib_triangles_get_atrI_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        int         *atr
+    );
+
+///
+/// ユーザ定義属性（実数型）の一括取得（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[out] atr         属性  atr(num_atr,num)
+///
+void fpolylib_triangles_get_atrR_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        PL_REAL     *atr
+    );
+
+///
+/// 頂点座標の一括設定（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[in]  vertex      頂点座標  vertex(3,3,num)
+///  @attention 移動後はfpolylib_group_set_need_rebuild()で再構築を指示すること
+///
+void fpolylib_triangles_set_vertexes_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        PL_REAL     *vertex
+    );
+
+///
+/// ユーザ定義属性（整数型）の一括設定（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[in]  atr         属性  atr(num_atr,num)
+///
+void fpolylib_triangles_set_atrI_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        int         *atr
+    );
+
+///
+/// ユーザ定義属性（実数型）の一括設定（タグ配列指定）
+///  @param[in]  num         ポリゴン数
+///  @param[in]  tags        三角形ポリゴンのタグ配列  tags(num)
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[in]  atr         属性  atr(num_atr,num)
+///
+void fpolylib_triangles_set_atrR_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        PL_REAL     *atr
+    );
+
+///
+/// 頂点座標の一括取得（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[out] vertex      頂点座標  vertex(3,3,ポリゴン数)
+///
+void fpolylib_group_get_vertexes_ (
+        PL_GRP_TAG  *tag_pg,
+        PL_REAL     *vertex
+    );
+
+///
+/// 法線ベクトルの一括取得（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[out] normal      法線ベクトル  normal(3,ポリゴン数)
+///
+void fpolylib_group_get_normals_ (
+        PL_GRP_TAG  *tag_pg,
+        PL_REAL     *normal
+    );
+
+///
+/// ユーザ定義属性（整数型）の一括取得（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[out] atr         属性  atr(num_atr,ポリゴン数)
+///
+void fpolylib_group_get_atrI_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        int         *atr
+    );
+
+///
+/// ユーザ定義属性（実数型）の一括取得（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[out] atr         属性  atr(num_atr,ポリゴン数)
+///
+void fpolylib_group_get_atrR_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        PL_REAL     *atr
+    );
+
+///
+/// 頂点座標の一括設定（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[in]  vertex      頂点座標  vertex(3,3,ポリゴン数)
+///  @attention 移動後はfpolylib_group_set_need_rebuild()で再構築を指示すること
+///
+void fpolylib_group_set_vertexes_ (
+        PL_GRP_TAG  *tag_pg,
+        PL_REAL     *vertex
+    );
+
+///
+/// ユーザ定義属性（整数型）の一括設定（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[in]  atr         属性  atr(num_atr,ポリゴン数)
+///
+void fpolylib_group_set_atrI_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        int         *atr
+    );
+
+///
+/// ユーザ定義属性（実数型）の一括設定（グループ指定）
+///  @param[in]  tag_pg      PolygonGroupのタグ
+///  @param[in]  num_atr     ポリゴン１個あたりの属性数
+///  @param[in]  atr         属性  atr(num_atr,ポリゴン数)
+///
+void fpolylib_group_set_atrR_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        PL_REAL     *atr
+    );
+
+//----------------------------------------------
+//  処理統計情報
+//    処理区分・カウンタ区分はFPolylib_define.incのPL_STATS_*
+//----------------------------------------------
+
+///
+/// 処理統計情報の集計の有効/無効の設定
+///  @param[in]  enable      1:集計する 0:集計しない(デフォルト)
+///
+void fpolylib_stats_set_enable_ (
+        int         *enable
+    );
+
+///
+/// 処理統計情報のリセット
+///
+void fpolylib_stats_reset_ ( void );
+
+///
+/// 処理区分の呼び出し回数と累積処理時間の取得（自ランク分）
+///  @param[in]  phase       処理区分
+///  @param[out] calls       呼び出し回数  integer*8
+///  @param[out] time        累積処理時間(秒)  real*8
+///
+void fpolylib_stats_get_time_ (
+        int             *phase,
+        long long int   *calls,
+        double          *time
+    );
+
+///
+/// カウンタの取得（自ランク分）
+///  @param[in]  counter     カウンタ区分
+///  @param[out] count       カウンタ値  integer*8
+///
+void fpolylib_stats_get_count_ (
+        int             *counter,
+        long long int   *count
+    );
+
+///
+/// 処理統計情報の全ランク集計
+///  @param[out] vmin        最小値  real*8 vmin(2*7+6)
+///  @param[out] vmax        最大値  real*8 vmax(2*7+6)
+///  @param[out] vavg        平均値  real*8 vavg(2*7+6)
+///  @param[out] ret         POLYLIB_STAT(integer)で定義される値が返る
+///  @attention 並びは累積処理時間(7)、呼び出し回数(7)、カウンタ(6)。
+///             MPI環境の場合、全rankで呼び出すこと（集団通信）
+///
+void fpolylib_stats_reduce_ (
+        double          *vmin,
+        double          *vmax,
+        double          *vavg,
+        POLYLIB_STAT    *ret
+    );
+
+///
+/// 処理統計情報のJSONファイル出力
+///  @param[in]  fname       出力ファイル名  character(len=PL_FILE_PATH_LEN)
+///  @param[out] ret         POLYLIB_STAT(integer)で定義される値が返る
+///  @attention MPI環境の場合、全rankで呼び出すこと（集団通信）
+///
+void fpolylib_stats_write_json_ (
+        char            *fname,
+        POLYLIB_STAT    *ret
+    );
+
 #ifdef __cplusplus
 } // extern "C" or extern
 #else
@@ -14,10 +14,93 @@
 #define file_io_h
 
 #include <vector>
+#include <fstream>
 #include "common/PolylibCommon.h"
 
 namespace PolylibNS {
 
+class DecompressBuf;
+
+//**************************************************************
+//   ポリゴンファイル入力ストリーム
+//**************************************************************
+
+///
+/// ポリゴンファイル入力ストリーム
+///   std::ifstreamと同じ使い方で、gzip/zstd圧縮されたファイルも読み込める。
+///   圧縮の有無はファイル先頭のマジックナンバーで判定する。
+///   圧縮ファイルはバックグラウンドスレッドで伸長しながら読み出すため、
+///   伸長とポリゴンの解析が並行して行われる。
+///
+///  @attention gzipはUSE_ZLIB、zstdはUSE_ZSTDを定義してビルドした場合のみ有効。
+///             シーク(seekg/tellg)は使用不可。
+///
+class PolygonIfstream : public std::istream {
+public:
+    ///
+    /// コンストラクタ
+    ///
+    PolygonIfstream();
+
+    ///
+    /// コンストラクタ（ファイルOpen）
+    ///
+    ///  @param[in] fname   ファイル名
+    ///  @param[in] mode    オープンモード（非圧縮ファイルの場合のみ有効）
+    ///
+    PolygonIfstream(
+        const std::string&      fname,
+        std::ios_base::openmode mode = std::ios_base::in
+    );
+
+    ///
+    /// デストラクタ
+    ///
+    ~PolygonIfstream();
+
+    ///
+    /// ファイルOpen
+    ///   失敗した場合はfail()がtrueとなる
+    ///
+    ///  @param[in] fname   ファイル名
+    ///  @param[in] mode    オープンモード（非圧縮ファイルの場合のみ有効）
+    ///
+    void open(
+        const std::string&      fname,
+        std::ios_base::openmode mode = std::ios_base::in
+    );
+
+    ///
+    /// ファイルがOpenされているか
+    ///
+    ///  @return    true:Open中
+    ///
+    bool is_open() const;
+
+    ///
+    /// 圧縮ファイルかどうか
+    ///
+    ///  @return    true:圧縮ファイルを伸長しながら読み込み中
+    ///
+    bool is_compressed() const { return m_decomp != NULL; }
+
+    ///
+    /// ファイルClose
+    ///
+    void close();
+
+private:
+    /// コピー禁止
+    PolygonIfstream( const PolygonIfstream& );
+    PolygonIfstream& operator=( const PolygonIfstream& );
+
+    /// 非圧縮ファイル用バッファ
+    std::filebuf    m_filebuf;
+
+    /// 圧縮ファイル用伸長バッファ
+    DecompressBuf*  m_decomp;
+};
+
 
 //**************************************************************
 //   STLファイル用
@@ -59,7 +142,7 @@ POLYLIB_STAT stl_a_load(
 ///      ポリゴンIDはシステム内で自動で採番される
 ///
 POLYLIB_STAT stl_a_load_read(
-    ifstream&                ifs,
+    istream&                 ifs,
     std::vector<Triangle*>&  tri_list, 
     int                      num_read,
     int&                     num_tri,
@@ -113,7 +196,7 @@ POLYLIB_STAT stl_b_load(
 //       
 ///
 POLYLIB_STAT stl_b_load_read_head(
-    ifstream&                ifs
+    istream&                 ifs
 );
 
 ///
@@ -133,7 +216,7 @@ POLYLIB_STAT stl_b_load_read_head(
 ///      ヘッダ部は、先にstl_b_load_read_head()で読みだしておくこと
 ///
 POLYLIB_STAT stl_b_load_read(
-    ifstream&                ifs,
+    istream&                 ifs,
     std::vector<Triangle*>&  tri_list, 
     int                      num_read,
     int&                     num_tri,
@@ -201,7 +284,7 @@ POLYLIB_STAT npt_a_load(
 //       
 ///
 POLYLIB_STAT npt_a_load_read_head(
-    ifstream&                ifs
+    istream&                 ifs
 );
 
 ///
@@ -220,7 +303,7 @@ POLYLIB_STAT npt_a_load_read_head(
 ///      ポリゴンIDはシステム内で自動で採番される
 ///
 POLYLIB_STAT npt_a_load_read(
-    ifstream&                ifs,
+    istream&                 ifs,
     std::vector<Triangle*>&  tri_list, 
     int                      num_read,
     int&                     num_tri,
@@ -273,7 +356,7 @@ POLYLIB_STAT npt_b_load(
 //       
 ///
 POLYLIB_STAT npt_b_load_read_head(
-    ifstream&                ifs
+    istream&                 ifs
 );
 
 ///
@@ -292,7 +375,7 @@ POLYLIB_STAT npt_b_load_read_head(
 ///      ポリゴンIDはシステム内で自動で採番される
 ///
 POLYLIB_STAT npt_b_load_read(
-    ifstream&                ifs,
+    istream&                 ifs,
     std::vector<Triangle*>&  tri_list, 
     int                      num_read,
     int&                     num_tri,
@@ -322,10 +405,81 @@ bool is_npt_a(
     const std::string&     path
 );
 
+//**************************************************************
+//   Polylibバイナリ（スナップショット）ファイル用
+//**************************************************************
+
+struct VNodeFlat;
+
+///
+/// Polylibバイナリファイル(plb)を読み込み、tri_listにポリゴン情報を設定する。
+///     ポリゴンID、ユーザ定義ID、ユーザ定義属性も復元する
+///     ファイルはメモリマップして読み込む
+///
+///  @param[in,out] tri_list    三角形ポリゴンリストの領域。
+///                                 出力は追加される
+///  @param[in]     fname       ファイル名。
+///  @param[out]    num_tri     ファイル内のポリゴン数
+///  @param[in]     scale       スケール
+///  @param[out]    group_path  保存時のポリゴングループのフルパス(NULL可)
+///  @param[out]    nodes       保存されたKD木のノード配列(NULL可)
+///                                 KD木が保存されていない時は空
+///  @param[out]    elem_idx    保存されたKD木の要素インデックス配列(NULL可)
+///                                 追加したポリゴンの先頭を0とする位置
+///  @param[out]    srch_mode   KD木作成時の検索モード(NULL可)
+///                                 1:曲面補正 0:3角形平面 -1:不明
+///  @return    POLYLIB_STATで定義される値が返る
+///  @attention
+///      ファイルは保存した計算機と同じバイトオーダ、PL_REALの精度であること
+///
+POLYLIB_STAT plb_load(
+    std::vector<Triangle*>          *tri_list, 
+    const std::string&              fname,
+    int                             *num_tri,
+    PL_REAL                         scale=1.0,
+    std::string                     *group_path=NULL,
+    std::vector<VNodeFlat>          *nodes=NULL,
+    std::vector<long long int>      *elem_idx=NULL,
+    int                             *srch_mode=NULL
+);
+
+///
+/// ポリゴン情報をPolylibバイナリファイル(plb)に書き出す。
+///     ポリゴン毎のID、ユーザ定義ID、ユーザ定義属性と
+///     フラット表現したKD木を格納する
+///
+///  @param[in] tri_list    ポリゴン情報。
+///  @param[in] fname       ファイル名。
+///  @param[in] group_path  ポリゴングループのフルパス
+///  @param[in] nodes       KD木のノード配列(空の場合KD木は保存しない)
+///  @param[in] elem_idx    KD木の要素インデックス配列（tri_list内の位置）
+///  @param[in] srch_mode   KD木作成時の検索モード（Polylib::get_srch_mode()）
+///                             1:曲面補正 0:3角形平面 -1:不明
+///  @return    POLYLIB_STATで定義される値が返る。
+///
+POLYLIB_STAT plb_save(
+    std::vector<Triangle*>              *tri_list, 
+    const std::string&                  fname,
+    const std::string&                  group_path,
+    const std::vector<VNodeFlat>&       nodes,
+    const std::vector<long long int>&   elem_idx,
+    int                                 srch_mode
+);
+
 //**************************************************************
 //   共通ＩＯ用
 //**************************************************************
 
+///
+/// 圧縮ファイルの拡張子かどうか
+///
+///  @param[in] ext     拡張子(get_ext_fr_path()の戻り値)
+///  @return    true:圧縮ファイルの拡張子(gz/zst)
+///
+bool is_compressed_ext(
+    const char*     ext
+);
+
 ///
 /// ファイルパスから名称(拡張子を除いた部分)を取得する
 ///
@@ -24,6 +24,8 @@ namespace PolylibNS {
 
 using namespace std;
 
+class PolygonIfstream;
+
 ////////////////////////////////////////////////////////////////////////////
 ///
 /// クラス:PolygonIO
@@ -54,6 +56,7 @@ public:
     ///
     /// STL/NPTファイルを読み込み、tri_listにセットする。
     ///     １個のポリゴンファイルを読み込む
+    ///     STL/NPTファイルはgzip/zstd圧縮されていてもよい
     ///
     ///  @param[in,out] tri_list    三角形ポリゴンリストの領域。
     ///  @param[in] fname           ファイル名
@@ -78,9 +81,10 @@ public:
     ///  @return    POLYLIB_STATで定義される値が返る。
     ///  @attention  STLとNPTのバイナリファイルに関しては
     ///              内部でヘッダ部の読み出しも行う
+    ///              gzip/zstd圧縮ファイルは伸長しながら読み込む
     ///
     static POLYLIB_STAT load_file_open(
-        std::ifstream&                      ifs,
+        PolygonIfstream&                    ifs,
         const std::string&                  fname, 
         const std::string&                  fmt
     );
@@ -92,7 +96,7 @@ public:
     ///  @param[in] ifs            入力ファイルストリーム
     ///  @return    POLYLIB_STATで定義される値が返る。
     ///
-    static POLYLIB_STAT load_file_close( ifstream& ifs );
+    static POLYLIB_STAT load_file_close( PolygonIfstream& ifs );
 
     ///
     /// STL/NPTファイルのRead（指定個数読み込む）
@@ -110,7 +114,7 @@ public:
     ///  @return    POLYLIB_STATで定義される値が返る。
     ///
     static POLYLIB_STAT load_file_read(
-        ifstream&                ifs,
+        std::istream&            ifs,
         const std::string&       fmt,
         std::vector<Triangle*>&  tri_list,
         int                      num_read,
@@ -143,6 +147,7 @@ public:
     ///  @param[in] filename        入力ファイル名。
     ///  @return    判定したファイルフォーマット。
     ///  @attention ファイル拡張子が"stl"の場合、ファイルを読み込んで判定する。
+    ///             拡張子が"gz"/"zst"の場合、一つ前の拡張子で判定する。
     ///
     static std::string input_file_format(
         const std::string &filename
@@ -181,6 +186,7 @@ public:
     static const std::string FMT_STL_BB;    ///< STLバイナリファイル
     static const std::string FMT_NPT_A;     ///< 長田パッチアスキーファイル
     static const std::string FMT_NPT_B;     ///< 長田パッチバイナリファイル
+    static const std::string FMT_PLB;       ///< Polylibバイナリファイル(KD木付き)
     static const std::string DEFAULT_FMT;   ///< PolygonIO.cxxで定義している値
 };
 
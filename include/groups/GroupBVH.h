@@ -0,0 +1,190 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#ifndef polylib_groupbvh_h
+#define polylib_groupbvh_h
+
+#include "common/BBox.h"
+#include "common/PolylibStat.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "polygons/Triangle.h"
+
+#include <vector>
+
+namespace PolylibNS {
+
+class PolygonGroup;
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// GroupBVHNode構造体
+/// グループ単位BVHのノードです。
+/// 親ノードの後に子ノードを並べた配列として保持する。
+///
+////////////////////////////////////////////////////////////////////////////
+struct GroupBVHNode {
+    /// ノードのBouding Box (min x,y,z, max x,y,z)。
+    PL_REAL     bbox[6];
+
+    /// 左の子ノードのインデックス(-1:リーフ)。
+    int         left;
+
+    /// 右の子ノードのインデックス。リーフの場合はグループ番号。
+    int         right;
+
+    /// 親ノードのインデックス(-1:ルート)。
+    int         parent;
+};
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// GroupBVHクラス
+/// 親グループ配下のリーフグループのBBoxより構築する、二段構成BVHの
+/// 上位階層です。
+///     リーフグループのBBoxで探索範囲を絞り込み、該当したグループのみ
+///     グループ毎の木構造（VTree/LBVH/VoxelGrid）で検索する
+///     部品（リーフグループ）が多いグループを一度に検索する場合に使用する
+///     リーフグループの移動時は、そのグループからルートまでのBBoxのみ
+///     更新する（木構造の再構築は行わない）
+///
+////////////////////////////////////////////////////////////////////////////
+
+class GroupBVH {
+public:
+    ///
+    /// コンストラクタ。
+    ///
+    GroupBVH();
+
+    ///
+    /// デストラクタ。
+    ///
+    ~GroupBVH() {}
+
+    ///
+    /// 木構造を構築する。
+    ///     グループのBBoxの中心で、最長軸方向に二分割する
+    ///
+    ///  @param[in] groups      リーフグループのリスト。
+    ///  @param[in] revision    グループ階層の更新番号。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention グループのポインタを参照するのみ。deleteは行わない。
+    ///
+    POLYLIB_STAT build(
+        const std::vector<PolygonGroup*>&   groups,
+        unsigned int                        revision
+        );
+
+    ///
+    /// 指定グループのBBoxの変更を反映する。
+    ///     グループのリーフからルートまでのノードのBBoxを更新する
+    ///
+    ///  @param[in] pg      BBoxが変更されたリーフグループ
+    ///  @return    true:登録済みのグループ
+    ///
+    bool refit(
+        const PolygonGroup  *pg
+        );
+
+    ///
+    /// 全グループのBBoxの変更を反映する。
+    ///
+    void refit( void );
+
+    ///
+    /// 指定矩形領域に含まれるポリゴンを抽出する
+    ///
+    ///  @param[in,out] tri_list    抽出した三角形ポリゴンリスト（追加される）
+    ///  @param[in,out] group_ids   抽出したポリゴンのグループID（追加される）
+    ///                                 NULLの場合は設定しない
+    ///  @param[in]     bbox        検索範囲を示す矩形領域
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:3頂点の一部でも検索領域と重なるものを抽出
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///  @attention グループIDはPolygonGroup::get_internal_id()の値
+    ///
+    POLYLIB_STAT search(
+        std::vector<Triangle*>& tri_list,
+        std::vector<int>*       group_ids,
+        const BBox&             bbox,
+        bool                    every
+        ) const;
+
+    ///
+    /// 登録したリーフグループのリストの取得
+    ///
+    const std::vector<PolygonGroup*>& get_groups() const
+    {
+        return m_groups;
+    }
+
+    ///
+    /// 構築時のグループ階層の更新番号の取得
+    ///
+    unsigned int get_revision() const
+    {
+        return m_revision;
+    }
+
+    ///
+    /// GroupBVHクラスが利用しているメモリ量を返す。
+    ///
+    ///  @return    利用中のメモリ量(byte)
+    ///
+    size_t memory_size() const;
+
+private:
+    ///
+    /// 部分木を構築する
+    ///
+    ///  @param[in] first,last  m_groups内のグループの範囲 [first,last)
+    ///  @param[in] parent      親ノードのインデックス
+    ///  @return    作成したノードのインデックス
+    ///
+    int build_node( int first, int last, int parent );
+
+    ///
+    /// リーフノードのBBoxをグループのBBoxから設定する
+    ///
+    ///  @param[in] node        リーフノードのインデックス
+    ///
+    void set_leaf_bbox( int node );
+
+    ///
+    /// 内部ノードのBBoxを子ノードから設定する
+    ///
+    ///  @param[in] node        内部ノードのインデックス
+    ///
+    void set_node_bbox( int node );
+
+    //=======================================================================
+    // クラス変数
+    //=======================================================================
+    /// ノード配列
+    std::vector<GroupBVHNode>           m_nodes;
+
+    /// 登録したリーフグループ（ノード順）
+    std::vector<PolygonGroup*>          m_groups;
+
+    /// グループ毎のリーフノードのインデックス
+    std::vector<int>                    m_leaf_node;
+
+    /// 構築用の作業領域（グループのBBoxの中心）
+    std::vector< Vec3<PL_REAL> >        m_center;
+
+    /// 構築時のグループ階層の更新番号
+    unsigned int                        m_revision;
+};
+
+} //namespace PolylibNS
+
+#endif  // polylib_groupbvh_h
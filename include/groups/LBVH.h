@@ -0,0 +1,171 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#ifndef polylib_lbvh_h
+#define polylib_lbvh_h
+
+#include "common/BBox.h"
+#include "common/PolylibStat.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "polygons/Triangle.h"
+
+#include <vector>
+
+namespace PolylibNS {
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// LBVHNode構造体
+/// 線形BVHのノードです。
+/// 内部ノード(n-1個)の後にリーフ(n個)を並べた配列として保持する。
+///
+////////////////////////////////////////////////////////////////////////////
+struct LBVHNode {
+    /// ノードのBouding Box (min x,y,z, max x,y,z)。
+    PL_REAL     bbox[6];
+
+    /// 左の子ノードのインデックス(-1:リーフ)。
+    int         left;
+
+    /// 右の子ノードのインデックス。リーフの場合は要素番号。
+    int         right;
+};
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// LBVHクラス
+/// 三角形ポリゴンの重心のMorton符号より構築する線形BVH(Linear BVH)です。
+///     Morton符号の基数ソートと、ソート済み符号からの各内部ノードの
+///     独立な決定により、ポリゴン数に比例する時間で構築する
+///     毎ステップ移動するポリゴンのように、木構造の再構築が頻繁な場合に使用する
+///     再構築時は前回の配列領域を再利用し、ノード毎のメモリ確保は行わない
+///     VTree(KD木)と同じ矩形領域検索・最近傍検索を提供する
+///
+////////////////////////////////////////////////////////////////////////////
+
+class LBVH {
+public:
+    ///
+    /// コンストラクタ。
+    ///
+    LBVH();
+
+    ///
+    /// デストラクタ。
+    ///
+    ~LBVH() {}
+
+    ///
+    /// 木構造を構築する。
+    ///     前回構築時の配列領域を再利用する
+    ///
+    ///  @param[in] tri_list    木構造の元になるポリゴンのリスト。
+    ///  @param[in] bbox        ポリゴン全体を外包するBBox（Morton符号の範囲）。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention ポリゴンのポインタを格納するが、参照のみ。deleteは行わない。
+    ///
+    POLYLIB_STAT build(
+        const std::vector<Triangle*>    *tri_list,
+        const BBox&                     bbox
+        );
+
+    ///
+    /// 木構造を空にする。配列領域は解放しない。
+    ///
+    void clear( void )
+    {
+        m_num = 0;
+    }
+
+    ///
+    /// 指定矩形領域に含まれるポリゴンを抽出する
+    ///
+    ///  @param[in,out] tri_list    抽出した三角形ポリゴンリスト（追加される）
+    ///  @param[in]     bbox        検索範囲を示す矩形領域
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:ポリゴンのBBoxが検索領域と重なるものを抽出
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///
+    POLYLIB_STAT search(
+        std::vector<Triangle*>& tri_list,
+        const BBox&             bbox,
+        bool                    every
+        ) const;
+
+    ///
+    /// 指定位置に重心が最も近いポリゴンを検索する。
+    ///
+    ///  @param[in]     pos     指定位置
+    ///  @return    検索されたポリゴン。ポリゴンがない場合はNULL
+    ///
+    const Triangle* search_nearest(
+        const Vec3<PL_REAL>&    pos
+        ) const;
+
+    ///
+    /// LBVHクラスが利用しているメモリ量を返す。
+    ///
+    ///  @return    利用中のメモリ量(byte)
+    ///
+    size_t memory_size() const;
+
+private:
+    ///
+    /// ソート済みMorton符号のi番目とj番目の共通先頭ビット数
+    ///     符号が等しい場合は番号の共通先頭ビット数を加える
+    ///
+    ///  @param[in] i,j     ソート済み符号の位置
+    ///  @return    共通先頭ビット数。jが範囲外の場合は-1
+    ///
+    int delta( int i, int j ) const;
+
+    ///
+    /// 内部ノードの子ノードを決定する
+    ///
+    ///  @param[in] i       内部ノード番号
+    ///
+    void build_node( int i );
+
+    //=======================================================================
+    // クラス変数
+    //=======================================================================
+    /// 要素数
+    int                                 m_num;
+
+    /// ノード配列（内部ノード0〜n-2、リーフn-1〜2n-2）
+    std::vector<LBVHNode>               m_nodes;
+
+    /// 親ノードのインデックス
+    std::vector<int>                    m_parent;
+
+    /// BBox集約時の訪問回数
+    std::vector<int>                    m_visit;
+
+    /// ソート済みMorton符号
+    std::vector<unsigned long long int> m_code;
+
+    /// 基数ソート用の作業領域
+    std::vector<unsigned long long int> m_code_tmp;
+
+    /// ソート済み要素番号
+    std::vector<int>                    m_idx;
+
+    /// 基数ソート用の作業領域
+    std::vector<int>                    m_idx_tmp;
+
+    /// ソート順の三角形ポリゴン（リーフの要素）
+    std::vector<Triangle*>              m_tri;
+};
+
+} //namespace PolylibNS
+
+#endif  // polylib_lbvh_h
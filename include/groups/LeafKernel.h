@@ -0,0 +1,76 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#ifndef polylib_leafkernel_h
+#define polylib_leafkernel_h
+
+#include "common/PolylibCommon.h"
+
+namespace PolylibNS {
+
+///
+/// KD木リーフ判定カーネルの種類
+///
+#define PL_KERNEL_AUTO      0   ///< 実行環境で使用可能な最速のもの
+#define PL_KERNEL_SCALAR    1   ///< スカラー
+#define PL_KERNEL_SSE       2   ///< SSE（x86）
+#define PL_KERNEL_AVX2      3   ///< AVX2（x86）
+
+/// リーフのSoA配列の要素数の境界（1行の要素数はこの倍数）
+#define PL_LEAF_SOA_ALIGN   8
+
+///
+/// リーフ判定カーネルの選択
+///     PL_KERNEL_AUTOの場合、CPUの対応命令を実行時に判定して選択する
+///     実行環境で使用できない種類を指定した場合はPL_KERNEL_AUTOとみなす
+///
+///  @param[in] type    PL_KERNEL_AUTO/SCALAR/SSE/AVX2
+///  @return    選択されたカーネルの種類
+///  @attention 静的初期化時にPL_KERNEL_AUTOで選択済み。
+///             検索と並行して呼び出さないこと
+///
+int leaf_kernel_select( int type );
+
+///
+/// 選択中のリーフ判定カーネルの種類の取得
+///
+///  @return    PL_KERNEL_SCALAR/SSE/AVX2
+///
+int leaf_kernel_type( void );
+
+///
+/// リーフ要素のBBox（SoA形式）と検索領域の一括判定
+///     要素iのBBoxは bmin[i],bmin[i+stride],bmin[i+2*stride] 〜
+///     bmax[i],bmax[i+stride],bmax[i+2*stride]
+///
+///  @param[in]  bmin       BBox最小位置のSoA配列(x,y,zの3行)
+///  @param[in]  bmax       BBox最大位置のSoA配列(x,y,zの3行)
+///  @param[in]  stride     SoA配列の1行の要素数
+///  @param[in]  num        判定する要素数 (num<=stride)
+///  @param[in]  q          検索領域 (min x,y,z, max x,y,z)
+///  @param[in]  contain    true:BBoxが検索領域に含まれるか
+///                         false:BBoxが検索領域と重なるか
+///  @param[out] hit        該当した要素番号（num個以上の領域）
+///  @return    該当した要素数
+///
+int leaf_box_test(
+    const PL_REAL   *bmin,
+    const PL_REAL   *bmax,
+    int             stride,
+    int             num,
+    const PL_REAL   q[6],
+    bool            contain,
+    int             *hit
+    );
+
+} //namespace PolylibNS
+
+#endif  // polylib_leafkernel_h
@@ -0,0 +1,303 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#ifndef polylib_meshsimplify_h
+#define polylib_meshsimplify_h
+
+#include "common/BBox.h"
+#include "common/PolylibStat.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "polygons/Triangle.h"
+#include "groups/VTree.h"
+
+#include <vector>
+#include <map>
+
+namespace PolylibNS {
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// MeshSimplifyクラス
+/// 二次誤差（Quadric Error Metrics）による辺縮約で
+/// 三角形ポリゴン群を簡略化するクラスです。
+///     座標が一致する頂点を共有頂点として接合（溶接）した上で縮約する
+///     境界辺・非多様体辺は形状保持のための重みを付けて縮約を抑制する
+///     縮約で消えた三角形は隣接する残存三角形に帰属させ、
+///     簡略化後の三角形ごとに元の三角形の対応を保持する
+///
+////////////////////////////////////////////////////////////////////////////
+
+class MeshSimplify {
+public:
+    ///
+    /// コンストラクタ。
+    ///
+    /// @param[in] tri_list 簡略化の元になるポリゴンのリスト。
+    /// @attention ポインタを参照するのみ。deleteは行わない。
+    ///            create_triangles()の実行までtri_listを変更しないこと
+    ///
+    MeshSimplify(
+        const std::vector<Triangle*>    &tri_list
+        );
+
+    ///
+    /// デストラクタ。
+    ///
+    ~MeshSimplify() {}
+
+    ///
+    /// 三角形数が目標値以下になるまで辺縮約を行う
+    ///     縮約可能な辺がなくなった場合は目標値に達する前に終了する
+    ///
+    ///  @param[in] target_num  目標とする三角形数
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///
+    POLYLIB_STAT simplify(
+        size_t      target_num
+        );
+
+    ///
+    /// 現在の三角形数を取得
+    ///
+    ///  @return    三角形数
+    ///
+    size_t get_num_tria() const
+    {
+        return m_num_alive;
+    }
+
+    ///
+    /// 簡略化後の三角形ポリゴンを作成する
+    ///     三角形のID・属性は、残存した元の三角形のものを引き継ぐ
+    ///     長田パッチは引き継がず、全てTriangleとして作成する
+    ///
+    ///  @param[out] tri_list   簡略化後の三角形ポリゴン（追加される）
+    ///  @param[out] src_ptr    src_idx内の各三角形の対応範囲の先頭位置
+    ///                             (tri_list追加数+1個)
+    ///  @param[out] src_idx    各三角形に対応する元の三角形のインデックス
+    ///                             (コンストラクタのtri_list内の位置)
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///  @attention tri_listに追加された三角形は呼び出し側で削除すること
+    ///
+    POLYLIB_STAT create_triangles(
+        std::vector<Triangle*>      &tri_list,
+        std::vector<long long int>  &src_ptr,
+        std::vector<long long int>  &src_idx
+        );
+
+private:
+    ///
+    /// 辺縮約の候補
+    ///
+    struct Collapse {
+        /// 縮約コスト（二次誤差）
+        double  cost;
+        /// 残す頂点
+        int     v0;
+        /// 消す頂点
+        int     v1;
+        /// 候補作成時の頂点の更新番号
+        int     ver0;
+        int     ver1;
+        /// 縮約後の頂点座標
+        Vec3<double>    pos;
+
+        bool operator<( const Collapse& c ) const
+        {
+            return cost > c.cost;   // priority_queueで最小コストを先頭にする
+        }
+    };
+
+    ///
+    /// 頂点の接合と三角形・隣接情報の作成
+    ///
+    void weld( void );
+
+    ///
+    /// 各頂点の二次誤差行列の作成
+    ///
+    void init_quadric( void );
+
+    ///
+    /// 辺縮約の候補を作成する
+    ///
+    ///  @param[in]  v0     残す頂点
+    ///  @param[in]  v1     消す頂点
+    ///  @param[out] col    縮約候補
+    ///
+    void eval_collapse(
+        int         v0,
+        int         v1,
+        Collapse    &col
+        ) const;
+
+    ///
+    /// 辺縮約を行う
+    ///     縮約により面が裏返る、非多様体になる等の場合は行わない
+    ///
+    ///  @param[in] col     縮約候補
+    ///  @return    true:縮約した
+    ///
+    bool collapse(
+        const Collapse  &col
+        );
+
+    ///
+    /// 頂点に接続する有効な三角形リストを整理する
+    ///
+    ///  @param[in] v       頂点
+    ///
+    void compact_vface( int v );
+
+    ///
+    /// 頂点に隣接する頂点リストを取得する
+    ///
+    ///  @param[in]  v      頂点
+    ///  @param[out] nbr    隣接頂点（ソート済み）
+    ///
+    void get_neighbors(
+        int                 v,
+        std::vector<int>    &nbr
+        ) const;
+
+    ///
+    /// 三角形の帰属先（残存三角形）を取得する
+    ///
+    ///  @param[in] f       三角形
+    ///  @return    帰属先の三角形
+    ///
+    int find_root( int f );
+
+    //=======================================================================
+    // クラス変数
+    //=======================================================================
+    /// 元の三角形ポリゴンのリスト
+    const std::vector<Triangle*>    *m_src;
+
+    /// 頂点座標
+    std::vector< Vec3<double> >     m_pos;
+
+    /// 頂点の二次誤差行列（対称4x4行列の上三角10要素）
+    std::vector<double>             m_quad;
+
+    /// 頂点の更新番号（-1:縮約で消滅）
+    std::vector<int>                m_vver;
+
+    /// 頂点に接続する三角形
+    std::vector< std::vector<int> > m_vface;
+
+    /// 三角形の頂点番号（3個ずつ）
+    std::vector<int>                m_face;
+
+    /// 三角形が有効か？
+    std::vector<char>               m_face_alive;
+
+    /// 三角形の帰属先（自身を指す場合は残存）
+    std::vector<int>                m_face_parent;
+
+    /// 有効な三角形数
+    size_t                          m_num_alive;
+};
+
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// PolygonLODクラス
+/// PolygonGroupの簡略化ポリゴン（詳細度レベル1段分）を保持するクラスです。
+///     簡略化ポリゴン、その検索用KD木、および元の三角形IDへの対応を持つ
+///
+////////////////////////////////////////////////////////////////////////////
+
+class PolygonLOD {
+public:
+    ///
+    /// コンストラクタ。
+    ///     KD木を作成する
+    ///
+    /// @param[in] max_elem KD木の最大要素数。
+    /// @param[in] tri_list 簡略化ポリゴンのリスト。
+    /// @param[in] src_ptr  src_ids内の各三角形の対応範囲の先頭位置。
+    /// @param[in] src_ids  各三角形に対応する元の三角形のID。
+    /// @attention tri_listはリスト毎本クラスで管理し、デストラクタで削除する
+    ///
+    PolygonLOD(
+        int                                 max_elem,
+        std::vector<Triangle*>              *tri_list,
+        const std::vector<long long int>    &src_ptr,
+        const std::vector<long long int>    &src_ids
+        );
+
+    ///
+    /// デストラクタ。
+    ///
+    ~PolygonLOD();
+
+    ///
+    /// 簡略化ポリゴンのリストを取得
+    ///
+    ///  @return    三角形ポリゴンリストへのポインタ
+    ///
+    std::vector<Triangle*>* get_triangles() const
+    {
+        return m_tri_list;
+    }
+
+    ///
+    /// KD木探索により、指定矩形領域に含まれる簡略化ポリゴンを抽出する
+    ///
+    ///  @param[in,out] tri_list    抽出した三角形ポリゴンリスト
+    ///  @param[in]     bbox        検索範囲を示す矩形領域
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:1頂点でも検索領域に含まれるものを抽出
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///
+    POLYLIB_STAT search(
+        std::vector<Triangle*>  &tri_list,
+        const BBox              &bbox,
+        bool                    every
+        ) const
+    {
+        return m_vtree->search( tri_list, bbox, every );
+    }
+
+    ///
+    /// 簡略化ポリゴンに対応する元の三角形IDを取得する
+    ///
+    ///  @param[in]  id     簡略化ポリゴンのID
+    ///  @param[out] ids    元の三角形ID（追加される）
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///
+    POLYLIB_STAT get_source_ids(
+        long long int               id,
+        std::vector<long long int>  &ids
+        ) const;
+
+private:
+    /// 簡略化ポリゴンのリスト
+    std::vector<Triangle*>          *m_tri_list;
+
+    /// KD木
+    VTree                           *m_vtree;
+
+    /// m_src_ids内の各三角形の対応範囲の先頭位置
+    std::vector<long long int>      m_src_ptr;
+
+    /// 各三角形に対応する元の三角形ID
+    std::vector<long long int>      m_src_ids;
+
+    /// 簡略化ポリゴンのIDからリスト内の位置への対応
+    std::map<long long int, long long int>  m_id_map;
+};
+
+} //namespace PolylibNS
+
+#endif  // polylib_meshsimplify_h
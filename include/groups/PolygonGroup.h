@@ -17,6 +17,10 @@
 #include "common/PolylibStat.h"
 #include "common/Vec3.h"
 #include "groups/VTree.h"
+#include "groups/LBVH.h"
+#include "groups/VoxelGrid.h"
+#include "groups/GroupBVH.h"
+#include "groups/MeshSimplify.h"
 #include "TextParser.h"
 #include "c_lang/CPolylib.h"
 #include <vector>
@@ -32,6 +36,7 @@ class PolylibMoveParams;
 class Triangle;
 class NptTriangle;
 class BBox;
+struct ParallelAreaInfo;
 
 // ユーザ定義属性（内部でのみ使用）
 struct UsrAtr {
@@ -90,6 +95,21 @@ public:
         bool                                clear = true
         );
 
+    ///
+    /// 引数で与えられるポリゴンリストを複製せずに登録し、KD木の生成を行う。
+    ///    （所有権移動版）
+    ///
+    ///  @param[in,out] tri_list    設定するポリゴンリスト(Triangle)
+    ///                             実行後は空リストとなる
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention  既存のポリゴンは削除される。
+    ///              tri_list内要素(Triangle)の管理はPolygonGroupに移るため
+    ///              以降は、利用者側でTriangleをdeleteしないこと
+    ///
+    POLYLIB_STAT init_swap(
+        std::vector<Triangle*>  &tri_list
+        );
+
     ///
     /// ポリゴンのポインタの登録
     ///
@@ -109,6 +129,24 @@ public:
              bool build_tree = true
         );
 
+    ///
+    /// ポリゴンの登録（所有権移動版）
+    ///
+    ///  @param[in,out] tri_list    設定するポリゴンリスト(Triangle)
+    ///                             実行後は空リストとなる
+    ///  @param[in] build_tree  KD木の作成フラグ
+    ///                            build_polygon_tree()実行
+    ///  @return    なし
+    ///  @attention  vectorの中身が内部リストと交換(swap)される。
+    ///              vector内要素のTriangleの管理はPolygonGroupに移るため
+    ///              以降は、利用者側でTriangleをdeleteしないこと
+    ///              vector自体は利用者側で管理する(auto変数でも可）
+    ///
+    void set_triangles_ptr(
+             std::vector<Triangle*>  &tri_list,
+             bool build_tree = true
+        );
+
     //
     /// PolygonGroupツリーの作成。
     /// 設定ファイルの内容を再帰的に呼び出し、PolygonGroupツリーを作成する。
@@ -182,18 +220,25 @@ public:
     ///  @param[in] format  ファイルフォーマット。
     ///  @param[in] tri_list 三角形ポリゴンリストの領域
     ///  @param[in,out] polygons_fname_map STL/NPT ファイル名とポリゴングループのパス
+    ///  @param[out] save_bytes 書き出しデータ量(byte)の返却用。省略可。
+    ///  @param[out] save_time  書き出し時間(秒)の返却用。省略可。
     ///  @return    POLYLIB_STATで定義される値が返る
     ///  @attention  ポリゴングループが持つポリゴンリストではなく、
     ///              外部から与えたポリゴンリストを使うことに注意
     ///              MPI環境においてRank0に集約したポリゴンリストを使う想定
     //               ポリゴングループのパスは使用する
+    ///              save_bytes/save_timeを指定した場合は書き出し統計情報
+    ///              (Polylib::add_save_stats()、StatsRegistry)に加算しない。
+    ///              非同期保存スレッドから呼ぶ場合に指定する
     ///
     POLYLIB_STAT save_polygons_file(
         const std::string&     rank_no,
         const std::string&     extend,
         const std::string&     format,
         std::vector<Triangle*> *tri_list,
-        std::map<std::string,std::string>& polygons_fname_map
+        std::map<std::string,std::string>& polygons_fname_map,
+        long long int*         save_bytes = NULL,
+        double*                save_time  = NULL
         );
 
 #ifdef MPI_PL
@@ -297,6 +342,29 @@ public:
             return PLSTAT_OK;
         };
 
+    ///
+    /// ポリゴン検索用の木構造のタイプを設定する
+    ///     ポリゴンが設定済みの場合は木構造を作成し直す
+    ///     設定ファイルでは index = "vtree" / "lbvh" で指定する
+    ///
+    ///  @param[in] type    PL_INDEX_VTREE:KD木(デフォルト)
+    ///                     PL_INDEX_LBVH :線形BVH（毎ステップ移動するグループ向け）
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT set_index_type(
+            int type
+        );
+
+    ///
+    /// ポリゴン検索用の木構造のタイプを取得する
+    ///
+    ///  @return    PL_INDEX_VTREE / PL_INDEX_LBVH
+    ///
+    int get_index_type( void ) const
+        {
+            return m_index_type;
+        };
+
     ///
     /// KD木の再構築フラグの設定
     ///     ユーザ定義の移動関数内の最後で呼び出す
@@ -308,6 +376,53 @@ public:
             m_need_rebuild = true;
         };
 
+    ///
+    /// グループ内の全ポリゴンのアフィン変換
+    ///     ユーザ定義の移動関数から呼び出す
+    ///     頂点座標を (x',y',z',1) = (x,y,z,1) * mat で変換する（行ベクトル系）
+    ///     法線ベクトルは再計算せず、matの３×３部分で変換する
+    ///     KD木の再構築フラグも設定する
+    ///
+    ///  @param[in] mat             ４×４変換マトリクス（行ベクトル系）
+    ///  @param[in] update_normal   法線ベクトルを更新するか？
+    ///  @param[in] update_area     面積を更新するか？
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention 詳細度(LOD)のポリゴンは変換しない
+    ///
+    POLYLIB_STAT transform(
+            const PL_REAL   mat[4][4],
+            bool            update_normal,
+            bool            update_area
+        );
+
+    ///
+    /// 移動関数の実行とKD木の再構築
+    ///     Polylib::move()から呼び出される。それぞれの処理時間を記録する
+    ///     並列移動モードの場合、複数のグループで同時に呼び出される
+    ///
+    ///  @param[in] params  移動計算パラメータセット
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT move_and_rebuild(
+            PolylibMoveParams   &params
+        );
+
+    ///
+    /// 直前のPolylib::move()での処理時間の取得
+    ///
+    ///  @param[out] move_time      移動関数の処理時間(秒)
+    ///  @param[out] rebuild_time   KD木再構築の処理時間(秒)
+    ///  @return    戻り値なし
+    ///
+    void get_move_time(
+            double&     move_time,
+            double&     rebuild_time
+        ) const
+        {
+            move_time    = m_move_time;
+            rebuild_time = m_rebuild_time;
+        };
+
 
     ///
     /// 指定矩形領域に含まれるポリゴンを抽出する。
@@ -368,6 +483,23 @@ public:
         ) const;
 
 
+    ///
+    /// 指定矩形領域と交差するポリゴンを抽出する（厳密判定）。
+    ///     木構造でBBoxが重なるポリゴンを抽出した後、三角形と矩形領域の
+    ///     交差を分離軸判定で確認し、BBoxのみ重なるポリゴンを除く
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト(Triangle/NptTriangle)
+    ///  @param[in]     bbox        矩形領域。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention tri_list内のポリゴン要素は、削除不可
+    ///             tri_listはクリアされず、検索されたポリゴンが追加される
+    ///             長田パッチも平面三角形として判定する
+    ///
+    POLYLIB_STAT search_exact(
+        std::vector<Triangle*>&     tri_list,
+        const BBox&                 bbox
+        ) const;
+
     /// 
     /// 指定位置に最も近いポリゴンを検索する
     ///
@@ -383,6 +515,194 @@ public:
         const Vec3<PL_REAL>&    pos
         ) const;
 
+    ///
+    /// ポリゴンリストの並べ替え前の順序を取得する。
+    ///     Polylib::set_sort_mode(true)の場合、KD木作成時にポリゴンリストを
+    ///     Morton符号順に並べ替えるため、その対応を返す
+    ///
+    ///  @param[out] order  get_triangles()のi番目のポリゴンの、
+    ///                     ポリゴン登録時（ファイル読み込み等）の位置
+    ///                     複数回並べ替えた場合も登録時の位置を返す
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///             登録後に三角形の追加・削除（migrate等）があった場合は
+    ///             対応が取れないため、orderを空にしてPLSTAT_NGを返す
+    ///  @attention 並べ替えていない場合、plbファイルから読み込んだ場合は
+    ///             order[i]=iとなる
+    ///             ファイルから読み込んだ直後は、ファイル内の順序となる
+    ///
+    POLYLIB_STAT get_tri_order(
+        std::vector<long long int>& order
+        ) const;
+
+    ///
+    /// 詳細度レベル（LOD）ごとの簡略化ポリゴンを作成する。
+    ///     二次誤差による辺縮約で、レベルkの三角形数を
+    ///     元の三角形数×ratio^k を目標に簡略化し、レベル毎にKD木を作成する
+    ///     レベルkはレベルk-1の簡略化ポリゴンから作成する
+    ///
+    ///  @param[in] num_level   作成するレベル数（レベル1〜num_level）
+    ///  @param[in] ratio       レベル毎の三角形数の縮小率 (0<ratio<1)
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention 既存の簡略化ポリゴンは削除される
+    ///             簡略化ポリゴンはKD木の再構築時に削除されるため、
+    ///             ポリゴンの移動・再読込後は再度作成すること
+    ///             MPI並列時は各ランクの担当ポリゴンのみで作成する
+    ///             縮約可能な辺がなくなった場合、目標数まで簡略化されない
+    ///
+    POLYLIB_STAT build_lod(
+        int                     num_level,
+        PL_REAL                 ratio = 0.25
+        );
+
+    ///
+    /// 作成済みの詳細度レベル数を取得する。
+    ///
+    ///  @return    簡略化ポリゴンのレベル数（未作成時は0）
+    ///
+    int get_num_lod_level( void ) const
+    {
+        return (int)m_lod.size();
+    };
+
+    ///
+    /// 指定した詳細度レベルのポリゴンリストを取得する。
+    ///
+    ///  @param[in] level       詳細度レベル（0:元のポリゴン）
+    ///  @return    三角形ポリゴンリスト。レベルが範囲外の場合はNULL
+    ///  @attention 返却したリスト、ポリゴンは削除不可
+    ///
+    std::vector<Triangle*>* get_lod_triangles(
+        int                     level
+        ) const;
+
+    ///
+    /// 指定矩形領域に含まれる、指定した詳細度レベルのポリゴンを抽出する。
+    ///
+    ///  @param[in,out] tri_list    検索されたポリゴンリスト
+    ///  @param[in]     bbox        矩形領域。
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出。
+    ///                             false:1頂点でも検索領域に含まれるものを抽出。
+    ///  @param[in]     level       詳細度レベル
+    ///                             0以下:元のポリゴンを検索
+    ///                             作成済みレベル数を超える場合は最も粗いレベルを検索
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention tri_list内のポリゴン要素は、削除不可
+    ///             簡略化ポリゴンのIDは代表とした元の三角形のID。
+    ///             対応する元の三角形IDはget_lod_source_ids()で取得する
+    ///
+    POLYLIB_STAT search(
+        std::vector<Triangle*>&     tri_list,
+        const BBox&                 bbox,
+        bool                        every,
+        int                         level
+        ) const;
+
+    ///
+    /// 簡略化ポリゴンに対応する元の三角形IDを取得する。
+    ///
+    ///  @param[in]  level      詳細度レベル（0:元のポリゴン）
+    ///  @param[in]  id         簡略化ポリゴンのID
+    ///  @param[out] ids        元の三角形ID（追加される）
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT get_lod_source_ids(
+        int                         level,
+        long long int               id,
+        std::vector<long long int>& ids
+        ) const;
+
+    ///
+    /// ボクセル格子インデックスを追加する。
+    ///     格子のセル毎にBBoxが重なる三角形ポリゴンのリストを作成する
+    ///     以後、ボクセル境界に揃い格子内に収まる矩形領域の検索は
+    ///     木構造ではなく格子で行う
+    ///     KD木の再構築時に格子も作成し直す
+    ///
+    ///  @param[in] org     格子の基点座標（セル(0,0,0)の最小位置）
+    ///  @param[in] dx      セル１辺の長さ
+    ///  @param[in] num     各方向のセル数
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention 格子による検索結果は木構造による検索結果と一致する
+    ///             MPI並列時は担当領域（複数）毎に追加する
+    ///
+    POLYLIB_STAT add_voxel_index(
+        const Vec3<PL_REAL>&    org,
+        const Vec3<PL_REAL>&    dx,
+        const int               num[3]
+        );
+
+    ///
+    /// ボクセル格子インデックスを全て削除する。
+    ///
+    void clear_voxel_index( void );
+
+    ///
+    /// ボクセル格子インデックス数を取得する。
+    ///
+    ///  @return    add_voxel_index()で追加した格子数
+    ///
+    int get_num_voxel_index( void ) const
+    {
+        return (int)m_vgrid.size();
+    };
+
+    ///
+    /// ボクセル格子インデックスを取得する。
+    ///     セル毎のポリゴンリストをCSR形式で一括参照する場合に使用する
+    ///     （VoxelGrid::get_cell_ptr()/get_cell_tri()）
+    ///
+    ///  @param[in] i       格子の番号
+    ///  @return    ボクセル格子。範囲外の場合はNULL
+    ///  @attention CSR内のポリゴン位置はget_triangles()内の位置
+    ///
+    const VoxelGrid* get_voxel_index(
+        int                     i
+        ) const
+    {
+        if( i < 0 || i >= (int)m_vgrid.size() ) return NULL;
+        return m_vgrid[i];
+    };
+
+    ///
+    /// 配下のリーフグループをまとめて検索するグループ単位BVHを作成する。
+    ///     上位階層にリーフグループのBBoxを持つ二段構成BVHとし、
+    ///     Polylib::search_polygons()で本グループを指定した場合、
+    ///     BBoxが重なるリーフグループのみを検索する
+    ///     リーフグループのKD木再構築時にBBoxを更新する
+    ///
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention リーフグループの場合は作成しない
+    ///             グループ階層を変更した場合は作成し直すこと
+    ///             （変更後、作成し直すまでは使用されない）
+    ///
+    POLYLIB_STAT build_group_bvh( void );
+
+    ///
+    /// グループ単位BVHを削除する。
+    ///
+    void clear_group_bvh( void );
+
+    ///
+    /// グループ単位BVHを取得する。
+    ///
+    ///  @return    グループ単位BVH。未作成の場合はNULL
+    ///
+    GroupBVH* get_group_bvh( void ) const
+    {
+        return m_group_bvh;
+    };
+
+    ///
+    /// ポリゴン全体を外包するBBoxを取得する。
+    ///     KD木の作成時に設定される
+    ///
+    ///  @return    BBox
+    ///
+    const BBox& get_bbox( void ) const
+    {
+        return m_bbox;
+    };
+
     ///
     /// PolygonGroupのフルパス名を取得する。
     ///
@@ -422,33 +742,41 @@ public:
 
     // 以下はMPI環境のPolylib実装用
 
-    ///
-    /// PE領域間移動する三角形ポリゴンリストの取得。
-    ///
-    ///  @param[in,out] tri_list        検索されたポリゴンリスト(Triangle)
-    ///  @param[in] neibour_bboxes      隣接PE領域バウンディングボックス
-    ///  @param[in] exclude_tria_ids    領域移動対象外三角形IDリスト
-    ///  @return    検索結果三角形リスト
-    ///  @attention 戻り値は使用後領域を解放すること
-    ///
-    //const std::vector<Triangle*>* search_outbounded(
-        //const BBox &        neibour_bbox,
-    POLYLIB_STAT search_outbounded(
-        std::vector<Triangle*>&     tri_list,
-        std::vector<BBox>&          neibour_bboxes,
-        std::vector<long long int>& exclude_tria_ids
-        );
-
     ///
     /// 三角形リストの追加（ID重複は追加されない）
     ///
     ///  @param[in] tri_list    三角形ポリゴンリストのポインタ。
+    ///  @param[in] ghost_masks tri_listの隣接PE領域ビットマスク（tri_listと同じ並び）
+    ///                         NULLの場合は隣接PE領域ビットマスクを破棄する
     ///  @return    POLYLIB_STATで定義される値が返る。
     ///  @attention 内部IDが重複した三角形は追加しない。KD木の再構築はしない。
     ///
     POLYLIB_STAT add_triangles(
-        const std::vector<Triangle*>&  tri_list
+        const std::vector<Triangle*>&  tri_list,
+        const std::vector<unsigned long long int>* ghost_masks = NULL
         );
+
+    ///
+    /// 隣接PE領域(ガイドセル含)に懸かっているかのビットマスクを取得
+    ///     三角形リストと同じ並び。要素数が三角形数と異なる場合は未設定
+    ///
+    ///  @return ビットマスクのリスト（ビット位置はPolylibの隣接PEの順番）
+    ///  @attention 一般ユーザ使用不可
+    ///
+    std::vector<unsigned long long int>& get_ghost_masks() {
+        return m_ghost_mask;
+    }
+
+    ///
+    /// move後に新たに懸かった隣接PE領域のビットマスクを取得
+    ///     get_ghost_masks()と同じ並び
+    ///
+    ///  @return ビットマスクのリスト
+    ///  @attention 一般ユーザ使用不可
+    ///
+    std::vector<unsigned long long int>& get_ghost_gains() {
+        return m_ghost_gain;
+    }
 #endif
 
     ///
@@ -617,6 +945,7 @@ public:
     void set_name(const std::string& name)
     {
         m_name = name;
+        update_hierarchy_revision();
     };
 
     ///
@@ -721,6 +1050,7 @@ public:
     void set_parent_path(std::string ppath)
     {
         m_parent_path = ppath;
+        update_hierarchy_revision();
     };
     
     ///
@@ -741,6 +1071,7 @@ public:
     void set_parent(PolygonGroup* p) 
     {
         m_parent = p;
+        update_hierarchy_revision();
     };
 
     ///
@@ -761,6 +1092,7 @@ public:
     void set_children(std::vector<PolygonGroup*>& p)
     {
         m_children = p;
+        update_hierarchy_revision();
     };
 
     ///
@@ -781,6 +1113,7 @@ public:
     void add_children(PolygonGroup* p) 
     {
         m_children.push_back(p);
+        update_hierarchy_revision();
     };
 
     ///
@@ -794,6 +1127,7 @@ public:
         for( itr=m_children.begin(); itr!=m_children.end(); itr++ ) {
             if( *itr == p ) {
                 itr = m_children.erase(itr);
+                update_hierarchy_revision();
                 break;
             }
         }
@@ -843,6 +1177,17 @@ public:
         return m_vtree;
     };
 
+    ///
+    /// 線形BVHオブジェクトを取得。
+    ///
+    /// @return 線形BVH（木構造のタイプがPL_INDEX_LBVHでない場合はNULL）
+    /// @attention  ユーザは使用不可。Polylib::used_memory_size()のみ使用
+    ///
+    LBVH *get_lbvh()
+    {
+        return m_lbvh;
+    };
+
 
     ///
     /// move()による移動前三角形一時保存リストの個数を取得。
@@ -861,6 +1206,20 @@ public:
     //  static const char *ATT_NAME_config;
     static const char *ATT_NAME_CLASS;
 
+    ///
+    /// グループ階層の更新番号を取得。
+    ///     グループ名・親子関係を変更する度に増加する（全グループ共通）
+    ///     Polylibのグループ名索引・検索ハンドルの再作成判定に使用する
+    ///
+    ///  @return 更新番号。
+    ///
+    static unsigned int get_hierarchy_revision();
+
+    ///
+    /// グループ階層の更新番号を進める。
+    ///
+    static void update_hierarchy_revision();
+
 protected:
 
     ///
@@ -924,6 +1283,83 @@ private:
     ///
     void delete_tri_list();
 
+    ///
+    /// ポリゴンリストをMorton符号順に並べ替える
+    ///     登録時の位置をm_tri_orderに設定する（前回の並べ替えと合成する）
+    ///
+    ///  @param[in] center  各ポリゴンのBBoxの中心
+    ///
+    void sort_tri_list(
+        const std::vector< Vec3<PL_REAL> >& center
+        );
+
+    ///
+    /// 詳細度レベルごとの簡略化ポリゴンの削除
+    ///
+    void delete_lod();
+
+    ///
+    /// ボクセル格子インデックスの作成
+    ///     追加済みの全格子を現在のポリゴンリストで作成し直す
+    ///
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT build_voxel_grids();
+
+    ///
+    /// 上位グループのグループ単位BVHに、本グループのBBoxの変更を反映する
+    ///
+    void refit_parent_bvh();
+
+    ///
+    /// 配下のリーフグループを抽出する
+    ///
+    ///  @param[out] leaf   リーフグループのリスト（追加される）
+    ///
+    void collect_leaf_groups(
+        std::vector<PolygonGroup*>& leaf
+        );
+
+    ///
+    /// Polylibバイナリファイル(plb)からポリゴン情報とKD木を読み込む
+    ///     保存されたKD木をそのまま復元し、再分割は行わない
+    ///     KD木が保存されていない、スケール指定時、または保存時と検索モードが
+    ///     異なる場合はKD木を作成する
+    ///
+    ///  @param[in] fname       ファイル名。
+    ///  @param[in] scale       縮尺率
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT load_polygons_plb(
+        const std::string&      fname,
+        PL_REAL                 scale
+        );
+
+    ///
+    /// インデックスキャッシュのファイル名を作成する。
+    ///     キャッシュディレクトリ/キーのハッシュ値.plb
+    ///
+    ///  @param[in] scale       縮尺率
+    ///  @return    キャッシュファイル名。ポリゴンファイルがない場合は空文字列
+    ///
+    std::string mk_index_cache_fname(
+        PL_REAL                 scale
+        );
+
+    ///
+    /// ポリゴン情報とKD木をPolylibバイナリファイル(plb)に出力する
+    ///     tri_listが本グループのポリゴンリストで、KD木が最新の場合は
+    ///     そのKD木を、それ以外は一時的に作成したKD木を保存する
+    ///
+    ///  @param[in] fname       ファイル名。
+    ///  @param[in] tri_list    三角形ポリゴンリストの領域
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT save_polygons_plb(
+        const std::string&      fname,
+        std::vector<Triangle*>  *tri_list
+        );
+
     ///
     /// STLファイル名を作成。ファイル名は、以下の通り。
     /// グループ名のフルパス_ランク番号_自由文字列.フォーマット文字列。
@@ -1006,6 +1442,38 @@ private:
     POLYLIB_STAT
         scatter_send_polygons( void );
 
+    ///
+    /// ポリゴン情報分散
+    /// ランク０の処理： 該当ランク領域のポリゴンを送信バッファに詰める
+    ///
+    /// @param[in]  area       送信先ランクの担当領域情報
+    /// @param[out] idata      ヘッダ情報(ポリゴン数、データタイプ、ユーザ定義属性数(整数型、実数型)、
+    ///                        1ポリゴンのサイズ、通信サイズ(byte))
+    /// @param[out] send_buff  送信バッファ (該当ポリゴンなしの場合はNULL）
+    /// @return POLYLIB_STATで定義される値が返る。
+    /// @attention  send_buffは使用後free()で解放すること
+    ///
+    POLYLIB_STAT
+        scatter_pack_polygons(
+                const ParallelAreaInfo& area,
+                long long int           idata[6],
+                char*&                  send_buff
+            );
+
+    ///
+    /// 自領域内ポリゴンを複製せずに取り出し、自領域外のポリゴンを削除する
+    ///
+    /// @param[out] tri_list  自身の担当領域内のポリゴン
+    ///                         (ポリゴンの管理は呼び出し側に移る）
+    /// @return POLYLIB_STATで定義される値が返る。
+    /// @attention  実行後、ポリゴングループのポリゴンリストは空となる
+    ///             KD木は再構築しないので、続けてinit_swap()等で登録すること
+    ///
+    POLYLIB_STAT
+        detach_inbounded_polygons(
+                std::vector<Triangle*>  &tri_list
+            );
+
     ///
     /// ポリゴン情報分散
     /// ランク０以外の処理： ランク０より該当ポリゴンを受信する
@@ -1105,12 +1573,44 @@ protected:
     /// 全三角形ポリゴンを外包するBoundingBox
     BBox    m_bbox;
 
+    /// 登録時のポリゴンの位置（並べ替えていない場合は空）
+    std::vector<long long int>  m_tri_order;
+
+    /// m_tri_orderが有効か（登録後に三角形の追加・削除があった場合はfalse）
+    bool    m_tri_order_valid;
+
+#ifdef MPI_PL
+    /// 隣接PE領域(ガイドセル含)に懸かっているかのビットマスク
+    //    m_tri_listと同じ並び。三角形毎に持たずグループで管理する
+    //    Polylib::move()で更新し、migrate()時の送信対象の判定に使用する
+    std::vector<unsigned long long int>  m_ghost_mask;
+
+    /// move()で新たに懸かった隣接PE領域のビットマスク（m_ghost_maskと同じ並び）
+    //    migrate()で送信後にクリアされる
+    std::vector<unsigned long long int>  m_ghost_gain;
+#endif
+
     /// KD木クラス
     VTree   *m_vtree;
 
+    /// 検索用の木構造のタイプ  PL_INDEX_VTREE/PL_INDEX_LBVH
+    int     m_index_type;
+
+    /// 線形BVHクラス（m_index_type==PL_INDEX_LBVHの場合）
+    LBVH    *m_lbvh;
+
     /// MAX要素数
     int     m_max_elements;
 
+    /// 詳細度レベルごとの簡略化ポリゴン（レベル1〜）
+    std::vector<PolygonLOD*>    m_lod;
+
+    /// ボクセル格子インデックス
+    std::vector<VoxelGrid*>     m_vgrid;
+
+    /// 配下のリーフグループのグループ単位BVH
+    GroupBVH    *m_group_bvh;
+
     //--------------------------------------
     // 移動関数へのポインタ
     //--------------------------------------
@@ -1124,6 +1624,12 @@ protected:
     /// KD木の再構築が必要か？
     bool                    m_need_rebuild;
 
+    /// 直前のmove_and_rebuild()での移動関数の処理時間(秒)
+    double                  m_move_time;
+
+    /// 直前のmove_and_rebuild()でのKD木再構築の処理時間(秒)
+    double                  m_rebuild_time;
+
     /// move()による移動前三角形一時保存リスト。
     //fj><  実装時再検討、このクラスのメンバーから削除可能であれば削除する
     std::vector<Triangle*>      *m_trias_before_move;
@@ -29,6 +29,37 @@ namespace PolylibNS {
 //class VNode;
 //class VElement;
 
+////////////////////////////////////////////////////////////////////////////
+///
+/// VNodeFlat構造体
+/// KD木ノードのフラット（配列）表現です。
+/// 前順（pre-order）で並べたノード配列としてファイルへ保存し、
+/// ロード時に再分割を行わずにKD木を復元するために使用する。
+///
+////////////////////////////////////////////////////////////////////////////
+struct VNodeFlat {
+    /// KD木生成用のBouding Box (min x,y,z, max x,y,z)。
+    PL_REAL         bbox[6];
+
+    /// KD木検索用のBouding Box (min x,y,z, max x,y,z)。
+    PL_REAL         bbox_search[6];
+
+    /// KD木の軸の方向インデックス。
+    long long int   axis;
+
+    /// 左下側ノードのインデックス(-1:リーフ)。
+    long long int   left;
+
+    /// 右下側ノードのインデックス(-1:リーフ)。
+    long long int   right;
+
+    /// リーフの要素の、要素インデックス配列における先頭位置。
+    long long int   elem_begin;
+
+    /// リーフの要素数。
+    long long int   elem_num;
+};
+
 class VElement {
 public:
     ///
@@ -118,6 +149,26 @@ public:
     ///
     void split(const int& max_elem);
 
+    ///
+    /// フラット表現のノード配列より、本ノード以下の木構造を復元する。
+    ///
+    /// @param[in]     nodes     ノード配列（前順）。
+    /// @param[in]     num_node  ノード数。
+    /// @param[in]     inode     本ノードのインデックス。
+    /// @param[in]     elem_idx  要素インデックス配列（tri_list内の位置）。
+    /// @param[in]     num_elem  要素インデックス数。
+    /// @param[in]     tri_list  要素の元になるポリゴンのリスト。
+    /// @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT restore(
+        const VNodeFlat*        nodes,
+        long long int           num_node,
+        long long int           inode,
+        const long long int*    elem_idx,
+        long long int           num_elem,
+        std::vector<Triangle*>  *tri_list
+        );
+
 #ifdef USE_DEPTH
     ///
     /// ノードの深さ情報のダンプ。
@@ -170,6 +221,16 @@ public:
         return m_bbox_search;
     }
 
+    ///
+    /// 検索用BBoxを設定。
+    ///
+    /// @param[in] bbox 検索用bbox。
+    ///
+    void set_bbox_search(const BBox& bbox)
+    {
+        m_bbox_search = bbox;
+    }
+
     ///
     /// このノードのBounding Boxを引数で与えられる要素を含めた大きさに変更する。
     ///
@@ -251,6 +312,34 @@ public:
         return m_vlist.size();
     }
 
+    ///
+    /// リーフ判定用のSoA配列を作成する（本ノード以下の全リーフ）。
+    ///     要素のBBox最小位置(x,y,z)・最大位置(x,y,z)の6行からなり、
+    ///     1行の要素数はPL_LEAF_SOA_ALIGNの倍数とする
+    ///     要素のBBoxと同じく作成時の値のため、every=falseの検索のみで使用する
+    ///
+    void build_soa();
+
+    ///
+    /// リーフ判定用のSoA配列を取得。
+    ///
+    /// @return SoA配列（未作成・リーフでない場合は空）。
+    ///
+    const std::vector<PL_REAL>& get_soa() const
+    {
+        return m_soa;
+    }
+
+    ///
+    /// リーフ判定用のSoA配列の1行の要素数を取得。
+    ///
+    /// @return 1行の要素数（未作成の場合は0）。
+    ///
+    int get_soa_stride() const
+    {
+        return m_soa_stride;
+    }
+
 #ifdef USE_DEPTH
     ///
     /// ノードの深さ情報を取得。
@@ -295,6 +384,12 @@ private:
     /// KD木検索用のBouding Box。
     BBox                    m_bbox_search;
 
+    /// リーフ判定用のSoA配列。
+    std::vector<PL_REAL>    m_soa;
+
+    /// リーフ判定用のSoA配列の1行の要素数。
+    int                     m_soa_stride;
+
 #ifdef USE_DEPTH
     /// ノードの深さ情報(未使用)。
     int                     m_depth;
@@ -325,6 +420,25 @@ public:
         std::vector<Triangle*>  *tri_list
         );
 
+    ///
+    /// コンストラクタ。
+    ///     フラット表現のノード配列よりKD木を復元する(再分割は行わない)
+    ///     ノード配列が不正な場合は、tri_listより木構造を作成し直す
+    ///
+    /// @param[in] max_elem 最大要素数。
+    /// @param[in] bbox     VTreeのbox範囲。
+    /// @param[in] tri_list 木構造の元になるポリゴンのリスト。
+    /// @param[in] nodes    ノード配列（前順）。
+    /// @param[in] elem_idx 要素インデックス配列（tri_list内の位置）。
+    ///
+    VTree(
+        int         max_elem, 
+        const BBox          bbox, 
+        std::vector<Triangle*>  *tri_list,
+        const std::vector<VNodeFlat>&       nodes,
+        const std::vector<long long int>&   elem_idx
+        );
+
     ///
     /// デストラクタ。
     ///
@@ -394,6 +508,20 @@ public:
     ///
     size_t memory_size();
 
+    ///
+    /// KD木をフラット表現（前順のノード配列）に変換する。
+    ///
+    ///  @param[in]  tri_list    木構造の元になったポリゴンのリスト。
+    ///  @param[out] nodes       ノード配列（前順）。
+    ///  @param[out] elem_idx    要素インデックス配列（tri_list内の位置）。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT flatten(
+        const std::vector<Triangle*>    *tri_list,
+        std::vector<VNodeFlat>&         nodes,
+        std::vector<long long int>&     elem_idx
+        ) const;
+
 private:
     ///
     /// 三角形をKD木構造に組み込む際に、どのノードへ組み込むかを検索する。
@@ -416,12 +544,14 @@ private:
     ///  @param[in]     every   true:ポリゴンの頂点がすべて含まれるNodeを検索。
     ///                         false:それ以外。
     ///  @param[in,out] vlist   検索結果配列へのポインタ。
+    ///  @param[in,out] cnt     訪れたノード数、判定したリーフ要素数（加算される）
     ///
     void search_recursive(
         VNode                   *vn, 
         const BBox              &bbox, 
         bool                    every, 
-        std::vector<VElement*>  *vlist
+        std::vector<VElement*>  *vlist,
+        long long int           cnt[2]
         ) const;
 
     ///
@@ -451,6 +581,22 @@ private:
         unsigned int    *poly_cnt
         );
 
+    ///
+    /// ノード以下をフラット表現に変換する（前順）。
+    ///
+    ///  @param[in]     vn          対象のノードへのポインタ。
+    ///  @param[in]     tri_index   ポリゴンとtri_list内の位置の対応(ポインタ順)。
+    ///  @param[in,out] nodes       ノード配列。
+    ///  @param[in,out] elem_idx    要素インデックス配列。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///
+    POLYLIB_STAT flatten_recursive(
+        VNode           *vn,
+        const std::vector< std::pair<Triangle*,long long int> >& tri_index,
+        std::vector<VNodeFlat>&         nodes,
+        std::vector<long long int>&     elem_idx
+        ) const;
+
     //=======================================================================
     // クラス変数
     //=======================================================================
@@ -0,0 +1,220 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#ifndef polylib_voxelgrid_h
+#define polylib_voxelgrid_h
+
+#include "common/BBox.h"
+#include "common/PolylibStat.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "polygons/Triangle.h"
+
+#include <vector>
+
+namespace PolylibNS {
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// VoxelGridクラス
+/// 計算領域のボクセル（セル）毎に、BBoxが重なる三角形ポリゴンを
+/// CSR形式で保持するボクセル格子インデックスです。
+///     木構造と同じくポリゴンのBBoxで登録し、検索結果は木構造と一致する
+///     三角形とセルの厳密な交差はPolygonGroup::search_exact()で判定する
+///     セル単位の検索はセル番号から直接求まるため、木構造の探索を行わない
+///     ボクセル境界に揃った矩形領域の検索、ボクセル化処理での
+///     セル毎の一括参照に使用する
+///
+////////////////////////////////////////////////////////////////////////////
+
+class VoxelGrid {
+public:
+    ///
+    /// コンストラクタ。
+    ///
+    ///  @param[in] org     格子の基点座標（セル(0,0,0)の最小位置）
+    ///  @param[in] dx      セル１辺の長さ
+    ///  @param[in] num     各方向のセル数
+    ///
+    VoxelGrid(
+        const Vec3<PL_REAL>&    org,
+        const Vec3<PL_REAL>&    dx,
+        const int               num[3]
+        );
+
+    ///
+    /// デストラクタ。
+    ///
+    ~VoxelGrid() {}
+
+    ///
+    /// セル毎のポリゴンリストを作成する。
+    ///     前回作成時の配列領域を再利用する
+    ///
+    ///  @param[in] tri_list    登録するポリゴンのリスト。
+    ///  @return    POLYLIB_STATで定義される値が返る。
+    ///  @attention ポリゴンのポインタを参照するのみ。deleteは行わない。
+    ///
+    POLYLIB_STAT build(
+        const std::vector<Triangle*>    *tri_list
+        );
+
+    ///
+    /// 登録ポリゴンを空にする。配列領域は解放しない。
+    ///
+    void clear( void );
+
+    ///
+    /// 矩形領域がボクセル境界に揃っており、格子内に含まれるか
+    ///     セル範囲より小さい矩形領域（丸め誤差を超えるもの）は対象外
+    ///
+    ///  @param[in]  bbox   矩形領域
+    ///  @param[out] range  矩形領域のセル範囲 (最小i,j,k, 最大i,j,k+1)
+    ///  @return    true:格子で検索可能
+    ///
+    bool covers(
+        const BBox&     bbox,
+        int             range[6]
+        ) const;
+
+    ///
+    /// 指定セル範囲に含まれるポリゴンを抽出する
+    ///     ボクセル境界に揃った矩形領域の検索用
+    ///
+    ///  @param[in,out] tri_list    抽出した三角形ポリゴンリスト（追加される）
+    ///  @param[in]     bbox        検索範囲を示す矩形領域
+    ///  @param[in]     range       covers()で求めたセル範囲
+    ///  @param[in]     every       true:3頂点が全て検索領域に含まれるものを抽出
+    ///                             false:BBoxが検索領域と重なるものを抽出
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///  @attention 複数セルに跨るポリゴンは１度だけ抽出する
+    ///
+    POLYLIB_STAT search(
+        std::vector<Triangle*>& tri_list,
+        const BBox&             bbox,
+        const int               range[6],
+        bool                    every
+        ) const;
+
+    ///
+    /// 指定セルにBBoxが重なるポリゴンを抽出する
+    ///     セル境界の許容誤差分、セル外のポリゴンを含むことがある
+    ///
+    ///  @param[in,out] tri_list    抽出した三角形ポリゴンリスト（追加される）
+    ///  @param[in]     i,j,k       セル番号
+    ///  @return    POLYLIB_STATで定義される値が返る
+    ///
+    POLYLIB_STAT search_cell(
+        std::vector<Triangle*>& tri_list,
+        int                     i,
+        int                     j,
+        int                     k
+        ) const;
+
+    ///
+    /// セル番号（一次元）の取得
+    ///     i + num[0]*(j + num[1]*k)
+    ///
+    ///  @param[in]     i,j,k       セル番号
+    ///  @return    セル番号（一次元）
+    ///
+    long long int cell_index( int i, int j, int k ) const
+    {
+        return (long long int)i + (long long int)m_num[0]
+                 * ( (long long int)j + (long long int)m_num[1] * k );
+    }
+
+    ///
+    /// 各方向のセル数の取得
+    ///
+    ///  @param[out]    num     各方向のセル数
+    ///
+    void get_num_cell( int num[3] ) const
+    {
+        num[0] = m_num[0];  num[1] = m_num[1];  num[2] = m_num[2];
+    }
+
+    ///
+    /// 格子の基点座標の取得
+    ///
+    const Vec3<PL_REAL>& get_origin() const
+    {
+        return m_org;
+    }
+
+    ///
+    /// セル１辺の長さの取得
+    ///
+    const Vec3<PL_REAL>& get_pitch() const
+    {
+        return m_dx;
+    }
+
+    ///
+    /// セル毎のポリゴンリストの先頭位置の取得（CSR形式）
+    ///     セルcのポリゴンは get_cell_tri()[ptr[c]]〜[ptr[c+1]-1]
+    ///
+    ///  @return    先頭位置（セル数+1個）。未作成時は空
+    ///
+    const std::vector<long long int>& get_cell_ptr() const
+    {
+        return m_cell_ptr;
+    }
+
+    ///
+    /// セル毎のポリゴンリストの取得（CSR形式）
+    ///
+    ///  @return    build()時のtri_list内のポリゴン位置
+    ///
+    const std::vector<int>& get_cell_tri() const
+    {
+        return m_cell_tri;
+    }
+
+    ///
+    /// VoxelGridクラスが利用しているメモリ量を返す。
+    ///
+    ///  @return    利用中のメモリ量(byte)
+    ///
+    size_t memory_size() const;
+
+private:
+    //=======================================================================
+    // クラス変数
+    //=======================================================================
+    /// 格子の基点座標
+    Vec3<PL_REAL>                       m_org;
+
+    /// セル１辺の長さ
+    Vec3<PL_REAL>                       m_dx;
+
+    /// 各方向のセル数
+    int                                 m_num[3];
+
+    /// 登録したポリゴンのリスト
+    const std::vector<Triangle*>        *m_tri;
+
+    /// セル毎のポリゴンリストの先頭位置
+    std::vector<long long int>          m_cell_ptr;
+
+    /// セル毎のポリゴン（m_tri内の位置）
+    std::vector<int>                    m_cell_tri;
+
+    /// 作成用の作業領域（セル番号）
+    std::vector<long long int>          m_pair_cell;
+
+    /// 作成用の作業領域（ポリゴン位置）
+    std::vector<int>                    m_pair_tri;
+};
+
+} //namespace PolylibNS
+
+#endif  // polylib_voxelgrid_h
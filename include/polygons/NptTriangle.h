@@ -55,6 +55,32 @@ struct NpatchParam {
     Vec3<PL_REAL>   cp_center;
 };
 
+//  NpatchParam p  -> PL_REAL r[21]
+#define NPATCH_PARAM_TO_REAL21(p,r) \
+            {   \
+                (r)[ 0]=(p).cp_side1_1.x;  (r)[ 1]=(p).cp_side1_1.y;  (r)[ 2]=(p).cp_side1_1.z; \
+                (r)[ 3]=(p).cp_side1_2.x;  (r)[ 4]=(p).cp_side1_2.y;  (r)[ 5]=(p).cp_side1_2.z; \
+                (r)[ 6]=(p).cp_side2_1.x;  (r)[ 7]=(p).cp_side2_1.y;  (r)[ 8]=(p).cp_side2_1.z; \
+                (r)[ 9]=(p).cp_side2_2.x;  (r)[10]=(p).cp_side2_2.y;  (r)[11]=(p).cp_side2_2.z; \
+                (r)[12]=(p).cp_side3_1.x;  (r)[13]=(p).cp_side3_1.y;  (r)[14]=(p).cp_side3_1.z; \
+                (r)[15]=(p).cp_side3_2.x;  (r)[16]=(p).cp_side3_2.y;  (r)[17]=(p).cp_side3_2.z; \
+                (r)[18]=(p).cp_center.x;   (r)[19]=(p).cp_center.y;   (r)[20]=(p).cp_center.z;  \
+            }
+
+
+//  PL_REAL r[21]  ->  NpatchParam p
+#define REAL21_TO_NPATCH_PARAM(r,p) \
+            {   \
+                (p).cp_side1_1.x=(r)[ 0];  (p).cp_side1_1.y=(r)[ 1];  (p).cp_side1_1.z=(r)[ 2]; \
+                (p).cp_side1_2.x=(r)[ 3];  (p).cp_side1_2.y=(r)[ 4];  (p).cp_side1_2.z=(r)[ 5]; \
+                (p).cp_side2_1.x=(r)[ 6];  (p).cp_side2_1.y=(r)[ 7];  (p).cp_side2_1.z=(r)[ 8]; \
+                (p).cp_side2_2.x=(r)[ 9];  (p).cp_side2_2.y=(r)[10];  (p).cp_side2_2.z=(r)[11]; \
+                (p).cp_side3_1.x=(r)[12];  (p).cp_side3_1.y=(r)[13];  (p).cp_side3_1.z=(r)[14]; \
+                (p).cp_side3_2.x=(r)[15];  (p).cp_side3_2.y=(r)[16];  (p).cp_side3_2.z=(r)[17]; \
+                (p).cp_center.x =(r)[18];  (p).cp_center.y =(r)[19];  (p).cp_center.z =(r)[20]; \
+            }
+
+
 ////////////////////////////////////////////////////////////////////////////
 ///
 /// クラス:NptTriangleクラス
@@ -147,6 +173,23 @@ public:
         m_npatchParam.cp_center  *= scale;
     } 
 
+    ///
+    /// ポリゴンのアフィン変換
+    ///     頂点座標と長田パッチの制御点を変換する
+    ///
+    /// @param[in] mat              ４×４変換マトリクス（行ベクトル系）
+    /// @param[in] nmat             法線ベクトル変換用３×３マトリクス
+    /// @param[in] update_normal    法線ベクトルを更新するか？
+    /// @param[in] update_area      面積を更新するか？
+    /// @return 戻り値なし
+    ///
+    virtual void transform(
+        const PL_REAL   mat[4][4],
+        const PL_REAL   nmat[3][3],
+        bool            update_normal,
+        bool            update_area
+        );
+
     ///
     /// ポリゴンの使用メモリサイズ取得
     ///    Polylib::used_memory_size()で使用する
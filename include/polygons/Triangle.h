@@ -343,6 +343,26 @@ public:
         m_vertex[2] *= scale;
     }
 
+    ///
+    /// ポリゴンのアフィン変換
+    ///     頂点座標を行ベクトル系の変換マトリクスで変換する
+    ///     (x',y',z',1) = (x,y,z,1) * mat
+    ///     法線ベクトルは再計算せず、nmatで変換する
+    ///
+    /// @param[in] mat              ４×４変換マトリクス（行ベクトル系）
+    /// @param[in] nmat             法線ベクトル変換用３×３マトリクス
+    ///                                 （matの３×３部分の余因子行列）
+    /// @param[in] update_normal    法線ベクトルを更新するか？
+    /// @param[in] update_area      面積を更新するか？
+    /// @return 戻り値なし
+    ///
+    virtual void transform(
+        const PL_REAL   mat[4][4],
+        const PL_REAL   nmat[3][3],
+        bool            update_normal,
+        bool            update_area
+        );
+
     ///
     /// ポリゴンの使用メモリサイズ取得
     ///    Polylib::used_memory_size()で使用する
@@ -496,6 +516,16 @@ public:
         m_id = id;
     }
 
+    ///
+    /// ポリゴンIDをシステムで一意の値に採番し直す。
+    ///
+    ///  @attention 一般ユーザ使用不可
+    ///
+    void set_unique_id()
+    {
+        m_id = create_unique_id();
+    }
+
     ///
     /// ポリゴンIDを返す。
     ///
@@ -555,6 +585,20 @@ public:
 
 
 protected:
+    ///
+    /// 座標の変換（行ベクトル系）。
+    ///
+    static void transform_point(
+        const PL_REAL   mat[4][4],
+        Vec3<PL_REAL>&  p
+        )
+    {
+        PL_REAL x = p.x, y = p.y, z = p.z;
+        p.x = x*mat[0][0] + y*mat[1][0] + z*mat[2][0] + mat[3][0];
+        p.y = x*mat[0][1] + y*mat[1][1] + z*mat[2][1] + mat[3][1];
+        p.z = x*mat[0][2] + y*mat[1][2] + z*mat[2][2] + mat[3][2];
+    }
+
     ///
     /// 法線ベクトル算出。
     ///
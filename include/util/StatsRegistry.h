@@ -0,0 +1,250 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#ifndef polylib_statsregistry_h
+#define polylib_statsregistry_h
+
+#include "common/PolylibDefine.h"
+#include "util/time.h"
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace PolylibNS {
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// StatsRegistryクラス
+/// 処理区分毎の呼び出し回数・累積処理時間と、検索・通信のカウンタを
+/// 集計する（シングルトン）。
+///     set_enable(true)とした場合のみ集計する（デフォルトは集計しない）
+///     集計しない場合の負荷はis_enable()の判定のみ
+///     値は自ランク分。全ランクの集計はPolylib::write_stats_json()で行う
+///
+////////////////////////////////////////////////////////////////////////////
+
+class StatsRegistry {
+public:
+    ///
+    /// インスタンスの取得
+    ///
+    static StatsRegistry* get_instance();
+
+    ///
+    /// 集計の有効/無効の設定
+    ///
+    ///  @param[in] enable  true:集計する
+    ///
+    static void set_enable( bool enable )
+    {
+        m_enable = enable;
+    }
+
+    ///
+    /// 集計が有効か
+    ///
+    static bool is_enable( void )
+    {
+        return m_enable;
+    }
+
+    ///
+    /// 全集計値のリセット
+    ///
+    void reset( void );
+
+    ///
+    /// 処理時間の加算（呼び出し回数も1加算する）
+    ///
+    ///  @param[in] phase   処理区分(PL_STATS_LOAD〜PL_STATS_SAVE)
+    ///  @param[in] time    処理時間(秒)
+    ///
+    void add_time( int phase, double time );
+
+    ///
+    /// カウンタの加算
+    ///
+    ///  @param[in] counter カウンタ区分(PL_STATS_SEARCH_NODES〜PL_STATS_SAVE_BYTES)
+    ///  @param[in] num     加算値
+    ///
+    void add_count( int counter, long long int num );
+
+    ///
+    /// 隣接PE毎のmigrate()送信量の加算
+    ///     PL_STATS_MIGRATE_BYTES/MSGSにも加算する
+    ///
+    ///  @param[in] rank    送信先ランク
+    ///  @param[in] bytes   送信データ量(byte)
+    ///  @param[in] msgs    送信メッセージ数
+    ///
+    void add_neighbour( int rank, long long int bytes, long long int msgs );
+
+    ///
+    /// 処理区分の累積処理時間の取得
+    ///
+    ///  @param[in] phase   処理区分
+    ///  @return    累積処理時間(秒)。区分が不正な場合は0
+    ///
+    double get_time( int phase ) const;
+
+    ///
+    /// 処理区分の呼び出し回数の取得
+    ///
+    ///  @param[in] phase   処理区分
+    ///  @return    呼び出し回数。区分が不正な場合は0
+    ///
+    long long int get_calls( int phase ) const;
+
+    ///
+    /// カウンタの取得
+    ///
+    ///  @param[in] counter カウンタ区分
+    ///  @return    カウンタ値。区分が不正な場合は0
+    ///
+    long long int get_count( int counter ) const;
+
+    ///
+    /// 隣接PE毎のmigrate()送信量の取得
+    ///
+    ///  @param[out] ranks  送信先ランク（昇順）
+    ///  @param[out] bytes  送信データ量(byte)
+    ///  @param[out] msgs   送信メッセージ数
+    ///
+    void get_neighbours(
+        std::vector<int>&           ranks,
+        std::vector<long long int>& bytes,
+        std::vector<long long int>& msgs
+        ) const;
+
+    ///
+    /// 全集計値を一列に並べて取得（MPI集計用）
+    ///     累積処理時間、呼び出し回数、カウンタの順
+    ///
+    ///  @param[out] vals   集計値（num_values()個）
+    ///
+    void get_values( std::vector<double>& vals ) const;
+
+    ///
+    /// get_values()で取得する値の個数
+    ///
+    static int num_values( void )
+    {
+        return 2*PL_STATS_NUM_PHASE + PL_STATS_NUM_COUNTER;
+    }
+
+    ///
+    /// 処理区分の名称の取得
+    ///
+    static const char* phase_name( int phase );
+
+    ///
+    /// カウンタ区分の名称の取得
+    ///
+    static const char* counter_name( int counter );
+
+    ///
+    /// 自ランクの集計値をJSONオブジェクトとして出力
+    ///
+    ///  @param[in] os      出力先
+    ///  @param[in] rank    ランク番号（出力するのみ）
+    ///  @param[in] indent  行頭の空白数
+    ///
+    void write_json( std::ostream& os, int rank, int indent = 0 ) const;
+
+    ///
+    /// 全ランクの最小・最大・平均をJSONオブジェクトとして出力
+    ///
+    ///  @param[in] os      出力先
+    ///  @param[in] vmin    最小値（get_values()の並び）
+    ///  @param[in] vmax    最大値
+    ///  @param[in] vavg    平均値
+    ///  @param[in] indent  行頭の空白数
+    ///
+    static void write_json_summary(
+        std::ostream&               os,
+        const std::vector<double>&  vmin,
+        const std::vector<double>&  vmax,
+        const std::vector<double>&  vavg,
+        int                         indent = 0
+        );
+
+private:
+    ///
+    /// コンストラクタ（get_instance()を使用すること）
+    ///
+    StatsRegistry();
+
+    //=======================================================================
+    // クラス変数
+    //=======================================================================
+    /// 集計が有効か
+    static bool                 m_enable;
+
+    /// 処理区分毎の累積処理時間(秒)
+    double                      m_time[PL_STATS_NUM_PHASE];
+
+    /// 処理区分毎の呼び出し回数
+    long long int               m_calls[PL_STATS_NUM_PHASE];
+
+    /// カウンタ
+    long long int               m_count[PL_STATS_NUM_COUNTER];
+
+    /// 隣接PE毎のmigrate()送信データ量(byte)
+    std::map<int,long long int> m_nbr_bytes;
+
+    /// 隣接PE毎のmigrate()送信メッセージ数
+    std::map<int,long long int> m_nbr_msgs;
+};
+
+////////////////////////////////////////////////////////////////////////////
+///
+/// StatsTimerクラス
+/// 生成から破棄までの時間をStatsRegistryの処理区分に加算する。
+///     関数の先頭で自動変数として宣言する
+///     生成時に集計が無効の場合は何もしない
+///
+////////////////////////////////////////////////////////////////////////////
+
+class StatsTimer {
+public:
+    ///
+    /// コンストラクタ。
+    ///
+    ///  @param[in] phase   処理区分
+    ///
+    explicit StatsTimer( int phase )
+    {
+        m_phase = StatsRegistry::is_enable() ? phase : -1;
+        m_start = (m_phase >= 0) ? get_wall_time() : 0.0;
+    }
+
+    ///
+    /// デストラクタ。
+    ///
+    ~StatsTimer()
+    {
+        if( m_phase >= 0 ) {
+            StatsRegistry::get_instance()->add_time( m_phase, get_wall_time() - m_start );
+        }
+    }
+
+private:
+    /// 処理区分（-1:計測しない）
+    int     m_phase;
+
+    /// 開始時刻
+    double  m_start;
+};
+
+} //namespace PolylibNS
+
+#endif  // polylib_statsregistry_h
@@ -18,6 +18,14 @@ namespace PolylibNS {
         double  *sys_time, 
         double  *total
         );
+
+    ///
+    /// 経過時間（壁時計時間）の取得
+    ///
+    ///  @return    基準時刻からの経過時間(秒)
+    ///  @attention 処理時間計測用。getrusage_sec()より軽量
+    ///
+    double get_wall_time( void );
 }
 
 #endif //polylib_time_h
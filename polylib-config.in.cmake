@@ -66,7 +66,7 @@ EOF
       ;;
 
     --libs)
-      echo -L@PL@/lib -l@PL_LIB@  @NPT_DIR_L@ @NPT_LIB_L@  -L@TP_DIR@/lib -l@TP_LIB@
+      echo -L@PL@/lib -l@PL_LIB@  @NPT_DIR_L@ @NPT_LIB_L@  -L@TP_DIR@/lib -l@TP_LIB@ @CMAKE_THREAD_LIBS_INIT@ @COMP_LDFLAGS@ @OMP_OPT@
       ;;
 
     *)
@@ -14,7 +14,10 @@
 #endif
 #include <fstream>
 #include <map>
+#include <algorithm>
 #include "Polylib.h"
+#include "util/time.h"
+#include "util/StatsRegistry.h"
 
 using namespace std;
 using namespace PolylibNS;
@@ -33,6 +36,33 @@ std::string PolylibNS::gs_rankno = "";
 ///    設定はPolylib::set_srch_modeで行う
 static bool polylib_srch_detail = false;
 
+/// インデックスキャッシュディレクトリ
+///    空文字列の場合、キャッシュを使用しない（デフォルト）
+///    設定はPolylib::set_cache_dir、または設定ファイルのcachedirで行う
+static std::string polylib_cache_dir = "";
+
+/// ポリゴンの並べ替えモード
+///    true:
+///      KD木作成時に、グループ内のポリゴンを重心のMorton符号順に並べ替える
+///    false:
+///      ファイル等から読み込んだ順序のまま（デフォルト）
+///    設定はPolylib::set_sort_modeで行う
+static bool polylib_sort_morton = false;
+
+/// グループ単位の並列移動モード
+///    true:
+///      move()で、グループ毎の移動関数・KD木再構築を並列に実行する
+///    false:
+///      グループ毎に順に実行する（デフォルト）
+///    設定はPolylib::set_parallel_moveで行う
+static bool polylib_parallel_move = false;
+
+///
+/// 本クラス内でのみ使用するTextParserのタグ
+///     Polylib直下に記述する
+///
+#define ATT_NAME_CACHE_DIR  "cachedir"
+
 /************************************************************************
  *
  * Polylibクラス
@@ -57,6 +87,36 @@ bool Polylib::get_srch_mode() {
     return polylib_srch_detail;
 }
 
+// static & public /////////////////////////////////////////////////////////////////////
+void Polylib::set_sort_mode( bool morton ) {
+    polylib_sort_morton = morton;
+}
+
+// static & public /////////////////////////////////////////////////////////////////////
+bool Polylib::get_sort_mode() {
+    return polylib_sort_morton;
+}
+
+// static & public /////////////////////////////////////////////////////////////////////
+void Polylib::set_parallel_move( bool parallel ) {
+    polylib_parallel_move = parallel;
+}
+
+// static & public /////////////////////////////////////////////////////////////////////
+bool Polylib::get_parallel_move() {
+    return polylib_parallel_move;
+}
+
+// static & public /////////////////////////////////////////////////////////////////////
+void Polylib::set_cache_dir( const std::string& dir ) {
+    polylib_cache_dir = dir;
+}
+
+// static & public /////////////////////////////////////////////////////////////////////
+std::string Polylib::get_cache_dir() {
+    return polylib_cache_dir;
+}
+
 
 /// TextParser
 // public /////////////////////////////////////////////////////////////////////
@@ -71,6 +131,10 @@ POLYLIB_STAT Polylib::load(
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::load_test() in." << endl;
 #endif
+    StatsTimer stats_timer( PL_STATS_LOAD );
+
+    // 非同期保存中はTextParserを使用できないため完了を待つ
+    wait_save_internal( "load" );
 
     // 設定ファイル読み込み
     try {
@@ -105,6 +169,9 @@ POLYLIB_STAT Polylib::save(
     char    my_extend[128];
     POLYLIB_STAT stat=PLSTAT_OK;
 
+    // 非同期保存中であれば完了を待つ
+    wait_save_internal( "save" );
+
 
     // 拡張文字列がカラであれば、現在時刻から作成
     if (extend == "") {
@@ -160,7 +227,234 @@ POLYLIB_STAT Polylib::save(
     
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::save_async(
+        const string&   file_format,
+        string          extend
+    ) 
+{
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::save_async() in." << endl;
+#endif
+    char    my_extend[128];
+
+    // 実行中の非同期保存があれば完了を待つ
+    wait_save_internal( "save_async" );
+
+    // 拡張文字列がカラであれば、現在時刻から作成
+    if (extend == "") {
+      time_t timer = time(NULL);
+      struct tm *date = localtime(&timer);
+      sprintf(my_extend, "%04d%02d%02d%02d%02d%02d",
+          date->tm_year+1900,date->tm_mon+1,date->tm_mday,
+          date->tm_hour,date->tm_min,date->tm_sec);
+    }
+    else {
+      sprintf(my_extend, "%s", extend.c_str());
+    }
+
+    SaveJob* job = new SaveJob;
+    job->rank_no = "";
+    job->extend  = my_extend;
+    job->format  = file_format;
+    job->stat    = PLSTAT_OK;
+
+    vector<PolygonGroup*>::iterator it;
+    for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
+      //リーフのみがポリゴン情報を持っている
+      if ((*it)->get_children().empty() == false)   continue;
+
+      // ポリゴン数が0ならばファイル出力不要
+      if ((*it)->get_triangles()->size() == 0)  continue;
+
+      // ポリゴンのスナップショット作成
+      add_save_job_group( job, *it, NULL );
+    }
+
+    return start_save_job( job );
+}
+
+#endif
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::wait_save(
+        string&  config_name_out
+    )
+{
+#ifdef PL_ASYNC_SAVE_THREAD
+    if( m_save_thread_running ) {
+        pthread_join( m_save_thread, NULL );
+        m_save_thread_running = false;
+    }
+#endif
+    if( m_save_job == NULL ) {
+        return PLSTAT_OK;
+    }
+
+    // 書き出し統計情報の加算
+    //   保存スレッドからは加算せず、ここ（呼び出し元スレッド）でまとめて加算する
+    double save_time = 0.0;
+    for (size_t i=0; i<m_save_job->save_times.size(); i++) {
+        save_time += m_save_job->save_times[i];
+    }
+    if( m_save_job->save_times.size() > 0 ) {
+        add_save_stats( m_save_job->save_bytes, save_time );
+    }
+    if( StatsRegistry::is_enable() ) {
+        StatsRegistry* stats = StatsRegistry::get_instance();
+        for (size_t i=0; i<m_save_job->save_times.size(); i++) {
+            stats->add_time( PL_STATS_SAVE, m_save_job->save_times[i] );
+        }
+        stats->add_count( PL_STATS_SAVE_BYTES, m_save_job->save_bytes );
+    }
+
+    POLYLIB_STAT stat = m_save_job->stat;
+    if( stat == PLSTAT_OK ) {
+        config_name_out = m_save_job->config_name;
+    }
+    delete m_save_job;
+    m_save_job = NULL;
+
+    return stat;
+}
+
+// protected //////////////////////////////////////////////////////////////////
+void Polylib::wait_save_internal(
+        const char* func_name
+    )
+{
+    string  save_config_name;
+    POLYLIB_STAT stat = wait_save( save_config_name );
+    if( stat != PLSTAT_OK ) {
+        PL_ERROSH << "[ERROR]Polylib::" << func_name << "():previous asynchronous save failed. returns:"
+                  << PolylibStat2::String(stat) << endl;
+    }
+}
+
+// protected //////////////////////////////////////////////////////////////////
+void Polylib::add_save_job_group(
+        SaveJob*                job,
+        PolygonGroup*           pg,
+        vector<Triangle*>*      tri_list
+    )
+{
+    job->groups.push_back( SaveJobGroup() );
+    SaveJobGroup& grp = job->groups.back();
+    grp.pg       = pg;
+    grp.tri_list = tri_list;
+    grp.pl_type  = PL_TYPE_TRIANGLE;
+    grp.numAtrI  = 0;
+    grp.numAtrR  = 0;
+    grp.num_tri  = 0;
+    if( tri_list != NULL ) return;
+
+    // ポリゴンリストを列指向形式で一括コピーする
+    //   (ポリゴン毎のオブジェクト生成はバックグラウンドスレッドで行う)
+    vector<Triangle*>* pg_tri_list = pg->get_triangles();
+    grp.num_tri = pg_tri_list->size();
+    if( grp.num_tri == 0 ) return;
+    grp.pl_type = (*pg_tri_list)[0]->get_pl_type();
+    grp.numAtrI = (*pg_tri_list)[0]->get_num_atrI();
+    grp.numAtrR = (*pg_tri_list)[0]->get_num_atrR();
+    grp.buff.resize( serialized_size_polygons(grp.pl_type, grp.numAtrI, grp.numAtrR, grp.num_tri) );
+    serialize_polygons( &(*pg_tri_list)[0], grp.num_tri, grp.pl_type,
+                        grp.numAtrI, grp.numAtrR, &grp.buff[0] );
+}
+
+// protected //////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::start_save_job(
+        SaveJob*    job
+    )
+{
+    m_save_job = job;
+
+#ifdef PL_ASYNC_SAVE_THREAD
+    if( pthread_create( &m_save_thread, NULL, save_thread_main, this ) == 0 ) {
+        m_save_thread_running = true;
+        return PLSTAT_OK;
+    }
+    PL_ERROSH << "[WARNING]Polylib::start_save_job():pthread_create() failed. "
+              << "save synchronously." << endl;
+#endif
+
+    // スレッドが使用できない場合は同期的に保存する
+    exec_save_job( job );
+    return PLSTAT_OK;
+}
+
+#ifdef PL_ASYNC_SAVE_THREAD
+// protected //////////////////////////////////////////////////////////////////
+void* Polylib::save_thread_main(
+        void*       arg
+    )
+{
+    Polylib* pl = static_cast<Polylib*>(arg);
+    pl->exec_save_job( pl->m_save_job );
+    return NULL;
+}
+#endif
+
+// protected //////////////////////////////////////////////////////////////////
+void Polylib::exec_save_job(
+        SaveJob*    job
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::exec_save_job() in." << endl;
 #endif
+    map<string,string> polygon_fname_map;
+
+    job->stat       = PLSTAT_OK;
+    job->save_bytes = 0;
+    job->save_times.clear();
+    for (size_t i=0; i<job->groups.size(); i++) {
+        SaveJobGroup& grp = job->groups[i];
+
+        vector<Triangle*>* tri_list = grp.tri_list;
+        vector<Triangle*>  snap_list;
+        if( tri_list == NULL ) {
+            deserialize_polygons( grp.pl_type, grp.numAtrI, grp.numAtrR, grp.num_tri,
+                                  &grp.buff[0], snap_list );
+            vector<char>().swap( grp.buff );
+            tri_list = &snap_list;
+        }
+
+        if( job->stat == PLSTAT_OK ) {
+            long long int save_bytes = 0;
+            double        save_time  = 0.0;
+            job->stat = grp.pg->save_polygons_file( job->rank_no, job->extend, job->format,
+                                                    tri_list, polygon_fname_map,
+                                                    &save_bytes, &save_time );
+            if( job->stat == PLSTAT_OK ) {
+                job->save_bytes += save_bytes;
+                job->save_times.push_back( save_time );
+            } else {
+                PL_ERROSH << "[ERROR]Polylib::exec_save_job():save_polygons_file() failed. "
+                          << grp.pg->acq_fullpath() << " returns:"
+                          << PolylibStat2::String(job->stat) << endl;
+            }
+        }
+
+        // スナップショット/集約済みポリゴンの削除
+        for (size_t j=0; j<tri_list->size(); j++) {
+            delete (*tri_list)[j];
+        }
+        if( grp.tri_list != NULL ) {
+            delete grp.tri_list;
+            grp.tri_list = NULL;
+        }
+    }
+    if( job->stat != PLSTAT_OK ) return;
+
+    // 初期化(tp)ファイルの更新保存
+    tp->changeNode("/");
+    clearfilepath(tp);
+    setfilepath(polygon_fname_map);
+
+    char    *config_name = save_config_file(job->rank_no, job->extend, job->format);
+    if (config_name == NULL)    job->stat = PLSTAT_NG;
+    else                        job->config_name = string(config_name);
+}
 
 
 #ifndef MPI_PL
@@ -172,25 +466,73 @@ POLYLIB_STAT Polylib::move(
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::move() in." << endl;
 #endif
-    POLYLIB_STAT ret;
+    StatsTimer stats_timer( PL_STATS_MOVE );
     vector<PolygonGroup*>::iterator it;
 
+    // リーフグループで、movableフラグONのポリゴンを移動
+    vector<PolygonGroup*> targets;
     for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
-
-        // リーフグループで、movableフラグONのポリゴンを移動
         if ((*it)->get_children().empty() == true && (*it)->get_movable() ) {
-            ret = (*it)->move(params);
-            if (ret != PLSTAT_OK)   return ret;
-
-            // 座標移動したのでKD木の再構築
-            ret = (*it)->rebuild_polygons();
-            if( ret != PLSTAT_OK ) return ret;
+            targets.push_back( *it );
         }
+    }
+
+    // 移動と、座標移動したのでKD木の再構築
+    //   並列移動モードの場合はグループ毎に並列実行
+    int num = (int)targets.size();
+    vector<POLYLIB_STAT> stat( num, PLSTAT_OK );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) if( polylib_parallel_move && num > 1 )
+#endif
+    for( int i=0; i<num; i++ ) {
+        stat[i] = targets[i]->move_and_rebuild( params );
+    }
 
+    for( int i=0; i<num; i++ ) {
+        if( stat[i] != PLSTAT_OK )  return stat[i];
     }
     return PLSTAT_OK;
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::reduce_stats(
+        vector<double>&     vmin,
+        vector<double>&     vmax,
+        vector<double>&     vavg
+    )
+{
+    StatsRegistry::get_instance()->get_values( vmin );
+    vmax = vmin;
+    vavg = vmin;
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::write_stats_json(
+        const string&       fname
+    )
+{
+    vector<double> vmin, vmax, vavg;
+    reduce_stats( vmin, vmax, vavg );
+
+    ofstream ofs( fname.c_str() );
+    if( !ofs ) {
+        PL_ERROSH << "[ERROR]Polylib::write_stats_json():Can't open file: "
+                  << fname << endl;
+        return PLSTAT_NG;
+    }
+    ofs << "{" << endl;
+    ofs << "  \"num_rank\": 1," << endl;
+    ofs << "  \"summary\":" << endl;
+    StatsRegistry::write_json_summary( ofs, vmin, vmax, vavg, 2 );
+    ofs << "," << endl;
+    ofs << "  \"ranks\": [" << endl;
+    StatsRegistry::get_instance()->write_json( ofs, 0, 4 );
+    ofs << endl << "  ]" << endl;
+    ofs << "}" << endl;
+    return PLSTAT_OK;
+}
+
 #endif
 
 // public /////////////////////////////////////////////////////////////////////
@@ -225,6 +567,97 @@ vector<PolygonGroup *> *Polylib::get_leaf_groups() const {
     return leaf;
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::build_lod(
+        const string&   group_name,
+        int             num_level,
+        PL_REAL         ratio
+    )
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::build_lod():Group not found: " 
+                  << group_name << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+
+    vector<PolygonGroup*> pg_list;
+    search_group(pg, &pg_list);
+    pg_list.push_back(pg);
+
+    // リーフグループのみ作成
+    for (size_t i=0; i<pg_list.size(); i++) {
+        if (pg_list[i]->get_children().size() != 0) continue;
+        POLYLIB_STAT ret = pg_list[i]->build_lod(num_level, ratio);
+        if (ret != PLSTAT_OK) return ret;
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::build_voxel_index(
+        const string&   group_name,
+        const PL_REAL   org[3],
+        const PL_REAL   dx[3],
+        const int       num[3]
+    )
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::build_voxel_index():Group not found: " 
+                  << group_name << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+
+    vector<PolygonGroup*> pg_list;
+    search_group(pg, &pg_list);
+    pg_list.push_back(pg);
+
+    // リーフグループのみ作成
+    Vec3<PL_REAL> v_org( org[0], org[1], org[2] );
+    Vec3<PL_REAL> v_dx ( dx[0],  dx[1],  dx[2]  );
+    for (size_t i=0; i<pg_list.size(); i++) {
+        if (pg_list[i]->get_children().size() != 0) continue;
+        pg_list[i]->clear_voxel_index();
+        POLYLIB_STAT ret = pg_list[i]->add_voxel_index(v_org, v_dx, num);
+        if (ret != PLSTAT_OK) return ret;
+    }
+    return PLSTAT_OK;
+}
+
+#ifdef MPI_PL
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::build_voxel_index(
+        const string&   group_name
+    )
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::build_voxel_index():Group not found: " 
+                  << group_name << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+
+    vector<PolygonGroup*> pg_list;
+    search_group(pg, &pg_list);
+    pg_list.push_back(pg);
+
+    // リーフグループのみ、担当領域毎に作成
+    for (size_t i=0; i<pg_list.size(); i++) {
+        if (pg_list[i]->get_children().size() != 0) continue;
+        pg_list[i]->clear_voxel_index();
+        for (size_t j=0; j<m_myproc_area.m_areas.size(); j++) {
+            const CalcAreaInfo& area = m_myproc_area.m_areas[j];
+            Vec3<PL_REAL> v_num = area.m_bbsize + area.m_gcsize * (PL_REAL)2.0;
+            int num[3] = { (int)(v_num.x + 0.5), (int)(v_num.y + 0.5), (int)(v_num.z + 0.5) };
+            POLYLIB_STAT ret = pg_list[i]->add_voxel_index(area.m_gcell_min, area.m_dx, num);
+            if (ret != PLSTAT_OK) return ret;
+        }
+    }
+    return PLSTAT_OK;
+}
+#endif
+
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT  Polylib::search_polygons(
         std::vector<Triangle*>& tri_list,
@@ -233,6 +666,19 @@ POLYLIB_STAT  Polylib::search_polygons(
         const Vec3<PL_REAL>&    max_pos, 
         bool            every
     ) const 
+{
+    return search_polygons( tri_list, group_name, min_pos, max_pos, every, 0 );
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons(
+        std::vector<Triangle*>& tri_list,
+        const string&           group_name, 
+        const Vec3<PL_REAL>&    min_pos, 
+        const Vec3<PL_REAL>&    max_pos, 
+        bool                    every,
+        int                     level
+    ) const 
 {
 #ifdef DEBUG
     //PL_DBGOSH << "Polylib::search_polygons() in." << endl;
@@ -244,6 +690,23 @@ POLYLIB_STAT  Polylib::search_polygons(
                   << group_name << endl;
         return PLSTAT_GROUP_NOT_FOUND;
     }
+    double wt_start = get_wall_time();  // 検索統計情報用
+    size_t num_start = tri_list.size();
+
+    // グループ単位BVHがある場合は、BBoxが重なるリーフグループのみ検索
+    GroupBVH* bvh = (level <= 0) ? get_valid_group_bvh(pg) : NULL;
+    if (bvh != NULL) {
+        BBox bbox;
+        bbox.init();
+        bbox.add(min_pos);
+        bbox.add(max_pos);
+        POLYLIB_STAT ret = bvh->search(tri_list, NULL, bbox, every);
+        if (ret != PLSTAT_OK) return ret;
+
+        add_search_stats( wt_start, tri_list.size() - num_start );
+        return PLSTAT_OK;
+    }
+
     vector<PolygonGroup*>* pg_list2 = new vector<PolygonGroup*>;
 
 #ifdef BENCHMARK
@@ -271,7 +734,7 @@ POLYLIB_STAT  Polylib::search_polygons(
 
         //リーフ構造からのみ検索を行う
         if ((*it)->get_children().size()==0) {
-            ret2 = (*it)->search (tri_list, bbox, every);
+            ret2 = (*it)->search (tri_list, bbox, every, level);
             if (ret2 != PLSTAT_OK) {
                 delete pg_list2;
                 return ret2;
@@ -295,6 +758,9 @@ POLYLIB_STAT  Polylib::search_polygons(
 #endif
 
     delete pg_list2;
+
+    // 検索統計情報
+    add_search_stats( wt_start, tri_list.size() - num_start );
 #ifdef DEBUG
     //PL_DBGOSH << "Polylib::search_polygons() out. tri_list.size()="<< tri_list.size() <<endl;
 #endif
@@ -302,6 +768,264 @@ POLYLIB_STAT  Polylib::search_polygons(
     return PLSTAT_OK;
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons_exact(
+        std::vector<Triangle*>& tri_list,
+        const string&           group_name, 
+        const Vec3<PL_REAL>&    min_pos, 
+        const Vec3<PL_REAL>&    max_pos
+    ) const 
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::search_polygons_exact():Group not found: " 
+                  << group_name << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    double wt_start = get_wall_time();  // 検索統計情報用
+    size_t num_start = tri_list.size();
+
+    vector<PolygonGroup*> pg_list;
+    search_group(pg, &pg_list);
+    pg_list.push_back(pg);
+
+    // 検索範囲
+    BBox bbox;
+    bbox.init();
+    bbox.add(min_pos);
+    bbox.add(max_pos);
+
+    //リーフ構造からのみ検索を行う
+    for (size_t i=0; i<pg_list.size(); i++) {
+        if (pg_list[i]->get_children().size() != 0) continue;
+        POLYLIB_STAT ret = pg_list[i]->search_exact(tri_list, bbox);
+        if (ret != PLSTAT_OK) return ret;
+    }
+
+    // 検索統計情報
+    add_search_stats( wt_start, tri_list.size() - num_start );
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::create_search_handle(
+        const string&           group_name,
+        PolylibSearchHandle&    handle
+    ) const 
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::create_search_handle():Group not found: " 
+                  << group_name << endl;
+        handle.m_group = NULL;
+        handle.m_leaf.clear();
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    handle.m_group = pg;
+    handle.m_leaf.clear();
+    handle.m_revision = PolygonGroup::get_hierarchy_revision() - 1;
+    return refresh_search_handle(handle);
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::refresh_search_handle(
+        PolylibSearchHandle&    handle
+    ) const 
+{
+    if (handle.m_group == NULL) {
+        PL_ERROSH << "[ERROR]Polylib::refresh_search_handle():Invalid search handle." 
+                  << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    unsigned int revision = PolygonGroup::get_hierarchy_revision();
+    if (handle.m_revision == revision) return PLSTAT_OK;
+
+    handle.m_leaf.clear();
+    get_handle_leaf_groups(handle, handle.m_leaf);
+    handle.m_revision = revision;
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void Polylib::update_search_index()
+{
+    update_group_index();
+
+    // グループ階層の変更前に作成されたグループ単位BVHを作成し直す
+    unsigned int revision = PolygonGroup::get_hierarchy_revision();
+    vector<PolygonGroup*>::iterator it;
+    for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
+        GroupBVH* bvh = (*it)->get_group_bvh();
+        if (bvh == NULL || bvh->get_revision() == revision) continue;
+        if ((*it)->build_group_bvh() != PLSTAT_OK) {
+            PL_ERROSH << "[ERROR]Polylib::update_search_index():"
+                      << "Can't rebuild group BVH: " << (*it)->get_name() << endl;
+        }
+    }
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons(
+        std::vector<Triangle*>&     tri_list,
+        const PolylibSearchHandle&  handle, 
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos, 
+        bool                        every,
+        int                         level
+    ) const 
+{
+    if (handle.m_group == NULL) {
+        PL_ERROSH << "[ERROR]Polylib::search_polygons():Invalid search handle." 
+                  << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    double wt_start = get_wall_time();  // 検索統計情報用
+    size_t num_start = tri_list.size();
+
+    // 検索範囲
+    BBox bbox;
+    bbox.init();
+    bbox.add(min_pos);
+    bbox.add(max_pos);
+
+    POLYLIB_STAT ret = search_handle_groups(tri_list, NULL, handle, bbox, every, level);
+    if (ret != PLSTAT_OK) return ret;
+
+    // 検索統計情報
+    add_search_stats( wt_start, tri_list.size() - num_start );
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons_exact(
+        std::vector<Triangle*>&     tri_list,
+        const PolylibSearchHandle&  handle, 
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos
+    ) const 
+{
+    if (handle.m_group == NULL) {
+        PL_ERROSH << "[ERROR]Polylib::search_polygons_exact():Invalid search handle." 
+                  << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    double wt_start = get_wall_time();  // 検索統計情報用
+    size_t num_start = tri_list.size();
+
+    // 検索範囲
+    BBox bbox;
+    bbox.init();
+    bbox.add(min_pos);
+    bbox.add(max_pos);
+
+    vector<PolygonGroup*> work;
+    const vector<PolygonGroup*>& leaf = get_handle_leaf_groups(handle, work);
+    for (size_t i=0; i<leaf.size(); i++) {
+        POLYLIB_STAT ret = leaf[i]->search_exact(tri_list, bbox);
+        if (ret != PLSTAT_OK) return ret;
+    }
+
+    // 検索統計情報
+    add_search_stats( wt_start, tri_list.size() - num_start );
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons(
+        std::vector<Triangle*>& tri_list,
+        std::vector<int>&       group_ids,
+        const string&           group_name, 
+        const Vec3<PL_REAL>&    min_pos, 
+        const Vec3<PL_REAL>&    max_pos, 
+        bool                    every
+    ) const 
+{
+    PolylibSearchHandle handle;
+    POLYLIB_STAT ret = create_search_handle(group_name, handle);
+    if (ret != PLSTAT_OK) return ret;
+
+    return search_polygons(tri_list, group_ids, handle, min_pos, max_pos, every);
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons(
+        std::vector<Triangle*>&     tri_list,
+        std::vector<int>&           group_ids,
+        const PolylibSearchHandle&  handle, 
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos, 
+        bool                        every
+    ) const 
+{
+    if (handle.m_group == NULL) {
+        PL_ERROSH << "[ERROR]Polylib::search_polygons():Invalid search handle." 
+                  << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    if (group_ids.size() != tri_list.size()) {
+        PL_ERROSH << "[ERROR]Polylib::search_polygons():Size of group_ids differs "
+                  << "from tri_list: " << group_ids.size() << " " << tri_list.size() << endl;
+        return PLSTAT_NG;
+    }
+    double wt_start = get_wall_time();  // 検索統計情報用
+    size_t num_start = tri_list.size();
+
+    // 検索範囲
+    BBox bbox;
+    bbox.init();
+    bbox.add(min_pos);
+    bbox.add(max_pos);
+
+    POLYLIB_STAT ret = search_handle_groups(tri_list, &group_ids, handle, bbox, every, 0);
+    if (ret != PLSTAT_OK) return ret;
+
+    // 検索統計情報
+    add_search_stats( wt_start, tri_list.size() - num_start );
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT  Polylib::search_polygons(
+        PolylibSearchResult&        result,
+        const Vec3<PL_REAL>&        min_pos, 
+        const Vec3<PL_REAL>&        max_pos, 
+        bool                        every
+    ) const 
+{
+    // 前回の結果の領域を再利用する
+    result.m_tri_list.clear();
+    return search_polygons(result.m_tri_list, result.m_handle, min_pos, max_pos, every);
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::build_group_bvh(
+        const string&   group_name
+    )
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::build_group_bvh():Group not found: " 
+                  << group_name << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    return pg->build_group_bvh();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::clear_group_bvh(
+        const string&   group_name
+    )
+{
+    PolygonGroup* pg = get_group(group_name);
+    if (pg == 0) {
+        PL_ERROSH << "[ERROR]Polylib::clear_group_bvh():Group not found: " 
+                  << group_name << endl;
+        return PLSTAT_GROUP_NOT_FOUND;
+    }
+    pg->clear_group_bvh();
+    return PLSTAT_OK;
+}
+
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT  Polylib::search_polygons(
         std::vector<NptTriangle*>& tri_list,
@@ -361,6 +1085,8 @@ void Polylib::add_pg_list(PolygonGroup *pg)
     PL_DBGOSH << "Polylib::add_pg_list() in." << endl;
 #endif
     m_pg_list.push_back(pg);
+    PolygonGroup::update_hierarchy_revision();
+    update_group_index();
 }
 
 // public /////////////////////////////////////////////////////////////////////
@@ -456,6 +1182,20 @@ PL_DBGOSH << "Polylib::used_memory_size:Triangle num=" << tri_list->size() << en
             if( vtree != NULL ) {
                 size += vtree->memory_size();
             }
+            // 線形BVH
+            LBVH    *lbvh = (*pg)->get_lbvh();
+            if( lbvh != NULL ) {
+                size += lbvh->memory_size();
+            }
+            // ボクセル格子インデックス
+            for( int i=0; i<(*pg)->get_num_voxel_index(); i++ ) {
+                size += (*pg)->get_voxel_index(i)->memory_size();
+            }
+        }
+
+        // グループ単位BVH
+        if( (*pg)->get_group_bvh() != NULL ) {
+            size += (*pg)->get_group_bvh()->memory_size();
         }
 
     }
@@ -485,17 +1225,8 @@ PL_DBGOSH << "Polylib::used_memory_size:Triangle num=" << tri_list->size() << en
         size += m_neibour_procs_area[i].m_areas.size()*sizeof(CalcAreaInfo);
     }
        
-    // migrate除外三角形IDマップ
-    map< int, vector<long long int> >::iterator ex;
-    size += sizeof(std::vector< std::map< int, std::vector<long long int> > >);
-    size += m_exclusion_map_procs.size()*sizeof(std::map< int, std::vector<long long int> >);
-    for(int i=0; i<m_exclusion_map_procs.size(); i++) {
-       size += m_exclusion_map_procs[i].size() * (sizeof(int)+sizeof(vector<long long int>)); 
-       for (ex = m_exclusion_map_procs[i].begin(); 
-                                    ex != m_exclusion_map_procs[i].end(); ex++) {
-            size += ex->second.size() * sizeof(long long int);
-        }
-    }
+    // 隣接PE領域ビットマスク有効フラグ
+    size += sizeof(bool);
 
     // 自プロセスのランク数、全プロセス数
     size += sizeof(int) * 2;
@@ -514,22 +1245,26 @@ PolygonGroup* Polylib::get_group(const string& name) const
 #ifdef DEBUG
     //PL_DBGOSH << "Polylib::get_group(" << name << ") in." << endl;
 #endif
-    vector<PolygonGroup*>::const_iterator it;
-    for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
-        if (name == (*it)->acq_fullpath()) {
-#ifdef DEBUG
-/*
-            PL_DBGOSH  << "get_group: " << (*it)->get_parent_path()
-                       << " name: " << (*it)->get_name()
-                       << " size: " << (*it)->get_children().size() << endl;
-*/
-#endif
-            return *it;
+    if (m_pg_index_valid &&
+        m_pg_index_revision == PolygonGroup::get_hierarchy_revision()) {
+        map<string, PolygonGroup*>::const_iterator it;
+        it = m_pg_path_index.find(name);
+        if (it != m_pg_path_index.end()) {
+            return it->second;
+        }
+        it = m_pg_name_index.find(name);
+        if (it != m_pg_name_index.end()) {
+            return it->second;
         }
     }
-    for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
-        if (name == (*it)->get_name()) {
-            return *it;
+    else {
+        // 索引が古い場合は索引を変更せずに線形探索する
+        vector<PolygonGroup*>::const_iterator it;
+        for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
+            if ((*it)->acq_fullpath() == name) return *it;
+        }
+        for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
+            if ((*it)->get_name() == name) return *it;
         }
     }
 #ifdef DEBUG
@@ -578,7 +1313,7 @@ POLYLIB_STAT  Polylib::search_nearest_polygon(
                         (v[0][2]+v[1][2]+v[2][2])/3.0);
                 PL_REAL dist2 = (c - pos).lengthSquared();
                 if (tri_min == 0 || dist2 < dist2_min) {
-                    tri_min = tri;
+                    tri_min = tri_near;
                     dist2_min = dist2;
                 }
             }
@@ -592,6 +1327,29 @@ POLYLIB_STAT  Polylib::search_nearest_polygon(
     return PLSTAT_OK;
 }
 
+// protected //////////////////////////////////////////////////////////////////
+void Polylib::add_search_stats(
+        double      wt_start,
+        size_t      num_result
+    ) const
+{
+    double wt = get_wall_time() - wt_start;
+
+    // 検索は複数スレッドから呼ばれることがある
+#ifdef _OPENMP
+#pragma omp critical (polylib_search_stats)
+#endif
+    {
+        m_search_count++;
+        m_search_time += wt;
+    }
+    if( StatsRegistry::is_enable() ) {
+        StatsRegistry* stats = StatsRegistry::get_instance();
+        stats->add_time( PL_STATS_SEARCH, wt );
+        stats->add_count( PL_STATS_SEARCH_RESULTS, (long long int)num_result );
+    }
+}
+
 // protected //////////////////////////////////////////////////////////////////
 Polylib::Polylib()
 {
@@ -603,12 +1361,35 @@ Polylib::Polylib()
 
     m_max_memory_size_mb = 0;
 
+    m_search_count = 0;
+    m_search_time  = 0.0;
+
+    m_pg_index_revision = 0;
+    m_pg_index_valid    = false;
+
+    m_save_bytes   = 0;
+    m_save_time    = 0.0;
+
+    m_save_job     = NULL;
+#ifdef PL_ASYNC_SAVE_THREAD
+    m_save_thread_running = false;
+#endif
+
+#ifdef MPI_PL
+    m_ghost_mask_valid = false;
+    m_ghost_mask_overflow_logged = false;
+    m_comm_bytes       = 0;
+    m_comm_bytes_saved = 0;
+#endif
     //PL_DBGOS<< __FUNCTION__ <<" m_factory "<< m_factory << " tp " << tp<<std::endl;
 }
 
 // protected //////////////////////////////////////////////////////////////////
 Polylib::~Polylib()
 {
+    // 非同期保存の完了待ち
+    wait_save_internal( "~Polylib" );
+
     vector<PolygonGroup*>::iterator it;
     for (it = m_pg_list.begin(); it != m_pg_list.end();) {
 #ifdef DEBUG
@@ -682,6 +1463,19 @@ POLYLIB_STAT Polylib::make_group_tree(
     tp->getNodes(nodes);
     string current_node;
 
+    // Polylib直下のリーフ：インデックスキャッシュディレクトリ
+    {
+      vector<string> leaves;
+      tp->getLabels(leaves);
+      if( find(leaves.begin(),leaves.end(),ATT_NAME_CACHE_DIR) != leaves.end() ) {
+        string value;
+        status = tp->getValue(ATT_NAME_CACHE_DIR,value);
+        if( status == TP_NO_ERROR ) {
+          set_cache_dir( value );
+        }
+      }
+    }
+
 
     //  tp->currentNode(current_node);
     // vector<string> leaves;
@@ -763,6 +1557,8 @@ POLYLIB_STAT Polylib::make_group_tree(
 
     } 
     
+    // グループ名・親子関係の設定後に索引を作成し直す
+    update_search_index();
 
     return PLSTAT_OK;
 }
@@ -1039,3 +1835,86 @@ void Polylib::search_group(
     }
 }
 
+// private ////////////////////////////////////////////////////////////////////
+const vector<PolygonGroup*>& Polylib::get_handle_leaf_groups(
+    const PolylibSearchHandle&  handle,
+    vector<PolygonGroup*>&      work
+) const {
+    if (handle.m_revision == PolygonGroup::get_hierarchy_revision()) {
+        return handle.m_leaf;
+    }
+
+    //子孫と自身からリーフグループを抽出
+    vector<PolygonGroup*> pg_list;
+    search_group(handle.m_group, &pg_list);
+    pg_list.push_back(handle.m_group);
+
+    for (size_t i=0; i<pg_list.size(); i++) {
+        if (pg_list[i]->get_children().size() == 0) {
+            work.push_back(pg_list[i]);
+        }
+    }
+    return work;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+POLYLIB_STAT Polylib::search_handle_groups(
+    std::vector<Triangle*>&     tri_list,
+    std::vector<int>*           group_ids,
+    const PolylibSearchHandle&  handle,
+    const BBox&                 bbox,
+    bool                        every,
+    int                         level
+) const {
+    // グループ単位BVHがある場合は、BBoxが重なるリーフグループのみ検索
+    GroupBVH* bvh = (level <= 0) ? get_valid_group_bvh(handle.m_group) : NULL;
+    if (bvh != NULL) {
+        return bvh->search(tri_list, group_ids, bbox, every);
+    }
+
+    vector<PolygonGroup*> work;
+    const vector<PolygonGroup*>& leaf = get_handle_leaf_groups(handle, work);
+    for (size_t i=0; i<leaf.size(); i++) {
+        size_t num_prev = tri_list.size();
+        POLYLIB_STAT ret = leaf[i]->search(tri_list, bbox, every, level);
+        if (ret != PLSTAT_OK) return ret;
+        // 追加されたポリゴン数だけグループIDを追加する
+        if (group_ids != NULL) {
+            group_ids->insert(group_ids->end(), tri_list.size() - num_prev,
+                              leaf[i]->get_internal_id());
+        }
+    }
+    return PLSTAT_OK;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+GroupBVH* Polylib::get_valid_group_bvh(
+    PolygonGroup    *pg
+) const {
+    GroupBVH* bvh = pg->get_group_bvh();
+    if (bvh == NULL) return NULL;
+
+    // グループ階層の変更後はupdate_search_index()で作成し直すまで使用しない
+    if (bvh->get_revision() != PolygonGroup::get_hierarchy_revision()) {
+        return NULL;
+    }
+    return bvh;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void Polylib::update_group_index()
+{
+    unsigned int revision = PolygonGroup::get_hierarchy_revision();
+
+    // 同名の場合は先に登録されたグループを優先
+    m_pg_path_index.clear();
+    m_pg_name_index.clear();
+    vector<PolygonGroup*>::const_iterator it;
+    for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
+        m_pg_path_index.insert(make_pair((*it)->acq_fullpath(), *it));
+        m_pg_name_index.insert(make_pair((*it)->get_name(), *it));
+    }
+    m_pg_index_revision = revision;
+    m_pg_index_valid    = true;
+}
+
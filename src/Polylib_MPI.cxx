@@ -16,9 +16,11 @@
 #include "mpi.h"
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <algorithm>
 #include "Polylib.h"
 
 
@@ -43,6 +45,29 @@ struct CalcAreaInfo_com {
     PL_REAL     gcell_max[3];   // ガイドセルを含めた担当領域の最大位置
 };
 
+// std::sort用ファンクタ   ポリゴンのvectorをソートするのに使用
+struct TriangleLess{
+    bool operator()( const Triangle *l, const Triangle *r ) const
+    {
+        return l->get_id() < r->get_id();
+    }
+};
+
+// std::stable_sort用ファンクタ   rebalance()の送信先ランクとポリゴンの組をランク順にソートする
+struct RankTrianglePairLess{
+    bool operator()( const std::pair<int,Triangle*>& l, const std::pair<int,Triangle*>& r ) const
+    {
+        return l.first < r.first;
+    }
+};
+
+// 担当領域KD木(create_area_tree())のノードが持つ最大要素数
+#define M_MAX_AREA_ELEMENTS 15
+
+// 三角形の隣接PE領域ビットマスクで管理できる隣接PE数
+//   これを超える隣接PEへはmigrate()時に領域判定して送信する
+#define M_GHOST_MASK_BITS ((int)(sizeof(unsigned long long int)*8))
+
 // migrate()処理 内部用
 struct ComHeadGroup {
     int     grp_id;     // ポリゴングループID
@@ -50,18 +75,74 @@ struct ComHeadGroup {
     int     pl_type;    // ポリゴンタイプ
     int     numAtrI;    // ユーザ定義属性（整数）
     int     numAtrR;    // ユーザ定義属性（実数）
-    int     pl_size;    // １ポリゴンの通信バッファサイズ(byte)
+    int     pl_size;    // １ポリゴンの旧形式シリアライズサイズ(byte) 通信量統計用
 };
 
 // migrate()処理 内部用
 struct ComHeadRank {
     int             num_grp;            // 1ランクの送受信するポリゴングループ数
-    int             nsize_mpi_double;   // MPI_DOUBLE単位としたときのポリゴン個数
+    size_t          nsize_byte;         // 1ランクの送受信するポリゴン情報のサイズ(byte)
     ComHeadGroup*   pGrpHead;           // 1グループ毎のヘッダ情報 ( num_grp数分あり )
 };
 
 
 
+
+// 担当領域KD木の作成
+//   全ランクの担当領域を、担当領域(ガイドセル含)の対角2点を頂点とする
+//   縮退三角形に置き換えてKD木(VTree)に登録する
+//      三角形のIDは担当領域の通番+1、ランク番号はarea_rankで引く
+//   担当領域が存在しない場合はNULLを返す
+static VTree*
+create_area_tree(
+        std::vector<ParallelAreaInfo>& all_procs_area,
+        std::vector<Triangle*>&        area_tri_list,
+        std::vector<int>&              area_rank
+    )
+{
+    BBox           all_bbox;
+    Vec3<PL_REAL>  normal( 0.0, 0.0, 0.0 );
+    all_bbox.init();
+
+    for( int irank=0; irank<all_procs_area.size(); irank++ ) {
+        for( int j=0; j<all_procs_area[irank].m_areas.size(); j++ ) {   // 複数担当領域
+            BBox* p_bbox = &(all_procs_area[irank].m_areas[j].m_gcell_bbox);
+            Vec3<PL_REAL> vertex[3];
+            vertex[0] = p_bbox->min;
+            vertex[1] = p_bbox->max;
+            vertex[2] = p_bbox->min;
+            long long int id = area_rank.size() + 1;
+            area_tri_list.push_back( new Triangle( vertex, normal, id ) );
+            area_rank.push_back( all_procs_area[irank].m_rank );
+            all_bbox.add( p_bbox->min );
+            all_bbox.add( p_bbox->max );
+        }
+    }
+
+    if( area_tri_list.size() == 0 ) {
+        return NULL;
+    }
+
+    return new VTree( M_MAX_AREA_ELEMENTS, all_bbox, &area_tri_list );
+}
+
+// 担当領域KD木の削除
+static void
+delete_area_tree(
+        VTree*                   area_tree,
+        std::vector<Triangle*>&  area_tri_list
+    )
+{
+    if( area_tree != NULL ) {
+        delete area_tree;
+    }
+    for( int i=0; i<area_tri_list.size(); i++ ) {
+        delete area_tri_list[i];
+    }
+    area_tri_list.clear();
+}
+
+
 ////////////////////////////////////////////////////////////////////////////
 /// 
 /// クラス:Polylib
@@ -103,7 +184,6 @@ Polylib::init_parallel_info(
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::init_parallel_info() in. " << endl;
 #endif
-    POLYLIB_STAT ret;
 
     // MPI情報の設定
     m_comm = comm;
@@ -121,6 +201,33 @@ Polylib::init_parallel_info(
     PL_DBGOSH << "m_myrank: " << m_myrank << " m_numproc: " << m_numproc << endl;
 #endif
 
+    // 担当領域情報の設定
+    vector<ParallelAreaInfo> all_procs_area;
+    return set_parallel_area( bboxes, all_procs_area );
+}
+
+
+// protected //////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::set_parallel_area(
+        const std::vector<ParallelBbox>&  bboxes,
+        std::vector<ParallelAreaInfo>&    all_procs_area
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::set_parallel_area() in. " << endl;
+#endif
+    POLYLIB_STAT ret;
+
+    // 既存の担当領域情報をクリア
+    m_myproc_area.m_areas.clear();
+    m_other_procs_area.clear();
+    m_neibour_procs_area.clear();
+
+    // 隣接PEの順番が変わるため、三角形の隣接PE領域ビットマスクは無効
+    m_ghost_mask_valid = false;
+    m_ghost_mask_overflow_logged = false;
+
     m_myproc_area.m_rank = m_myrank;
     for( int i=0; i<bboxes.size(); i++ )  {
         PL_REAL bbsize_f[3], gcsize_f[3];
@@ -161,11 +268,10 @@ Polylib::init_parallel_info(
     }
 
     //  Polylib4.xよりランク内の担当領域数が複数個可能となったため、
-    //  MPI_Allgatherは使えない、Rank0に一旦あつめて、その後、broadする
+    //  担当領域数を収集した後、MPI_Allgathervで全ランクの担当領域を収集する
     //  実際はユーザ側は、全体をどう分割すのかは知っているはずであるが．．．
     //
     
-    vector<ParallelAreaInfo> all_procs_area;
     // 全ランクの担当領域を設定
     ret = allgather_ParallelAreaInfo ( m_myproc_area, all_procs_area );
     if( ret != PLSTAT_OK ) {
@@ -195,6 +301,15 @@ Polylib::init_parallel_info(
     }
 #endif
 
+    // 自PE領域と隣接するPE領域の検索
+    //   全ランクの担当領域(ガイドセル含)をKD木に登録し、自PE領域で検索する
+    //   ランク数が多い場合、全ランク×自PE領域の総当たりでは処理時間がかかるため
+    std::vector<bool> neibour_flags( m_numproc, false );
+    ret = search_neibour_procs( all_procs_area, neibour_flags );
+    if( ret != PLSTAT_OK ) {
+        return ret;
+    }
+
     // 自PEを除く全PE担当領域情報リスト設定
     // 自PE領域と隣接するPE領域情報リスト設定
 
@@ -206,24 +321,9 @@ Polylib::init_parallel_info(
         m_other_procs_area.push_back( all_procs_area[irank] );
         
         // 自PE領域と隣接するPE領域情報はm_neibour_procs_areaにも追加
-        bool bcross = false;
-            // 自身の担当領域数
-        for( int i=0; i<m_myproc_area.m_areas.size(); i++ ) {
-            for( int j=0; j<all_procs_area[irank].m_areas.size(); j++ ) {
-                if( m_myproc_area.m_areas[i].m_gcell_bbox.crossed( all_procs_area[irank].m_areas[j].m_gcell_bbox ) ) 
-                {
-                    bcross = true;
-                    break;
-                }
-            }
-            if( bcross ) break;
-        }
-        if( bcross ) {
+        if( neibour_flags[irank] ) {
             // 隣接PE担当領域情報リスト 追加
             m_neibour_procs_area.push_back( all_procs_area[irank] );
-            // migrate除外三角形IDマップ の空を追加
-            std::map< int, std::vector<long long int> >  exclusion_map_rank;
-            m_exclusion_map_procs.push_back( exclusion_map_rank );
         }
     }
 
@@ -241,8 +341,12 @@ Polylib::load(
 #ifdef DEBUG
     PL_DBGOSH << m_myrank << ": " << "Polylib::load() in. " << endl;
 #endif
+    StatsTimer stats_timer( PL_STATS_LOAD );
     POLYLIB_STAT ret;
 
+    // 非同期保存中はTextParserを使用できないため完了を待つ
+    wait_save_internal( "load" );
+
     // ポリゴングループtreeの作成：全ランクで同じデータを設定する
     try {
         tp->read(config_filename);
@@ -253,6 +357,9 @@ Polylib::load(
     catch( POLYLIB_STAT e ){
         return e;
     }
+
+    // 読み込んだ三角形の隣接PE領域ビットマスクは未設定
+    m_ghost_mask_valid = false;
     
     //------------------------------------------------------------------------
     //  メモリ削減のため、ポリゴングループ毎に以下の処理を行う
@@ -333,6 +440,9 @@ Polylib::save(
     char    my_extend[128];
     POLYLIB_STAT stat;
 
+    // 非同期保存中であれば完了を待つ
+    wait_save_internal( "save" );
+
     // 拡張文字列がカラであれば、現在時刻から作成
     if (extend == "") {
       time_t timer = time(NULL);
@@ -394,6 +504,72 @@ Polylib::save(
 }
 
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::save_async(
+               const std::string& file_format,
+               std::string        extend
+            )
+{
+#ifdef DEBUG
+  PL_DBGOSH << "Polylib::save_async() in. " << endl;
+#endif
+    POLYLIB_STAT    ret;
+    char    my_extend[128];
+
+    // 実行中の非同期保存があれば完了を待つ
+    wait_save_internal( "save_async" );
+
+    // 拡張文字列がカラであれば、現在時刻から作成
+    if (extend == "") {
+      time_t timer = time(NULL);
+      struct tm *date = localtime(&timer);
+      sprintf(my_extend, "%04d%02d%02d%02d%02d%02d",
+          date->tm_year+1900,date->tm_mon+1,date->tm_mday,
+          date->tm_hour,date->tm_min,date->tm_sec);
+    }
+    else {
+      sprintf(my_extend, "%s", extend.c_str());
+    }
+
+    SaveJob* job = new SaveJob;
+    job->rank_no = "";
+    job->extend  = my_extend;
+    job->format  = file_format;
+    job->stat    = PLSTAT_OK;
+
+    for (int i=0; i<m_pg_list.size(); i++) {
+        // リーフの場合
+        if ( m_pg_list[i]->get_children().empty() == true) {
+
+            std::vector<Triangle*>* tri_list = new std::vector<Triangle*>;
+
+            // ランク0にポリゴンデータを集約する（全ランクの集団通信のため同期的に行う）
+            ret = m_pg_list[i]->gather_polygons( *tri_list );
+            if (ret != PLSTAT_OK) {
+                delete tri_list;
+                for (size_t j=0; j<job->groups.size(); j++) {
+                    std::vector<Triangle*>* p = job->groups[j].tri_list;
+                    for (size_t k=0; k<p->size(); k++) delete (*p)[k];
+                    delete p;
+                }
+                delete job;
+                return ret;
+            }
+
+            // 集約したポリゴンデータの出力はバックグラウンドで行う
+            if( m_myrank == 0 ) {
+                add_save_job_group( job, m_pg_list[i], tri_list );
+            } else {
+                delete tri_list;
+            }
+        }
+    }
+
+    return start_save_job( job );
+}
+
+
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT
 Polylib::save_parallel(
@@ -408,6 +584,9 @@ Polylib::save_parallel(
 #endif
     POLYLIB_STAT ret;
 
+    // 非同期保存中であれば完了を待つ
+    wait_save_internal( "save_parallel" );
+
     // 各ランク毎に保存
     //if( (ret = Polylib::save_at_rank( p_config_filename, m_myrank, m_numproc-1, extend, file_format)) != PLSTAT_OK ) {
     if( (ret = Polylib::save_at_rank( config_name_out, m_myrank, m_numproc-1, extend, file_format)) != PLSTAT_OK ) {
@@ -418,6 +597,60 @@ Polylib::save_parallel(
 }
 
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::save_parallel_async(
+    const std::string& file_format,
+    std::string extend
+)
+{
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::save_parallel_async() in. " << endl;
+#endif
+    char    my_extend[128];
+
+    // 実行中の非同期保存があれば完了を待つ
+    wait_save_internal( "save_parallel_async" );
+
+    // 拡張文字列がカラであれば、現在時刻から作成
+    if (extend == "") {
+        time_t      timer = time(NULL);
+        struct tm   *date = localtime(&timer);
+        sprintf(my_extend, "%04d%02d%02d%02d%02d%02d",
+            date->tm_year+1900, date->tm_mon+1, date->tm_mday,
+            date->tm_hour,      date->tm_min,   date->tm_sec);
+    }
+    else {
+        sprintf(my_extend, "%s", extend.c_str());
+    }
+
+    // ランク番号の整形
+    char    rank_no[16];
+    int     fig = (int)log10((double)(m_numproc-1)) + 1;
+    sprintf(rank_no, "%0*d", fig, m_myrank);
+
+    SaveJob* job = new SaveJob;
+    job->rank_no = rank_no;
+    job->extend  = my_extend;
+    job->format  = file_format;
+    job->stat    = PLSTAT_OK;
+
+    vector<PolygonGroup*>::iterator it;
+    for (it = m_pg_list.begin(); it != m_pg_list.end(); it++) {
+        //リーフのみがポリゴン情報を持っている
+        if ((*it)->get_children().empty() == false) continue;
+
+        // ポリゴン数が0ならばファイル出力不要
+        if ((*it)->get_triangles()->size() == 0) continue;
+
+        // ポリゴンのスナップショット作成
+        add_save_job_group( job, *it, NULL );
+    }
+
+    return start_save_job( job );
+}
+
+
 //TextParser version 
 // protected //////////////////////////////////////////////////////////////////
 POLYLIB_STAT Polylib::save_at_rank(
@@ -511,37 +744,57 @@ Polylib::move(
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::move() in. " << endl;
 #endif
+    StatsTimer stats_timer( PL_STATS_MOVE );
     POLYLIB_STAT ret;
     vector<PolygonGroup*>::iterator group_itr;
     PolygonGroup *p_pg;
 
-    // move実行前から隣接PE領域に懸かっている三角形をmigrate対象除外リストに載せる
-    //     全隣接PE領域、全ポリゴングループ対象
-    ret = select_excluded_trias();
-    if( ret != PLSTAT_OK ) {
-        PL_ERROSH << "[ERROR]Polylib::move():select_exclude_trias() failed. returns:" << PolylibStat2::String(ret) << endl;
-        return ret;
+    // 隣接PE領域ビットマスクが未設定なら、move実行前の状態で初期化する
+    //     以降はmove毎に差分で更新するため、ここでの初期化は初回のみ
+    if( !m_ghost_mask_valid ) {
+        for (group_itr = m_pg_list.begin(); group_itr != m_pg_list.end(); group_itr++) {
+            if( (*group_itr)->get_movable() ) {
+                update_ghost_masks( *group_itr, false );
+            }
+        }
+        m_ghost_mask_valid = true;
     }
 
-    // 各ポリゴングループのmove()を実行
-    // 全グループに対して
+    // 移動する可能性のあるポリゴングループのみ対象
+    vector<PolygonGroup*> targets;
     for (group_itr = m_pg_list.begin(); group_itr != m_pg_list.end(); group_itr++) {
-            p_pg = (*group_itr);
+        if( (*group_itr)->get_movable() ) {
+            targets.push_back( *group_itr );
+        }
+    }
 
-        // 移動する可能性のあるポリゴングループのみ対象
-        if( p_pg->get_movable() ) {
+    // 各ポリゴングループのmove()を実行し、KD木を再構築
+    //     (三角形同士の位置関係が変化したため、再構築が必要)
+    //     並列移動モードの場合はグループ毎に並列実行（MPI通信は行わない）
+    int num = (int)targets.size();
+    bool parallel = get_parallel_move();
+    vector<POLYLIB_STAT> stat( num, PLSTAT_OK );
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) if( parallel && num > 1 )
+#else
+    (void)parallel;
+#endif
+    for( int i=0; i<num; i++ ) {
+        stat[i] = targets[i]->move_and_rebuild( params );
+    }
 
-            // move実行
-            if( (ret = p_pg->move( params )) != PLSTAT_OK ) {
-                PL_ERROSH << "[ERROR]Polylib::move():(*group_itr)->move() failed. returns:" << PolylibStat2::String(ret) << endl;
-                return ret;
-            }
+    for( int i=0; i<num; i++ ) {
+        p_pg = targets[i];
+        if( (ret = stat[i]) != PLSTAT_OK ) {
+            PL_ERROSH << "[ERROR]Polylib::move():p_pg->move_and_rebuild() failed. name:" << p_pg->get_name()
+                      << " returns:" << PolylibStat2::String(ret) << endl;
+            return ret;
+        }
 
-            // KD木を再構築 (三角形同士の位置関係が変化したため、再構築が必要)
-            if( (ret = p_pg->rebuild_polygons()) != PLSTAT_OK ) {
-                PL_ERROSH << "[ERROR]Polylib::move():(*group_itr)->rebuild_polygons() failed. returns:" << PolylibStat2::String(ret) << endl;
-                return ret;
-            }
+        // 移動により新たに隣接PE領域に懸かった三角形を記録
+        if( (ret = update_ghost_masks( p_pg, true )) != PLSTAT_OK ) {
+            PL_ERROSH << "[ERROR]Polylib::move():update_ghost_masks() failed. returns:" << PolylibStat2::String(ret) << endl;
+            return ret;
         }
     }
     return PLSTAT_OK;
@@ -549,70 +802,65 @@ Polylib::move(
 
 
 // protected //////////////////////////////////////////////////////////////////
-POLYLIB_STAT
-Polylib::select_excluded_trias( void )
+unsigned long long int
+Polylib::calc_ghost_mask(
+        Triangle* tri
+    )
 {
-#ifdef DEBUG
-    PL_DBGOSH << "Polylib::select_excluded_trias() in." <<endl;
-#endif
-    POLYLIB_STAT ret;
-
-    // migrate除外三角形IDマップ クリア
-    m_exclusion_map_procs.clear();
+    unsigned long long int mask = 0;
+    BBox tri_bbox = tri->get_bbox( true );
 
-    // 全隣接PEについて
-    //     m_neibour_procsとm_exclusion_mapは同一のランク数が設定される
-    for(unsigned int i=0; i<m_neibour_procs_area.size(); i++ ) {
-        std::map< int, std::vector<long long int> >  exclusion_map_rank;
-            //    pg_id            polygon_id
-        exclusion_map_rank.clear();
+    int num_bits = m_neibour_procs_area.size();
+    if( num_bits > M_GHOST_MASK_BITS ) num_bits = M_GHOST_MASK_BITS;
 
-        vector<BBox> bboxes;
-        bboxes.clear();
+    for(int i=0; i<num_bits; i++ ) {
         // 隣接PE内の担当領域数
-        for(unsigned int j=0; j<m_neibour_procs_area[i].m_areas.size(); j++) {
-            bboxes.push_back( m_neibour_procs_area[i].m_areas[j].m_gcell_bbox );
-        }
-        
-        // 全隣接PEについて
-        //     m_neibour_procsとm_exclusion_mapは同一のランク数が設定される
-        for(int ig=0; ig<m_pg_list.size(); ig++ ) {
-            // 移動する可能性のあるポリゴングループのみ対象
-            if( m_pg_list[ig]->get_movable() ) {
-            } else {
-                continue; // Next Loop
+        for(int j=0; j<m_neibour_procs_area[i].m_areas.size(); j++) {
+            if( tri_bbox.crossed( m_neibour_procs_area[i].m_areas[j].m_gcell_bbox ) ) {
+                mask |= (1ULL << i);
+                break;
             }
+        }
+    }
+    return mask;
+}
 
-            vector<Triangle*>  tri_list;
-            vector<long long int> ids;
-
-            ids.clear();
-            tri_list.clear();
-
-            // 隣接PE領域(ガイドセル含)に懸かる三角形IDリストを作成
-            bool duplicate = false; // 重複削除なし
-            ret = m_pg_list[ig]->search( tri_list, bboxes, false, duplicate );
-        
-            for(unsigned int k=0; k<tri_list.size(); k++ ) {
-                ids.push_back( tri_list[k]->get_id() );
-            }
-        
-            // ポリゴンIDが重複しているが除外リストなので無視する
 
+// protected //////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::update_ghost_masks(
+        PolygonGroup*   p_pg,
+        bool            gain
+    )
+{
 #ifdef DEBUG
-    PL_DBGOSH << "group_name="<<m_pg_list[ig]->get_name()<<" grp internal_id:" << m_pg_list[ig]->get_internal_id() << " neibour_rank:" 
-              << m_neibour_procs_area[i].m_rank
-              << " 除外三角形数:" << ids.size() << endl;
+    PL_DBGOSH << "Polylib::update_ghost_masks() in. group_name="<<p_pg->get_name()<<endl;
 #endif
+    vector<Triangle*>* tri_list = p_pg->get_triangles();
+    if( tri_list == NULL ) {
+        return PLSTAT_OK;
+    }
 
-            // migrate除外三角形IDマップに追加
-            exclusion_map_rank[m_pg_list[ig]->get_internal_id()] = ids;
-
-        }  // !pg loop
-        
-        m_exclusion_map_procs.push_back( exclusion_map_rank );
+    // ビットマスクはグループで三角形リストと同じ並びで保持する
+    //   要素数が異なる場合（三角形リストが再構築された場合）は未設定とし、
+    //   全ての隣接PE領域に新たに懸かったものとして扱う（受信側で重複IDは削除される）
+    vector<unsigned long long int>& masks = p_pg->get_ghost_masks();
+    vector<unsigned long long int>& gains = p_pg->get_ghost_gains();
+    if( masks.size() != tri_list->size() || gains.size() != tri_list->size() ) {
+        masks.assign( tri_list->size(), 0 );
+        gains.assign( tri_list->size(), 0 );
+    }
 
-    } // ! neibour_procs loop
+    for(int i=0; i<tri_list->size(); i++ ) {
+        unsigned long long int mask = calc_ghost_mask( (*tri_list)[i] );
+        if( gain ) {
+            // 新たに懸かった隣接PE領域を追加（migrate()でクリアされるまで累積）
+            gains[i] |= mask & ~masks[i];
+        } else {
+            gains[i] = 0;
+        }
+        masks[i] = mask;
+    }
 
     return PLSTAT_OK;
 }
@@ -676,41 +924,29 @@ Polylib::allgather_ParallelAreaInfo(
         VEC3_TO_REAL( myproc_area.m_areas[i].m_gcell_max, my_area_com[i].gcell_max );
     }
 
-    // ランク０に担当領域情報を集約する
-        // ランク０の処理
-    if( m_myrank == 0 )
-    {
-        int ip = 0;
-        // Rank0の担当領域設定
-        memcpy( &all_areas_com[ip], my_area_com, num_areas_myrank*sizeof(CalcAreaInfo_com) );
-        ip += num_areas_myrank;
-
-        // Rank0以外の担当領域を受信して設定
-        for( int i=1; i<m_numproc; i++ ) {
-            MPI_Status status;
-
-            // 各ランクからの担当領域受信
-            iret = MPI_Recv( &all_areas_com[ip], (num_areas_allrank[i]*sizeof(CalcAreaInfo_com)), 
-                             MPI_CHAR,
-                             i, 1001, MPI_COMM_WORLD, &status );
-
-            ip += num_areas_allrank[i];
-        }
-    
-    }
-        // ランク０以外の処理
-    else
-    {
-        iret = MPI_Send( my_area_com, (num_areas_myrank*sizeof(CalcAreaInfo_com)), 
-                     MPI_CHAR,
-                     0, 1001, MPI_COMM_WORLD );
+    // 全ランクの担当領域情報を収集する
+    //   ランク毎に担当領域数が異なるためMPI_Allgathervを使用する
+    int* recv_counts = (int*)malloc( m_numproc*sizeof(int) );   // 受信サイズ(byte)
+    int* displs      = (int*)malloc( m_numproc*sizeof(int) );   // 受信位置(byte)
+    int  disp = 0;
+    for( int i=0; i<m_numproc; i++ ) {
+        recv_counts[i] = num_areas_allrank[i]*sizeof(CalcAreaInfo_com);
+        displs[i]      = disp;
+        disp += recv_counts[i];
     }
 
-    // ランク０より他ランクに送信する
-    iret = MPI_Bcast( all_areas_com, (num_tot_areas*sizeof(CalcAreaInfo_com)), 
-                         MPI_CHAR,
-                         0, MPI_COMM_WORLD );
-    
+    iret = MPI_Allgatherv( my_area_com, (num_areas_myrank*sizeof(CalcAreaInfo_com)), MPI_BYTE,
+                           all_areas_com, recv_counts, displs, MPI_BYTE, m_comm );
+    free( recv_counts );
+    free( displs );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::allgather_ParallelAreaInfo():MPI_Allgatherv "
+                  << "faild." << endl;
+        free( num_areas_allrank );
+        free( all_areas_com );
+        free( my_area_com );
+        return PLSTAT_MPI_ERROR;
+    }
     
     // ParallelAreaInfoに詰め直す
     int ip=0;
@@ -746,6 +982,498 @@ Polylib::allgather_ParallelAreaInfo(
 }
 
 
+// protected //////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::search_neibour_procs(
+        std::vector<ParallelAreaInfo>& all_procs_area,
+        std::vector<bool>&             neibour_flags
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::search_neibour_procs() in. " << endl;
+#endif
+    POLYLIB_STAT ret = PLSTAT_OK;
+
+    neibour_flags.assign( all_procs_area.size(), false );
+
+    //  全ランクの担当領域をKD木に登録する
+    std::vector<Triangle*>  area_tri_list;
+    std::vector<int>        area_rank;
+    VTree* area_tree = create_area_tree( all_procs_area, area_tri_list, area_rank );
+    if( area_tree == NULL ) {
+        return PLSTAT_OK;
+    }
+
+    // 自PE領域(複数）に交差する担当領域を検索
+    std::vector<Triangle*>  tri_list;
+    for( int i=0; i<m_myproc_area.m_areas.size(); i++ ) {
+        ret = area_tree->search( tri_list, m_myproc_area.m_areas[i].m_gcell_bbox, false );
+        if( ret != PLSTAT_OK ) {
+            PL_ERROSH << "[ERROR]Polylib::search_neibour_procs():area_tree->search() failed. returns:"
+                      << PolylibStat2::String(ret) << endl;
+            break;
+        }
+    }
+
+    for( int i=0; i<tri_list.size(); i++ ) {
+        int irank = area_rank[ tri_list[i]->get_id() - 1 ];
+        neibour_flags[irank] = true;
+    }
+
+    // あとしまつ
+    delete_area_tree( area_tree, area_tri_list );
+
+    return ret;
+}
+
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::rebalance(
+        PL_REAL bpos[3], 
+        unsigned int bbsize[3], 
+        unsigned int gcsize[3], 
+        PL_REAL dx[3]
+    )
+{
+    ParallelBbox  bbox;
+    vector<ParallelBbox> bboxes;
+    
+    bbox.bpos[0]   = bpos[0];   bbox.bpos[1]   = bpos[1];    bbox.bpos[2]   = bpos[2];
+    bbox.bbsize[0] = bbsize[0]; bbox.bbsize[1] = bbsize[1];  bbox.bbsize[2] = bbsize[2];
+    bbox.gcsize[0] = gcsize[0]; bbox.gcsize[1] = gcsize[1];  bbox.gcsize[2] = gcsize[2];
+    bbox.dx[0]     = dx[0];     bbox.dx[1]     = dx[1];      bbox.dx[2]     = dx[2];
+
+    bboxes.push_back( bbox );
+    
+    return rebalance( bboxes );
+}
+
+
+// public /////////////////////////////////////////////////////////////////////
+//   ポリゴンの再分散
+//     1) 新担当領域を設定し、全ランクの新担当領域をKD木に登録する
+//     2) 各ポリゴンのBBoxでKD木を検索し、送信先ランクを決定する
+//     3) 送信サイズをMPI_Alltoall、ポリゴン情報を1対1通信で交換する
+//     4) 自ランクに残るポリゴンと受信ポリゴンでポリゴングループを再構築する
+//   送受信バッファはランク毎に以下の形式でポリゴングループ分並べる
+//     ComHeadGroup + シリアライズしたポリゴン(num_tri分) + パディング(double境界)
+POLYLIB_STAT
+Polylib::rebalance(
+        const std::vector<ParallelBbox>&  bboxes
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::rebalance() in. " << endl;
+#endif
+    POLYLIB_STAT ret;
+    int iret;
+
+    //-------------------------------------------------------
+    // 新担当領域の設定
+    //-------------------------------------------------------
+    vector<ParallelAreaInfo> all_procs_area;
+    ret = set_parallel_area( bboxes, all_procs_area );
+    if( ret != PLSTAT_OK ) {
+        return ret;
+    }
+
+    std::vector<Triangle*>  area_tri_list;
+    std::vector<int>        area_rank;
+    VTree* area_tree = create_area_tree( all_procs_area, area_tri_list, area_rank );
+
+    //-------------------------------------------------------
+    // ポリゴン毎の送信先ランクの決定
+    //-------------------------------------------------------
+    // ポリゴンを持つ可能性のあるリーフグループ（全ランクで同一順）
+    vector<PolygonGroup*> leaf_list;
+    for (int i=0; i<m_pg_list.size(); i++) {
+        if ( m_pg_list[i]->get_children().empty() == true) {
+            leaf_list.push_back( m_pg_list[i] );
+        }
+    }
+    int num_grp = leaf_list.size();
+
+    // グループ毎の自ランクに残すポリゴン、送信先ランクとポリゴンの組
+    vector< vector<Triangle*> >                  keep_lists( num_grp );
+    vector< vector< pair<int,Triangle*> > >      send_lists( num_grp );
+    vector< vector<char> >                       keep_flags( num_grp );   // 既存ポリゴン毎の残すフラグ
+    vector<int> mark( m_numproc, -1 );  // ポリゴン毎の送信先重複チェック用
+
+    for(int ig=0; ig<num_grp; ig++ ) {
+        vector<Triangle*>* p_tri_list = leaf_list[ig]->get_triangles();
+        if( p_tri_list == NULL ) continue;
+        keep_flags[ig].assign( p_tri_list->size(), 0 );
+        if( area_tree == NULL ) continue;
+
+        for(int i=0; i<p_tri_list->size(); i++ ) {
+            Triangle* p_tri = (*p_tri_list)[i];
+            vector<Triangle*> hit_list;
+            area_tree->search( hit_list, p_tri->get_bbox(true), false );
+
+            for(int k=0; k<hit_list.size(); k++ ) {
+                int irank = area_rank[ hit_list[k]->get_id() - 1 ];
+                if( mark[irank] == i ) continue;    // 同一ランクの複数担当領域
+                mark[irank] = i;
+                if( irank == m_myrank ) {
+                    keep_lists[ig].push_back( p_tri );
+                    keep_flags[ig][i] = 1;
+                } else {
+                    send_lists[ig].push_back( pair<int,Triangle*>( irank, p_tri ) );
+                }
+            }
+        }
+        // 送信先ランク順に並べる
+        std::stable_sort( send_lists[ig].begin(), send_lists[ig].end(), RankTrianglePairLess() );
+        mark.assign( m_numproc, -1 );
+    }
+    delete_area_tree( area_tree, area_tri_list );
+
+    //-------------------------------------------------------
+    // 送信サイズ計算（byte、double境界に合わせる）
+    //   2GBを超える場合があるため64bit整数で扱う
+    //-------------------------------------------------------
+    long long int* send_counts = new long long int[m_numproc];
+    long long int* recv_counts = new long long int[m_numproc];
+    size_t*        sdispls     = new size_t[m_numproc];
+    size_t*        rdispls     = new size_t[m_numproc];
+    for(int irank=0; irank<m_numproc; irank++ ) {
+        send_counts[irank] = 0;
+    }
+
+    for(int ig=0; ig<num_grp; ig++ ) {
+        if( send_lists[ig].size() == 0 ) continue;
+        Triangle* p_tri0 = send_lists[ig][0].second;
+        int    pl_type = p_tri0->get_pl_type();
+        int    numAtrI = p_tri0->get_num_atrI();
+        int    numAtrR = p_tri0->get_num_atrR();
+        size_t pl_size = p_tri0->serialized_size();
+        size_t ist = 0;
+        while( ist < send_lists[ig].size() ) {
+            int    irank = send_lists[ig][ist].first;
+            size_t ied = ist;
+            while( ied < send_lists[ig].size() && send_lists[ig][ied].first == irank ) ied++;
+            size_t isize = sizeof(ComHeadGroup)
+                         + serialized_size_polygons( pl_type, numAtrI, numAtrR, ied-ist );
+            send_counts[irank] += ((isize + sizeof(double) - 1)/sizeof(double))*sizeof(double);
+            add_comm_stats( isize, sizeof(ComHeadGroup) + (ied-ist)*pl_size );
+            ist = ied;
+        }
+    }
+
+    iret = MPI_Alltoall( send_counts, 1, MPI_LONG_LONG_INT, recv_counts, 1, MPI_LONG_LONG_INT, m_comm );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::rebalance():MPI_Alltoall faild." << endl;
+        delete[] send_counts;  delete[] recv_counts;
+        delete[] sdispls;      delete[] rdispls;
+        return PLSTAT_MPI_ERROR;
+    }
+
+    size_t nsend_byte = 0;
+    size_t nrecv_byte = 0;
+    for(int irank=0; irank<m_numproc; irank++ ) {
+        sdispls[irank] = nsend_byte;
+        rdispls[irank] = nrecv_byte;
+        nsend_byte += send_counts[irank];
+        nrecv_byte += recv_counts[irank];
+    }
+    size_t nsend_double = nsend_byte/sizeof(double);
+    size_t nrecv_double = nrecv_byte/sizeof(double);
+
+    //-------------------------------------------------------
+    // 送信バッファに詰める
+    //-------------------------------------------------------
+    double* send_buff = new double[ nsend_double>0 ? nsend_double : 1 ];
+    double* recv_buff = new double[ nrecv_double>0 ? nrecv_double : 1 ];
+    vector<char*> pbuff_ranks( m_numproc );
+    for(int irank=0; irank<m_numproc; irank++ ) {
+        pbuff_ranks[irank] = (char*)send_buff + sdispls[irank];
+    }
+
+    vector<Triangle*> tri_run;      // 同一送信先ランクのポリゴン
+    for(int ig=0; ig<num_grp; ig++ ) {
+        if( send_lists[ig].size() == 0 ) continue;
+        Triangle* p_tri0 = send_lists[ig][0].second;
+        size_t ist = 0;
+        while( ist < send_lists[ig].size() ) {
+            int    irank = send_lists[ig][ist].first;
+            size_t ied = ist;
+            tri_run.clear();
+            while( ied < send_lists[ig].size() && send_lists[ig][ied].first == irank ) {
+                tri_run.push_back( send_lists[ig][ied].second );
+                ied++;
+            }
+
+            ComHeadGroup head;
+            head.grp_id  = leaf_list[ig]->get_internal_id();
+            head.num_tri = ied - ist;
+            head.pl_type = p_tri0->get_pl_type();
+            head.numAtrI = p_tri0->get_num_atrI();
+            head.numAtrR = p_tri0->get_num_atrR();
+            head.pl_size = p_tri0->serialized_size();
+
+            char* pbuff_st = pbuff_ranks[irank];
+            char* pbuff    = pbuff_st;
+            memcpy( pbuff, &head, sizeof(ComHeadGroup) );
+            pbuff += sizeof(ComHeadGroup);
+            pbuff = serialize_polygons( &tri_run[0], head.num_tri, head.pl_type,
+                                        head.numAtrI, head.numAtrR, pbuff );
+            // double境界に合わせる
+            size_t isize = pbuff - pbuff_st;
+            pbuff_ranks[irank] = pbuff_st + ((isize + sizeof(double) - 1)/sizeof(double))*sizeof(double);
+            ist = ied;
+        }
+    }
+
+    // 自ランクに残さないポリゴンは送信バッファに詰めたので削除
+    for(int ig=0; ig<num_grp; ig++ ) {
+        vector<Triangle*>* p_tri_list = leaf_list[ig]->get_triangles();
+        if( p_tri_list == NULL ) continue;
+        for(int i=0; i<p_tri_list->size(); i++ ) {
+            if( keep_flags[ig][i] == 0 ) {
+                delete (*p_tri_list)[i];
+            }
+        }
+        // 残すポリゴンはkeep_listsで管理する
+        p_tri_list->clear();
+    }
+    send_lists.clear();
+
+    //-------------------------------------------------------
+    // ポリゴン情報の交換
+    //   MPI_Alltoallvは要素数・変位がint型のため、
+    //   1対1通信（2GB超は派生データ型）で交換する
+    //-------------------------------------------------------
+    vector<MPI_Request> reqs;
+    reqs.reserve( 2*m_numproc );
+    iret = MPI_SUCCESS;
+    for(int irank=0; irank<m_numproc && iret==MPI_SUCCESS; irank++ ) {
+        if( recv_counts[irank] == 0 ) continue;
+        if( irank == m_myrank ) {
+            memcpy( (char*)recv_buff + rdispls[irank], (char*)send_buff + sdispls[irank], recv_counts[irank] );
+            continue;
+        }
+        reqs.push_back( MPI_REQUEST_NULL );
+        iret = mpi_irecv_bytes( (char*)recv_buff + rdispls[irank], recv_counts[irank],
+                                irank, 1201, m_comm, &reqs.back() );
+    }
+    for(int irank=0; irank<m_numproc && iret==MPI_SUCCESS; irank++ ) {
+        if( send_counts[irank] == 0 || irank == m_myrank ) continue;
+        reqs.push_back( MPI_REQUEST_NULL );
+        iret = mpi_isend_bytes( (char*)send_buff + sdispls[irank], send_counts[irank],
+                                irank, 1201, m_comm, &reqs.back() );
+    }
+    if( iret == MPI_SUCCESS && reqs.size() > 0 ) {
+        iret = MPI_Waitall( reqs.size(), &reqs[0], MPI_STATUSES_IGNORE );
+    }
+    delete[] send_buff;
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::rebalance():polygon exchange faild." << endl;
+        delete[] recv_buff;
+        delete[] send_counts;  delete[] recv_counts;
+        delete[] sdispls;      delete[] rdispls;
+        return PLSTAT_MPI_ERROR;
+    }
+
+    //-------------------------------------------------------
+    // 受信データの展開
+    //-------------------------------------------------------
+    map<int,int> grp_index;     // グループID -> leaf_listの何番目か
+    for(int ig=0; ig<num_grp; ig++ ) {
+        grp_index[ leaf_list[ig]->get_internal_id() ] = ig;
+    }
+
+    for(int irank=0; irank<m_numproc; irank++ ) {
+        char* pbuff     = (char*)recv_buff + rdispls[irank];
+        char* pbuff_end = pbuff + recv_counts[irank];
+        while( pbuff < pbuff_end ) {
+            ComHeadGroup head;
+            memcpy( &head, pbuff, sizeof(ComHeadGroup) );
+            char* pbuff_st = pbuff;
+            pbuff += sizeof(ComHeadGroup);
+
+            int ig = grp_index[ head.grp_id ];
+            // deserialize: Triangle/NptTrinangleオブジェクト生成
+            pbuff = const_cast<char*>( deserialize_polygons( head.pl_type, head.numAtrI, head.numAtrR,
+                                                             head.num_tri, pbuff, keep_lists[ig] ) );
+            size_t isize = pbuff - pbuff_st;
+            pbuff = pbuff_st + ((isize + sizeof(double) - 1)/sizeof(double))*sizeof(double);
+        }
+    }
+
+    delete[] recv_buff;
+    delete[] send_counts;  delete[] recv_counts;
+    delete[] sdispls;      delete[] rdispls;
+
+    //-------------------------------------------------------
+    // ポリゴングループの再構築
+    //-------------------------------------------------------
+    for(int ig=0; ig<num_grp; ig++ ) {
+        if( leaf_list[ig]->get_triangles() == NULL && keep_lists[ig].size() == 0 ) continue;
+
+        // ID順にソートしてID重複分を削除
+        //    複数ランクから同一ポリゴンを受信することがあるため
+        vector<Triangle*>* p_new_list = new vector<Triangle*>;
+        p_new_list->reserve( keep_lists[ig].size() );
+        std::sort( keep_lists[ig].begin(), keep_lists[ig].end(), TriangleLess() );
+        for(int i=0; i<keep_lists[ig].size(); i++ ) {
+            if( p_new_list->size() > 0 &&
+                p_new_list->back()->get_id() == keep_lists[ig][i]->get_id() ) {
+                // IDが同一なので削除
+                delete keep_lists[ig][i];
+            } else {
+                p_new_list->push_back( keep_lists[ig][i] );
+            }
+        }
+        keep_lists[ig].clear();
+
+        // ポリゴンのポインタの登録・KDツリー等の構築
+        leaf_list[ig]->set_triangles_ptr( p_new_list, true );
+    }
+
+#ifdef DEBUG
+    PL_DBGOSH << "Polylib::rebalance() out. " << endl;
+#endif
+    return PLSTAT_OK;
+}
+
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::get_load_info_procs(
+        std::vector<int>&     num_tria_procs,
+        std::vector<double>&  search_time_procs
+    )
+{
+    int iret;
+    int num_tria = 0;
+
+    // 自ランクのポリゴン数(リーフグループの合計)
+    for (int i=0; i<m_pg_list.size(); i++) {
+        if ( m_pg_list[i]->get_children().empty() == true) {
+            vector<Triangle*>* p_tri_list = m_pg_list[i]->get_triangles();
+            if( p_tri_list != NULL ) {
+                num_tria += p_tri_list->size();
+            }
+        }
+    }
+    long long int search_count;
+    double search_time;
+    get_search_stats( search_count, search_time );
+
+    num_tria_procs.resize( m_numproc );
+    search_time_procs.resize( m_numproc );
+
+    iret = MPI_Allgather( &num_tria, 1, MPI_INT, &num_tria_procs[0], 1, MPI_INT, m_comm );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::get_load_info_procs():MPI_Allgather faild." << endl;
+        return PLSTAT_MPI_ERROR;
+    }
+    iret = MPI_Allgather( &search_time, 1, MPI_DOUBLE, &search_time_procs[0], 1, MPI_DOUBLE, m_comm );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::get_load_info_procs():MPI_Allgather faild." << endl;
+        return PLSTAT_MPI_ERROR;
+    }
+
+    return PLSTAT_OK;
+}
+
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::reduce_stats(
+        std::vector<double>&  vmin,
+        std::vector<double>&  vmax,
+        std::vector<double>&  vavg
+    )
+{
+    vector<double> vals;
+    StatsRegistry::get_instance()->get_values( vals );
+    int num = (int)vals.size();
+    vmin.resize( num );
+    vmax.resize( num );
+    vavg.resize( num );
+
+    if( MPI_Allreduce( &vals[0], &vmin[0], num, MPI_DOUBLE, MPI_MIN, m_comm ) != MPI_SUCCESS
+     || MPI_Allreduce( &vals[0], &vmax[0], num, MPI_DOUBLE, MPI_MAX, m_comm ) != MPI_SUCCESS
+     || MPI_Allreduce( &vals[0], &vavg[0], num, MPI_DOUBLE, MPI_SUM, m_comm ) != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::reduce_stats():MPI_Allreduce faild." << endl;
+        return PLSTAT_MPI_ERROR;
+    }
+    for( int i=0; i<num; i++ ) {
+        vavg[i] /= m_numproc;
+    }
+    return PLSTAT_OK;
+}
+
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+Polylib::write_stats_json(
+        const std::string&    fname
+    )
+{
+    int iret;
+    vector<double> vmin, vmax, vavg;
+    POLYLIB_STAT ret = reduce_stats( vmin, vmax, vavg );
+    if( ret != PLSTAT_OK ) return ret;
+
+    // 各ランクのJSONオブジェクトをランク0に集める
+    ostringstream oss;
+    StatsRegistry::get_instance()->write_json( oss, m_myrank, 4 );
+    string json = oss.str();
+    int len = (int)json.size();
+
+    vector<int> len_procs( m_numproc, 0 );
+    iret = MPI_Gather( &len, 1, MPI_INT, &len_procs[0], 1, MPI_INT, 0, m_comm );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::write_stats_json():MPI_Gather faild." << endl;
+        return PLSTAT_MPI_ERROR;
+    }
+    vector<int> disp( m_numproc, 0 );
+    for( int i=1; i<m_numproc; i++ ) {
+        disp[i] = disp[i-1] + len_procs[i-1];
+    }
+    vector<char> buff( m_myrank == 0 ? disp[m_numproc-1] + len_procs[m_numproc-1] + 1 : 1 );
+    iret = MPI_Gatherv( const_cast<char*>(json.c_str()), len, MPI_CHAR,
+                        &buff[0], &len_procs[0], &disp[0], MPI_CHAR, 0, m_comm );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::write_stats_json():MPI_Gatherv faild." << endl;
+        return PLSTAT_MPI_ERROR;
+    }
+
+    // ランク0のみ出力。結果は全ランクに返す
+    int ok = 1;
+    if( m_myrank == 0 ) {
+        ofstream ofs( fname.c_str() );
+        if( !ofs ) {
+            PL_ERROSH << "[ERROR]Polylib::write_stats_json():Can't open file: "
+                      << fname << endl;
+            ok = 0;
+        } else {
+            ofs << "{" << endl;
+            ofs << "  \"num_rank\": " << m_numproc << "," << endl;
+            ofs << "  \"summary\":" << endl;
+            StatsRegistry::write_json_summary( ofs, vmin, vmax, vavg, 2 );
+            ofs << "," << endl;
+            ofs << "  \"ranks\": [" << endl;
+            for( int i=0; i<m_numproc; i++ ) {
+                ofs.write( &buff[disp[i]], len_procs[i] );
+                ofs << ( i < m_numproc-1 ? "," : "" ) << endl;
+            }
+            ofs << "  ]" << endl;
+            ofs << "}" << endl;
+        }
+    }
+    iret = MPI_Bcast( &ok, 1, MPI_INT, 0, m_comm );
+    if( iret != MPI_SUCCESS ) {
+        PL_ERROSH << "[ERROR]Polylib::write_stats_json():MPI_Bcast faild." << endl;
+        return PLSTAT_MPI_ERROR;
+    }
+    return ok ? PLSTAT_OK : PLSTAT_NG;
+}
+
+
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT
 Polylib::migrate( void )
@@ -753,6 +1481,7 @@ Polylib::migrate( void )
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::migrate() in. " << endl;
 #endif
+    StatsTimer stats_timer( PL_STATS_MIGRATE );
     POLYLIB_STAT ret;
     int         iret;
     int num_req_grp_num = 0;
@@ -790,54 +1519,96 @@ Polylib::migrate( void )
         }
         
         head_rank[i].num_grp          = 0;
-        head_rank[i].nsize_mpi_double = 0;
+        head_rank[i].nsize_byte       = 0;
         head_rank[i].pGrpHead = (ComHeadGroup*) malloc( num_grp_rank_wk*sizeof(ComHeadGroup) );
         head_recv_rank[i].num_grp          = 0;
-        head_recv_rank[i].nsize_mpi_double = 0;
+        head_recv_rank[i].nsize_byte       = 0;
         head_recv_rank[i].pGrpHead = NULL;
         send_buff_ranks[i] = NULL;
         recv_buff_ranks[i] = NULL;
     }
 
-    // 隣接PE数ループ
-    for (int i=0; i<m_neibour_procs_area.size(); i++) {
-        vector<BBox> bboxes;
-        bboxes.clear();
+    // 隣接PE毎・移動可能グループ毎の送信三角形リストを作成
+    //     move()で新たに隣接PE領域に懸かった三角形のみ対象とする
+    //     (三角形の隣接PE領域ビットマスクで判定するため、領域検索は不要)
+    //     ビットマスクが無効の場合はmove()が実行されていないため送信なし
+    vector< vector< vector<Triangle*> > > send_lists( m_neibour_procs_area.size() );
+    if( m_ghost_mask_valid ) {
+        int num_grp_movable = 0;
+        for(int j=0; j<m_pg_list.size(); j++ ) {
+            if( m_pg_list[j]->get_movable() ) { // グループが移動可？
+                num_grp_movable++;
+            }
+        }
+        for (int i=0; i<m_neibour_procs_area.size(); i++) {
+            send_lists[i].resize( num_grp_movable );
+        }
+        if( (int)m_neibour_procs_area.size() > M_GHOST_MASK_BITS && !m_ghost_mask_overflow_logged ) {
+            PL_ERROSH << "[WARNING]Polylib::migrate():number of neighbour PEs "
+                      << m_neibour_procs_area.size() << " exceeds " << M_GHOST_MASK_BITS
+                      << ". polygons overlapping the rest are sent without the ghost mask." << endl;
+            m_ghost_mask_overflow_logged = true;
+        }
 
-        // 隣接PE内の担当領域数
-        for(int j=0; j<m_neibour_procs_area[i].m_areas.size(); j++) {
-            bboxes.push_back( m_neibour_procs_area[i].m_areas[j].m_gcell_bbox );
+        int jp = 0;
+        for(int j=0; j<m_pg_list.size(); j++ ) {
+            if( !m_pg_list[j]->get_movable() ) continue;
+
+            vector<Triangle*>* tri_list = m_pg_list[j]->get_triangles();
+            const vector<unsigned long long int>& masks = m_pg_list[j]->get_ghost_masks();
+            const vector<unsigned long long int>& gains = m_pg_list[j]->get_ghost_gains();
+            if( tri_list != NULL ) {
+                // ビットマスク未設定（move()後に三角形リストが再構築された）の場合は
+                //   懸かっている隣接PE領域全てに新たに懸かったものとして扱う
+                bool with_mask = ( masks.size() == tri_list->size() && gains.size() == tri_list->size() );
+                for(int k=0; k<tri_list->size(); k++ ) {
+                    Triangle* tri = (*tri_list)[k];
+                    unsigned long long int gain = with_mask ? (gains[k] & masks[k]) : calc_ghost_mask( tri );
+                    for (int i=0; i<m_neibour_procs_area.size(); i++) {
+                        if( i < M_GHOST_MASK_BITS ) {
+                            if( gain & (1ULL << i) ) {
+                                send_lists[i][jp].push_back( tri );
+                            }
+                        } else {
+                            // ビットマスク対象外の隣接PEは領域判定のみで送信
+                            //   受信側で重複IDは削除される
+                            BBox tri_bbox = tri->get_bbox( true );
+                            for(int ia=0; ia<m_neibour_procs_area[i].m_areas.size(); ia++) {
+                                if( tri_bbox.crossed( m_neibour_procs_area[i].m_areas[ia].m_gcell_bbox ) ) {
+                                    send_lists[i][jp].push_back( tri );
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            jp++;
         }
-        
+    }
+
+    // 隣接PE数ループ
+    for (int i=0; i<m_neibour_procs_area.size(); i++) {
         vector<Triangle*> tri_list_rank;
         tri_list_rank.clear();
         
         size_t  isize_send_buff = 0;
+        size_t  isize_legacy    = 0;    // 旧形式（ポリゴン毎）でのサイズ 統計用
         
         // ポリゴングループ数
         for(int j=0; j<m_pg_list.size(); j++ ) {
         
             if( m_pg_list[j]->get_movable() ) { // グループが移動可？
             
+                // 各ランクのヘッダに設定
+                int ip= head_rank[i].num_grp;
+
+                // 当該隣接PE領域に新たに懸かった三角形
                 vector<Triangle*> tri_list_pg;
-                tri_list_pg.clear();
-            
-                // 当該隣接PE領域への移動除外三角形IDリストを取得
-                map< int, vector<long long int> >::iterator const itr =
-                    m_exclusion_map_procs[i].find( m_pg_list[j]->get_internal_id() );
-                
-                // 当該隣接PE領域内にある移動フラグONの三角形を取得
-                if( itr != m_exclusion_map_procs[i].end() ) {
-                    ret = m_pg_list[j]->search_outbounded( tri_list_pg,
-                                              bboxes, ((*itr).second) );
-                } else {
-#ifdef DEBUG
-                    PL_DBGOSH << "Polylib::migrate() m_exclusion_map_procs not matched: i="<<i<<" group name="<<m_pg_list[j]->get_name() <<endl;
-#endif
+                if( !send_lists[i].empty() ) {
+                    tri_list_pg.swap( send_lists[i][ip] );
                 }
 
-                // 各ランクのヘッダに設定
-                int ip= head_rank[i].num_grp;
                 head_rank[i].pGrpHead[ip].grp_id  = m_pg_list[j]->get_internal_id();
                 head_rank[i].pGrpHead[ip].num_tri = tri_list_pg.size();
                 if( tri_list_pg.size() > 0 ) {
@@ -860,24 +1631,23 @@ Polylib::migrate( void )
                     for(int k=0; k<tri_list_pg.size(); k++) {
                         tri_list_rank.push_back( tri_list_pg[k] );
                     }
-                    isize_send_buff += head_rank[i].pGrpHead[ip].num_tri*head_rank[i].pGrpHead[ip].pl_size;
+                    isize_send_buff += serialized_size_polygons( head_rank[i].pGrpHead[ip].pl_type,
+                                                                 head_rank[i].pGrpHead[ip].numAtrI,
+                                                                 head_rank[i].pGrpHead[ip].numAtrR,
+                                                                 head_rank[i].pGrpHead[ip].num_tri );
+                    isize_legacy    += head_rank[i].pGrpHead[ip].num_tri*head_rank[i].pGrpHead[ip].pl_size;
                 }
             }
         }
         
-        // 通信サイズ(MPI_DOUBLE単位）
+        // 通信サイズ(byte)
+        head_rank[i].nsize_byte = isize_send_buff;
         if( isize_send_buff > 0 ) {
-            if( (isize_send_buff%sizeof(double)) == 0 ) {
-                head_rank[i].nsize_mpi_double = isize_send_buff/sizeof(double); 
-            } else {
-                head_rank[i].nsize_mpi_double = isize_send_buff/sizeof(double) + 1;
-            }
-        
-            send_buff_ranks[i] = (char*)malloc( (size_t)(head_rank[i].nsize_mpi_double)*sizeof(double) );
+            send_buff_ranks[i] = (char*)malloc( isize_send_buff );
         } else {
-            head_rank[i].nsize_mpi_double = 0;
-            send_buff_ranks[i]            = NULL;
+            send_buff_ranks[i] = NULL;
         }
+        add_comm_stats( isize_send_buff, isize_legacy );
 
 
         // 送信バッファに設定
@@ -886,34 +1656,44 @@ Polylib::migrate( void )
         
         for(int j=0; j<head_rank[i].num_grp; j++ ) {
             int num_tri = head_rank[i].pGrpHead[j].num_tri;
-            int pl_size = head_rank[i].pGrpHead[j].pl_size;
-
-            for(int k=0; k<num_tri; k++) {
-                // 送信バッファにパック
-                pbuff = tri_list_rank[ip]->serialize( pbuff );
-                ip++;
-            }
+            if( num_tri == 0 ) continue;
+
+            // 送信バッファにグループ単位でパック
+            pbuff = serialize_polygons( &tri_list_rank[ip], num_tri,
+                                        head_rank[i].pGrpHead[j].pl_type,
+                                        head_rank[i].pGrpHead[j].numAtrI,
+                                        head_rank[i].pGrpHead[j].numAtrR, pbuff );
+            ip += num_tri;
         }
         
     }
 
 
+    // 送信済みの三角形の新規隣接PE領域ビットをクリア
+    for(int j=0; j<m_pg_list.size(); j++ ) {
+        vector<unsigned long long int>& gains = m_pg_list[j]->get_ghost_gains();
+        if( m_pg_list[j]->get_movable() ) {
+            gains.assign( gains.size(), 0 );
+        }
+    }
+
     //-------------------------------------------------------
-    // ランク毎のグループ数・MPI_DOUBLE数の送信／受信
+    // ランク毎のグループ数・通信サイズの送信／受信
     //-------------------------------------------------------
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::migrate() send/recv num of group start" << endl;
 #endif
     num_req_grp_num = 0;
-    int** idata      = alloc_array_2d_int( m_neibour_procs_area.size(), 2 );
-    int** idata_recv = alloc_array_2d_int( m_neibour_procs_area.size(), 2 );
+    //   通信サイズが2GBを超える場合があるため64bit整数で送受信する
+    long long int* idata      = new long long int[ 2*m_neibour_procs_area.size() ];
+    long long int* idata_recv = new long long int[ 2*m_neibour_procs_area.size() ];
 
     // 隣接PE数ループ
     for (int i=0; i<m_neibour_procs_area.size(); i++) {
         // 送信
-        idata[i][0] = head_rank[i].num_grp;     // 移動可能グループ数
-        idata[i][1] = head_rank[i].nsize_mpi_double;    // 通信サイズ(MPI_DOUBLE単位）
-        iret = MPI_Isend( idata[i], 2, MPI_INT,
+        idata[2*i  ] = head_rank[i].num_grp;     // 移動可能グループ数
+        idata[2*i+1] = head_rank[i].nsize_byte;  // 通信サイズ(byte)
+        iret = MPI_Isend( &idata[2*i], 2, MPI_LONG_LONG_INT,
                           m_neibour_procs_area[i].m_rank, 1101,
                           m_comm, &req_grp_num[num_req_grp_num] );
         if( iret != MPI_SUCCESS) {
@@ -924,7 +1704,7 @@ Polylib::migrate( void )
         num_req_grp_num++;
 
         // 受信
-        iret = MPI_Irecv( idata_recv[i], 2, MPI_INT,
+        iret = MPI_Irecv( &idata_recv[2*i], 2, MPI_LONG_LONG_INT,
                           m_neibour_procs_area[i].m_rank, 1101,
                           m_comm, &req_grp_num[num_req_grp_num] );
         if( iret != MPI_SUCCESS) {
@@ -953,15 +1733,15 @@ PL_DBGOSH << "Polylib::migrate() MPI_Waitall(grp_num) end" << endl;
     
     // 領域確保
     for (int i=0; i<m_neibour_procs_area.size(); i++) {
-        head_recv_rank[i].num_grp          = idata_recv[i][0];
-        head_recv_rank[i].nsize_mpi_double = idata_recv[i][1];
+        head_recv_rank[i].num_grp          = idata_recv[2*i  ];
+        head_recv_rank[i].nsize_byte       = idata_recv[2*i+1];
         if( head_recv_rank[i].num_grp > 0 ) {
             head_recv_rank[i].pGrpHead = (ComHeadGroup*)malloc( (size_t)(head_recv_rank[i].num_grp)*sizeof(ComHeadGroup) );
         } else {
             head_recv_rank[i].pGrpHead = NULL;
         }
-        if( head_recv_rank[i].nsize_mpi_double > 0 ) {
-            recv_buff_ranks[i] = (char*)malloc( (size_t)(head_recv_rank[i].nsize_mpi_double)*sizeof(double) );
+        if( head_recv_rank[i].nsize_byte > 0 ) {
+            recv_buff_ranks[i] = (char*)malloc( head_recv_rank[i].nsize_byte );
         } else {
             recv_buff_ranks[i] = NULL;
         }
@@ -1020,8 +1800,8 @@ PL_DBGOSH << "Polylib::migrate() MPI_Waitall(grp) end" << endl;
     num_req_tri = 0;
     for (int i=0; i<m_neibour_procs_area.size(); i++) {
         // 送信
-        if( head_rank[i].nsize_mpi_double > 0 ) {
-            iret = MPI_Isend( send_buff_ranks[i], head_rank[i].nsize_mpi_double, MPI_DOUBLE,
+        if( head_rank[i].nsize_byte > 0 ) {
+            iret = mpi_isend_bytes( send_buff_ranks[i], head_rank[i].nsize_byte,
                           m_neibour_procs_area[i].m_rank, 1103,
                           m_comm, &req_tri[num_req_tri] );
             if( iret != MPI_SUCCESS) {
@@ -1033,8 +1813,8 @@ PL_DBGOSH << "Polylib::migrate() MPI_Waitall(grp) end" << endl;
         }
 
         // 受信
-        if( head_recv_rank[i].nsize_mpi_double > 0 ) {
-            iret = MPI_Irecv( recv_buff_ranks[i], head_recv_rank[i].nsize_mpi_double, MPI_DOUBLE,
+        if( head_recv_rank[i].nsize_byte > 0 ) {
+            iret = mpi_irecv_bytes( recv_buff_ranks[i], head_recv_rank[i].nsize_byte,
                           m_neibour_procs_area[i].m_rank, 1103,
                           m_comm, &req_tri[num_req_tri] ); 
             if( iret != MPI_SUCCESS) {
@@ -1054,6 +1834,19 @@ PL_DBGOSH << "Polylib::migrate() MPI_Waitall(tri) start" << endl;
 PL_DBGOSH << "Polylib::migrate() MPI_Waitall(tri) end" << endl;
 #endif
 
+    // 隣接PE毎の送信量（処理統計情報）
+    //     グループ数・通信サイズ、ComHeadGroup、ポリゴン情報の3種類
+    if( StatsRegistry::is_enable() ) {
+        for (int i=0; i<m_neibour_procs_area.size(); i++) {
+            long long int bytes = 2*sizeof(long long int)
+                                + (long long int)head_rank[i].num_grp*sizeof(ComHeadGroup)
+                                + head_rank[i].nsize_byte;
+            long long int msgs  = 1 + ( head_rank[i].num_grp    > 0 ? 1 : 0 )
+                                    + ( head_rank[i].nsize_byte > 0 ? 1 : 0 );
+            StatsRegistry::get_instance()->add_neighbour( m_neibour_procs_area[i].m_rank, bytes, msgs );
+        }
+    }
+
     //-------------------------------------------------------
     // ポリゴン情報作成（アンパック）およびポリゴン追加
     //-------------------------------------------------------
@@ -1071,20 +1864,20 @@ PL_DBGOSH << "Polylib::migrate() MPI_Waitall(tri) end" << endl;
         int jp = 0;
         for(int j=0; j<m_pg_list.size(); j++ ) {
             if( m_pg_list[j]->get_movable() ) { // グループが移動可？
-                int num_tri = head_recv_rank[i].pGrpHead[jp].num_tri;
-                int pl_size = head_recv_rank[i].pGrpHead[jp].pl_size;
-                int pl_type = head_recv_rank[i].pGrpHead[jp].pl_type;
+                ComHeadGroup& head = head_recv_rank[i].pGrpHead[jp];
                 tri_list.clear();
-                for(int k=0; k<num_tri; k++) {
-                    // deserialize: Triangle/NptTrinangleオブジェクト生成
-                    Triangle* pTri = deserialize_polygon( pl_type, pbuff );
-                    pbuff += pl_size;
-                    tri_list.push_back( pTri );
+                // deserialize: Triangle/NptTrinangleオブジェクト生成
+                pbuff = const_cast<char*>( deserialize_polygons( head.pl_type, head.numAtrI, head.numAtrR,
+                                                                 head.num_tri, pbuff, tri_list ) );
+                // 受信した三角形の隣接PE領域ビットマスクを自PE基準で設定
+                vector<unsigned long long int> masks( tri_list.size() );
+                for(int k=0; k<tri_list.size(); k++) {
+                    masks[k] = calc_ghost_mask( tri_list[k] );
                 }
                 jp++;
                 
                 // ポリゴングループに三角形リストを追加
-                if( (ret = m_pg_list[j]->add_triangles( tri_list )) != PLSTAT_OK ) {
+                if( (ret = m_pg_list[j]->add_triangles( tri_list, &masks )) != PLSTAT_OK ) {
                     PL_ERROSH << "[ERROR]Polylib::migrate():pg->add_triangles() failed. returns:"
                               << PolylibStat2::String(ret) << endl;
                     return ret;
@@ -1141,7 +1934,7 @@ PL_DBGOSH << "Polylib::migrate() MPI_Waitall(tri) end" << endl;
     delete[] head_rank; delete[] head_recv_rank;
     delete[] send_buff_ranks; delete[] recv_buff_ranks;
 
-    free_array_2d( (void**)idata ); free_array_2d(  (void**)idata_recv );
+    delete[] idata;  delete[] idata_recv;
 
 #ifdef DEBUG
     PL_DBGOSH << "Polylib::migrate() out normaly." << endl;
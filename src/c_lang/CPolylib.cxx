@@ -13,6 +13,7 @@
 #include "mpi.h"
 #endif
 #include <string>
+#include <algorithm>
 #include "c_lang/CPolylib.h"
 #include "Polylib.h"
 
@@ -30,6 +31,163 @@ using namespace PolylibNS;
 //static Polylib* p_polylib_instance = NULL;
 Polylib* p_polylib_instance = NULL;  // Fortranで使用するためstaticを外す
 
+//--------------------------------------------------
+//  内部関数
+//--------------------------------------------------
+
+///
+/// ポリゴンリストの参照（ポインタ配列）
+///
+struct TriPtrAt {
+    Triangle* const *p;
+    Triangle* operator()( int i ) const { return p[i]; }
+};
+
+///
+/// ポリゴンリストの参照（タグ配列）
+///
+struct TriTagAt {
+    const PL_ELM_TAG *p;
+    Triangle* operator()( int i ) const { return reinterpret_cast<Triangle*>(p[i]); }
+};
+
+///
+/// 三角形ポリゴンの頂点座標をvertex[9*i+3*j+k]へ詰める
+///
+template <class TriAt>
+static void copy_out_vertexes( int num, const TriAt& at, PL_REAL *vertex )
+{
+    for( int i=0; i<num; i++ ) {
+        Vec3<PL_REAL>* v = at(i)->get_vertexes();
+        VEC3_3_TO_REAL9( v, &vertex[9*i] );
+    }
+}
+
+///
+/// 三角形ポリゴンの法線ベクトルをnormal[3*i+k]へ詰める
+///
+template <class TriAt>
+static void copy_out_normals( int num, const TriAt& at, PL_REAL *normal )
+{
+    for( int i=0; i<num; i++ ) {
+        Vec3<PL_REAL> n = at(i)->get_normal();
+        VEC3_TO_REAL( n, &normal[3*i] );
+    }
+}
+
+///
+/// 三角形ポリゴンのユーザ定義属性（整数型）をatr[num_atr*i+j]へ詰める
+///
+template <class TriAt>
+static void copy_out_atrI( int num, const TriAt& at, int num_atr, int *atr )
+{
+    for( int i=0; i<num; i++ ) {
+        Triangle *tri = at(i);
+        int n = std::min( num_atr, tri->get_num_atrI() );
+        int *p = tri->get_pAtrI();
+        int j = 0;
+        for( ; j<n; j++ )       atr[num_atr*i+j] = p[j];
+        for( ; j<num_atr; j++ ) atr[num_atr*i+j] = 0;
+    }
+}
+
+///
+/// 三角形ポリゴンのユーザ定義属性（実数型）をatr[num_atr*i+j]へ詰める
+///
+template <class TriAt>
+static void copy_out_atrR( int num, const TriAt& at, int num_atr, PL_REAL *atr )
+{
+    for( int i=0; i<num; i++ ) {
+        Triangle *tri = at(i);
+        int n = std::min( num_atr, tri->get_num_atrR() );
+        PL_REAL *p = tri->get_pAtrR();
+        int j = 0;
+        for( ; j<n; j++ )       atr[num_atr*i+j] = p[j];
+        for( ; j<num_atr; j++ ) atr[num_atr*i+j] = 0.0;
+    }
+}
+
+///
+/// vertex[9*i+3*j+k]を三角形ポリゴンの頂点座標に設定する
+///     法線ベクトル,面積も再計算する
+///
+template <class TriAt>
+static void copy_in_vertexes( int num, const TriAt& at, const PL_REAL *vertex )
+{
+    for( int i=0; i<num; i++ ) {
+        Vec3<PL_REAL> v[3];
+        REAL9_TO_VEC3_3( &vertex[9*i], v );
+        at(i)->set_vertexes( v, true, true );
+    }
+}
+
+///
+/// atr[num_atr*i+j]を三角形ポリゴンのユーザ定義属性（整数型）に設定する
+///     ポリゴンの属性数を超える分は無視する
+///
+template <class TriAt>
+static void copy_in_atrI( int num, const TriAt& at, int num_atr, const int *atr )
+{
+    for( int i=0; i<num; i++ ) {
+        Triangle *tri = at(i);
+        int n = std::min( num_atr, tri->get_num_atrI() );
+        int *p = tri->get_pAtrI();
+        for( int j=0; j<n; j++ )    p[j] = atr[num_atr*i+j];
+    }
+}
+
+///
+/// atr[num_atr*i+j]を三角形ポリゴンのユーザ定義属性（実数型）に設定する
+///     ポリゴンの属性数を超える分は無視する
+///
+template <class TriAt>
+static void copy_in_atrR( int num, const TriAt& at, int num_atr, const PL_REAL *atr )
+{
+    for( int i=0; i<num; i++ ) {
+        Triangle *tri = at(i);
+        int n = std::min( num_atr, tri->get_num_atrR() );
+        PL_REAL *p = tri->get_pAtrR();
+        for( int j=0; j<n; j++ )    p[j] = atr[num_atr*i+j];
+    }
+}
+
+///
+/// タグ配列の参照
+///
+static TriTagAt tags_tri_at( const PL_ELM_TAG *tags )
+{
+    TriTagAt at;
+    at.p = tags;
+    return at;
+}
+
+///
+/// グループのポリゴンリストの参照
+///
+static TriPtrAt group_tri_at( PL_GRP_TAG tag_pg, int *num )
+{
+    PolygonGroup* pg = reinterpret_cast<PolygonGroup*>(tag_pg);
+    vector<Triangle*>* tri_list = pg->get_triangles();
+    TriPtrAt at;
+    at.p = NULL;
+    *num = 0;
+    if( tri_list != NULL && !tri_list->empty() ) {
+        at.p  = &(*tri_list)[0];
+        *num  = (int)tri_list->size();
+    }
+    return at;
+}
+
+///
+/// 検索結果カーソルのポリゴンリストの参照
+///
+static TriPtrAt result_tri_at( PolylibSearchResult *result )
+{
+    TriPtrAt at;
+    at.p = result->m_tri_list.empty() ? NULL : &result->m_tri_list[0];
+    return at;
+}
+
 
 /// C言語用Polylib環境の構築
 ///     Polylibインスタンス生成
@@ -205,6 +363,17 @@ polylib_move(
     return p_polylib_instance->move( params );
 }
 
+///
+/// グループ単位の並列移動モードの指定
+///   Polylib::set_parallel_moveメソッドのラッパー関数
+///
+void polylib_set_parallel_move(
+               int parallel
+             )
+{
+    Polylib::set_parallel_move( parallel != 0 );
+}
+
 #ifdef MPI_PL
 ///
 /// Polylib::mograteメソッドのラッパー関数
@@ -555,6 +724,160 @@ POLYLIB_STAT polylib_search_nearest_polygon(
     return PLSTAT_OK;
 }
 
+///
+/// 検索結果カーソルの作成
+///  @param[out]    res         検索結果カーソルのタグ
+///  @param[in]     group_name  抽出グループ名。
+///  @return    POLYLIB_STATで定義される値が返る
+///
+POLYLIB_STAT polylib_result_create(
+        PL_RES_TAG  *res,
+        char*       group_name
+    )
+{
+    PolylibSearchResult *result = new PolylibSearchResult;
+    std::string group_name_tmp = group_name;
+
+    POLYLIB_STAT ret = p_polylib_instance->create_search_handle(
+                            group_name_tmp, result->m_handle );
+    if( ret != PLSTAT_OK ) {
+        delete result;
+        *res = PL_NULL_TAG;
+        return ret;
+    }
+    *res = reinterpret_cast<PL_RES_TAG>( result );
+    return PLSTAT_OK;
+}
+
+///
+/// 検索結果カーソルの削除
+///  @param[in]     res         検索結果カーソルのタグ
+///
+void polylib_result_delete(
+        PL_RES_TAG  res
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    delete result;
+}
+
+///
+/// 検索結果カーソルへのポリゴンの検索
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[in]     min_pos     抽出する矩形領域の最小値。(x,y,z順の配列)
+///  @param[in]     max_pos     抽出する矩形領域の最大値。(x,y,z順の配列)
+///  @param[in]     every       抽出オプション。
+///  @param[out]    num         抽出された三角形ポリゴン数
+///  @return    POLYLIB_STATで定義される値が返る
+///
+POLYLIB_STAT polylib_result_search(
+        PL_RES_TAG  res,
+        PL_REAL     min_pos[3],
+        PL_REAL     max_pos[3],
+        int         every,
+        int         *num
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    Vec3<PL_REAL>    min_pos_tmp( min_pos );
+    Vec3<PL_REAL>    max_pos_tmp( max_pos );
+    bool every_tmp = ( every == 1 );
+
+    POLYLIB_STAT ret = p_polylib_instance->search_polygons(
+                            *result, min_pos_tmp, max_pos_tmp, every_tmp );
+    *num = result->m_tri_list.size();
+    return ret;
+}
+
+///
+/// 検索結果の三角形ポリゴン数の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @return    三角形ポリゴン数
+///
+int polylib_result_get_num(
+        PL_RES_TAG  res
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    return result->m_tri_list.size();
+}
+
+///
+/// 検索結果の三角形ポリゴンのタグの取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[out]    tags        三角形ポリゴンのタグ
+///
+void polylib_result_get_tags(
+        PL_RES_TAG  res,
+        PL_ELM_TAG  *tags
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    for( size_t i=0; i<result->m_tri_list.size(); i++ ) {
+        tags[i] = reinterpret_cast<PL_ELM_TAG>( result->m_tri_list[i] );
+    }
+}
+
+///
+/// 検索結果の三角形ポリゴンの頂点座標の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[out]    vertex      頂点座標 vertex[9*i+3*j+k]
+///
+void polylib_result_get_vertexes(
+        PL_RES_TAG  res,
+        PL_REAL     *vertex
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    copy_out_vertexes( result->m_tri_list.size(), result_tri_at(result), vertex );
+}
+
+///
+/// 検索結果の三角形ポリゴンの法線ベクトルの取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[out]    normal      法線ベクトル normal[3*i+k]
+///
+void polylib_result_get_normals(
+        PL_RES_TAG  res,
+        PL_REAL     *normal
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    copy_out_normals( result->m_tri_list.size(), result_tri_at(result), normal );
+}
+
+///
+/// 検索結果の三角形ポリゴンのユーザ定義属性（整数型）の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]
+///
+void polylib_result_get_atrI(
+        PL_RES_TAG  res,
+        int         num_atr,
+        int         *atr
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    copy_out_atrI( result->m_tri_list.size(), result_tri_at(result), num_atr, atr );
+}
+
+///
+/// 検索結果の三角形ポリゴンのユーザ定義属性（実数型）の取得
+///  @param[in]     res         検索結果カーソルのタグ
+///  @param[in]     num_atr     ポリゴン１個あたりの属性数
+///  @param[out]    atr         属性 atr[num_atr*i+j]
+///
+void polylib_result_get_atrR(
+        PL_RES_TAG  res,
+        int         num_atr,
+        PL_REAL     *atr
+    )
+{
+    PolylibSearchResult *result = reinterpret_cast<PolylibSearchResult*>( res );
+    copy_out_atrR( result->m_tri_list.size(), result_tri_at(result), num_atr, atr );
+}
+
 ///
 /// Polylib::show_group_hierarchyメソッドのラッパー関数。
 /// グループ階層構造リストを標準出力に出力する。
@@ -793,6 +1116,33 @@ void polylib_group_set_need_rebuild( PL_GRP_TAG tag )
     return pg->set_need_rebuild();
 }
 
+///
+/// 直前のpolylib_move()での処理時間の取得
+///
+void polylib_group_get_move_time(
+            PL_GRP_TAG  tag,
+            double      *move_time,
+            double      *rebuild_time
+         )
+{
+    PolygonGroup* pg = reinterpret_cast<PolygonGroup*>(tag);
+    pg->get_move_time( *move_time, *rebuild_time );
+}
+
+///
+/// グループ内の全ポリゴンのアフィン変換
+///
+POLYLIB_STAT polylib_group_transform(
+            PL_GRP_TAG  tag,
+            PL_REAL     mat[4][4],
+            int         update_normal,
+            int         update_area
+         )
+{
+    PolygonGroup* pg = reinterpret_cast<PolygonGroup*>(tag);
+    return pg->transform( mat, update_normal!=0, update_area!=0 );
+}
+
 //----------------------------------------------
 // setter / getter
 //----------------------------------------------
@@ -806,6 +1156,8 @@ void polylib_group_set_name(
     PolygonGroup* pg = reinterpret_cast<PolygonGroup*>(tag);
     std::string name_tmp = name;
     pg->set_name( name );
+    // グループ名の索引を作成し直す
+    p_polylib_instance->update_search_index();
 }
 
 /// グループ名取得
@@ -1125,3 +1477,231 @@ PL_REAL* polylib_triangle_get_pAtrR(
     return tri->get_pAtrR();
 }
 
+
+//--------------------------------------------------
+//  複数ポリゴンの一括操作
+//--------------------------------------------------
+
+/// 頂点座標の一括取得（タグ配列指定）
+void polylib_triangles_get_vertexes(
+            int         num,
+            PL_ELM_TAG  *tags,
+            PL_REAL     *vertex
+            )
+{
+    copy_out_vertexes( num, tags_tri_at(tags), vertex );
+}
+
+/// 法線ベクトルの一括取得（タグ配列指定）
+void polylib_triangles_get_normals(
+            int         num,
+            PL_ELM_TAG  *tags,
+            PL_REAL     *normal
+            )
+{
+    copy_out_normals( num, tags_tri_at(tags), normal );
+}
+
+/// ユーザ定義属性（整数型）の一括取得（タグ配列指定）
+void polylib_triangles_get_atrI(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            int         *atr
+            )
+{
+    copy_out_atrI( num, tags_tri_at(tags), num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括取得（タグ配列指定）
+void polylib_triangles_get_atrR(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            PL_REAL     *atr
+            )
+{
+    copy_out_atrR( num, tags_tri_at(tags), num_atr, atr );
+}
+
+/// 頂点座標の一括設定（タグ配列指定）
+///     法線ベクトル,面積も内部で設定する
+void polylib_triangles_set_vertexes(
+            int         num,
+            PL_ELM_TAG  *tags,
+            PL_REAL     *vertex
+            )
+{
+    copy_in_vertexes( num, tags_tri_at(tags), vertex );
+}
+
+/// ユーザ定義属性（整数型）の一括設定（タグ配列指定）
+void polylib_triangles_set_atrI(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            int         *atr
+            )
+{
+    copy_in_atrI( num, tags_tri_at(tags), num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括設定（タグ配列指定）
+void polylib_triangles_set_atrR(
+            int         num,
+            PL_ELM_TAG  *tags,
+            int         num_atr,
+            PL_REAL     *atr
+            )
+{
+    copy_in_atrR( num, tags_tri_at(tags), num_atr, atr );
+}
+
+/// 頂点座標の一括取得（グループ指定）
+void polylib_group_get_vertexes(
+            PL_GRP_TAG  tag_pg,
+            PL_REAL     *vertex
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_out_vertexes( num, at, vertex );
+}
+
+/// 法線ベクトルの一括取得（グループ指定）
+void polylib_group_get_normals(
+            PL_GRP_TAG  tag_pg,
+            PL_REAL     *normal
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_out_normals( num, at, normal );
+}
+
+/// ユーザ定義属性（整数型）の一括取得（グループ指定）
+void polylib_group_get_atrI(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            int         *atr
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_out_atrI( num, at, num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括取得（グループ指定）
+void polylib_group_get_atrR(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            PL_REAL     *atr
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_out_atrR( num, at, num_atr, atr );
+}
+
+/// 頂点座標の一括設定（グループ指定）
+///     法線ベクトル,面積も内部で設定する
+void polylib_group_set_vertexes(
+            PL_GRP_TAG  tag_pg,
+            PL_REAL     *vertex
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_in_vertexes( num, at, vertex );
+}
+
+/// ユーザ定義属性（整数型）の一括設定（グループ指定）
+void polylib_group_set_atrI(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            int         *atr
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_in_atrI( num, at, num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括設定（グループ指定）
+void polylib_group_set_atrR(
+            PL_GRP_TAG  tag_pg,
+            int         num_atr,
+            PL_REAL     *atr
+            )
+{
+    int num;
+    TriPtrAt at = group_tri_at( tag_pg, &num );
+    copy_in_atrR( num, at, num_atr, atr );
+}
+
+
+//--------------------------------------------------
+//  処理統計情報
+//--------------------------------------------------
+
+/// 処理統計情報の集計の有効/無効の設定
+void polylib_stats_set_enable(
+            int         enable
+            )
+{
+    StatsRegistry::set_enable( enable != 0 );
+}
+
+/// 処理統計情報のリセット
+void polylib_stats_reset( void )
+{
+    StatsRegistry::get_instance()->reset();
+}
+
+/// 処理区分の呼び出し回数と累積処理時間の取得
+void polylib_stats_get_time(
+            int             phase,
+            long long int   *calls,
+            double          *time
+            )
+{
+    *calls = StatsRegistry::get_instance()->get_calls( phase );
+    *time  = StatsRegistry::get_instance()->get_time( phase );
+}
+
+/// カウンタの取得
+void polylib_stats_get_count(
+            int             counter,
+            long long int   *count
+            )
+{
+    *count = StatsRegistry::get_instance()->get_count( counter );
+}
+
+/// 処理統計情報の全ランク集計
+POLYLIB_STAT polylib_stats_reduce(
+            double      *vmin,
+            double      *vmax,
+            double      *vavg
+            )
+{
+    std::vector<double> wmin, wmax, wavg;
+    POLYLIB_STAT ret = p_polylib_instance->reduce_stats( wmin, wmax, wavg );
+    if( ret != PLSTAT_OK )  return ret;
+
+    for( size_t i=0; i<wmin.size(); i++ ) {
+        vmin[i] = wmin[i];
+        vmax[i] = wmax[i];
+        vavg[i] = wavg[i];
+    }
+    return PLSTAT_OK;
+}
+
+/// 処理統計情報のJSONファイル出力
+POLYLIB_STAT polylib_stats_write_json(
+            char        *fname
+            )
+{
+    std::string fname_wk = fname;
+    return p_polylib_instance->write_stats_json( fname_wk );
+}
@@ -294,6 +294,18 @@ fpolylib_move_ (
     *ret = p_polylib_instance->move( params );
 }
 
+///
+/// グループ単位の並列移動モードの指定
+///  @param[in]     parallel    1:グループ毎に並列に実行する 0:順に実行する
+///
+void
+fpolylib_set_parallel_move_ (
+                          int* parallel
+             )
+{
+    polylib_set_parallel_move( *parallel );
+}
+
 #ifdef MPI_PL
 ///
 /// Polylib::mograteメソッドのラッパー関数
@@ -587,6 +599,104 @@ void fpolylib_search_nearest_polygon_ (
     *ret = PLSTAT_OK;
 }
 
+///
+/// 検索結果カーソルの作成
+///  @param[out] res         検索結果カーソルのタグ
+///  @param[in]  group_name  抽出グループ名
+///  @param[out] ret     POLYLIB_STAT(integer)で定義される値が返る
+///
+void fpolylib_result_create_ (
+        PL_RES_TAG  *res,
+        char*       group_name,
+        POLYLIB_STAT* ret
+    )
+{
+    std::string      group_name_tmp; int len_c;
+    fpolylib_fstring_to_cstring ( group_name, PL_GRP_PATH_LEN, 
+                                  group_name_tmp, len_c );
+
+    *ret = polylib_result_create( res, const_cast<char*>(group_name_tmp.c_str()) );
+}
+
+///
+/// 検索結果カーソルの削除
+///  @param[in]  res         検索結果カーソルのタグ
+///
+void fpolylib_result_delete_ (
+        PL_RES_TAG  *res
+    )
+{
+    polylib_result_delete( *res );
+}
+
+///
+/// 検索結果カーソルへのポリゴンの検索
+///  @param[in]  res         検索結果カーソルのタグ
+///  @param[in]  min_pos     抽出する矩形領域の最小値。(x,y,z順の配列)
+///  @param[in]  max_pos     抽出する矩形領域の最大値。(x,y,z順の配列)
+///  @param[in]  every       抽出オプション。
+///  @param[out] num         抽出された三角形ポリゴン数
+///  @param[out] ret     POLYLIB_STAT(integer)で定義される値が返る
+///
+void fpolylib_result_search_ (
+        PL_RES_TAG  *res,
+        PL_REAL     min_pos[3],
+        PL_REAL     max_pos[3],
+        int         *every,
+        int         *num,
+        POLYLIB_STAT* ret
+    )
+{
+    *ret = polylib_result_search( *res, min_pos, max_pos, *every, num );
+}
+
+/// 検索結果の三角形ポリゴンのタグの取得
+void fpolylib_result_get_tags_ (
+        PL_RES_TAG  *res,
+        PL_ELM_TAG  *tags
+    )
+{
+    polylib_result_get_tags( *res, tags );
+}
+
+/// 検索結果の三角形ポリゴンの頂点座標の取得
+void fpolylib_result_get_vertexes_ (
+        PL_RES_TAG  *res,
+        PL_REAL     *vertex
+    )
+{
+    polylib_result_get_vertexes( *res, vertex );
+}
+
+/// 検索結果の三角形ポリゴンの法線ベクトルの取得
+void fpolylib_result_get_normals_ (
+        PL_RES_TAG  *res,
+        PL_REAL     *normal
+    )
+{
+    polylib_result_get_normals( *res, normal );
+}
+
+/// 検索結果の三角形ポリゴンのユーザ定義属性（整数型）の取得
+void fpolylib_result_get_atrI_ (
+        PL_RES_TAG  *res,
+        int         *num_atr,
+        int         *atr
+    )
+{
+    polylib_result_get_atrI( *res, *num_atr, atr );
+}
+
+/// 検索結果の三角形ポリゴンのユーザ定義属性（実数型）の取得
+void fpolylib_result_get_atrR_ (
+        PL_RES_TAG  *res,
+        int         *num_atr,
+        PL_REAL     *atr
+    )
+{
+    polylib_result_get_atrR( *res, *num_atr, atr );
+}
+
 ///
 /// Polylib::show_group_hierarchyメソッドのラッパー関数。
 /// グループ階層構造リストを標準出力に出力する。
@@ -809,6 +919,35 @@ void fpolylib_group_set_need_rebuild_ ( PL_GRP_TAG* tag_pg )
     pg->set_need_rebuild();
 }
 
+///
+/// 直前のfpolylib_move()での処理時間の取得
+///
+void fpolylib_group_get_move_time_ (
+            PL_GRP_TAG*     tag_pg,
+            double*         move_time,
+            double*         rebuild_time
+    )
+{
+    polylib_group_get_move_time( *tag_pg, move_time, rebuild_time );
+}
+
+///
+/// グループ内の全ポリゴンのアフィン変換
+///     Fortranの mat(4,4) はC言語の mat[4][4] の転置となるため、
+///     列ベクトル系のマトリクスとしてそのまま渡す
+///
+void fpolylib_group_transform_ (
+            PL_GRP_TAG*     tag_pg,
+            PL_REAL*        mat,
+            int*            update_normal,
+            int*            update_area,
+            POLYLIB_STAT*   ret
+    )
+{
+    *ret = polylib_group_transform( *tag_pg, reinterpret_cast<PL_REAL(*)[4]>(mat),
+                                    *update_normal, *update_area );
+}
+
 
 //----------------------------------------------
 // setter / getter
@@ -826,6 +965,8 @@ void fpolylib_group_set_name_ (
                                   group_name_tmp, len_c );
 
     pg->set_name( group_name_tmp );
+    // グループ名の索引を作成し直す
+    p_polylib_instance->update_search_index();
 }
 
 /// グループ名取得
@@ -1306,4 +1447,209 @@ void fpolylib_triangle_set_atrR_ (
 }
 
 
+//--------------------------------------------------
+//  複数ポリゴンの一括操作
+//--------------------------------------------------
+
+/// 頂点座標の一括取得（タグ配列指定）
+void fpolylib_triangles_get_vertexes_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        PL_REAL     *vertex
+    )
+{
+    polylib_triangles_get_vertexes( *num, tags, vertex );
+}
+
+/// 法線ベクトルの一括取得（タグ配列指定）
+void fpolylib_triangles_get_normals_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        PL_REAL     *normal
+    )
+{
+    polylib_triangles_get_normals( *num, tags, normal );
+}
+
+/// ユーザ定義属性（整数型）の一括取得（タグ配列指定）
+void fpolylib_triangles_get_atrI_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        int         *atr
+    )
+{
+    polylib_triangles_get_atrI( *num, tags, *num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括取得（タグ配列指定）
+void fpolylib_triangles_get_atrR_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        PL_REAL     *atr
+    )
+{
+    polylib_triangles_get_atrR( *num, tags, *num_atr, atr );
+}
+
+/// 頂点座標の一括設定（タグ配列指定）
+void fpolylib_triangles_set_vertexes_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        PL_REAL     *vertex
+    )
+{
+    polylib_triangles_set_vertexes( *num, tags, vertex );
+}
+
+/// ユーザ定義属性（整数型）の一括設定（タグ配列指定）
+void fpolylib_triangles_set_atrI_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        int         *atr
+    )
+{
+    polylib_triangles_set_atrI( *num, tags, *num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括設定（タグ配列指定）
+void fpolylib_triangles_set_atrR_ (
+        int         *num,
+        PL_ELM_TAG  *tags,
+        int         *num_atr,
+        PL_REAL     *atr
+    )
+{
+    polylib_triangles_set_atrR( *num, tags, *num_atr, atr );
+}
+
+/// 頂点座標の一括取得（グループ指定）
+void fpolylib_group_get_vertexes_ (
+        PL_GRP_TAG  *tag_pg,
+        PL_REAL     *vertex
+    )
+{
+    polylib_group_get_vertexes( *tag_pg, vertex );
+}
+
+/// 法線ベクトルの一括取得（グループ指定）
+void fpolylib_group_get_normals_ (
+        PL_GRP_TAG  *tag_pg,
+        PL_REAL     *normal
+    )
+{
+    polylib_group_get_normals( *tag_pg, normal );
+}
+
+/// ユーザ定義属性（整数型）の一括取得（グループ指定）
+void fpolylib_group_get_atrI_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        int         *atr
+    )
+{
+    polylib_group_get_atrI( *tag_pg, *num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括取得（グループ指定）
+void fpolylib_group_get_atrR_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        PL_REAL     *atr
+    )
+{
+    polylib_group_get_atrR( *tag_pg, *num_atr, atr );
+}
+
+/// 頂点座標の一括設定（グループ指定）
+void fpolylib_group_set_vertexes_ (
+        PL_GRP_TAG  *tag_pg,
+        PL_REAL     *vertex
+    )
+{
+    polylib_group_set_vertexes( *tag_pg, vertex );
+}
+
+/// ユーザ定義属性（整数型）の一括設定（グループ指定）
+void fpolylib_group_set_atrI_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        int         *atr
+    )
+{
+    polylib_group_set_atrI( *tag_pg, *num_atr, atr );
+}
+
+/// ユーザ定義属性（実数型）の一括設定（グループ指定）
+void fpolylib_group_set_atrR_ (
+        PL_GRP_TAG  *tag_pg,
+        int         *num_atr,
+        PL_REAL     *atr
+    )
+{
+    polylib_group_set_atrR( *tag_pg, *num_atr, atr );
+}
+
+
+//--------------------------------------------------
+//  処理統計情報
+//--------------------------------------------------
+
+/// 処理統計情報の集計の有効/無効の設定
+void fpolylib_stats_set_enable_ (
+        int         *enable
+    )
+{
+    polylib_stats_set_enable( *enable );
+}
+
+/// 処理統計情報のリセット
+void fpolylib_stats_reset_ ( void )
+{
+    polylib_stats_reset();
+}
+
+/// 処理区分の呼び出し回数と累積処理時間の取得
+void fpolylib_stats_get_time_ (
+        int             *phase,
+        long long int   *calls,
+        double          *time
+    )
+{
+    polylib_stats_get_time( *phase, calls, time );
+}
+
+/// カウンタの取得
+void fpolylib_stats_get_count_ (
+        int             *counter,
+        long long int   *count
+    )
+{
+    polylib_stats_get_count( *counter, count );
+}
 
+/// 処理統計情報の全ランク集計
+void fpolylib_stats_reduce_ (
+        double          *vmin,
+        double          *vmax,
+        double          *vavg,
+        POLYLIB_STAT    *ret
+    )
+{
+    *ret = polylib_stats_reduce( vmin, vmax, vavg );
+}
+
+/// 処理統計情報のJSONファイル出力
+void fpolylib_stats_write_json_ (
+        char            *fname,
+        POLYLIB_STAT    *ret
+    )
+{
+    std::string fname_wk;
+    int len_c;
+    fpolylib_fstring_to_cstring( fname, PL_FILE_PATH_LEN, fname_wk, len_c );
+
+    *ret = p_polylib_instance->write_stats_json( fname_wk );
+}
@@ -16,10 +16,26 @@
 #include <fstream>
 #include <vector>
 #include <iomanip>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#endif
+#include <deque>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
 #include "common/tt.h"
 #include "polygons/Triangle.h"
+#include "groups/VTree.h"
 #include "file_io/PolygonIO.h"
 #include "file_io/FileIO_func.h"
+#include "Polylib_func.h"
 
 namespace PolylibNS {
 
@@ -32,11 +48,54 @@ using namespace std;
 #define TT_LITTLE_ENDIAN    2
 #define TT_BIG_ENDIAN       3
 
+// Polylibバイナリファイル(plb)
+//   ヘッダ部 : マジック(8byte)
+//              int  バージョン, エンディアン確認値, sizeof(PL_REAL), ポリゴンタイプ,
+//                   整数属性数, 実数属性数, グループパス長,
+//                   KD木作成時の検索モード(0:不明 1:3角形平面 2:曲面補正)
+//              long long  ポリゴン数, KD木ノード数, KD木要素数, ポリゴンデータサイズ
+//   グループパス(8byte境界までパディング)
+//   ポリゴンデータ(serialize_polygons()の列指向形式)
+//   KD木ノード配列(ノード毎に PL_REAL×12, long long×5)
+//   KD木要素インデックス配列(long long)
+#define PLB_MAGIC           "PLBSNAP"
+#define PLB_MAGIC_LEN       8
+#define PLB_VERSION         1
+#define PLB_HEAD_SIZE       (PLB_MAGIC_LEN + 8*sizeof(int) + 4*sizeof(long long int))
+#define PLB_NODE_SIZE       (12*sizeof(PL_REAL) + 5*sizeof(long long int))
+#define PLB_PAD8(n)         (((n)+7)/8*8)
+
+// 書き出し用バッファ
+//   ポリゴンをバッファに一括で変換し、まとめて書き出す
+#define WRITE_BUFF_SIZE     (4*1024*1024)   // バッファサイズ(byte)
+#define WRITE_LINE_MAX      256             // アスキー出力1行の最大長(byte)
+#if SCIENTIFIC_OUT
+#define WRITE_REAL3_FMT     "%.6e %.6e %.6e\n"
+#else
+#define WRITE_REAL3_FMT     "%.6g %.6g %.6g\n"
+#endif
+
+// 圧縮ファイル入力
+//   伸長スレッドはDECOMP_BLOCK_SIZE単位で伸長し、最大DECOMP_QUEUE_NUM個先行する
+#define DECOMP_NONE         0
+#define DECOMP_GZIP         1
+#define DECOMP_ZSTD         2
+#define DECOMP_IN_SIZE      (256*1024)      // 圧縮データ読み込みサイズ(byte)
+#define DECOMP_BLOCK_SIZE   (1024*1024)     // 伸長ブロックサイズ(byte)
+#define DECOMP_QUEUE_NUM    4               // 先行伸長ブロック数
+#define DECOMP_PUTBACK      16              // putback領域サイズ(byte)
+
 // プライベート（static）関数 プロトタイプ宣言
 static void tt_invert_byte_order(void* _mem, int size, int n);
 static int  tt_check_machine_endian();
 static void tt_read(istream& is, void* _data, int size, int n, int inv);
 static void tt_write(ostream& os, const void* _data, int size, int n, int inv);
+static char* write_buff_flush(ostream& os, vector<char>& buff, char* p, size_t margin);
+static char* put_line(char* p, const char* head, const Vec3<PL_REAL>& v);
+static POLYLIB_STAT plb_parse(const char* pbuff, size_t fsize, const string& fname,
+                              vector<Triangle*>* tri_list, int* num_tri, PL_REAL scale,
+                              string* group_path, vector<VNodeFlat>* nodes,
+                              vector<long long int>* elem_idx, int* srch_mode);
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -52,7 +111,7 @@ POLYLIB_STAT stl_a_load(
     PL_REAL         scale
 ) 
 {
-    ifstream is(fname.c_str());
+    PolygonIfstream is(fname.c_str());
     if (is.fail()) {
         PL_ERROSH << "[ERROR]FileIO_func:stl_a_load():Can't open " << fname << endl;
         return PLSTAT_STL_IO_ERROR;
@@ -71,7 +130,7 @@ PL_DBGOSH << "stl_a_load() ret="<<ret<<" total="<<tri_list->size()<<" eof="<<eof
 
 // ASCIIモードのSTLファイルを指定個数分読み込み
 POLYLIB_STAT stl_a_load_read(
-    ifstream&                is,
+    istream&                 is,
     std::vector<Triangle*>&  tri_list,
     int                      num_read,
     int&                     num_tri,
@@ -89,7 +148,7 @@ POLYLIB_STAT stl_a_load_read(
     Vec3<PL_REAL> vtx[3];
     //while (is >> token && !is.eof()) {
     is >> token;
-    while ( !is.eof() ) {
+    while ( !is.eof() && !is.fail() ) {
         if (token == "solid") {
             string s;
             is >> s;   // solid name  のname部分をread
@@ -178,31 +237,26 @@ POLYLIB_STAT stl_a_save(
         return PLSTAT_STL_IO_ERROR;
     }
 
-    os << "solid " << "model1" << endl;
+    // 1行毎のflushを避けるため、バッファにまとめて書き出す
+    vector<char> buff( WRITE_BUFF_SIZE );
+    char* p = &buff[0];
+    p += sprintf(p, "solid model1\n");
 
     vector<Triangle*>::iterator itr;
     for (itr = tri_list->begin(); itr != tri_list->end(); itr++) {
-#if SCIENTIFIC_OUT
-        os  << "  facet " << "normal " << setprecision(6) << scientific 
-            << (*itr)->get_normal() << endl;
-#else
-        os  << "  facet " << "normal " << setprecision(6) 
-            << (*itr)->get_normal() << endl;
-#endif
-        os << "    outer " << "loop" << endl;
+        // 1ファセット分(7行)の空きがなければ書き出す
+        p = write_buff_flush(os, buff, p, 7*WRITE_LINE_MAX);
+
+        const Vec3<PL_REAL>* vertex = (*itr)->get_vertexes();
+        p = put_line(p, "  facet normal ", (*itr)->get_normal());
+        p += sprintf(p, "    outer loop\n");
         for (int j = 0; j < 3; j++) {
-#if SCIENTIFIC_OUT
-            os  << "      vertex " << setprecision(6) << scientific 
-                << (*itr)->get_vertexes()[j] << endl;
-#else
-            os  << "      vertex " << setprecision(6) 
-                << (*itr)->get_vertexes()[j] << endl;
-#endif
+            p = put_line(p, "      vertex ", vertex[j]);
         }
-        os << "    endloop" << endl;
-        os << "  endfacet" << endl;
+        p += sprintf(p, "    endloop\n  endfacet\n");
     }
-    os << "endsolid " << "model1" << endl;
+    p += sprintf(p, "endsolid model1\n");
+    os.write(&buff[0], p - &buff[0]);
 
     if (!os.eof() && os.fail()) {
         PL_ERROSH << "[ERROR]FileIO_func:stl_a_save():Error in saving: " << fname << endl;
@@ -224,7 +278,7 @@ POLYLIB_STAT stl_b_load(
     PL_REAL         scale
 ) 
 {
-    ifstream ifs(fname.c_str(), ios::in | ios::binary);
+    PolygonIfstream ifs(fname.c_str(), ios::in | ios::binary);
     if (ifs.fail()) {
         PL_ERROSH << "[ERROR]FileIO_func:stl_b_load():Can't open " << fname << endl;
         return PLSTAT_STL_IO_ERROR;
@@ -243,7 +297,7 @@ PL_DBGOSH << "npt_b_load() ret="<<ret<<" total="<<tri_list->size()<<" eof="<<eof
 
 // バイナリモードのSTLファイルのヘッダ部を読み飛ばす
 POLYLIB_STAT stl_b_load_read_head(
-        ifstream&                ifs
+        istream&                 ifs
     ) 
 {
     int inv = tt_check_machine_endian() == TT_LITTLE_ENDIAN ? 0 : 1;
@@ -261,7 +315,7 @@ POLYLIB_STAT stl_b_load_read_head(
 // バイナリモードのSTLファイルからポリゴン指定個数分読み込み
 //      ファイルからは単精度実数(4byte)で読み込む
 POLYLIB_STAT stl_b_load_read(
-    ifstream&           ifs,
+    istream&            ifs,
     vector<Triangle*>&  tri_list, 
     int                 num_read,
     int&                num_tri,
@@ -285,6 +339,9 @@ POLYLIB_STAT stl_b_load_read(
             eof = true;
             break;
         }
+        if ( ifs.fail() ) {
+            break;  // 読み込みエラー(圧縮ファイルの伸長エラー等)
+        }
         
         Vec3<PL_REAL> normal;
         normal.x = nml[0];
@@ -364,31 +421,39 @@ POLYLIB_STAT stl_b_save(
     tt_write(ofs, buf, 1, STL_HEAD, inv);
     tt_write(ofs, &element, sizeof(uint), 1, inv);
 
-    for (uint m = 0; m < element; m++) {
-        Vec3<PL_REAL>* vertex = (*tri_list)[m]->get_vertexes();
-        Vec3<PL_REAL>  norm = (*tri_list)[m]->get_normal();
-
-        // PL_REAL -> float 変換
-        float vtx[3][3];
-        float nml[3];
-
-        vtx[0][0] = vertex[0].x;  vtx[0][1]= vertex[0].y;  vtx[0][2] = vertex[0].z;
-        vtx[1][0] = vertex[1].x;  vtx[1][1]= vertex[1].y;  vtx[1][2] = vertex[1].z;
-        vtx[2][0] = vertex[2].x;  vtx[2][1]= vertex[2].y;  vtx[2][2] = vertex[2].z;
-        nml[0] = norm.x;  nml[1]= norm.y;  nml[2] = norm.z;
+    // ポリゴンはバッファに一括で変換してから書き出す
+    //   1ポリゴン : 法線・3頂点(float×12) + ユーザ定義ID(2byte)
+    const size_t rec_size = 12*sizeof(float) + sizeof(ushort);
+    const uint   num_rec  = WRITE_BUFF_SIZE / rec_size;
+    vector<char> buff( num_rec*rec_size );
+
+    for (uint m0 = 0; m0 < element; m0 += num_rec) {
+        uint m1 = (element-m0 < num_rec) ? element : m0+num_rec;
+        char* p = &buff[0];
+        for (uint m = m0; m < m1; m++) {
+            const Vec3<PL_REAL>* vertex = (*tri_list)[m]->get_vertexes();
+            Vec3<PL_REAL>  norm = (*tri_list)[m]->get_normal();
+
+            // PL_REAL -> float 変換
+            PL_REAL rec_tmp[12];
+            float   rec[12];
+            VEC3_TO_REAL( norm, (rec_tmp+0) );
+            VEC3_3_TO_REAL9( vertex, (rec_tmp+3) );
+            for (int j = 0; j < 12; j++) {
+                rec[j] = rec_tmp[j];
+            }
 
-        // write plane normal
-        tt_write(ofs, nml, sizeof(float), 3, inv);
+            // ２バイト予備領域にユーザ定義IDを記録(Polylib-2.1より)
+            ushort exid_2b = (*tri_list)[m]->get_exid();
 
-        // write vertex
-        for(int j=0; j<3; j++ ) {
-            tt_write(ofs, vtx[j], sizeof(float), 3, inv);
+            if (inv) {
+                tt_invert_byte_order(rec, sizeof(float), 12);
+                tt_invert_byte_order(&exid_2b, sizeof(ushort), 1);
+            }
+            memcpy(p, rec, 12*sizeof(float));   p += 12*sizeof(float);
+            memcpy(p, &exid_2b, sizeof(ushort)); p += sizeof(ushort);
         }
-
-        // ２バイト予備領域にユーザ定義IDを記録(Polylib-2.1より)
-        int exid = (*tri_list)[m]->get_exid();
-        ushort exid_2b = exid;
-        tt_write(ofs, &exid_2b, sizeof(ushort), 1, inv);
+        ofs.write(&buff[0], p - &buff[0]);
     }
 
     if (!ofs.eof() && ofs.fail()) {
@@ -410,7 +475,7 @@ bool is_stl_a(const string& path)
     size_t      i = 0;
     char        c;
 
-    ifstream ifs(path.c_str());
+    PolygonIfstream ifs(path.c_str());
     if (!ifs)                  return false;
 
     // ファイル内容の一部を読み込み
@@ -443,7 +508,7 @@ POLYLIB_STAT npt_a_load(
         PL_REAL      scale
     )
 {
-    ifstream is(fname.c_str());
+    PolygonIfstream is(fname.c_str());
     if (is.fail()) {
         PL_ERROSH << "[ERROR]FileIO_func:npt_a_load():Can't open " << fname << endl;
         return PLSTAT_NPT_IO_ERROR;
@@ -463,7 +528,7 @@ PL_DBGOSH << "npt_a_load() ret="<<ret<<" total="<<tri_list->size()<<" eof="<<eof
 
 // ASCIIモードの長田パッチファイルのヘッダ部を読み飛ばす
 POLYLIB_STAT npt_a_load_read_head(
-        ifstream&                is
+        istream&                 is
     )
 {
     // ファセット数読み込み
@@ -475,7 +540,7 @@ POLYLIB_STAT npt_a_load_read_head(
 
 // ASCIIモードの長田パッチファイルを読み込み、tri_listに三角形ポリゴン情報を設定する
 POLYLIB_STAT npt_a_load_read(
-        ifstream&                    is,
+        istream&                     is,
         //std::vector<NptTriangle*>&   tri_list, 
         std::vector<Triangle*>&   tri_list, 
         int                          num_read,
@@ -593,41 +658,32 @@ POLYLIB_STAT npt_a_save(
 //    PL_DBGOSH<<__FUNCTION__ << " num_tri="<<num_tri<<endl;
 //#endif
 
-    os << num_tri << endl;
+    // 1行毎のflushを避けるため、バッファにまとめて書き出す
+    vector<char> buff( WRITE_BUFF_SIZE );
+    char* p = &buff[0];
+    p += sprintf(p, "%d\n", num_tri);
 
     for ( int i=0; i<num_tri; i++ ) {
-        Vec3<PL_REAL>* vertex = (*tri_list)[i]->get_vertexes();
-        const NpatchParam*   npatch = (*tri_list)[i]->get_npatch_param();
-        
-        
-        os  << "facet" << endl;
+        // 1ファセット分(11行)の空きがなければ書き出す
+        p = write_buff_flush(os, buff, p, 11*WRITE_LINE_MAX);
 
-#if SCIENTIFIC_OUT
-        os  << "  vertex " << setprecision(6) << scientific << vertex[0] << endl;
-        os  << "  vertex " << setprecision(6) << scientific << vertex[1] << endl;
-        os  << "  vertex " << setprecision(6) << scientific << vertex[2] << endl;
-
-        os  << "  coef1 " << setprecision(6) << scientific << npatch->cp_side1_1 << endl;
-        os  << "  coef2 " << setprecision(6) << scientific << npatch->cp_side1_2 << endl;
-        os  << "  coef3 " << setprecision(6) << scientific << npatch->cp_side2_1 << endl;
-        os  << "  coef4 " << setprecision(6) << scientific << npatch->cp_side2_2 << endl;
-        os  << "  coef5 " << setprecision(6) << scientific << npatch->cp_side3_1 << endl;
-        os  << "  coef6 " << setprecision(6) << scientific << npatch->cp_side3_2 << endl;
-        os  << "  coef7 " << setprecision(6) << scientific << npatch->cp_center  << endl;
-#else
-        os  << "  vertex " << setprecision(6) << vertex[0] << endl;
-        os  << "  vertex " << setprecision(6) << vertex[1] << endl;
-        os  << "  vertex " << setprecision(6) << vertex[2] << endl;
+        const Vec3<PL_REAL>* vertex = (*tri_list)[i]->get_vertexes();
+        const NpatchParam*   npatch = (*tri_list)[i]->get_npatch_param();
 
-        os  << "  coef1 " << setprecision(6) << npatch->cp_side1_1 << endl;
-        os  << "  coef2 " << setprecision(6) << npatch->cp_side1_2 << endl;
-        os  << "  coef3 " << setprecision(6) << npatch->cp_side2_1 << endl;
-        os  << "  coef4 " << setprecision(6) << npatch->cp_side2_2 << endl;
-        os  << "  coef5 " << setprecision(6) << npatch->cp_side3_1 << endl;
-        os  << "  coef6 " << setprecision(6) << npatch->cp_side3_2 << endl;
-        os  << "  coef7 " << setprecision(6) << npatch->cp_center  << endl;
-#endif
+        p += sprintf(p, "facet\n");
+        p = put_line(p, "  vertex ", vertex[0]);
+        p = put_line(p, "  vertex ", vertex[1]);
+        p = put_line(p, "  vertex ", vertex[2]);
+
+        p = put_line(p, "  coef1 ", npatch->cp_side1_1);
+        p = put_line(p, "  coef2 ", npatch->cp_side1_2);
+        p = put_line(p, "  coef3 ", npatch->cp_side2_1);
+        p = put_line(p, "  coef4 ", npatch->cp_side2_2);
+        p = put_line(p, "  coef5 ", npatch->cp_side3_1);
+        p = put_line(p, "  coef6 ", npatch->cp_side3_2);
+        p = put_line(p, "  coef7 ", npatch->cp_center);
     }
+    os.write(&buff[0], p - &buff[0]);
 
     if (!os.eof() && os.fail()) {
         PL_ERROSH << "[ERROR]FileIO_func:npt_a_save():Error in saving: " << fname << endl;
@@ -647,7 +703,7 @@ POLYLIB_STAT npt_b_load(
         PL_REAL                     scale
     )
 {
-    ifstream ifs(fname.c_str(), ios::in | ios::binary);
+    PolygonIfstream ifs(fname.c_str(), ios::in | ios::binary);
     if (ifs.fail()) {
         PL_ERROSH << "[ERROR]FileIO_func:npt_b_load():Can't open " << fname << endl;
         return PLSTAT_NPT_IO_ERROR;
@@ -666,7 +722,7 @@ PL_DBGOSH << "npt_b_load() ret="<<ret<<" total="<<tri_list->size()<<" eof="<<eof
 
 
 // バイナリモードの長田パッチファイルのヘッダ部を読み飛ばす
-POLYLIB_STAT npt_b_load_read_head( ifstream& ifs )
+POLYLIB_STAT npt_b_load_read_head( istream& ifs )
 {
     int inv = tt_check_machine_endian() == TT_LITTLE_ENDIAN ? 0 : 1;
     uint    element = 0;
@@ -677,7 +733,7 @@ POLYLIB_STAT npt_b_load_read_head( ifstream& ifs )
 // バイナリモードの長田パッチファイルからポリゴン指定個数分読み込み
 //      ファイルからは単精度実数(4byte)で読み込む
 POLYLIB_STAT npt_b_load_read(
-        ifstream&                ifs,
+        istream&                 ifs,
         std::vector<Triangle*>&  tri_list, 
         int                      num_read,
         int&                     num_tri,
@@ -706,8 +762,8 @@ POLYLIB_STAT npt_b_load_read(
                 vtx[j][k] *= scale;
             }
         }
-        if( eof ) {
-            break;
+        if( eof || ifs.fail() ) {
+            break;  // 読み込みエラー(圧縮ファイルの伸長エラー等)はループ後に判定
         }
         
         // read npach parameter
@@ -781,36 +837,35 @@ POLYLIB_STAT npt_b_save(
 
     tt_write(ofs, &element, sizeof(uint), 1, inv);
 
-    for (uint i = 0; i < element; i++) {
-        Vec3<PL_REAL>* vertex = (*tri_list)[i]->get_vertexes();
-        const NpatchParam*   npatch = (*tri_list)[i]->get_npatch_param();
-
-        PL_REAL vtx_tmp[9];
-        PL_REAL param_tmp[21];
-
-        VEC3_3_TO_REAL9(vertex,vtx_tmp);
-        VEC3_TO_REAL( npatch->cp_side1_1, (param_tmp+ 0) );
-        VEC3_TO_REAL( npatch->cp_side1_2, (param_tmp+ 3) );
-        VEC3_TO_REAL( npatch->cp_side2_1, (param_tmp+ 6) );
-        VEC3_TO_REAL( npatch->cp_side2_2, (param_tmp+ 9) );
-        VEC3_TO_REAL( npatch->cp_side3_1, (param_tmp+12) );
-        VEC3_TO_REAL( npatch->cp_side3_2, (param_tmp+15) );
-        VEC3_TO_REAL( npatch->cp_center,  (param_tmp+18) );
+    // ポリゴンはバッファに一括で変換してから書き出す
+    //   1ポリゴン : 3頂点(float×9) + 長田パッチパラメータ(float×21)
+    const size_t rec_size = 30*sizeof(float);
+    const uint   num_rec  = WRITE_BUFF_SIZE / rec_size;
+    vector<char> buff( num_rec*rec_size );
+
+    for (uint m0 = 0; m0 < element; m0 += num_rec) {
+        uint m1 = (element-m0 < num_rec) ? element : m0+num_rec;
+        char* p = &buff[0];
+        for (uint i = m0; i < m1; i++) {
+            Vec3<PL_REAL>* vertex = (*tri_list)[i]->get_vertexes();
+            const NpatchParam*   npatch = (*tri_list)[i]->get_npatch_param();
+
+            // PL_REAL -> float 変換
+            PL_REAL rec_tmp[30];
+            float   rec[30];
+            VEC3_3_TO_REAL9( vertex, (rec_tmp+0) );
+            NPATCH_PARAM_TO_REAL21( (*npatch), (rec_tmp+9) );
+            for (int j = 0; j < 30; j++) {
+                rec[j] = rec_tmp[j];
+            }
 
-        // PL_REAL -> float 変換
-        float vtx[9];
-        float param[21];
-        for(int j=0; j<9; j++) {
-            vtx[j] = vtx_tmp[j];
-        }
-        for(int j=0; j<21; j++) {
-            param[j] = param_tmp[j];
+            if (inv) {
+                tt_invert_byte_order(rec, sizeof(float), 30);
+            }
+            memcpy(p, rec, rec_size);
+            p += rec_size;
         }
-
-        // write vertex
-        tt_write(ofs, vtx,   sizeof(float),  9, inv);
-        // write npach parameter
-        tt_write(ofs, param, sizeof(float), 21, inv);
+        ofs.write(&buff[0], p - &buff[0]);
     }
 
     if (!ofs.eof() && ofs.fail()) {
@@ -838,7 +893,7 @@ bool is_npt_a(
     size_t      i = 0;
     char        c;
 
-    ifstream ifs(path.c_str());
+    PolygonIfstream ifs(path.c_str());
     if (!ifs)                  return false;
 
     // 先頭行を読み飛ばす
@@ -864,10 +919,593 @@ bool is_npt_a(
     else                        return false;
 }
 
+//**************************************************************
+//   Polylibバイナリ（スナップショット）ファイル用
+//**************************************************************
+
+//////////////////////////////////////////////////////////////////////////////
+POLYLIB_STAT plb_load(
+    vector<Triangle*>           *tri_list, 
+    const string&               fname,
+    int                         *num_tri,
+    PL_REAL                     scale,
+    string                      *group_path,
+    vector<VNodeFlat>           *nodes,
+    vector<long long int>       *elem_idx,
+    int                         *srch_mode
+)
+{
+    POLYLIB_STAT ret;
+
+#if defined(_WIN32)
+    // メモリマップが使用できない環境では一括読み込み
+    ifstream ifs(fname.c_str(), ios::in | ios::binary);
+    if (ifs.fail()) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Can't open " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    ifs.seekg(0, ios::end);
+    size_t fsize = (size_t)ifs.tellg();
+    ifs.seekg(0, ios::beg);
+    vector<char> fbuff( fsize>0 ? fsize : 1 );
+    ifs.read(&fbuff[0], fsize);
+    if (ifs.fail()) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Error in loading: " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    ret = plb_parse( &fbuff[0], fsize, fname, tri_list, num_tri, scale,
+                     group_path, nodes, elem_idx, srch_mode );
+#else
+    // ファイルをメモリマップし、コピーせずに直接デシリアライズする
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Can't open " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)PLB_HEAD_SIZE) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Invalid file: " << fname << endl;
+        close(fd);
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    size_t fsize = st.st_size;
+    void* pmap = mmap(NULL, fsize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pmap == MAP_FAILED) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Can't map " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    madvise(pmap, fsize, MADV_SEQUENTIAL);
+
+    ret = plb_parse( (const char*)pmap, fsize, fname, tri_list, num_tri, scale,
+                     group_path, nodes, elem_idx, srch_mode );
+    munmap(pmap, fsize);
+#endif
+
+    return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+POLYLIB_STAT plb_save(
+    vector<Triangle*>               *tri_list, 
+    const string&                   fname,
+    const string&                   group_path,
+    const vector<VNodeFlat>&        nodes,
+    const vector<long long int>&    elem_idx,
+    int                             srch_mode
+)
+{
+    int pl_type = PL_TYPE_TRIANGLE;
+    int numAtrI = 0;
+    int numAtrR = 0;
+    long long int num_tri = tri_list->size();
+    if (num_tri > 0) {
+        pl_type = (*tri_list)[0]->get_pl_type();
+        numAtrI = (*tri_list)[0]->get_num_atrI();
+        numAtrR = (*tri_list)[0]->get_num_atrR();
+    }
+    long long int num_node  = nodes.size();
+    long long int num_elem  = elem_idx.size();
+    long long int data_size = serialized_size_polygons( pl_type, numAtrI, numAtrR, num_tri );
+
+    ofstream ofs(fname.c_str(), ios::out | ios::binary);
+    if (ofs.fail()) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_save():Can't open " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+
+    // ヘッダ部
+    char head[PLB_HEAD_SIZE];
+    int  ihead[8] = { PLB_VERSION, 1, (int)sizeof(PL_REAL), pl_type,
+                      numAtrI, numAtrR, (int)group_path.size(),
+                      srch_mode < 0 ? 0 : srch_mode+1 };
+    long long int lhead[4] = { num_tri, num_node, num_elem, data_size };
+    memset( head, 0, PLB_HEAD_SIZE );
+    memcpy( head, PLB_MAGIC, strlen(PLB_MAGIC) );
+    memcpy( head+PLB_MAGIC_LEN, ihead, 8*sizeof(int) );
+    memcpy( head+PLB_MAGIC_LEN+8*sizeof(int), lhead, 4*sizeof(long long int) );
+    ofs.write( head, PLB_HEAD_SIZE );
+
+    // グループパス
+    vector<char> path( PLB_PAD8(group_path.size())+1, 0 );
+    memcpy( &path[0], group_path.c_str(), group_path.size() );
+    ofs.write( &path[0], PLB_PAD8(group_path.size()) );
+
+    // ポリゴンデータ
+    if (num_tri > 0) {
+        vector<char> buff( data_size );
+        serialize_polygons( &(*tri_list)[0], num_tri, pl_type, numAtrI, numAtrR, &buff[0] );
+        ofs.write( &buff[0], data_size );
+    }
+
+    // KD木
+    if (num_node > 0) {
+        vector<char> buff( num_node*PLB_NODE_SIZE );
+        char* p = &buff[0];
+        for (long long int i = 0; i < num_node; i++) {
+            const VNodeFlat& nd = nodes[i];
+            long long int ldata[5] = { nd.axis, nd.left, nd.right, nd.elem_begin, nd.elem_num };
+            memcpy( p, nd.bbox,        6*sizeof(PL_REAL) );   p += 6*sizeof(PL_REAL);
+            memcpy( p, nd.bbox_search, 6*sizeof(PL_REAL) );   p += 6*sizeof(PL_REAL);
+            memcpy( p, ldata,          5*sizeof(long long int) );  p += 5*sizeof(long long int);
+        }
+        ofs.write( &buff[0], buff.size() );
+    }
+    if (num_elem > 0) {
+        ofs.write( (const char*)&elem_idx[0], num_elem*sizeof(long long int) );
+    }
+
+    if (ofs.fail()) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_save():Error in saving: " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+
+    return PLSTAT_OK;
+}
+
+//**************************************************************
+//   圧縮ファイル入力用
+//**************************************************************
+
+///
+/// 圧縮ファイル伸長用ストリームバッファ
+///   伸長スレッドで伸長したブロックを順に読み出す
+///
+class DecompressBuf : public std::streambuf {
+public:
+    DecompressBuf();
+    ~DecompressBuf();
+
+    bool open( const string& fname, int type );
+    void close();
+
+protected:
+    virtual int_type underflow();
+
+private:
+    long long int decode( char* out, size_t size );
+    bool next_block();
+#if !defined(_WIN32)
+    static void* thread_main( void* arg );
+#endif
+
+    string          m_fname;        ///< ファイル名
+    FILE*           m_fp;           ///< 圧縮ファイル
+    int             m_type;         ///< 圧縮形式
+    vector<char>    m_in;           ///< 圧縮データ
+    size_t          m_in_pos;       ///< 圧縮データ処理位置
+    size_t          m_in_len;       ///< 圧縮データ長
+    bool            m_frame_end;    ///< 圧縮フレームの終端まで伸長したか
+    vector<char>    m_get;          ///< 読み出し中ブロック(先頭はputback領域)
+    bool            m_error;        ///< 伸長エラー
+#ifdef USE_ZLIB
+    z_stream        m_zs;
+    bool            m_zs_init;
+#endif
+#ifdef USE_ZSTD
+    ZSTD_DStream*   m_zds;
+#endif
+#if !defined(_WIN32)
+    pthread_t               m_thread;
+    bool                    m_thread_running;
+    pthread_mutex_t         m_mutex;
+    pthread_cond_t          m_cond;
+    deque< vector<char>* >  m_queue;    ///< 伸長済みブロック
+    bool                    m_done;     ///< 伸長完了(またはエラー)
+    bool                    m_stop;     ///< 伸長中断要求
+#endif
+};
+
+//////////////////////////////////////////////////////////////////////////////
+DecompressBuf::DecompressBuf()
+    : m_fp(NULL), m_type(DECOMP_NONE), m_in_pos(0), m_in_len(0),
+      m_frame_end(true), m_error(false)
+{
+#ifdef USE_ZLIB
+    m_zs_init = false;
+#endif
+#ifdef USE_ZSTD
+    m_zds = NULL;
+#endif
+#if !defined(_WIN32)
+    m_thread_running = false;
+    m_done = false;
+    m_stop = false;
+    pthread_mutex_init( &m_mutex, NULL );
+    pthread_cond_init( &m_cond, NULL );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+DecompressBuf::~DecompressBuf()
+{
+    close();
+#if !defined(_WIN32)
+    pthread_cond_destroy( &m_cond );
+    pthread_mutex_destroy( &m_mutex );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool DecompressBuf::open( const string& fname, int type )
+{
+    close();
+    m_fname = fname;
+    m_type  = type;
+
+    if( type == DECOMP_GZIP ) {
+#ifdef USE_ZLIB
+        memset( &m_zs, 0, sizeof(m_zs) );
+        if( inflateInit2( &m_zs, 15+32 ) != Z_OK ) {   // gzip/zlibヘッダ自動判定
+            PL_ERROSH << "[ERROR]DecompressBuf::open():inflateInit2() failed. " << fname << endl;
+            return false;
+        }
+        m_zs_init = true;
+#else
+        PL_ERROSH << "[ERROR]DecompressBuf::open():gzip is not supported "
+                  << "(build with USE_ZLIB). " << fname << endl;
+        return false;
+#endif
+    } else if( type == DECOMP_ZSTD ) {
+#ifdef USE_ZSTD
+        m_zds = ZSTD_createDStream();
+        if( m_zds == NULL || ZSTD_isError( ZSTD_initDStream( m_zds ) ) ) {
+            PL_ERROSH << "[ERROR]DecompressBuf::open():ZSTD_initDStream() failed. " << fname << endl;
+            return false;
+        }
+#else
+        PL_ERROSH << "[ERROR]DecompressBuf::open():zstd is not supported "
+                  << "(build with USE_ZSTD). " << fname << endl;
+        return false;
+#endif
+    } else {
+        return false;
+    }
+
+    m_fp = fopen( fname.c_str(), "rb" );
+    if( m_fp == NULL ) {
+        return false;
+    }
+    m_in.resize( DECOMP_IN_SIZE );
+    m_in_pos    = 0;
+    m_in_len    = 0;
+    m_frame_end = true;
+    m_error     = false;
+    m_get.resize( DECOMP_PUTBACK + DECOMP_BLOCK_SIZE );
+    setg( &m_get[0], &m_get[DECOMP_PUTBACK], &m_get[DECOMP_PUTBACK] );
+
+#if !defined(_WIN32)
+    // 伸長スレッド起動（起動できない場合はunderflow()内で伸長する）
+    m_done = false;
+    m_stop = false;
+    if( pthread_create( &m_thread, NULL, thread_main, this ) == 0 ) {
+        m_thread_running = true;
+    }
+#endif
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void DecompressBuf::close()
+{
+#if !defined(_WIN32)
+    if( m_thread_running ) {
+        pthread_mutex_lock( &m_mutex );
+        m_stop = true;
+        pthread_cond_broadcast( &m_cond );
+        pthread_mutex_unlock( &m_mutex );
+        pthread_join( m_thread, NULL );
+        m_thread_running = false;
+    }
+    for( size_t i=0; i<m_queue.size(); i++ ) {
+        delete m_queue[i];
+    }
+    m_queue.clear();
+#endif
+    if( m_fp != NULL ) {
+        fclose( m_fp );
+        m_fp = NULL;
+    }
+#ifdef USE_ZLIB
+    if( m_zs_init ) {
+        inflateEnd( &m_zs );
+        m_zs_init = false;
+    }
+#endif
+#ifdef USE_ZSTD
+    if( m_zds != NULL ) {
+        ZSTD_freeDStream( m_zds );
+        m_zds = NULL;
+    }
+#endif
+    vector<char>().swap( m_in );
+    vector<char>().swap( m_get );
+    setg( NULL, NULL, NULL );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// 伸長データをoutに最大size byte格納する
+//   戻り値 : 格納したサイズ(0:ファイル終端) 、-1:エラー
+long long int DecompressBuf::decode( char* out, size_t size )
+{
+#if !defined(USE_ZLIB) && !defined(USE_ZSTD)
+    // 伸長ライブラリなし（open()で失敗するため通常は呼ばれない）
+    (void)out;
+    (void)size;
+    PL_ERROSH << "[ERROR]DecompressBuf::decode():compressed files are not supported "
+              << "(built without zlib/zstd). " << m_fname << endl;
+    return -1;
+#else
+    size_t produced = 0;
+    while( produced < size ) {
+        // 圧縮データ読み込み
+        if( m_in_pos == m_in_len ) {
+            m_in_pos = 0;
+            m_in_len = fread( &m_in[0], 1, m_in.size(), m_fp );
+            if( m_in_len == 0 ) {
+                if( ferror(m_fp) ) {
+                    PL_ERROSH << "[ERROR]DecompressBuf::decode():read error. " << m_fname << endl;
+                    return -1;
+                }
+                if( !m_frame_end ) {
+                    PL_ERROSH << "[ERROR]DecompressBuf::decode():unexpected end of file. " << m_fname << endl;
+                    return -1;
+                }
+                break;
+            }
+        }
+
+#ifdef USE_ZLIB
+        if( m_type == DECOMP_GZIP ) {
+            m_zs.next_in   = (Bytef*)&m_in[m_in_pos];
+            m_zs.avail_in  = (uInt)(m_in_len - m_in_pos);
+            m_zs.next_out  = (Bytef*)(out + produced);
+            m_zs.avail_out = (uInt)(size - produced);
+            m_frame_end = false;
+            int zret = inflate( &m_zs, Z_NO_FLUSH );
+            m_in_pos = m_in_len - m_zs.avail_in;
+            produced = size - m_zs.avail_out;
+            if( zret == Z_STREAM_END ) {
+                // 連結されたgzipメンバに備えてリセット
+                m_frame_end = true;
+                inflateReset( &m_zs );
+            } else if( zret != Z_OK && zret != Z_BUF_ERROR ) {
+                PL_ERROSH << "[ERROR]DecompressBuf::decode():inflate() failed. " << m_fname << endl;
+                return -1;
+            }
+        }
+#endif
+#ifdef USE_ZSTD
+        if( m_type == DECOMP_ZSTD ) {
+            ZSTD_inBuffer  zin  = { &m_in[0], m_in_len, m_in_pos };
+            ZSTD_outBuffer zout = { out, size, produced };
+            size_t zret = ZSTD_decompressStream( m_zds, &zout, &zin );
+            if( ZSTD_isError( zret ) ) {
+                PL_ERROSH << "[ERROR]DecompressBuf::decode():ZSTD_decompressStream() failed. "
+                          << ZSTD_getErrorName( zret ) << " " << m_fname << endl;
+                return -1;
+            }
+            m_in_pos    = zin.pos;
+            produced    = zout.pos;
+            m_frame_end = (zret == 0);
+        }
+#endif
+    }
+    return produced;
+#endif
+}
+
+#if !defined(_WIN32)
+//////////////////////////////////////////////////////////////////////////////
+void* DecompressBuf::thread_main( void* arg )
+{
+    DecompressBuf* p = static_cast<DecompressBuf*>(arg);
+
+    while( true ) {
+        // 先行伸長ブロック数の上限待ち
+        pthread_mutex_lock( &p->m_mutex );
+        while( p->m_queue.size() >= DECOMP_QUEUE_NUM && !p->m_stop ) {
+            pthread_cond_wait( &p->m_cond, &p->m_mutex );
+        }
+        bool stop = p->m_stop;
+        pthread_mutex_unlock( &p->m_mutex );
+        if( stop ) break;
+
+        vector<char>* blk = new vector<char>( DECOMP_BLOCK_SIZE );
+        long long int n = p->decode( &(*blk)[0], DECOMP_BLOCK_SIZE );
+
+        pthread_mutex_lock( &p->m_mutex );
+        if( n > 0 ) {
+            blk->resize( n );
+            p->m_queue.push_back( blk );
+        } else {
+            delete blk;
+            p->m_done  = true;
+            p->m_error = (n < 0);
+        }
+        pthread_cond_broadcast( &p->m_cond );
+        pthread_mutex_unlock( &p->m_mutex );
+        if( n <= 0 ) break;
+    }
+    return NULL;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+// 次の伸長ブロックを読み出し位置に設定する
+//   戻り値 : false:ファイル終端またはエラー
+bool DecompressBuf::next_block()
+{
+    // 直前のデータをputback領域に残す
+    size_t npb = gptr() - eback();
+    if( npb > DECOMP_PUTBACK ) npb = DECOMP_PUTBACK;
+    memmove( &m_get[DECOMP_PUTBACK-npb], gptr()-npb, npb );
+
+    long long int n = 0;
+#if !defined(_WIN32)
+    if( m_thread_running ) {
+        vector<char>* blk = NULL;
+        pthread_mutex_lock( &m_mutex );
+        while( m_queue.empty() && !m_done ) {
+            pthread_cond_wait( &m_cond, &m_mutex );
+        }
+        if( !m_queue.empty() ) {
+            blk = m_queue.front();
+            m_queue.pop_front();
+            pthread_cond_broadcast( &m_cond );
+        }
+        pthread_mutex_unlock( &m_mutex );
+        if( blk != NULL ) {
+            n = blk->size();
+            memcpy( &m_get[DECOMP_PUTBACK], &(*blk)[0], n );
+            delete blk;
+        }
+    } else
+#endif
+    {
+        n = decode( &m_get[DECOMP_PUTBACK], DECOMP_BLOCK_SIZE );
+        if( n < 0 ) m_error = true;
+    }
+    if( n <= 0 ) return false;
+
+    setg( &m_get[DECOMP_PUTBACK-npb], &m_get[DECOMP_PUTBACK], &m_get[DECOMP_PUTBACK+n] );
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+DecompressBuf::int_type DecompressBuf::underflow()
+{
+    if( gptr() < egptr() ) {
+        return traits_type::to_int_type( *gptr() );
+    }
+    if( m_fp == NULL || !next_block() ) {
+        // 伸長エラーはストリームのbadbitとして通知する
+        if( m_error ) throw ios_base::failure( "decompression error" );
+        return traits_type::eof();
+    }
+    return traits_type::to_int_type( *gptr() );
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// ファイル先頭のマジックナンバーより圧縮形式を判定する
+static int decomp_type( const string& fname )
+{
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+    FILE* fp = fopen( fname.c_str(), "rb" );
+    if( fp == NULL ) return DECOMP_NONE;
+    size_t n = fread( magic, 1, 4, fp );
+    fclose( fp );
+
+    if( n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b ) {
+        return DECOMP_GZIP;
+    }
+    if( n == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd ) {
+        return DECOMP_ZSTD;
+    }
+    return DECOMP_NONE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+PolygonIfstream::PolygonIfstream()
+    : std::istream(NULL), m_decomp(NULL)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+PolygonIfstream::PolygonIfstream(
+    const std::string&      fname,
+    std::ios_base::openmode mode
+)
+    : std::istream(NULL), m_decomp(NULL)
+{
+    open( fname, mode );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+PolygonIfstream::~PolygonIfstream()
+{
+    close();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void PolygonIfstream::open(
+    const std::string&      fname,
+    std::ios_base::openmode mode
+)
+{
+    close();
+
+    int type = decomp_type( fname );
+    if( type == DECOMP_NONE ) {
+        if( m_filebuf.open( fname.c_str(), mode | ios_base::in ) != NULL ) {
+            rdbuf( &m_filebuf );
+        } else {
+            setstate( ios_base::failbit );
+        }
+        return;
+    }
+
+    m_decomp = new DecompressBuf;
+    if( m_decomp->open( fname, type ) ) {
+        rdbuf( m_decomp );
+    } else {
+        delete m_decomp;
+        m_decomp = NULL;
+        setstate( ios_base::failbit );
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool PolygonIfstream::is_open() const
+{
+    return m_decomp != NULL || m_filebuf.is_open();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void PolygonIfstream::close()
+{
+    rdbuf( NULL );
+    if( m_filebuf.is_open() ) {
+        m_filebuf.close();
+    }
+    if( m_decomp != NULL ) {
+        delete m_decomp;
+        m_decomp = NULL;
+    }
+}
+
 //**************************************************************
 //   共通ＩＯ用
 //**************************************************************
 
+//////////////////////////////////////////////////////////////////////////////
+bool is_compressed_ext( const char* ext )
+{
+    return !strcmp(ext, "gz")  || !strcmp(ext, "GZ") ||
+           !strcmp(ext, "zst") || !strcmp(ext, "ZST");
+}
+
 //////////////////////////////////////////////////////////////////////////////
 char *get_fname_fr_path( const std::string& path )
 {
@@ -957,4 +1595,130 @@ static void tt_write(ostream& os, const void* _data, int size, int n, int inv)
     }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// 書き出しバッファの残りがmargin未満であれば、内容を書き出して先頭に戻す
+static char* write_buff_flush(ostream& os, vector<char>& buff, char* p, size_t margin)
+{
+    char* p_top = &buff[0];
+    if ((size_t)(p_top + buff.size() - p) < margin) {
+        os.write(p_top, p - p_top);
+        return p_top;
+    }
+    return p;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// アスキー出力 : 見出し + ベクトル(3要素)の1行をバッファに書き込む
+static char* put_line(char* p, const char* head, const Vec3<PL_REAL>& v)
+{
+    size_t len = strlen(head);
+    memcpy(p, head, len);
+    p += len;
+    p += sprintf(p, WRITE_REAL3_FMT, (double)v.x, (double)v.y, (double)v.z);
+    return p;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Polylibバイナリファイル(plb)の内容を解析し、ポリゴン・KD木を復元する
+static POLYLIB_STAT plb_parse(
+    const char*             pbuff,
+    size_t                  fsize,
+    const string&           fname,
+    vector<Triangle*>       *tri_list,
+    int                     *num_tri,
+    PL_REAL                 scale,
+    string                  *group_path,
+    vector<VNodeFlat>       *nodes,
+    vector<long long int>   *elem_idx,
+    int                     *srch_mode
+)
+{
+    int             ihead[8];
+    long long int   lhead[4];
+    if (fsize < PLB_HEAD_SIZE || strncmp( pbuff, PLB_MAGIC, PLB_MAGIC_LEN ) != 0) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Not a plb file: " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    memcpy( ihead, pbuff+PLB_MAGIC_LEN, 8*sizeof(int) );
+    memcpy( lhead, pbuff+PLB_MAGIC_LEN+8*sizeof(int), 4*sizeof(long long int) );
+
+    int version   = ihead[0];
+    int endian    = ihead[1];
+    int real_size = ihead[2];
+    int pl_type   = ihead[3];
+    int numAtrI   = ihead[4];
+    int numAtrR   = ihead[5];
+    int path_len  = ihead[6];
+    int mode      = ihead[7];
+    long long int ntri      = lhead[0];
+    long long int num_node  = lhead[1];
+    long long int num_elem  = lhead[2];
+    long long int data_size = lhead[3];
+
+    if (version != PLB_VERSION || endian != 1 || real_size != (int)sizeof(PL_REAL)) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Unsupported version/byte order/precision: "
+                  << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+    if ((pl_type != PL_TYPE_TRIANGLE && pl_type != PL_TYPE_NPT) ||
+        numAtrI < 0 || numAtrR < 0 || path_len < 0 || mode < 0 || mode > 2 ||
+        ntri < 0 || num_node < 0 || num_elem < 0 ||
+        data_size != (long long int)serialized_size_polygons( pl_type, numAtrI, numAtrR, ntri ) ||
+        fsize != PLB_HEAD_SIZE + PLB_PAD8((size_t)path_len) + data_size
+                 + num_node*PLB_NODE_SIZE + num_elem*sizeof(long long int) ) {
+        PL_ERROSH << "[ERROR]FileIO_func:plb_load():Broken file: " << fname << endl;
+        return PLSTAT_PLB_IO_ERROR;
+    }
+
+    const char* p = pbuff + PLB_HEAD_SIZE;
+    if (srch_mode != NULL) {
+        *srch_mode = mode - 1;
+    }
+    if (group_path != NULL) {
+        group_path->assign( p, path_len );
+    }
+    p += PLB_PAD8((size_t)path_len);
+
+    // ポリゴンデータ
+    size_t num_tri_prev = tri_list->size();
+    p = deserialize_polygons( pl_type, numAtrI, numAtrR, ntri, p, *tri_list );
+    *num_tri = ntri;
+
+    // スケール指定時は座標を変換する（保存されたKD木は使用できない）
+    if (scale != 1.0) {
+        for (size_t i = num_tri_prev; i < tri_list->size(); i++) {
+            (*tri_list)[i]->rescale( scale );
+        }
+        num_node = 0;
+        num_elem = 0;
+    }
+
+    // KD木
+    if (nodes != NULL) {
+        nodes->resize( num_node );
+        for (long long int i = 0; i < num_node; i++) {
+            VNodeFlat& nd = (*nodes)[i];
+            long long int ldata[5];
+            memcpy( nd.bbox,        p, 6*sizeof(PL_REAL) );   p += 6*sizeof(PL_REAL);
+            memcpy( nd.bbox_search, p, 6*sizeof(PL_REAL) );   p += 6*sizeof(PL_REAL);
+            memcpy( ldata,          p, 5*sizeof(long long int) );  p += 5*sizeof(long long int);
+            nd.axis       = ldata[0];
+            nd.left       = ldata[1];
+            nd.right      = ldata[2];
+            nd.elem_begin = ldata[3];
+            nd.elem_num   = ldata[4];
+        }
+    } else {
+        p += num_node*PLB_NODE_SIZE;
+    }
+    if (elem_idx != NULL) {
+        elem_idx->resize( num_elem );
+        if (num_elem > 0) {
+            memcpy( &(*elem_idx)[0], p, num_elem*sizeof(long long int) );
+        }
+    }
+
+    return PLSTAT_OK;
+}
+
 } //namespace PolylibNS
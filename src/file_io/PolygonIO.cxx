@@ -13,6 +13,7 @@
 #include <string>
 #include <string.h>
 
+#include "groups/VTree.h"
 #include "file_io/PolygonIO.h"
 #include "file_io/FileIO_func.h"
 
@@ -26,6 +27,7 @@ const string PolygonIO::FMT_STL_B  = "stl_b";
 const string PolygonIO::FMT_STL_BB = "stl_bb";
 const string PolygonIO::FMT_NPT_A  = "npt_a";
 const string PolygonIO::FMT_NPT_B  = "npt_b";
+const string PolygonIO::FMT_PLB    = "plb";
 const string PolygonIO::DEFAULT_FMT = PolygonIO::FMT_STL_B;
 
 /************************************************************************
@@ -101,6 +103,10 @@ POLYLIB_STAT PolygonIO::load(
         //ret = npt_b_load(npt_list, fname, &num_tri, scale);
         ret = npt_b_load(tri_list, fname, &num_tri, scale);
 
+    } else if (fmt == FMT_PLB) {
+        // 保存されたKD木は使用しない（PolygonGroupで復元する）
+        ret = plb_load(tri_list, fname, &num_tri, scale);
+
     } else {
         PL_ERROSH << "[ERROR]:PolygonIO::load():Unknown io format." << endl;
         ret = PLSTAT_UNKNOWN_FILE_FORMAT;
@@ -111,7 +117,7 @@ POLYLIB_STAT PolygonIO::load(
 
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT PolygonIO::load_file_open(
-        ifstream&           ifs, 
+        PolygonIfstream&    ifs, 
         const std::string&  fname, 
         const std::string&  fmt
     )
@@ -171,7 +177,7 @@ POLYLIB_STAT PolygonIO::load_file_open(
 }
 
 // public /////////////////////////////////////////////////////////////////////
-POLYLIB_STAT PolygonIO::load_file_close( ifstream&  ifs )
+POLYLIB_STAT PolygonIO::load_file_close( PolygonIfstream&  ifs )
 {
     ifs.close();
 	return PLSTAT_OK;
@@ -179,7 +185,7 @@ POLYLIB_STAT PolygonIO::load_file_close( ifstream&  ifs )
 
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT PolygonIO::load_file_read(
-        ifstream&           ifs, 
+        istream&            ifs, 
         const std::string&  fmt,
         vector<Triangle*>&  tri_list, 
         int                 num_read,
@@ -244,6 +250,10 @@ POLYLIB_STAT PolygonIO::save(
 
         return npt_b_save(npt_list, fname);
 
+    } else if (fmt == FMT_PLB) {
+        // KD木なしで保存（KD木付きの保存はPolygonGroupで行う）
+        return plb_save(tri_list, fname, "", vector<VNodeFlat>(), vector<long long int>(), -1);
+
     } else {
         return PLSTAT_UNKNOWN_FILE_FORMAT;
     }
@@ -258,6 +268,16 @@ string PolygonIO::input_file_format(
 
     //書式の決定
     char    *ext = get_ext_fr_path(filename);
+
+    // 圧縮ファイル(.gz/.zst)は一つ前の拡張子で判定する
+    //   Polylibバイナリファイル(plb)は圧縮不可
+    if (is_compressed_ext(ext)) {
+        string  fname_ext = get_fname_fr_path(filename);
+        ext = get_ext_fr_path(fname_ext);
+        if (!strcmp(ext, "plb") || !strcmp(ext, "PLB")) {
+            return "";
+        }
+    }
     if (!strcmp(ext, "stla") || !strcmp(ext, "STLA")) {
          return FMT_STL_A;
 
@@ -286,6 +306,8 @@ string PolygonIO::input_file_format(
             //PL_DBGOSH <<" input_file_format(): format=="<<FMT_NPT_B <<endl;
             return FMT_NPT_B;
         }
+    } else if (!strcmp(ext, "plb") || !strcmp(ext, "PLB")) {
+         return FMT_PLB;
     }
 
     return "";
@@ -313,6 +335,9 @@ std::string PolygonIO::get_extension_format(
     } else if (fmt == FMT_NPT_B) {
         extension = "nptb";
 
+    } else if (fmt == FMT_PLB) {
+        extension = "plb";
+
     } else {
         PL_ERROSH << "[ERROR]:PolygonIO::get_extension_format():Unknown io format." << endl;
     }
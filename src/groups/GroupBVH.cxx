@@ -0,0 +1,266 @@
+/*
+ * Polylib - Polygon Management Library
+ *
+ * Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+ * All rights reserved.
+ *
+ * Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+#include "Polylib.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "common/BBox.h"
+#include "polygons/Triangle.h"
+#include "groups/PolygonGroup.h"
+#include "groups/GroupBVH.h"
+#include "util/StatsRegistry.h"
+#include <algorithm>
+
+namespace PolylibNS {
+
+using namespace std;
+
+/// 探索用スタックの大きさ
+///     中央で二分割するため、木の深さはlog2(グループ数)程度
+#define GROUP_BVH_STACK_SIZE 128
+
+//
+// ノードのBBoxと矩形領域が重なるか
+//
+static inline bool node_crossed( const PL_REAL *b, const BBox& bbox )
+{
+    if (b[3] < bbox.min.x || bbox.max.x < b[0]) return false;
+    if (b[4] < bbox.min.y || bbox.max.y < b[1]) return false;
+    if (b[5] < bbox.min.z || bbox.max.z < b[2]) return false;
+    return true;
+}
+
+//
+// BBoxの中心の指定軸成分で比較
+//
+struct GroupCenterLess {
+    const vector< Vec3<PL_REAL> >   *center;
+    int                             axis;
+    bool operator()( int a, int b ) const
+    {
+        const PL_REAL *pa = (*center)[a];
+        const PL_REAL *pb = (*center)[b];
+        return pa[axis] < pb[axis];
+    }
+};
+
+
+/************************************************************************
+ *
+ * GroupBVHクラス
+ *
+ ***********************************************************************/
+// public /////////////////////////////////////////////////////////////////////
+GroupBVH::GroupBVH()
+{
+    m_revision = 0;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT GroupBVH::build(
+        const vector<PolygonGroup*>&    groups,
+        unsigned int                    revision
+    )
+{
+    m_nodes.clear();
+    m_groups = groups;
+    m_leaf_node.assign( groups.size(), -1 );
+    m_revision = revision;
+    if( groups.empty() ) {
+        return PLSTAT_OK;
+    }
+
+    m_center.resize( groups.size() );
+    for( size_t i=0; i<groups.size(); i++ ) {
+        const BBox& b = groups[i]->get_bbox();
+        m_center[i].assign( (b.min.x + b.max.x) * (PL_REAL)0.5,
+                            (b.min.y + b.max.y) * (PL_REAL)0.5,
+                            (b.min.z + b.max.z) * (PL_REAL)0.5 );
+    }
+    m_nodes.reserve( 2*groups.size() - 1 );
+    build_node( 0, (int)groups.size(), -1 );
+
+#ifdef DEBUG
+    PL_DBGOSH << "GroupBVH::build() num_group=" << m_groups.size()
+              << " num_node=" << m_nodes.size() << endl;
+#endif
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+bool GroupBVH::refit(
+        const PolygonGroup  *pg
+    )
+{
+    for( size_t i=0; i<m_groups.size(); i++ ) {
+        if( m_groups[i] != pg )     continue;
+
+        int node = m_leaf_node[i];
+        set_leaf_bbox( node );
+        for( node = m_nodes[node].parent; node >= 0; node = m_nodes[node].parent ) {
+            set_node_bbox( node );
+        }
+        return true;
+    }
+    return false;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void GroupBVH::refit( void )
+{
+    // 子ノードは親ノードより後ろにある
+    for( int node=(int)m_nodes.size()-1; node>=0; node-- ) {
+        if( m_nodes[node].left < 0 ) {
+            set_leaf_bbox( node );
+        } else {
+            set_node_bbox( node );
+        }
+    }
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT GroupBVH::search(
+        vector<Triangle*>&  tri_list,
+        vector<int>*        group_ids,
+        const BBox&         bbox,
+        bool                every
+    ) const
+{
+    if( m_nodes.empty() ) {
+        return PLSTAT_OK;
+    }
+
+    long long int num_node = 0;     // 訪れたノード数
+    int stack[GROUP_BVH_STACK_SIZE];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const GroupBVHNode &nd = m_nodes[ stack[--sp] ];
+        num_node++;
+        if( !node_crossed( nd.bbox, bbox ) )    continue;
+
+        if( nd.left < 0 ) {
+            PolygonGroup *pg = m_groups[nd.right];
+            size_t num_prev = tri_list.size();
+            POLYLIB_STAT ret = pg->search( tri_list, bbox, every );
+            if( ret != PLSTAT_OK )  return ret;
+            // 追加されたポリゴン数だけグループIDを追加する
+            if( group_ids != NULL ) {
+                group_ids->insert( group_ids->end(), tri_list.size() - num_prev,
+                                   pg->get_internal_id() );
+            }
+            continue;
+        }
+        stack[sp++] = nd.right;
+        stack[sp++] = nd.left;
+    }
+    if( StatsRegistry::is_enable() ) {
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_NODES, num_node );
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+size_t GroupBVH::memory_size() const
+{
+    size_t size = sizeof(GroupBVH);
+    size += sizeof(GroupBVHNode) * m_nodes.capacity();
+    size += sizeof(PolygonGroup*) * m_groups.capacity();
+    size += sizeof(int) * m_leaf_node.capacity();
+    size += sizeof(Vec3<PL_REAL>) * m_center.capacity();
+    return size;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+int GroupBVH::build_node(
+        int     first,
+        int     last,
+        int     parent
+    )
+{
+    int node = (int)m_nodes.size();
+    GroupBVHNode nd;
+    nd.left   = -1;
+    nd.right  = first;
+    nd.parent = parent;
+    m_nodes.push_back( nd );
+
+    if( last - first == 1 ) {
+        m_leaf_node[first] = node;
+        set_leaf_bbox( node );
+        return node;
+    }
+
+    // 中心の範囲が最長の軸で二分割
+    BBox cb;
+    cb.init();
+    for( int i=first; i<last; i++ ) {
+        cb.add( m_center[i] );
+    }
+    Vec3<PL_REAL> len = cb.max - cb.min;
+    const PL_REAL *lp = len;
+    int axis = 0;
+    if( lp[1] > lp[axis] )  axis = 1;
+    if( lp[2] > lp[axis] )  axis = 2;
+
+    vector<int> order( last - first );
+    for( int i=first; i<last; i++ ) {
+        order[i-first] = i;
+    }
+    int mid = (first + last) / 2;
+    GroupCenterLess comp;
+    comp.center = &m_center;
+    comp.axis   = axis;
+    std::nth_element( order.begin(), order.begin() + (mid-first), order.end(), comp );
+
+    // 分割順に並べ替え
+    vector<PolygonGroup*>        grp( last - first );
+    vector< Vec3<PL_REAL> >      ctr( last - first );
+    for( int i=0; i<last-first; i++ ) {
+        const Vec3<PL_REAL> &c = m_center[ order[i] ];
+        grp[i] = m_groups[ order[i] ];
+        ctr[i].assign( c.x, c.y, c.z );
+    }
+    std::copy( grp.begin(), grp.end(), m_groups.begin() + first );
+    for( int i=0; i<last-first; i++ ) {
+        m_center[first+i].assign( ctr[i].x, ctr[i].y, ctr[i].z );
+    }
+
+    int left  = build_node( first, mid, node );
+    int right = build_node( mid, last, node );
+    m_nodes[node].left  = left;
+    m_nodes[node].right = right;
+    set_node_bbox( node );
+    return node;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void GroupBVH::set_leaf_bbox( int node )
+{
+    GroupBVHNode &nd = m_nodes[node];
+    const BBox& b = m_groups[nd.right]->get_bbox();
+    nd.bbox[0] = b.min.x;   nd.bbox[1] = b.min.y;   nd.bbox[2] = b.min.z;
+    nd.bbox[3] = b.max.x;   nd.bbox[4] = b.max.y;   nd.bbox[5] = b.max.z;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void GroupBVH::set_node_bbox( int node )
+{
+    GroupBVHNode &nd = m_nodes[node];
+    const PL_REAL *l = m_nodes[nd.left].bbox;
+    const PL_REAL *r = m_nodes[nd.right].bbox;
+    for( int i=0; i<3; i++ ) {
+        nd.bbox[i]   = std::min( l[i],   r[i]   );
+        nd.bbox[i+3] = std::max( l[i+3], r[i+3] );
+    }
+}
+
+} //namespace PolylibNS
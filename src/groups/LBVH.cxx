@@ -0,0 +1,351 @@
+/*
+ * Polylib - Polygon Management Library
+ *
+ * Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+ * All rights reserved.
+ *
+ * Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+#include "Polylib.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "common/BBox.h"
+#include "polygons/Triangle.h"
+#include "groups/LBVH.h"
+#include "util/StatsRegistry.h"
+#include <algorithm>
+
+namespace PolylibNS {
+
+using namespace std;
+
+/// 探索用スタックの大きさ
+///     木の深さは共通先頭ビット数(Morton符号63bit+要素番号32bit)で抑えられる
+#define LBVH_STACK_SIZE 128
+
+//
+// 先頭の0ビット数(64bit)  x!=0であること
+//
+static inline int clz64( unsigned long long int x )
+{
+#if defined(__GNUC__)
+    return __builtin_clzll( x );
+#else
+    int n = 0;
+    while( !(x & 0x8000000000000000ULL) ) { x <<= 1; n++; }
+    return n;
+#endif
+}
+
+//
+// 先頭の0ビット数(32bit)  x!=0であること
+//
+static inline int clz32( unsigned int x )
+{
+#if defined(__GNUC__)
+    return __builtin_clz( x );
+#else
+    int n = 0;
+    while( !(x & 0x80000000U) ) { x <<= 1; n++; }
+    return n;
+#endif
+}
+
+//
+// ノードのBBoxと矩形領域が重なるか
+//
+static inline bool node_crossed( const PL_REAL *b, const BBox& bbox )
+{
+    if (b[3] < bbox.min.x || bbox.max.x < b[0]) return false;
+    if (b[4] < bbox.min.y || bbox.max.y < b[1]) return false;
+    if (b[5] < bbox.min.z || bbox.max.z < b[2]) return false;
+    return true;
+}
+
+//
+// 点とノードのBBoxの距離の2乗
+//
+static inline PL_REAL node_dist2( const PL_REAL *b, const Vec3<PL_REAL>& pos )
+{
+    const PL_REAL *p = pos;
+    PL_REAL d2 = 0.0;
+    for( int i=0; i<3; i++ ) {
+        PL_REAL d = 0.0;
+        if( p[i] < b[i] )           d = b[i] - p[i];
+        else if( p[i] > b[i+3] )    d = p[i] - b[i+3];
+        d2 += d*d;
+    }
+    return d2;
+}
+
+
+/************************************************************************
+ *
+ * LBVHクラス
+ *
+ ***********************************************************************/
+// public /////////////////////////////////////////////////////////////////////
+LBVH::LBVH()
+{
+    m_num = 0;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT LBVH::build(
+        const vector<Triangle*>     *tri_list,
+        const BBox&                 bbox
+    )
+{
+    int n = (int)tri_list->size();
+    m_num = n;
+    if( n == 0 ) {
+        return PLSTAT_OK;
+    }
+
+    // 配列領域は前回分を再利用する（縮小はしない）
+    m_code.resize( n );
+    m_code_tmp.resize( n );
+    m_idx.resize( n );
+    m_idx_tmp.resize( n );
+    m_tri.resize( n );
+    m_nodes.resize( 2*n-1 );
+    m_parent.resize( 2*n-1 );
+    m_visit.assign( n-1, 0 );
+
+    // 重心のMorton符号
+    unsigned long long int code_or = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:code_or)
+#endif
+    for( int i=0; i<n; i++ ) {
+        const Vec3<PL_REAL> *v = (*tri_list)[i]->get_vertexes();
+        Vec3<PL_REAL> c = (v[0] + v[1] + v[2]) / (PL_REAL)3.0;
+        m_code[i] = morton_code( c, bbox );
+        m_idx[i]  = i;
+        code_or  |= m_code[i];
+    }
+
+    // 基数ソート(8bit毎、使用しているビットのみ)
+    int nbits = (code_or == 0) ? 0 : 64 - clz64( code_or );
+    for( int shift=0; shift<nbits; shift+=8 ) {
+        size_t cnt[257];
+        for( int b=0; b<257; b++ )  cnt[b] = 0;
+        for( int i=0; i<n; i++ ) {
+            cnt[ ((m_code[i] >> shift) & 0xff) + 1 ]++;
+        }
+        for( int b=0; b<256; b++ )  cnt[b+1] += cnt[b];
+        for( int i=0; i<n; i++ ) {
+            size_t k = cnt[ (m_code[i] >> shift) & 0xff ]++;
+            m_code_tmp[k] = m_code[i];
+            m_idx_tmp[k]  = m_idx[i];
+        }
+        m_code.swap( m_code_tmp );
+        m_idx.swap( m_idx_tmp );
+    }
+
+    // リーフ
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for( int k=0; k<n; k++ ) {
+        Triangle *tri = (*tri_list)[ m_idx[k] ];
+        BBox b = tri->get_bbox( true );     // VElementと同じBBox
+        LBVHNode &nd = m_nodes[n-1+k];
+        nd.bbox[0] = b.min.x;  nd.bbox[1] = b.min.y;  nd.bbox[2] = b.min.z;
+        nd.bbox[3] = b.max.x;  nd.bbox[4] = b.max.y;  nd.bbox[5] = b.max.z;
+        nd.left  = -1;
+        nd.right = k;
+        m_tri[k] = tri;
+    }
+
+    // 内部ノード（各ノード独立に決定）
+    m_parent[0] = -1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for( int i=0; i<n-1; i++ ) {
+        build_node( i );
+    }
+
+    // BBoxをリーフから集約する
+    //   子ノードの2回目の到達で両方の子のBBoxが確定している
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for( int k=0; k<n; k++ ) {
+        int p = m_parent[n-1+k];
+        while( p >= 0 ) {
+            int v;
+#ifdef _OPENMP
+#pragma omp flush
+#pragma omp atomic capture
+#endif
+            v = m_visit[p]++;
+            if( v == 0 )    break;      // もう一方の子が未確定
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+            LBVHNode &nd = m_nodes[p];
+            const PL_REAL *l = m_nodes[nd.left].bbox;
+            const PL_REAL *r = m_nodes[nd.right].bbox;
+            for( int j=0; j<3; j++ ) {
+                nd.bbox[j]   = min( l[j],   r[j]   );
+                nd.bbox[j+3] = max( l[j+3], r[j+3] );
+            }
+            p = m_parent[p];
+        }
+    }
+
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT LBVH::search(
+        vector<Triangle*>&  tri_list,
+        const BBox&         bbox,
+        bool                every
+    ) const
+{
+    if( m_num == 0 ) {
+        return PLSTAT_OK;
+    }
+
+    long long int cnt[2] = { 0, 0 };     // 訪れたノード数、判定したリーフ数
+    int stack[LBVH_STACK_SIZE];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const LBVHNode &nd = m_nodes[ stack[--sp] ];
+        cnt[0]++;
+        if( !node_crossed( nd.bbox, bbox ) )    continue;
+
+        if( nd.left < 0 ) {
+            cnt[1]++;
+            Triangle *tri = m_tri[nd.right];
+            if( every ) {
+                const Vec3<PL_REAL> *v = tri->get_vertexes();
+                if( bbox.contain(v[0]) && bbox.contain(v[1]) && bbox.contain(v[2]) ) {
+                    tri_list.push_back( tri );
+                }
+            } else {
+                tri_list.push_back( tri );
+            }
+            continue;
+        }
+        stack[sp++] = nd.right;
+        stack[sp++] = nd.left;
+    }
+    if( StatsRegistry::is_enable() ) {
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_NODES,  cnt[0] );
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_LEAVES, cnt[1] );
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+const Triangle* LBVH::search_nearest(
+        const Vec3<PL_REAL>&    pos
+    ) const
+{
+    if( m_num == 0 ) {
+        return NULL;
+    }
+
+    const Triangle *tri_min = NULL;
+    PL_REAL dist2_min = 0.0;
+
+    int stack[LBVH_STACK_SIZE];
+    int sp = 0;
+    stack[sp++] = 0;
+    while( sp > 0 ) {
+        const LBVHNode &nd = m_nodes[ stack[--sp] ];
+        // BBoxまでの距離が現在の最小距離以上のノードは探索しない
+        if( tri_min != NULL && node_dist2( nd.bbox, pos ) >= dist2_min )    continue;
+
+        if( nd.left < 0 ) {
+            const Triangle *tri = m_tri[nd.right];
+            const Vec3<PL_REAL> *v = tri->get_vertexes();
+            Vec3<PL_REAL> c = (v[0] + v[1] + v[2]) / (PL_REAL)3.0;
+            PL_REAL dist2 = (c - pos).lengthSquared();
+            if( tri_min == NULL || dist2 < dist2_min ) {
+                tri_min   = tri;
+                dist2_min = dist2;
+            }
+            continue;
+        }
+        // 近い方の子ノードを先に探索
+        PL_REAL dl = node_dist2( m_nodes[nd.left].bbox,  pos );
+        PL_REAL dr = node_dist2( m_nodes[nd.right].bbox, pos );
+        if( dl <= dr ) {
+            stack[sp++] = nd.right;
+            stack[sp++] = nd.left;
+        } else {
+            stack[sp++] = nd.left;
+            stack[sp++] = nd.right;
+        }
+    }
+    return tri_min;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+size_t LBVH::memory_size() const
+{
+    size_t size = sizeof(LBVH);
+    size += sizeof(LBVHNode) * m_nodes.capacity();
+    size += sizeof(int) * ( m_parent.capacity() + m_visit.capacity()
+                          + m_idx.capacity() + m_idx_tmp.capacity() );
+    size += sizeof(unsigned long long int) * ( m_code.capacity() + m_code_tmp.capacity() );
+    size += sizeof(Triangle*) * m_tri.capacity();
+    return size;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+int LBVH::delta( int i, int j ) const
+{
+    if( j < 0 || j >= m_num )   return -1;
+    unsigned long long int x = m_code[i] ^ m_code[j];
+    if( x == 0 ) {
+        return 64 + clz32( (unsigned int)(i ^ j) );
+    }
+    return clz64( x );
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void LBVH::build_node( int i )
+{
+    // ノードが受け持つ範囲の方向
+    int d = ( delta(i, i+1) - delta(i, i-1) >= 0 ) ? 1 : -1;
+
+    // 範囲の他端を探索
+    int dmin = delta( i, i-d );
+    int lmax = 2;
+    while( delta( i, i+lmax*d ) > dmin )    lmax *= 2;
+    int l = 0;
+    for( int t=lmax/2; t>=1; t/=2 ) {
+        if( delta( i, i+(l+t)*d ) > dmin )  l += t;
+    }
+    int j = i + l*d;
+
+    // 範囲内の分割位置を探索
+    int dnode = delta( i, j );
+    int s = 0;
+    int t = l;
+    do {
+        t = (t+1) / 2;
+        if( delta( i, i+(s+t)*d ) > dnode ) s += t;
+    } while( t > 1 );
+    int gamma = i + s*d + min( d, 0 );
+
+    // 子ノード（範囲の端であればリーフ）
+    int left  = ( min(i,j) == gamma )   ? m_num-1+gamma   : gamma;
+    int right = ( max(i,j) == gamma+1 ) ? m_num-1+gamma+1 : gamma+1;
+    m_nodes[i].left  = left;
+    m_nodes[i].right = right;
+    m_parent[left]   = i;
+    m_parent[right]  = i;
+}
+
+} //namespace PolylibNS
@@ -0,0 +1,253 @@
+/*
+ * Polylib - Polygon Management Library
+ *
+ * Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+ * All rights reserved.
+ *
+ * Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+#include "common/PolylibCommon.h"
+#include "groups/LeafKernel.h"
+
+// x86のGCC互換コンパイラでは、SSE/AVX2版を関数単位の命令セット指定で作成し
+// 実行時にCPUの対応命令で切り替える
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define PL_LEAF_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace PolylibNS {
+
+/// リーフ判定カーネルの関数型
+typedef int (*LeafBoxFunc)( const PL_REAL*, const PL_REAL*, int, int,
+                            const PL_REAL*, bool, int* );
+
+//
+// スカラー版
+//
+static int box_test_scalar(
+    const PL_REAL   *bmin,
+    const PL_REAL   *bmax,
+    int             stride,
+    int             num,
+    const PL_REAL   q[6],
+    bool            contain,
+    int             *hit
+) {
+    const PL_REAL *x0 = bmin, *y0 = bmin + stride, *z0 = bmin + 2*stride;
+    const PL_REAL *x1 = bmax, *y1 = bmax + stride, *z1 = bmax + 2*stride;
+    int n = 0;
+    if( contain ) {
+        for( int i=0; i<num; i++ ) {
+            if( q[0] <= x0[i] && x1[i] <= q[3] &&
+                q[1] <= y0[i] && y1[i] <= q[4] &&
+                q[2] <= z0[i] && z1[i] <= q[5] ) {
+                hit[n++] = i;
+            }
+        }
+    } else {
+        // BBox::crossed()と同じ判定
+        for( int i=0; i<num; i++ ) {
+            if( x1[i] < q[0] || q[3] < x0[i] )  continue;
+            if( y1[i] < q[1] || q[4] < y0[i] )  continue;
+            if( z1[i] < q[2] || q[5] < z0[i] )  continue;
+            hit[n++] = i;
+        }
+    }
+    return n;
+}
+
+#ifdef PL_LEAF_KERNEL_X86
+
+// 判定結果のビットマスクから要素番号を取り出す
+#define LEAF_PUSH_HITS( bits, base )                \
+    while( bits ) {                                 \
+        hit[n++] = (base) + __builtin_ctz( bits );  \
+        bits &= bits - 1;                           \
+    }
+
+#ifdef _REAL_IS_DOUBLE_
+#define SSE_LANES       2
+#define SSE_VEC         __m128d
+#define SSE_LOAD        _mm_loadu_pd
+#define SSE_SET1        _mm_set1_pd
+#define SSE_LT          _mm_cmplt_pd
+#define SSE_LE          _mm_cmple_pd
+#define SSE_OR          _mm_or_pd
+#define SSE_AND         _mm_and_pd
+#define SSE_MASK        _mm_movemask_pd
+#define AVX_LANES       4
+#define AVX_VEC         __m256d
+#define AVX_LOAD        _mm256_loadu_pd
+#define AVX_SET1        _mm256_set1_pd
+#define AVX_LT(a,b)     _mm256_cmp_pd( a, b, _CMP_LT_OQ )
+#define AVX_LE(a,b)     _mm256_cmp_pd( a, b, _CMP_LE_OQ )
+#define AVX_OR          _mm256_or_pd
+#define AVX_AND         _mm256_and_pd
+#define AVX_MASK        _mm256_movemask_pd
+#else
+#define SSE_LANES       4
+#define SSE_VEC         __m128
+#define SSE_LOAD        _mm_loadu_ps
+#define SSE_SET1        _mm_set1_ps
+#define SSE_LT          _mm_cmplt_ps
+#define SSE_LE          _mm_cmple_ps
+#define SSE_OR          _mm_or_ps
+#define SSE_AND         _mm_and_ps
+#define SSE_MASK        _mm_movemask_ps
+#define AVX_LANES       8
+#define AVX_VEC         __m256
+#define AVX_LOAD        _mm256_loadu_ps
+#define AVX_SET1        _mm256_set1_ps
+#define AVX_LT(a,b)     _mm256_cmp_ps( a, b, _CMP_LT_OQ )
+#define AVX_LE(a,b)     _mm256_cmp_ps( a, b, _CMP_LE_OQ )
+#define AVX_OR          _mm256_or_ps
+#define AVX_AND         _mm256_and_ps
+#define AVX_MASK        _mm256_movemask_ps
+#endif
+
+//
+// SSE版
+//   SoA配列は1行がPL_LEAF_SOA_ALIGNの倍数のため、端数の要素も読み込める
+//
+__attribute__((target("sse2")))
+static int box_test_sse(
+    const PL_REAL   *bmin,
+    const PL_REAL   *bmax,
+    int             stride,
+    int             num,
+    const PL_REAL   q[6],
+    bool            contain,
+    int             *hit
+) {
+    const PL_REAL *x0 = bmin, *y0 = bmin + stride, *z0 = bmin + 2*stride;
+    const PL_REAL *x1 = bmax, *y1 = bmax + stride, *z1 = bmax + 2*stride;
+    SSE_VEC qx0 = SSE_SET1( q[0] ), qy0 = SSE_SET1( q[1] ), qz0 = SSE_SET1( q[2] );
+    SSE_VEC qx1 = SSE_SET1( q[3] ), qy1 = SSE_SET1( q[4] ), qz1 = SSE_SET1( q[5] );
+    int n = 0;
+    for( int i=0; i<num; i+=SSE_LANES ) {
+        unsigned int bits;
+        if( contain ) {
+            SSE_VEC m = SSE_AND( SSE_LE( qx0, SSE_LOAD(x0+i) ), SSE_LE( SSE_LOAD(x1+i), qx1 ) );
+            m = SSE_AND( m, SSE_AND( SSE_LE( qy0, SSE_LOAD(y0+i) ), SSE_LE( SSE_LOAD(y1+i), qy1 ) ) );
+            m = SSE_AND( m, SSE_AND( SSE_LE( qz0, SSE_LOAD(z0+i) ), SSE_LE( SSE_LOAD(z1+i), qz1 ) ) );
+            bits = (unsigned int)SSE_MASK( m );
+        } else {
+            SSE_VEC s = SSE_OR( SSE_LT( SSE_LOAD(x1+i), qx0 ), SSE_LT( qx1, SSE_LOAD(x0+i) ) );
+            s = SSE_OR( s, SSE_OR( SSE_LT( SSE_LOAD(y1+i), qy0 ), SSE_LT( qy1, SSE_LOAD(y0+i) ) ) );
+            s = SSE_OR( s, SSE_OR( SSE_LT( SSE_LOAD(z1+i), qz0 ), SSE_LT( qz1, SSE_LOAD(z0+i) ) ) );
+            bits = ~(unsigned int)SSE_MASK( s ) & ((1u << SSE_LANES) - 1);
+        }
+        if( num - i < SSE_LANES ) {
+            bits &= (1u << (num - i)) - 1;
+        }
+        LEAF_PUSH_HITS( bits, i );
+    }
+    return n;
+}
+
+//
+// AVX2版
+//
+__attribute__((target("avx2")))
+static int box_test_avx2(
+    const PL_REAL   *bmin,
+    const PL_REAL   *bmax,
+    int             stride,
+    int             num,
+    const PL_REAL   q[6],
+    bool            contain,
+    int             *hit
+) {
+    const PL_REAL *x0 = bmin, *y0 = bmin + stride, *z0 = bmin + 2*stride;
+    const PL_REAL *x1 = bmax, *y1 = bmax + stride, *z1 = bmax + 2*stride;
+    AVX_VEC qx0 = AVX_SET1( q[0] ), qy0 = AVX_SET1( q[1] ), qz0 = AVX_SET1( q[2] );
+    AVX_VEC qx1 = AVX_SET1( q[3] ), qy1 = AVX_SET1( q[4] ), qz1 = AVX_SET1( q[5] );
+    int n = 0;
+    for( int i=0; i<num; i+=AVX_LANES ) {
+        unsigned int bits;
+        if( contain ) {
+            AVX_VEC m = AVX_AND( AVX_LE( qx0, AVX_LOAD(x0+i) ), AVX_LE( AVX_LOAD(x1+i), qx1 ) );
+            m = AVX_AND( m, AVX_AND( AVX_LE( qy0, AVX_LOAD(y0+i) ), AVX_LE( AVX_LOAD(y1+i), qy1 ) ) );
+            m = AVX_AND( m, AVX_AND( AVX_LE( qz0, AVX_LOAD(z0+i) ), AVX_LE( AVX_LOAD(z1+i), qz1 ) ) );
+            bits = (unsigned int)AVX_MASK( m );
+        } else {
+            AVX_VEC s = AVX_OR( AVX_LT( AVX_LOAD(x1+i), qx0 ), AVX_LT( qx1, AVX_LOAD(x0+i) ) );
+            s = AVX_OR( s, AVX_OR( AVX_LT( AVX_LOAD(y1+i), qy0 ), AVX_LT( qy1, AVX_LOAD(y0+i) ) ) );
+            s = AVX_OR( s, AVX_OR( AVX_LT( AVX_LOAD(z1+i), qz0 ), AVX_LT( qz1, AVX_LOAD(z0+i) ) ) );
+            bits = ~(unsigned int)AVX_MASK( s ) & ((1u << AVX_LANES) - 1);
+        }
+        if( num - i < AVX_LANES ) {
+            bits &= (1u << (num - i)) - 1;
+        }
+        LEAF_PUSH_HITS( bits, i );
+    }
+    return n;
+}
+
+#endif  // PL_LEAF_KERNEL_X86
+
+/// 選択中のカーネル
+///     検索中に書き換えないよう、静的初期化時に一度だけ選択する
+///     (静的初期化前に呼ばれた場合もスカラー版で動作する)
+static LeafBoxFunc  leaf_box_func = box_test_scalar;
+static int          leaf_box_type = PL_KERNEL_SCALAR;
+
+/// 静的初期化時のカーネル選択
+struct LeafKernelInit {
+    LeafKernelInit() { leaf_kernel_select( PL_KERNEL_AUTO ); }
+};
+static LeafKernelInit   leaf_kernel_init;
+
+// public /////////////////////////////////////////////////////////////////////
+int leaf_kernel_select( int type )
+{
+#ifdef PL_LEAF_KERNEL_X86
+    __builtin_cpu_init();
+    bool has_avx2 = __builtin_cpu_supports( "avx2" );
+    bool has_sse  = __builtin_cpu_supports( "sse2" );
+    if( (type == PL_KERNEL_AVX2 && !has_avx2) || (type == PL_KERNEL_SSE && !has_sse) ) {
+        type = PL_KERNEL_AUTO;
+    }
+    if( type == PL_KERNEL_AUTO ) {
+        type = has_avx2 ? PL_KERNEL_AVX2 : ( has_sse ? PL_KERNEL_SSE : PL_KERNEL_SCALAR );
+    }
+    if( type == PL_KERNEL_AVX2 ) {
+        leaf_box_func = box_test_avx2;
+    } else if( type == PL_KERNEL_SSE ) {
+        leaf_box_func = box_test_sse;
+    } else {
+        type = PL_KERNEL_SCALAR;
+        leaf_box_func = box_test_scalar;
+    }
+#else
+    type = PL_KERNEL_SCALAR;
+    leaf_box_func = box_test_scalar;
+#endif
+    leaf_box_type = type;
+    return type;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+int leaf_kernel_type( void )
+{
+    return leaf_box_type;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+int leaf_box_test(
+    const PL_REAL   *bmin,
+    const PL_REAL   *bmax,
+    int             stride,
+    int             num,
+    const PL_REAL   q[6],
+    bool            contain,
+    int             *hit
+) {
+    return leaf_box_func( bmin, bmax, stride, num, q, contain, hit );
+}
+
+} //namespace PolylibNS
@@ -0,0 +1,577 @@
+/*
+ * Polylib - Polygon Management Library
+ *
+ * Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+ * All rights reserved.
+ *
+ * Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+#include "Polylib.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "common/BBox.h"
+#include "polygons/Triangle.h"
+#include "groups/VTree.h"
+#include "groups/MeshSimplify.h"
+#include <queue>
+#include <algorithm>
+#include <math.h>
+
+//#define DEBUG
+
+namespace PolylibNS {
+
+using namespace std;
+
+#define LOD_BOUNDARY_WEIGHT 1000.0  /// 境界辺の形状保持用の重み
+#define LOD_MAX_MOVE        2.0     /// 縮約後頂点の移動量上限（辺長に対する比）
+
+// std::sort用ファンクタ   頂点番号を座標順にソートするのに使用
+struct WeldLess{
+    const vector< Vec3<double> >   *pos;
+    bool operator()( int l, int r ) const
+    {
+        const Vec3<double> &a = (*pos)[l];
+        const Vec3<double> &b = (*pos)[r];
+        if( a.x != b.x )    return a.x < b.x;
+        if( a.y != b.y )    return a.y < b.y;
+        return a.z < b.z;
+    }
+};
+
+//
+// 平面 ax+by+cz+d=0 の二次誤差行列を重みwで加算する
+//
+static void add_plane_quadric(
+        double                  *q,
+        const Vec3<double>      &n,
+        double                  d,
+        double                  w
+    )
+{
+    q[0] += w*n.x*n.x;  q[1] += w*n.x*n.y;  q[2] += w*n.x*n.z;  q[3] += w*n.x*d;
+    q[4] += w*n.y*n.y;  q[5] += w*n.y*n.z;  q[6] += w*n.y*d;
+    q[7] += w*n.z*n.z;  q[8] += w*n.z*d;
+    q[9] += w*d*d;
+}
+
+//
+// 二次誤差行列による頂点の誤差
+//
+static double quadric_error(
+        const double            *q,
+        const Vec3<double>      &p
+    )
+{
+    return     q[0]*p.x*p.x + 2.0*q[1]*p.x*p.y + 2.0*q[2]*p.x*p.z + 2.0*q[3]*p.x
+             + q[4]*p.y*p.y + 2.0*q[5]*p.y*p.z + 2.0*q[6]*p.y
+             + q[7]*p.z*p.z + 2.0*q[8]*p.z
+             + q[9];
+}
+
+
+/************************************************************************
+ *
+ * MeshSimplifyクラス
+ *
+ ***********************************************************************/
+// public /////////////////////////////////////////////////////////////////////
+MeshSimplify::MeshSimplify(
+        const vector<Triangle*>     &tri_list
+    )
+{
+    m_src = &tri_list;
+    m_num_alive = 0;
+    weld();
+    init_quadric();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT MeshSimplify::simplify(
+        size_t      target_num
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "MeshSimplify::simplify() in. num=" << m_num_alive
+              << " target=" << target_num << endl;
+#endif
+    if( m_num_alive <= target_num ) {
+        return PLSTAT_OK;
+    }
+
+    // 全ての辺の縮約候補を作成
+    priority_queue<Collapse> heap;
+    vector< pair<int,int> > edges;
+    edges.reserve( m_face.size() );
+    for( size_t f=0; f<m_face_alive.size(); f++ ) {
+        if( !m_face_alive[f] )  continue;
+        for( int k=0; k<3; k++ ) {
+            int a = m_face[3*f+k];
+            int b = m_face[3*f+(k+1)%3];
+            if( a == b )    continue;   // 縮約対象外の頂点重複三角形
+            edges.push_back( a<b ? make_pair(a,b) : make_pair(b,a) );
+        }
+    }
+    sort( edges.begin(), edges.end() );
+    edges.erase( unique( edges.begin(), edges.end() ), edges.end() );
+    for( size_t i=0; i<edges.size(); i++ ) {
+        Collapse col;
+        eval_collapse( edges[i].first, edges[i].second, col );
+        heap.push( col );
+    }
+    vector< pair<int,int> >().swap( edges );
+
+    // コストの小さい辺から縮約
+    vector<int> nbr;
+    while( m_num_alive > target_num && !heap.empty() ) {
+        Collapse col = heap.top();
+        heap.pop();
+
+        // 候補作成後に頂点が更新されていれば無効
+        if( m_vver[col.v0] != col.ver0 || m_vver[col.v1] != col.ver1 ) {
+            continue;
+        }
+        if( !collapse( col ) ) {
+            continue;
+        }
+
+        // 残した頂点に接続する辺の候補を作り直す
+        get_neighbors( col.v0, nbr );
+        for( size_t i=0; i<nbr.size(); i++ ) {
+            Collapse col_new;
+            eval_collapse( col.v0, nbr[i], col_new );
+            heap.push( col_new );
+        }
+    }
+
+#ifdef DEBUG
+    PL_DBGOSH << "MeshSimplify::simplify() out. num=" << m_num_alive << endl;
+#endif
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT MeshSimplify::create_triangles(
+        vector<Triangle*>       &tri_list,
+        vector<long long int>   &src_ptr,
+        vector<long long int>   &src_idx
+    )
+{
+    size_t nf = m_face_alive.size();
+
+    // 残存三角形の出力順
+    vector<long long int> order( nf, -1 );
+    long long int num = 0;
+    for( size_t f=0; f<nf; f++ ) {
+        if( m_face_alive[f] )   order[f] = num++;
+    }
+
+    // 元の三角形の帰属先ごとの個数
+    vector<long long int> root( nf, -1 );
+    vector<long long int> cnt( num+1, 0 );
+    for( size_t f=0; f<nf; f++ ) {
+        int r = find_root( (int)f );
+        if( r < 0 || !m_face_alive[r] )   continue;
+        root[f] = order[r];
+        cnt[ root[f]+1 ]++;
+    }
+
+    src_ptr.resize( num+1 );
+    src_ptr[0] = 0;
+    for( long long int i=0; i<num; i++ ) {
+        cnt[i+1] += cnt[i];
+        src_ptr[i+1] = cnt[i+1];
+    }
+    src_idx.resize( cnt[num] );
+    vector<long long int> pos( cnt.begin(), cnt.end()-1 );
+    for( size_t f=0; f<nf; f++ ) {
+        if( root[f] < 0 )   continue;
+        src_idx[ pos[root[f]]++ ] = f;
+    }
+
+    // 三角形ポリゴンの作成
+    tri_list.reserve( tri_list.size() + num );
+    for( size_t f=0; f<nf; f++ ) {
+        if( !m_face_alive[f] )  continue;
+        Triangle *src = (*m_src)[f];
+        Vec3<PL_REAL> vtx[3];
+        for( int k=0; k<3; k++ ) {
+            const Vec3<double> &p = m_pos[ m_face[3*f+k] ];
+            vtx[k].assign( (PL_REAL)p.x, (PL_REAL)p.y, (PL_REAL)p.z );
+        }
+        Triangle *tri = new Triangle( vtx, src->get_id(),
+                                      src->get_num_atrI(), src->get_num_atrR(),
+                                      src->get_pAtrI(), src->get_pAtrR() );
+        tri->set_exid( src->get_exid() );
+        tri_list.push_back( tri );
+    }
+
+    return PLSTAT_OK;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void MeshSimplify::weld( void )
+{
+    size_t nf = m_src->size();
+
+    // 三角形の全頂点を座標順に並べ、一致する座標を同一頂点とする
+    vector< Vec3<double> > pos( 3*nf );
+    for( size_t f=0; f<nf; f++ ) {
+        Vec3<PL_REAL> *vtx = (*m_src)[f]->get_vertexes();
+        for( int k=0; k<3; k++ ) {
+            pos[3*f+k].assign( vtx[k].x, vtx[k].y, vtx[k].z );
+        }
+    }
+    vector<int> idx( 3*nf );
+    for( size_t i=0; i<idx.size(); i++ )  idx[i] = (int)i;
+    WeldLess less;
+    less.pos = &pos;
+    sort( idx.begin(), idx.end(), less );
+
+    m_face.resize( 3*nf );
+    m_pos.clear();
+    for( size_t i=0; i<idx.size(); i++ ) {
+        if( i == 0 || less( idx[i-1], idx[i] ) ) {
+            m_pos.push_back( pos[idx[i]] );
+        }
+        m_face[ idx[i] ] = (int)m_pos.size() - 1;
+    }
+
+    size_t nv = m_pos.size();
+    m_vver.assign( nv, 0 );
+    m_vface.assign( nv, vector<int>() );
+    m_face_alive.assign( nf, 1 );
+    m_face_parent.resize( nf );
+    m_num_alive = nf;
+
+    vector<int> degenerate;
+    for( size_t f=0; f<nf; f++ ) {
+        m_face_parent[f] = (int)f;
+        int *v = &m_face[3*f];
+        if( v[0] == v[1] || v[1] == v[2] || v[2] == v[0] ) {
+            degenerate.push_back( (int)f );
+            continue;
+        }
+        for( int k=0; k<3; k++ ) {
+            m_vface[ v[k] ].push_back( (int)f );
+        }
+    }
+
+    // 頂点が重複する三角形は、頂点を共有する三角形に帰属させる
+    // 共有する三角形がなければ縮約対象外としてそのまま残す
+    for( size_t i=0; i<degenerate.size(); i++ ) {
+        int f = degenerate[i];
+        for( int k=0; k<3; k++ ) {
+            const vector<int> &vf = m_vface[ m_face[3*f+k] ];
+            if( !vf.empty() ) {
+                m_face_parent[f] = vf[0];
+                m_face_alive[f] = 0;
+                m_num_alive--;
+                break;
+            }
+        }
+    }
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void MeshSimplify::init_quadric( void )
+{
+    m_quad.assign( 10*m_pos.size(), 0.0 );
+
+    vector< pair< pair<int,int>, int > > edges;
+    for( size_t f=0; f<m_face_alive.size(); f++ ) {
+        if( !m_face_alive[f] )  continue;
+        const int *v = &m_face[3*f];
+        const Vec3<double> &p0 = m_pos[v[0]];
+        Vec3<double> n = cross( m_pos[v[1]]-p0, m_pos[v[2]]-p0 );
+        double len = n.length();
+        if( len <= 0.0 )    continue;
+        n /= len;
+        double d = -dot( n, p0 );
+        // 面積で重み付け
+        for( int k=0; k<3; k++ ) {
+            add_plane_quadric( &m_quad[10*v[k]], n, d, 0.5*len );
+            int a = v[k];
+            int b = v[(k+1)%3];
+            edges.push_back( make_pair( a<b ? make_pair(a,b) : make_pair(b,a), (int)f ) );
+        }
+    }
+
+    // 境界辺・非多様体辺（共有する三角形が2以外）は、
+    // 辺を含み面に垂直な平面の誤差を加えて形状を保持する
+    sort( edges.begin(), edges.end() );
+    size_t i = 0;
+    while( i < edges.size() ) {
+        size_t j = i + 1;
+        while( j < edges.size() && edges[j].first == edges[i].first )   j++;
+        if( j - i != 2 ) {
+            for( size_t k=i; k<j; k++ ) {
+                int a = edges[k].first.first;
+                int b = edges[k].first.second;
+                const int *v = &m_face[3*edges[k].second];
+                const Vec3<double> &p0 = m_pos[v[0]];
+                Vec3<double> nf = cross( m_pos[v[1]]-p0, m_pos[v[2]]-p0 );
+                Vec3<double> e  = m_pos[b] - m_pos[a];
+                Vec3<double> n  = cross( e, nf );
+                double len = n.length();
+                if( len <= 0.0 )    continue;
+                n /= len;
+                double d = -dot( n, m_pos[a] );
+                double w = LOD_BOUNDARY_WEIGHT * e.lengthSquared();
+                add_plane_quadric( &m_quad[10*a], n, d, w );
+                add_plane_quadric( &m_quad[10*b], n, d, w );
+            }
+        }
+        i = j;
+    }
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void MeshSimplify::eval_collapse(
+        int         v0,
+        int         v1,
+        Collapse    &col
+    ) const
+{
+    double q[10];
+    for( int i=0; i<10; i++ ) {
+        q[i] = m_quad[10*v0+i] + m_quad[10*v1+i];
+    }
+    const Vec3<double> &p0 = m_pos[v0];
+    const Vec3<double> &p1 = m_pos[v1];
+    Vec3<double> mid = (p0 + p1) * 0.5;
+
+    // 誤差最小となる位置 (Aの3x3部分)x = -b をクラメルの公式で解く
+    bool solved = false;
+    Vec3<double> p;
+    double det = q[0]*(q[4]*q[7]-q[5]*q[5])
+               - q[1]*(q[1]*q[7]-q[5]*q[2])
+               + q[2]*(q[1]*q[5]-q[4]*q[2]);
+    if( fabs(det) > 1.0e-30 ) {
+        double bx = -q[3], by = -q[6], bz = -q[8];
+        p.x = ( bx*(q[4]*q[7]-q[5]*q[5]) - q[1]*(by*q[7]-q[5]*bz) + q[2]*(by*q[5]-q[4]*bz) ) / det;
+        p.y = ( q[0]*(by*q[7]-q[5]*bz) - bx*(q[1]*q[7]-q[5]*q[2]) + q[2]*(q[1]*bz-by*q[2]) ) / det;
+        p.z = ( q[0]*(q[4]*bz-by*q[5]) - q[1]*(q[1]*bz-by*q[2]) + bx*(q[1]*q[5]-q[4]*q[2]) ) / det;
+        // 悪条件で辺から大きく離れた解は採用しない
+        double lim = LOD_MAX_MOVE * LOD_MAX_MOVE * distanceSquared( p0, p1 );
+        solved = distanceSquared( p, mid ) <= lim;
+    }
+
+    if( !solved ) {
+        // 両端点と中点のうち誤差最小の位置
+        p.assign( mid.x, mid.y, mid.z );
+        double e = quadric_error( q, mid );
+        double e0 = quadric_error( q, p0 );
+        double e1 = quadric_error( q, p1 );
+        if( e0 < e ) { p.assign( p0.x, p0.y, p0.z ); e = e0; }
+        if( e1 < e ) { p.assign( p1.x, p1.y, p1.z ); }
+    }
+
+    col.cost = max( quadric_error( q, p ), 0.0 );
+    col.v0   = v0;
+    col.v1   = v1;
+    col.ver0 = m_vver[v0];
+    col.ver1 = m_vver[v1];
+    col.pos.assign( p.x, p.y, p.z );
+}
+
+// private ////////////////////////////////////////////////////////////////////
+bool MeshSimplify::collapse(
+        const Collapse  &col
+    )
+{
+    int v0 = col.v0;
+    int v1 = col.v1;
+    compact_vface( v0 );
+    compact_vface( v1 );
+    const vector<int> &f0 = m_vface[v0];
+    const vector<int> &f1 = m_vface[v1];
+
+    // 辺を共有する三角形
+    vector<int> shared;
+    for( size_t i=0; i<f0.size(); i++ ) {
+        const int *v = &m_face[3*f0[i]];
+        if( v[0] == v1 || v[1] == v1 || v[2] == v1 )    shared.push_back( f0[i] );
+    }
+    if( shared.empty() )    return false;
+
+    // 縮約後に残る三角形がなければ縮約しない（形状が消えるため）
+    if( f0.size() + f1.size() == 2*shared.size() )  return false;
+
+    // 両端点に共通の隣接頂点は辺を共有する三角形の頂点のみ（非多様体化の防止）
+    vector<int> n0, n1, common;
+    get_neighbors( v0, n0 );
+    get_neighbors( v1, n1 );
+    set_intersection( n0.begin(), n0.end(), n1.begin(), n1.end(),
+                      back_inserter( common ) );
+    if( common.size() != shared.size() )    return false;
+
+    // 面の裏返りの確認
+    for( int s=0; s<2; s++ ) {
+        int vs = (s==0) ? v0 : v1;
+        int vo = (s==0) ? v1 : v0;
+        const vector<int> &fl = m_vface[vs];
+        for( size_t i=0; i<fl.size(); i++ ) {
+            const int *v = &m_face[3*fl[i]];
+            if( v[0] == vo || v[1] == vo || v[2] == vo )    continue;
+            Vec3<double> p[3];
+            Vec3<double> q[3];
+            for( int k=0; k<3; k++ ) {
+                const Vec3<double> &pk = m_pos[v[k]];
+                const Vec3<double> &qk = (v[k] == vs) ? col.pos : pk;
+                p[k].assign( pk.x, pk.y, pk.z );
+                q[k].assign( qk.x, qk.y, qk.z );
+            }
+            Vec3<double> n_old = cross( p[1]-p[0], p[2]-p[0] );
+            Vec3<double> n_new = cross( q[1]-q[0], q[2]-q[0] );
+            if( dot( n_old, n_new ) <= 0.0 )    return false;
+        }
+    }
+
+    // 縮約
+    m_pos[v0].assign( col.pos.x, col.pos.y, col.pos.z );
+    for( int i=0; i<10; i++ ) {
+        m_quad[10*v0+i] += m_quad[10*v1+i];
+    }
+    m_vver[v0]++;
+    m_vver[v1] = -1;
+
+    for( size_t i=0; i<shared.size(); i++ ) {
+        m_face_alive[ shared[i] ] = 0;
+        m_num_alive--;
+    }
+    for( size_t i=0; i<f1.size(); i++ ) {
+        int f = f1[i];
+        if( !m_face_alive[f] )  continue;
+        for( int k=0; k<3; k++ ) {
+            if( m_face[3*f+k] == v1 )   m_face[3*f+k] = v0;
+        }
+        m_vface[v0].push_back( f );
+    }
+    vector<int>().swap( m_vface[v1] );
+    compact_vface( v0 );
+
+    // 消えた三角形は、第3頂点を共有する残存三角形に帰属させる
+    const vector<int> &fl = m_vface[v0];
+    for( size_t i=0; i<shared.size(); i++ ) {
+        const int *v = &m_face[3*shared[i]];
+        int w = (v[0] != v0 && v[0] != v1) ? v[0] : ((v[1] != v0 && v[1] != v1) ? v[1] : v[2]);
+        int g = fl[0];
+        for( size_t j=0; j<fl.size(); j++ ) {
+            const int *u = &m_face[3*fl[j]];
+            if( u[0] == w || u[1] == w || u[2] == w ) {
+                g = fl[j];
+                break;
+            }
+        }
+        m_face_parent[ shared[i] ] = g;
+    }
+
+    return true;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void MeshSimplify::compact_vface( int v )
+{
+    vector<int> &fl = m_vface[v];
+    size_t n = 0;
+    for( size_t i=0; i<fl.size(); i++ ) {
+        if( m_face_alive[ fl[i] ] )     fl[n++] = fl[i];
+    }
+    fl.resize( n );
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void MeshSimplify::get_neighbors(
+        int             v,
+        vector<int>     &nbr
+    ) const
+{
+    nbr.clear();
+    const vector<int> &fl = m_vface[v];
+    for( size_t i=0; i<fl.size(); i++ ) {
+        if( !m_face_alive[ fl[i] ] )    continue;
+        for( int k=0; k<3; k++ ) {
+            int u = m_face[3*fl[i]+k];
+            if( u != v )    nbr.push_back( u );
+        }
+    }
+    sort( nbr.begin(), nbr.end() );
+    nbr.erase( unique( nbr.begin(), nbr.end() ), nbr.end() );
+}
+
+// private ////////////////////////////////////////////////////////////////////
+int MeshSimplify::find_root( int f )
+{
+    int r = f;
+    while( m_face_parent[r] != r )  r = m_face_parent[r];
+    // 経路圧縮
+    while( m_face_parent[f] != r ) {
+        int next = m_face_parent[f];
+        m_face_parent[f] = r;
+        f = next;
+    }
+    return r;
+}
+
+
+/************************************************************************
+ *
+ * PolygonLODクラス
+ *
+ ***********************************************************************/
+// public /////////////////////////////////////////////////////////////////////
+PolygonLOD::PolygonLOD(
+        int                             max_elem,
+        vector<Triangle*>               *tri_list,
+        const vector<long long int>     &src_ptr,
+        const vector<long long int>     &src_ids
+    )
+{
+    m_tri_list = tri_list;
+    m_src_ptr  = src_ptr;
+    m_src_ids  = src_ids;
+
+    BBox bbox;
+    bbox.init();
+    bool detail = Polylib::get_srch_mode();  // Polylib環境より検索モード取得
+    for( size_t i=0; i<m_tri_list->size(); i++ ) {
+        BBox bbox_tri = (*m_tri_list)[i]->get_bbox( detail );
+        bbox.add( bbox_tri.min );
+        bbox.add( bbox_tri.max );
+        m_id_map[ (*m_tri_list)[i]->get_id() ] = i;
+    }
+    m_vtree = new VTree( max_elem, bbox, m_tri_list );
+}
+
+// public /////////////////////////////////////////////////////////////////////
+PolygonLOD::~PolygonLOD()
+{
+    delete m_vtree;
+    for( size_t i=0; i<m_tri_list->size(); i++ ) {
+        delete (*m_tri_list)[i];
+    }
+    delete m_tri_list;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonLOD::get_source_ids(
+        long long int           id,
+        vector<long long int>   &ids
+    ) const
+{
+    map<long long int, long long int>::const_iterator it = m_id_map.find( id );
+    if( it == m_id_map.end() ) {
+        PL_ERROSH << "[ERROR]PolygonLOD::get_source_ids():Polygon not found: "
+                  << id << endl;
+        return PLSTAT_POLYGON_NOT_EXIST;
+    }
+    long long int i = it->second;
+    ids.insert( ids.end(), m_src_ids.begin()+m_src_ptr[i], m_src_ids.begin()+m_src_ptr[i+1] );
+    return PLSTAT_OK;
+}
+
+} //namespace PolylibNS
@@ -15,11 +15,18 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <math.h>
+#include <sys/stat.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 #include "Polylib.h"
+#include "util/time.h"
 #include "polygons/Triangle.h"
 #include "polygons/NptTriangle.h"
 #include "groups/PolygonGroup.h"
 #include "file_io/PolygonIO.h"
+#include "file_io/FileIO_func.h"
 #include "c_lang/CPolylib.h"
 
 //#define BENCHMARK
@@ -48,6 +55,14 @@ using namespace PolylibNS;
 ///
 #define ATT_NAME_PATH       "filepath"
 #define ATT_NAME_MOVABLE    "movable"
+#define ATT_NAME_INDEX      "index"
+
+///
+/// 本クラス内でのみ使用するTextParserの値
+///     検索用の木構造のタイプ(ATT_NAME_INDEX)
+///
+#define ATT_VALUE_INDEX_VTREE   "vtree"
+#define ATT_VALUE_INDEX_LBVH    "lbvh"
 
 ///
 /// 本クラス内でのみ使用するTextParserのタグ
@@ -69,6 +84,14 @@ struct TriangleLess{
     }
 };
 
+// std::sort用ファンクタ   (ポリゴン, 位置)の対のvectorをポリゴンID順にソートするのに使用
+struct TriangleIndexLess{
+    bool operator()( const pair<Triangle*,size_t>& l, const pair<Triangle*,size_t>& r ) const
+    {
+        return l.first->get_id() < r.first->get_id();
+    }
+};
+
 // std::equal用ファンクタ   ポリゴンのvectorのID重複を削除するのに使用
 struct TriangleEqual{
     bool operator()( const Triangle *l, const Triangle *r ) const
@@ -89,10 +112,16 @@ PolygonGroup::PolygonGroup() {
     //m_parent    = 0;
     m_parent       = NULL;
     m_tri_list     = NULL;
+    m_tri_order_valid = true;
     m_vtree        = NULL;
+    m_index_type   = PL_INDEX_VTREE;
+    m_lbvh         = NULL;
+    m_group_bvh    = NULL;
     m_move_func    = NULL;
     m_move_func_c  = NULL;
     m_need_rebuild = false;
+    m_move_time    = 0.0;
+    m_rebuild_time = 0.0;
     m_trias_before_move = NULL;
     m_max_elements = M_MAX_ELEMENTS;
 }
@@ -110,10 +139,18 @@ PolygonGroup::~PolygonGroup()
         delete m_trias_before_move;
     }
 
+    delete_lod();
+    clear_voxel_index();
+    clear_group_bvh();
+
     if (m_vtree != NULL) {
         delete m_vtree;
     }
 
+    if (m_lbvh != NULL) {
+        delete m_lbvh;
+    }
+
     if (m_tri_list != NULL) {
         for(int i=0; i<m_tri_list->size(); i++ ) {
             delete( (*m_tri_list)[i] );
@@ -162,6 +199,20 @@ POLYLIB_STAT PolygonGroup::init(
     return build_polygon_tree();
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::init_swap(
+            vector<Triangle*>   &tri_list
+        ) 
+{
+#ifdef DEBUG
+    PL_DBGOSH <<"PolygonGroup::init_swap:tri_list.size()=" << tri_list.size() << endl;
+#endif
+    init_tri_list();
+    // ポリゴンは複製せず、リストの中身を交換する
+    m_tri_list->swap( tri_list );
+    return build_polygon_tree();
+}
+
 // public /////////////////////////////////////////////////////////////////////
 void PolygonGroup::set_triangles_ptr(
                 vector<Triangle*> *tri_list,
@@ -175,6 +226,19 @@ void PolygonGroup::set_triangles_ptr(
     }
 }
 
+// public /////////////////////////////////////////////////////////////////////
+void PolygonGroup::set_triangles_ptr(
+                vector<Triangle*> &tri_list,
+                bool build_tree
+            )
+{
+    init_tri_list();                // 既存データ削除
+    m_tri_list->swap( tri_list );   // リストの中身を交換
+    if( build_tree ) {
+        build_polygon_tree();  // KDツリー等の構築
+    }
+}
+
 
 //TextParser version
 // public /////////////////////////////////////////////////////////////////////
@@ -279,12 +343,23 @@ POLYLIB_STAT PolygonGroup::build_polygon_tree()
 #ifdef DEBUG
     PL_DBGOSH << "PolygonGroup::build_polygon_tree() in.:" << m_name << endl;
 #endif
+    StatsTimer stats_timer( PL_STATS_BUILD );
+
+    // ポリゴンが変わるため簡略化ポリゴンは破棄
+    delete_lod();
 
     if( m_tri_list == NULL )  {
         if (m_vtree != NULL) {
             delete m_vtree;
             m_vtree = NULL;
         }
+        if (m_lbvh != NULL) {
+            delete m_lbvh;
+            m_lbvh = NULL;
+        }
+        for( size_t i=0; i<m_vgrid.size(); i++ ) {
+            m_vgrid[i]->clear();
+        }
         return PLSTAT_OK;
     }
 
@@ -296,14 +371,28 @@ POLYLIB_STAT PolygonGroup::build_polygon_tree()
         bbox.init();
         bool detail = Polylib::get_srch_mode();  // Polylib環境より検索モード取得
         //PL_DBGOSH << "PolygonGroup::build_polygon_tree() get_srch_mode() detai="<<detail << endl;
+        bool sort_morton = Polylib::get_sort_mode();  // Polylib環境より並べ替えモード取得
+        vector< Vec3<PL_REAL> > center;
+        if( sort_morton ) {
+            center.reserve( m_tri_list->size() );
+        }
 
         for( int i=0; i<m_tri_list->size(); i++ ) {
             BBox bbox_tri = (*m_tri_list)[i]->get_bbox( detail );  // 必ずtrueなのか確認要
             bbox.add( bbox_tri.min );
             bbox.add( bbox_tri.max );
+            if( sort_morton ) {
+                center.push_back( (bbox_tri.min + bbox_tri.max) * (PL_REAL)0.5 );
+            }
         }
         m_bbox = bbox;
 
+        // ポリゴンを空間的に近いもの同士が並ぶように並べ替える
+        //   並べ替えない場合はリストの順序が変わらないため、m_tri_orderはそのまま
+        if( sort_morton ) {
+            sort_tri_list( center );
+        }
+
 #ifdef DEBUG
         Vec3<PL_REAL> min = m_bbox.getPoint(0);
         Vec3<PL_REAL> max = m_bbox.getPoint(7);
@@ -311,8 +400,30 @@ POLYLIB_STAT PolygonGroup::build_polygon_tree()
 #endif
 
         // 木構造作成
-        if (m_vtree != NULL) delete m_vtree;
-        m_vtree = new VTree(m_max_elements, m_bbox, m_tri_list);
+        if( m_index_type == PL_INDEX_LBVH ) {
+            // 線形BVH  前回の領域を再利用する
+            if (m_vtree != NULL) {
+                delete m_vtree;
+                m_vtree = NULL;
+            }
+            if (m_lbvh == NULL) m_lbvh = new LBVH();
+            POLYLIB_STAT ret = m_lbvh->build(m_tri_list, m_bbox);
+            if (ret != PLSTAT_OK) return ret;
+        } else {
+            if (m_lbvh != NULL) {
+                delete m_lbvh;
+                m_lbvh = NULL;
+            }
+            if (m_vtree != NULL) delete m_vtree;
+            m_vtree = new VTree(m_max_elements, m_bbox, m_tri_list);
+        }
+
+        // ボクセル格子インデックス
+        POLYLIB_STAT ret = build_voxel_grids();
+        if (ret != PLSTAT_OK) return ret;
+
+        // 上位グループのBVHのBBoxを更新
+        refit_parent_bvh();
     }
 
 #ifdef BENCHMARK
@@ -345,6 +456,36 @@ PL_DBGOSH << "PolygonGroup:load_polygons_file():IN" << endl;
 #endif
     //POLYLIB_STAT ret = m_polygons->import(m_polygon_files, scale);
     init_tri_list();
+
+    // Polylibバイナリファイル単独の場合は保存されたKD木を復元する
+    if( m_polygon_files.size() == 1 &&
+        m_polygon_files.begin()->second == PolygonIO::FMT_PLB ) {
+        return load_polygons_plb( m_polygon_files.begin()->first, scale );
+    }
+
+    // インデックスキャッシュが有効な場合、キャッシュがあればそこから読み込む
+    //   並べ替えモードではキャッシュに並べ替え前の順序(m_tri_order)が
+    //   残らないため、キャッシュを使用しない
+    string cache_fname;
+    if( !Polylib::get_cache_dir().empty() && !Polylib::get_sort_mode() ) {
+        cache_fname = mk_index_cache_fname( scale );
+        struct stat st;
+        if( !cache_fname.empty() && stat( cache_fname.c_str(), &st ) == 0 ) {
+            if( load_polygons_plb( cache_fname, 1.0 ) == PLSTAT_OK ) {
+#ifdef DEBUG
+                PL_DBGOSH << "PolygonGroup:load_polygons_file():cache hit " << cache_fname << endl;
+#endif
+                // ポリゴンIDはファイル読み込み時と同様に採番し直す
+                for( size_t i=0; i<m_tri_list->size(); i++ ) {
+                    (*m_tri_list)[i]->set_unique_id();
+                }
+                return PLSTAT_OK;
+            }
+            // 読み込めないキャッシュは作成し直す
+            init_tri_list();
+        }
+    }
+
     POLYLIB_STAT ret = PolygonIO::load(m_tri_list, m_polygon_files, scale);
     if (ret != PLSTAT_OK) return ret;
 
@@ -358,7 +499,26 @@ PL_DBGOSH << "PolygonGroup:load_polygons_file():IN" << endl;
     if (ret != PLSTAT_OK) return ret;
 #endif
 
-    return build_polygon_tree();
+    ret = build_polygon_tree();
+    if (ret != PLSTAT_OK) return ret;
+
+    // インデックスキャッシュ書き込み
+    //   同時に実行される他プロセスが書き込み途中のキャッシュを読まないよう
+    //   一時ファイルに書き込んでから置き換える
+    //   書き込みに失敗してもロードは成功とする
+    if( !cache_fname.empty() ) {
+        ostringstream tmp_fname;
+        tmp_fname << cache_fname << ".tmp";
+#if !defined(_WIN32)
+        tmp_fname << getpid();
+#endif
+        if( save_polygons_plb( tmp_fname.str(), m_tri_list ) != PLSTAT_OK ||
+            rename( tmp_fname.str().c_str(), cache_fname.c_str() ) != 0 ) {
+            remove( tmp_fname.str().c_str() );
+        }
+    }
+
+    return PLSTAT_OK;
 }
 
 
@@ -381,11 +541,44 @@ POLYLIB_STAT PolygonGroup::save_polygons_file(
     const string&   extend,
     const string&   format,
     std::vector<Triangle*> *tri_list,
-    map<string,string>& polygon_fname_map
+    map<string,string>& polygon_fname_map,
+    long long int*  save_bytes,
+    double*         save_time
 ) 
 {
   char  *fname = mk_polygons_fname(rank_no, extend, format,polygon_fname_map);
-  return PolygonIO::save(tri_list, fname, format);
+  double wt_start = get_wall_time();
+  // 呼び出し側で統計を集める場合は計測しない
+  StatsTimer stats_timer( save_bytes == NULL ? PL_STATS_SAVE : -1 );
+  POLYLIB_STAT ret;
+
+  // Polylibバイナリファイルの場合はKD木も保存する
+  if( format == PolygonIO::FMT_PLB ) {
+    ret = save_polygons_plb(fname, tri_list);
+  } else {
+    ret = PolygonIO::save(tri_list, fname, format);
+  }
+  if( ret != PLSTAT_OK ) return ret;
+
+  // 書き出しスループット統計
+  struct stat st;
+  if( stat( fname, &st ) == 0 ) {
+    double wt = get_wall_time() - wt_start;
+    if( save_bytes != NULL ) {
+      *save_bytes = st.st_size;
+      if( save_time != NULL ) *save_time = wt;
+    } else {
+      Polylib::get_instance()->add_save_stats( st.st_size, wt );
+      if( StatsRegistry::is_enable() ) {
+        StatsRegistry::get_instance()->add_count( PL_STATS_SAVE_BYTES, st.st_size );
+      }
+    }
+#ifdef DEBUG
+    PL_DBGOSH << "PolygonGroup::save_polygons_file() " << fname << " " << st.st_size 
+              << " bytes " << wt << " sec" << endl;
+#endif
+  }
+  return PLSTAT_OK;
 }
 
 
@@ -437,6 +630,23 @@ PL_DBGOSH <<  "PolygonGroup::move() in." << endl;
     return PLSTAT_OK;
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::move_and_rebuild(
+    PolylibMoveParams   &params
+)
+{
+    double wt_start = get_wall_time();
+    POLYLIB_STAT ret = move( params );
+    double wt_move = get_wall_time();
+    m_move_time    = wt_move - wt_start;
+    m_rebuild_time = 0.0;
+    if( ret != PLSTAT_OK )  return ret;
+
+    ret = rebuild_polygons();
+    m_rebuild_time = get_wall_time() - wt_move;
+    return ret;
+}
+
 
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT PolygonGroup::search(
@@ -445,11 +655,46 @@ POLYLIB_STAT PolygonGroup::search(
             bool                every 
         ) const
 {
+    // ボクセル境界に揃った領域は格子で検索
+    for( size_t i=0; i<m_vgrid.size(); i++ ) {
+        int range[6];
+        if( m_vgrid[i]->covers( bbox, range ) ) {
+            return m_vgrid[i]->search(tri_list, bbox, range, every );
+        }
+    }
+    if( m_lbvh != NULL ) {
+        return m_lbvh->search(tri_list, bbox, every );
+    }
     return m_vtree->search(tri_list, bbox, every );
 }
 
 
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::search_exact(
+            vector<Triangle*>&  tri_list,
+            const BBox&         bbox
+        ) const
+{
+    if( m_vtree == NULL && m_lbvh == NULL ) {
+        return PLSTAT_OK;
+    }
+
+    // BBoxが重なるポリゴン（ボクセル格子または木構造）から三角形が交差するものを抽出
+    vector<Triangle*> cand;
+    POLYLIB_STAT ret = search(cand, bbox, false );
+    if( ret != PLSTAT_OK )  return ret;
+
+    Vec3<PL_REAL> center = (bbox.min + bbox.max) * (PL_REAL)0.5;
+    Vec3<PL_REAL> half   = (bbox.max - bbox.min) * (PL_REAL)0.5;
+    for( size_t i=0; i<cand.size(); i++ ) {
+        if( tri_box_overlap( cand[i]->get_vertexes(), center, half ) ) {
+            tri_list.push_back( cand[i] );
+        }
+    }
+    return PLSTAT_OK;
+}
+
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT PolygonGroup::search(
             vector<Triangle*>&  tri_list,
@@ -459,12 +704,12 @@ POLYLIB_STAT PolygonGroup::search(
         ) const
 {
     POLYLIB_STAT ret;
-    if( m_vtree == NULL ) {
+    if( m_vtree == NULL && m_lbvh == NULL ) {
         return PLSTAT_OK;
     }
 
     for(int i=0; i<bboxes.size(); i++ ) {
-        ret = m_vtree->search(tri_list, bboxes[i], every );
+        ret = search(tri_list, bboxes[i], every );
         if( ret != PLSTAT_OK )  return ret;
     }
     
@@ -507,56 +752,13 @@ string PolygonGroup::acq_file_name() {
 
 #ifdef MPI_PL
 
-// public /////////////////////////////////////////////////////////////////////
-POLYLIB_STAT
-PolygonGroup::search_outbounded(
-    std::vector<Triangle*>&     tri_list,
-    std::vector<BBox>& neibour_bboxes,
-    std::vector<long long int>&  exclude_tria_ids
-)
-{
-#ifdef DEBUG
-    PL_DBGOSH << "PolygonGroup::search_outbounded() in. " << endl;
-    PL_DBGOSH << "    group name="<<this->get_name() <<endl;
-    PL_DBGOSH << "    exclude_tria_ids.size()="<<exclude_tria_ids.size() <<endl;
-#endif
-    POLYLIB_STAT ret;
-
-    // 除外IDリストを昇順ソート
-    std::sort( exclude_tria_ids.begin(), exclude_tria_ids.end() );
-
-    // 隣接PE領域(ガイドセル含)に懸かる三角形を検索
-    for(int i=0; i<neibour_bboxes.size(); i++ ) {
-        ret = search( tri_list, neibour_bboxes[i], false );
-    }
-#ifdef DEBUG
-PL_DBGOSH << "p_trias orig tri_list.size()=" << tri_list.size() << endl;
-#endif
-
-    // 検索結果から除外対象を除く
-    vector<Triangle*>::iterator itr;
-    for( itr=tri_list.begin(); itr!=tri_list.end(); ) {
-        long long int id = (*itr)->get_id();
-        if( std::binary_search(exclude_tria_ids.begin(),
-                               exclude_tria_ids.end(), id) ) {
-            itr = tri_list.erase(itr);
-        }
-        else {
-            itr++;
-        }
-    }
-#ifdef DEBUG
-PL_DBGOSH << "p_trias return tri_list.size()="<<tri_list.size() <<endl;
-#endif
-    return PLSTAT_OK;
-}
-
 // public /////////////////////////////////////////////////////////////////////
 // 三角形リストの追加
 //   内部IDが重複した三角形は追加しない。KD木の再構築はしない。
 POLYLIB_STAT
 PolygonGroup::add_triangles(
-    const std::vector<Triangle*>& tri_list
+    const std::vector<Triangle*>& tri_list,
+    const std::vector<unsigned long long int>* ghost_masks
 )
 {
 #ifdef DEBUG
@@ -570,34 +772,68 @@ PolygonGroup::add_triangles(
         m_tri_list = new vector<Triangle*>;
     }
 
+    // 隣接PE領域ビットマスクを引き継ぐか？
+    //   既存の三角形と追加する三角形の両方に設定されている場合のみ
+    size_t num_old = m_tri_list->size();
+    bool with_mask = ( ghost_masks != NULL && ghost_masks->size() == tri_list.size() &&
+                       m_ghost_mask.size() == num_old && m_ghost_gain.size() == num_old );
+
     //m_polygons->add( &tri_list );
-    int num_reserve = m_tri_list->size() + tri_list.size();
-    vector<Triangle*> tri_list_tmp;
+    //   (三角形, 追加前の位置)の対で管理する。追加分の位置はnum_old以降
+    int num_reserve = num_old + tri_list.size();
+    vector< pair<Triangle*,size_t> > tri_list_tmp;
     tri_list_tmp.reserve( num_reserve );
-    tri_list_tmp = *m_tri_list;
+    for(size_t i=0; i<num_old; i++ ) {
+        tri_list_tmp.push_back( make_pair( (*m_tri_list)[i], i ) );
+    }
     m_tri_list->clear();
     m_tri_list->reserve( num_reserve );
 
     // ひとまず全部追加
-    copy_polygons( tri_list, tri_list_tmp ); // deep copyして追加
+    vector<Triangle*> tri_list_add;
+    copy_polygons( tri_list, tri_list_add ); // deep copyして追加
+    for(size_t i=0; i<tri_list_add.size(); i++ ) {
+        tri_list_tmp.push_back( make_pair( tri_list_add[i], num_old+i ) );
+    }
 
     // 三角形リストをID順にソート
-    std::sort( tri_list_tmp.begin(), tri_list_tmp.end(), TriangleLess() );
+    std::sort( tri_list_tmp.begin(), tri_list_tmp.end(), TriangleIndexLess() );
     // 追加
-    long long int id_pre = tri_list_tmp[0]->get_id();
-    m_tri_list->push_back( tri_list_tmp[0] );
+    vector<unsigned long long int> mask, gain;
+    if( with_mask ) {
+        mask.reserve( num_reserve );
+        gain.reserve( num_reserve );
+    }
+    long long int id_pre = 0;
 
-    for(int i=1; i<tri_list_tmp.size(); i++ ) {
-        long long int id = tri_list_tmp[i]->get_id();
-        if( id == id_pre ) {
+    for(size_t i=0; i<tri_list_tmp.size(); i++ ) {
+        Triangle* tri = tri_list_tmp[i].first;
+        long long int id = tri->get_id();
+        if( i > 0 && id == id_pre ) {
             // IDが同一なので削除
-            delete tri_list_tmp[i];
-        } else {
-            // 新しいIDなのでリストに登録
-            m_tri_list->push_back( tri_list_tmp[i] );
-            id_pre = id;
+            delete tri;
+            continue;
+        }
+        // 新しいIDなのでリストに登録
+        m_tri_list->push_back( tri );
+        id_pre = id;
+        if( with_mask ) {
+            size_t pos = tri_list_tmp[i].second;
+            if( pos < num_old ) {
+                mask.push_back( m_ghost_mask[pos] );
+                gain.push_back( m_ghost_gain[pos] );
+            } else {
+                mask.push_back( (*ghost_masks)[pos-num_old] );
+                gain.push_back( 0 );
+            }
         }
     }
+    m_ghost_mask.swap( mask );
+    m_ghost_gain.swap( gain );
+
+    // 登録時の位置との対応は取れなくなる
+    m_tri_order.clear();
+    m_tri_order_valid = false;
 
     // KD木要再構築フラグを立てる
     m_need_rebuild = true;
@@ -607,6 +843,117 @@ PolygonGroup::add_triangles(
 
 #endif
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+PolygonGroup::set_index_type( int type )
+{
+    if( type != PL_INDEX_VTREE && type != PL_INDEX_LBVH ) {
+        PL_ERROSH << "[ERROR]PolygonGroup::set_index_type():Unknown index type: "
+                  << type << endl;
+        return PLSTAT_NG;
+    }
+    if( type == m_index_type ) {
+        return PLSTAT_OK;
+    }
+    m_index_type = type;
+
+    // 作成済みの木構造を作り直す
+    if( m_vtree != NULL || m_lbvh != NULL ) {
+        return build_polygon_tree();
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+PolygonGroup::add_voxel_index(
+        const Vec3<PL_REAL>&    org,
+        const Vec3<PL_REAL>&    dx,
+        const int               num[3]
+    )
+{
+    if( dx.x <= 0.0 || dx.y <= 0.0 || dx.z <= 0.0 ||
+        num[0] <= 0 || num[1] <= 0 || num[2] <= 0 ) {
+        PL_ERROSH << "[ERROR]PolygonGroup::add_voxel_index():Invalid grid: dx="
+                  << dx << " num=" << num[0] << " " << num[1] << " " << num[2] << endl;
+        return PLSTAT_NG;
+    }
+    VoxelGrid *grid = new VoxelGrid( org, dx, num );
+    m_vgrid.push_back( grid );
+
+    // 木構造作成済みであれば格子も作成する
+    if( m_vtree != NULL || m_lbvh != NULL ) {
+        return grid->build( m_tri_list );
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void
+PolygonGroup::clear_voxel_index( void )
+{
+    for( size_t i=0; i<m_vgrid.size(); i++ ) {
+        delete m_vgrid[i];
+    }
+    m_vgrid.clear();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+PolygonGroup::build_group_bvh( void )
+{
+    if( m_children.empty() ) {
+        clear_group_bvh();
+        return PLSTAT_OK;
+    }
+    vector<PolygonGroup*> leaf;
+    collect_leaf_groups( leaf );
+
+    if( m_group_bvh == NULL ) m_group_bvh = new GroupBVH();
+    return m_group_bvh->build( leaf, get_hierarchy_revision() );
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void
+PolygonGroup::clear_group_bvh( void )
+{
+    if( m_group_bvh != NULL ) {
+        delete m_group_bvh;
+        m_group_bvh = NULL;
+    }
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void
+PolygonGroup::refit_parent_bvh()
+{
+    // 並列移動時は複数グループから同じ上位グループのBVHを更新するため排他する
+#ifdef _OPENMP
+#pragma omp critical (polylib_group_bvh_refit)
+#endif
+    for( PolygonGroup *p = m_parent; p != NULL; p = p->m_parent ) {
+        if( p->m_group_bvh != NULL ) {
+            StatsTimer stats_timer( PL_STATS_REFIT );
+            p->m_group_bvh->refit( this );
+        }
+    }
+}
+
+// private ////////////////////////////////////////////////////////////////////
+void
+PolygonGroup::collect_leaf_groups(
+        vector<PolygonGroup*>&  leaf
+    )
+{
+    if( m_children.empty() ) {
+        leaf.push_back( this );
+        return;
+    }
+    for( size_t i=0; i<m_children.size(); i++ ) {
+        m_children[i]->collect_leaf_groups( leaf );
+    }
+}
+
 // public /////////////////////////////////////////////////////////////////////
 POLYLIB_STAT
 PolygonGroup::rebuild_polygons()
@@ -653,6 +1000,11 @@ POLYLIB_STAT PolygonGroup::show_group_info(
     }
 
     PL_DBGOSH << "  movable: "<<m_movable <<endl;
+    if( m_movable ) {
+        PL_DBGOSH << "  move time: "<<m_move_time <<"  rebuild time: "<<m_rebuild_time <<endl;
+    }
+    PL_DBGOSH << "  index: "<<(m_index_type==PL_INDEX_LBVH ? ATT_VALUE_INDEX_LBVH : ATT_VALUE_INDEX_VTREE) <<endl;
+    PL_DBGOSH << "  voxel index: "<<m_vgrid.size() <<endl;
 
     if (m_parent_path.empty() == false) {
         PL_DBGOSH << "  parent polygon group name: " << m_parent_path << endl;
@@ -847,6 +1199,41 @@ POLYLIB_STAT PolygonGroup::get_polygons_reduce_atrR(
 #endif
 
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::transform(
+        const PL_REAL   mat[4][4],
+        bool            update_normal,
+        bool            update_area
+    )
+{
+    if( m_tri_list == NULL || m_tri_list->empty() ) {
+        return PLSTAT_OK;
+    }
+
+    // 法線ベクトル変換用の余因子行列（行i = 行i+1 × 行i+2）
+    PL_REAL nmat[3][3];
+    for( int i=0; i<3; i++ ) {
+        const PL_REAL *a = mat[(i+1)%3];
+        const PL_REAL *b = mat[(i+2)%3];
+        nmat[i][0] = a[1]*b[2] - a[2]*b[1];
+        nmat[i][1] = a[2]*b[0] - a[0]*b[2];
+        nmat[i][2] = a[0]*b[1] - a[1]*b[0];
+    }
+
+    Triangle **tri = &(*m_tri_list)[0];
+    int num = (int)m_tri_list->size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for( int i=0; i<num; i++ ) {
+        tri[i]->transform( mat, nmat, update_normal, update_area );
+    }
+
+    m_need_rebuild = true;
+    return PLSTAT_OK;
+}
+
+
 POLYLIB_STAT PolygonGroup::rescale_polygons( PL_REAL scale )
 {
     if( m_tri_list->size() == 0 ) {
@@ -879,10 +1266,175 @@ POLYLIB_STAT PolygonGroup::search_nearest(
     ) const 
 {
     //return m_polygons->search_nearest(tri,pos);
+    if( m_lbvh != NULL ) {
+        tri = const_cast<Triangle*>(m_lbvh->search_nearest(pos)); // constを外す
+        return PLSTAT_OK;
+    }
     tri = const_cast<Triangle*>(m_vtree->search_nearest(pos)); // constを外す
     return PLSTAT_OK;
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::build_lod(
+        int         num_level,
+        PL_REAL     ratio
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "PolygonGroup::build_lod() in. num_level=" << num_level
+              << " ratio=" << ratio << endl;
+#endif
+    if( ratio <= 0.0 || ratio >= 1.0 ) {
+        PL_ERROSH << "[ERROR]PolygonGroup::build_lod():Invalid ratio: "
+                  << ratio << endl;
+        return PLSTAT_NG;
+    }
+
+    delete_lod();
+    if( m_tri_list == NULL || m_tri_list->size() == 0 ) {
+        return PLSTAT_OK;
+    }
+
+#ifdef DEBUG
+    double wt_start = get_wall_time();
+#endif
+    size_t num_tri = m_tri_list->size();
+
+    // レベル毎に1つ前のレベルの簡略化ポリゴンから作成する
+    const vector<Triangle*>    *cur = m_tri_list;
+    vector<long long int>       cur_ptr;    // 前レベル三角形の元ID範囲
+    vector<long long int>       cur_ids;    // 前レベル三角形の元ID
+    for( int level=1; level<=num_level; level++ ) {
+        size_t target = (size_t)( num_tri * pow( (double)ratio, level ) );
+        if( target < 1 )    target = 1;
+
+        MeshSimplify simp( *cur );
+        POLYLIB_STAT ret = simp.simplify( target );
+        if( ret != PLSTAT_OK )  return ret;
+
+        // 縮約できなかった場合はレベルを追加しない
+        if( simp.get_num_tria() >= cur->size() ) {
+            break;
+        }
+
+        vector<Triangle*>       *tri_list = new vector<Triangle*>;
+        vector<long long int>   src_ptr;
+        vector<long long int>   src_idx;
+        ret = simp.create_triangles( *tri_list, src_ptr, src_idx );
+        if( ret != PLSTAT_OK ) {
+            for( size_t i=0; i<tri_list->size(); i++ )  delete (*tri_list)[i];
+            delete tri_list;
+            return ret;
+        }
+
+        // 前レベルのインデックスを元の三角形IDに置き換える
+        vector<long long int> ptr( 1, 0 );
+        vector<long long int> ids;
+        ids.reserve( num_tri );
+        for( size_t i=0; i+1<src_ptr.size(); i++ ) {
+            size_t ids_begin = ids.size();
+            for( long long int j=src_ptr[i]; j<src_ptr[i+1]; j++ ) {
+                long long int c = src_idx[j];
+                if( level == 1 ) {
+                    ids.push_back( (*cur)[c]->get_id() );
+                } else {
+                    ids.insert( ids.end(), cur_ids.begin()+cur_ptr[c],
+                                           cur_ids.begin()+cur_ptr[c+1] );
+                }
+            }
+            sort( ids.begin()+ids_begin, ids.end() );
+            ptr.push_back( ids.size() );
+        }
+
+        PolygonLOD *lod = new PolygonLOD( m_max_elements, tri_list, ptr, ids );
+        m_lod.push_back( lod );
+        cur = tri_list;
+        cur_ptr.swap( ptr );
+        cur_ids.swap( ids );
+
+#ifdef DEBUG
+        PL_DBGOSH << "PolygonGroup::build_lod() level=" << level
+                  << " num_tri=" << tri_list->size() << " target=" << target << endl;
+#endif
+    }
+
+#ifdef DEBUG
+    PL_DBGOSH << "PolygonGroup::build_lod() out. time=" << get_wall_time()-wt_start << endl;
+#endif
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::get_tri_order(
+        vector<long long int>&  order
+    ) const
+{
+    order.clear();
+    if( m_tri_list == NULL )    return PLSTAT_OK;
+
+    // 登録後に三角形が追加・削除された場合は対応が取れない
+    if( !m_tri_order_valid ||
+        ( !m_tri_order.empty() && m_tri_order.size() != m_tri_list->size() ) ) {
+        return PLSTAT_NG;
+    }
+    if( !m_tri_order.empty() ) {
+        order = m_tri_order;
+        return PLSTAT_OK;
+    }
+    // 並べ替えていない場合は元の順序のまま
+    order.resize( m_tri_list->size() );
+    for( size_t i=0; i<order.size(); i++ ) {
+        order[i] = i;
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+vector<Triangle*>* PolygonGroup::get_lod_triangles(
+        int         level
+    ) const
+{
+    if( level == 0 )    return m_tri_list;
+    if( level < 0 || level > (int)m_lod.size() )    return NULL;
+    return m_lod[level-1]->get_triangles();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::search(
+            vector<Triangle*>&  tri_list,
+            const BBox&         bbox, 
+            bool                every,
+            int                 level
+        ) const
+{
+    if( level <= 0 || m_lod.empty() ) {
+        return search( tri_list, bbox, every );
+    }
+    if( level > (int)m_lod.size() ) {
+        level = (int)m_lod.size();
+    }
+    return m_lod[level-1]->search( tri_list, bbox, every );
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::get_lod_source_ids(
+        int                     level,
+        long long int           id,
+        vector<long long int>&  ids
+    ) const
+{
+    if( level == 0 ) {
+        ids.push_back( id );
+        return PLSTAT_OK;
+    }
+    if( level < 0 || level > (int)m_lod.size() ) {
+        PL_ERROSH << "[ERROR]PolygonGroup::get_lod_source_ids():Invalid level: "
+                  << level << endl;
+        return PLSTAT_NG;
+    }
+    return m_lod[level-1]->get_source_ids( id, ids );
+}
+
 /// ポリゴングループのユーザ定義属性取得。
 ///
 ///  @param[in]     key     キー
@@ -954,6 +1506,22 @@ POLYLIB_STAT PolygonGroup::setup_attribute (
     m_movable = tp->convertBool(movable_string,&ierror);      
   }
 
+  // 検索用の木構造のタイプ
+  leaf_iter = find(leaves.begin(),leaves.end(),ATT_NAME_INDEX);
+  if(leaf_iter!=leaves.end()) {
+    string index_string;
+    tp_error=tp->getValue((*leaf_iter),index_string);
+    if( index_string == ATT_VALUE_INDEX_LBVH ) {
+      m_index_type = PL_INDEX_LBVH;
+    } else if( index_string == ATT_VALUE_INDEX_VTREE ) {
+      m_index_type = PL_INDEX_VTREE;
+    } else {
+      PL_ERROSH << "[ERROR]PolygonGroup::setup_attribute():Unknown index type: "
+                << index_string << endl;
+      return PLSTAT_CONFIG_ERROR;
+    }
+  }
+
   // グループ名が重複していないか確認
   // for tp
   string current_node;
@@ -1224,6 +1792,13 @@ PolygonGroup::is_far(
 // private //////////////////////////////////////////////////////////////////
 void PolygonGroup::init_tri_list()
 {
+    delete_lod();
+    m_tri_order.clear();
+    m_tri_order_valid = true;
+#ifdef MPI_PL
+    m_ghost_mask.clear();
+    m_ghost_gain.clear();
+#endif
     if (m_tri_list == NULL) {
         m_tri_list = new vector<Triangle*>;
     }
@@ -1239,6 +1814,13 @@ void PolygonGroup::init_tri_list()
 // private //////////////////////////////////////////////////////////////////
 void PolygonGroup::delete_tri_list()
 {
+    delete_lod();
+    m_tri_order.clear();
+    m_tri_order_valid = true;
+#ifdef MPI_PL
+    m_ghost_mask.clear();
+    m_ghost_gain.clear();
+#endif
     if (m_tri_list != NULL) {
 
         vector<Triangle*>::iterator itr;
@@ -1250,6 +1832,193 @@ void PolygonGroup::delete_tri_list()
     }
 }
 
+// private //////////////////////////////////////////////////////////////////
+void PolygonGroup::sort_tri_list(
+    const vector< Vec3<PL_REAL> >&  center
+)
+{
+    size_t num = m_tri_list->size();
+
+    // (Morton符号, 並べ替え前の位置)でソート。同一符号は元の順序を保つ
+    vector< pair<unsigned long long int, long long int> > key( num );
+    for( size_t i=0; i<num; i++ ) {
+        key[i] = make_pair( morton_code( center[i], m_bbox ), (long long int)i );
+    }
+    sort( key.begin(), key.end() );
+
+    vector<Triangle*> sorted( num );
+    for( size_t i=0; i<num; i++ ) {
+        sorted[i] = (*m_tri_list)[ key[i].second ];
+    }
+    m_tri_list->swap( sorted );
+
+    // 登録時の位置は前回までの並べ替えと合成する
+    //   new[i] = old[key[i].second]  （未並べ替えの場合はold[i]=i）
+    if( m_tri_order_valid ) {
+        if( !m_tri_order.empty() && m_tri_order.size() != num ) {
+            m_tri_order.clear();
+            m_tri_order_valid = false;
+        } else {
+            vector<long long int> order( num );
+            for( size_t i=0; i<num; i++ ) {
+                order[i] = m_tri_order.empty() ? key[i].second : m_tri_order[ key[i].second ];
+            }
+            m_tri_order.swap( order );
+        }
+    }
+
+#ifdef MPI_PL
+    // 隣接PE領域ビットマスクも同じ並びにする
+    if( m_ghost_mask.size() == num && m_ghost_gain.size() == num ) {
+        vector<unsigned long long int> mask( num ), gain( num );
+        for( size_t i=0; i<num; i++ ) {
+            mask[i] = m_ghost_mask[ key[i].second ];
+            gain[i] = m_ghost_gain[ key[i].second ];
+        }
+        m_ghost_mask.swap( mask );
+        m_ghost_gain.swap( gain );
+    } else {
+        m_ghost_mask.clear();
+        m_ghost_gain.clear();
+    }
+#endif
+}
+
+// private //////////////////////////////////////////////////////////////////
+void PolygonGroup::delete_lod()
+{
+    for( size_t i=0; i<m_lod.size(); i++ ) {
+        delete m_lod[i];
+    }
+    m_lod.clear();
+}
+
+// private //////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::build_voxel_grids()
+{
+    for( size_t i=0; i<m_vgrid.size(); i++ ) {
+        POLYLIB_STAT ret = m_vgrid[i]->build( m_tri_list );
+        if( ret != PLSTAT_OK )  return ret;
+    }
+    return PLSTAT_OK;
+}
+
+// private //////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::load_polygons_plb(
+    const string&       fname,
+    PL_REAL             scale
+) {
+    int                     num_tri;
+    string                  group_path;
+    vector<VNodeFlat>       nodes;
+    vector<long long int>   elem_idx;
+    int                     srch_mode;
+
+    POLYLIB_STAT ret = plb_load( m_tri_list, fname, &num_tri, scale,
+                                 &group_path, &nodes, &elem_idx, &srch_mode );
+    if (ret != PLSTAT_OK) return ret;
+
+#ifdef DEBUG
+    PL_DBGOSH << "PolygonGroup::load_polygons_plb() " << fname << " path=" << group_path
+              << " num_tri=" << num_tri << " num_node=" << nodes.size() << endl;
+#endif
+
+    // KD木が保存されていない（スケール指定を含む）場合、
+    // 保存時と検索モードが異なる（KD木のBBoxが異なる）場合、
+    // 線形BVHを使用する場合は作成する
+    if( nodes.empty() || srch_mode != (int)Polylib::get_srch_mode() ||
+        m_index_type != PL_INDEX_VTREE ) {
+        return build_polygon_tree();
+    }
+
+    // ルートノードのBBoxが保存時のグループのBBox
+    m_bbox.setMinMax( Vec3<PL_REAL>(nodes[0].bbox[0], nodes[0].bbox[1], nodes[0].bbox[2]),
+                      Vec3<PL_REAL>(nodes[0].bbox[3], nodes[0].bbox[4], nodes[0].bbox[5]) );
+
+    delete_lod();
+    m_tri_order.clear();    // 保存時の順序のまま
+    if (m_vtree != NULL) delete m_vtree;
+    m_vtree = new VTree(m_max_elements, m_bbox, m_tri_list, nodes, elem_idx);
+    refit_parent_bvh();
+
+    return build_voxel_grids();
+}
+
+// private //////////////////////////////////////////////////////////////////
+string PolygonGroup::mk_index_cache_fname( PL_REAL scale )
+{
+    // キャッシュキー
+    //   全ポリゴンファイルのパス・フォーマット・サイズ・更新時刻、縮尺率、
+    //   検索モード、並べ替えモード、KD木ノードの最大要素数、実数精度
+    ostringstream key;
+    map<string, string>::const_iterator it;
+    for (it = m_polygon_files.begin(); it != m_polygon_files.end(); it++) {
+        struct stat st;
+        if( stat( it->first.c_str(), &st ) != 0 ) {
+            return "";      // ファイルがない場合は通常の読み込みでエラーとする
+        }
+        key << it->first << '|' << it->second << '|'
+            << (long long int)st.st_size << '|' << (long long int)st.st_mtime << '|';
+    }
+    key << setprecision(17) << scale << '|' << Polylib::get_srch_mode() << '|'
+        << Polylib::get_sort_mode() << '|' << m_max_elements << '|' << sizeof(PL_REAL);
+
+    // FNV-1a(64bit)ハッシュをファイル名とする
+    string skey = key.str();
+    unsigned long long int hash = 14695981039346656037ULL;
+    for( size_t i=0; i<skey.size(); i++ ) {
+        hash ^= (unsigned char)skey[i];
+        hash *= 1099511628211ULL;
+    }
+
+    ostringstream fname;
+    fname << Polylib::get_cache_dir() << "/" 
+          << hex << setw(16) << setfill('0') << hash << "." 
+          << PolygonIO::get_extension_format( PolygonIO::FMT_PLB );
+    return fname.str();
+}
+
+// private //////////////////////////////////////////////////////////////////
+POLYLIB_STAT PolygonGroup::save_polygons_plb(
+    const string&       fname,
+    vector<Triangle*>   *tri_list
+) {
+    vector<VNodeFlat>       nodes;
+    vector<long long int>   elem_idx;
+    POLYLIB_STAT            ret = PLSTAT_OK;
+
+    if (tri_list == NULL) {
+        PL_ERROSH << "[ERROR]PolygonGroup::save_polygons_plb():tri_list is NULL." << endl;
+        return PLSTAT_NG;
+    }
+
+    if( tri_list == m_tri_list && m_vtree != NULL && !m_need_rebuild ) {
+        ret = m_vtree->flatten( tri_list, nodes, elem_idx );
+    }
+    else if( tri_list->size() > 0 ) {
+        // Rank0に集約したポリゴンリスト等は一時的にKD木を作成する
+        BBox bbox;
+        bbox.init();
+        bool detail = Polylib::get_srch_mode();
+        for( int i=0; i<tri_list->size(); i++ ) {
+            BBox bbox_tri = (*tri_list)[i]->get_bbox( detail );
+            bbox.add( bbox_tri.min );
+            bbox.add( bbox_tri.max );
+        }
+        VTree vtree( m_max_elements, bbox, tri_list );
+        ret = vtree.flatten( tri_list, nodes, elem_idx );
+    }
+
+    // KD木を変換できない場合はポリゴンのみ保存する（ロード時に作成）
+    if (ret != PLSTAT_OK) {
+        nodes.clear();
+        elem_idx.clear();
+    }
+
+    return plb_save( tri_list, fname, acq_fullpath(), nodes, elem_idx,
+                     (int)Polylib::get_srch_mode() );
+}
+
 // private //////////////////////////////////////////////////////////////////
 char *PolygonGroup::mk_polygons_fname(
     const string&       rank_no,
@@ -1336,3 +2105,18 @@ int PolygonGroup::create_global_unique_id()
     return global_id++;
 }
 
+/// グループ階層の更新番号
+static unsigned int hierarchy_revision = 0;
+
+// public /////////////////////////////////////////////////////////////////////
+unsigned int PolygonGroup::get_hierarchy_revision()
+{
+    return hierarchy_revision;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void PolygonGroup::update_hierarchy_revision()
+{
+    hierarchy_revision++;
+}
+
@@ -14,6 +14,7 @@
 
 #include "mpi.h"
 #include <vector>
+#include <algorithm>
 #include "Polylib.h"
 
 using namespace std;
@@ -44,11 +45,53 @@ struct TriangleEqual{
 };
 
 
+// load_polygons_mem_reduced()処理 内部用
+//   送信中の分割ポリゴン情報（ランク０のみ）
+struct ScatterChunk {
+    std::vector<long long int>  idata;      // ランク毎のヘッダ(7個ずつ）
+    std::vector<char*>          buffs;      // ランク毎の送信バッファ
+    std::vector<MPI_Request>    reqs;       // 送信リクエスト
+    int                         num_req;    // 送信リクエスト数
+    size_t                      size_buff;  // 送信バッファサイズ合計(byte)
+
+    ScatterChunk() : num_req(0), size_buff(0) {}
+};
+
+// 送信完了待ち・送信バッファ解放
+//   戻り値はMPI関数の戻り値
+static int scatter_chunk_wait( ScatterChunk& ck )
+{
+    int iret = MPI_SUCCESS;
+    if( ck.num_req > 0 ) {
+        iret = MPI_Waitall( ck.num_req, &(ck.reqs[0]), MPI_STATUSES_IGNORE );
+    }
+    for( size_t i=0; i<ck.buffs.size(); i++ ) {
+        if( ck.buffs[i] != NULL ) free( ck.buffs[i] );
+    }
+    ck.buffs.clear();
+    ck.num_req   = 0;
+    ck.size_buff = 0;
+    return iret;
+}
+
+// 送信の進行（完了は待たない）
+static void scatter_chunk_test( ScatterChunk& ck )
+{
+    int flag;
+    if( ck.num_req > 0 ) {
+        MPI_Testall( ck.num_req, &(ck.reqs[0]), &flag, MPI_STATUSES_IGNORE );
+    }
+}
+
+// load_polygons_mem_reduced()で読み込みを小分けにする分割数
+//   小分けの合間に送信中の通信を進める
+#define M_LOAD_READ_DIV 8
+
 // 重複ポリゴン削除用の構造体
 struct TriangleIndex {
     /// キー
     long long int  id;      // ポリゴン
-    int            index;   // vectorの何番目かを示す値
+    size_t         index;   // vectorの何番目かを示す値
 };
 
 // std::sort用ファンクタ   ポリゴンのvectorをソートするのに使用
@@ -332,8 +375,8 @@ PolygonGroup::get_polygons_reduce_sum_atrI(
     {
 
         //int index[numproc];  // ランク毎の先頭インデックス
-        int* index = new int[numproc];
-        int num_tri_tot;
+        size_t* index = new size_t[numproc];
+        size_t  num_tri_tot;
 
         index[0] = 0;
         num_tri_tot = num_tri_ranks[0];
@@ -347,7 +390,7 @@ PolygonGroup::get_polygons_reduce_sum_atrI(
             int           *atrs_tot  = new int          [num_tri_tot];
 
             // 自身の設定
-            int ip = index[0];
+            size_t ip = index[0];
             for(int i=0; i<num_tri_myrank; i++ ) {
                 ids_tot [ip] = ids [i];
                 atrs_tot[ip] = atrs[i];
@@ -359,9 +402,8 @@ PolygonGroup::get_polygons_reduce_sum_atrI(
                 if( num_tri_ranks[irank] > 0 )  {
                     ip = index[irank];
                     // ポリゴンID受信
-                    // MPI_LONG/MPI_LONG_LONG  8byte?  -> use MPI_DOUBLE
                     iret = MPI_Irecv( 
-                                 &ids_tot[ip], num_tri_ranks[irank], MPI_DOUBLE, 
+                                 &ids_tot[ip], num_tri_ranks[irank], MPI_LONG_LONG_INT, 
                                  irank, 1000, comm, &reqs[num_reqs]
                              );
                     num_reqs++;
@@ -382,7 +424,7 @@ PolygonGroup::get_polygons_reduce_sum_atrI(
             std::vector<TriangleIndex> tri_index_list;
             tri_index_list.reserve( num_tri_tot );
             // 構造体に変更
-            for(int i=0; i<num_tri_tot; i++ ) {
+            for(size_t i=0; i<num_tri_tot; i++ ) {
                 TriangleIndex tri_index;
                 tri_index.id    = ids_tot[i];
                 tri_index.index = i;
@@ -422,9 +464,8 @@ PolygonGroup::get_polygons_reduce_sum_atrI(
             int           *p_atrs = &atrs[0];
 
             // ポリゴンID送信
-            // MPI_LONG/MPI_LONG_LONG  8byte?  -> use MPI_DOUBLE
             iret = MPI_Isend( 
-                             p_ids, num_tri_myrank, MPI_DOUBLE, 
+                             p_ids, num_tri_myrank, MPI_LONG_LONG_INT, 
                              0, 1000, comm, &reqs[num_reqs]
                      );
             num_reqs++;
@@ -486,9 +527,9 @@ PolygonGroup::get_polygons_reduce_sum_atrR(
     // ランク０処理        
     if( myrank == 0 )
     {
-        int num_tri_tot;
+        size_t  num_tri_tot;
         //int index[numproc];  // ランク毎の先頭インデックス
-        int* index = new int[numproc];  // ランク毎の先頭インデックス
+        size_t* index = new size_t[numproc];  // ランク毎の先頭インデックス
 
         index[0] = 0;
         num_tri_tot = num_tri_ranks[0];
@@ -502,7 +543,7 @@ PolygonGroup::get_polygons_reduce_sum_atrR(
             PL_REAL       *atrs_tot  = new PL_REAL      [num_tri_tot];
 
             // 自身の設定
-            int ip = index[0];
+            size_t ip = index[0];
             for(int i=0; i<num_tri_myrank; i++ ) {
                 ids_tot [ip] = ids [i];
                 atrs_tot[ip] = atrs[i];
@@ -514,9 +555,8 @@ PolygonGroup::get_polygons_reduce_sum_atrR(
                 if( num_tri_ranks[irank] > 0 )  {
                     ip = index[irank];
                     // ポリゴンID受信
-                    // MPI_LONG/MPI_LONG_LONG  8byte?  -> use MPI_DOUBLE
                     iret = MPI_Irecv( 
-                                 &ids_tot[ip], num_tri_ranks[irank], MPI_DOUBLE, 
+                                 &ids_tot[ip], num_tri_ranks[irank], MPI_LONG_LONG_INT, 
                                  irank, 1000, comm, &reqs[num_reqs]
                              );
                     num_reqs++;
@@ -537,7 +577,7 @@ PolygonGroup::get_polygons_reduce_sum_atrR(
             std::vector<TriangleIndex> tri_index_list;
             tri_index_list.reserve( num_tri_tot );
             // 構造体に変更
-            for(int i=0; i<num_tri_tot; i++ ) {
+            for(size_t i=0; i<num_tri_tot; i++ ) {
                 TriangleIndex tri_index;
                 tri_index.id    = ids_tot[i];
                 tri_index.index = i;
@@ -577,9 +617,8 @@ PolygonGroup::get_polygons_reduce_sum_atrR(
             PL_REAL       *p_atrs = &atrs[0];
 
             // ポリゴンID送信
-            // MPI_LONG/MPI_LONG_LONG  8byte?  -> use MPI_DOUBLE
             iret = MPI_Isend( 
-                             p_ids, num_tri_myrank, MPI_DOUBLE, 
+                             p_ids, num_tri_myrank, MPI_LONG_LONG_INT, 
                              0, 1000, comm, &reqs[num_reqs]
                      );
             num_reqs++;
@@ -656,33 +695,102 @@ PolygonGroup::erase_outbounded_polygons( void )
 
     vector<Triangle*> tri_list;
 
-    ret = get_inbounded_polygons( tri_list );
+    // 隣接PE領域ビットマスクを残すポリゴンに引き継ぐため、
+    //   (ポリゴンのアドレス, 元の位置)をアドレス順で保持しておく
+    bool with_mask = ( m_tri_list != NULL &&
+                       m_ghost_mask.size() == m_tri_list->size() &&
+                       m_ghost_gain.size() == m_tri_list->size() );
+    vector< pair<Triangle*,size_t> > old_pos;
+    if( with_mask ) {
+        old_pos.reserve( m_tri_list->size() );
+        for(size_t i=0; i<m_tri_list->size(); i++ ) {
+            old_pos.push_back( make_pair( (*m_tri_list)[i], i ) );
+        }
+        std::sort( old_pos.begin(), old_pos.end() );
+    }
 
-    //if( tri_list.size()>0 ) {
-    if( ret == PLSTAT_OK ) {
-        // initの中で最初に既存のポリゴンはポインタを指定して削除される。
-        // そのため、別途、外側でnewしないと元のポリゴンを参照できなくなる。
-        // initの中でさらにポリゴンのコピーが作成されるため
-        // 結局、copy_tri_list内のポリゴンは削除する必要がある。
-        //
-        vector<Triangle*> copy_tri_list;
+    // 自領域内ポリゴンを取り出す（自領域外のポリゴンは削除される）
+    ret = detach_inbounded_polygons( tri_list );
 
-        copy_polygons( tri_list, copy_tri_list );
+    if( ret == PLSTAT_OK ) {
+        vector<unsigned long long int> mask, gain;
+        if( with_mask ) {
+            mask.resize( tri_list.size() );
+            gain.resize( tri_list.size() );
+            for(size_t i=0; i<tri_list.size(); i++ ) {
+                vector< pair<Triangle*,size_t> >::iterator it =
+                    std::lower_bound( old_pos.begin(), old_pos.end(), make_pair( tri_list[i], (size_t)0 ) );
+                mask[i] = m_ghost_mask[ it->second ];
+                gain[i] = m_ghost_gain[ it->second ];
+            }
+        }
 
         // 検索結果でポリゴン情報を再構築
-        if( (ret = init( &copy_tri_list, true )) != PLSTAT_OK ) {
-            PL_ERROSH << "[ERROR]PolygonGroup::erase_outbounded_polygons():pg->init() failed. returns:"
+        //   ポリゴンは複製せず、そのまま登録する
+        //   init_swap()はビットマスクを破棄するため、ここで登録する
+        //   登録時の位置との対応が既に取れない（migrate後）場合はそのまま
+        bool order_valid = m_tri_order_valid;
+        init_tri_list();
+        m_tri_list->swap( tri_list );
+        m_ghost_mask.swap( mask );
+        m_ghost_gain.swap( gain );
+        m_tri_order_valid = order_valid;
+        if( (ret = build_polygon_tree()) != PLSTAT_OK ) {
+            PL_ERROSH << "[ERROR]PolygonGroup::erase_outbounded_polygons():build_polygon_tree() failed. returns:"
                       << PolylibStat2::String(ret) << endl;
             return ret;
         }
+    }
+
+    return ret;
+}
+
+
+// public //////////////////////////////////////////////////////////////////
+POLYLIB_STAT
+PolygonGroup::detach_inbounded_polygons(
+        std::vector<Triangle*>  &tri_list
+    )
+{
+#ifdef DEBUG
+    PL_DBGOSH << "PolygonGroup::detach_inbounded_polygons() in. " << endl;
+#endif
+    POLYLIB_STAT ret;
+
+    ret = get_inbounded_polygons( tri_list );
+    if( ret != PLSTAT_OK ) {
+        return ret;
+    }
 
-        // copyポリゴン削除
-        for(int i=0; i<copy_tri_list.size(); i++ ) {
-            delete copy_tri_list[i];
+    if( m_tri_list != NULL ) {
+        // 自領域内ポリゴン(アドレス順)
+        vector<Triangle*> tri_list_keep( tri_list );
+        std::sort( tri_list_keep.begin(), tri_list_keep.end() );
+
+        // 自領域外のポリゴンのみ削除
+        for(int i=0; i<m_tri_list->size(); i++ ) {
+            if( !std::binary_search( tri_list_keep.begin(), tri_list_keep.end(), (*m_tri_list)[i] ) ) {
+                delete (*m_tri_list)[i];
+            }
         }
+        // 自領域内ポリゴンの管理はtri_listに移ったため、リストのみクリア
+        m_tri_list->clear();
     }
 
-    return ret;
+    // KD木はポリゴンを参照しているため削除
+    if( m_vtree != NULL ) {
+        delete m_vtree;
+        m_vtree = NULL;
+    }
+    // 線形BVHは領域を再利用するため空にするのみ
+    if( m_lbvh != NULL ) {
+        m_lbvh->clear();
+    }
+    for( size_t i=0; i<m_vgrid.size(); i++ ) {
+        m_vgrid[i]->clear();
+    }
+
+    return PLSTAT_OK;
 }
 
 
@@ -711,11 +819,8 @@ PolygonGroup::scatter_polygons( void )
         // ポリゴン情報をランク０より受信する
         ret = scatter_receive_polygons( tri_list );
 
-        init( &tri_list, true );
-        // pg->init()でcopyされるので元のポリゴン削除
-        for(int i=0; i<tri_list.size(); i++) {
-            delete tri_list[i];
-        }
+        // 受信したポリゴンは複製せずに登録
+        ret = init_swap( tri_list );
     }
 
     return PLSTAT_OK;
@@ -760,7 +865,7 @@ PolygonGroup::scatter_polygons(
         // ポリゴンを登録する(一時的に使用するため）
         //     copyを防ぐため、ポインタを登録する
         std::vector<Triangle*>  *tri_list_tmp = new std::vector<Triangle*>;
-        *tri_list_tmp = tri_list_div_all;  // 要素のcopy
+        tri_list_tmp->swap( tri_list_div_all );  // 要素の交換
 
         // ポリゴンのポインタの登録・KDツリー等の構築
         set_triangles_ptr( tri_list_tmp, true );
@@ -768,23 +873,17 @@ PolygonGroup::scatter_polygons(
         // ランク０以外に該当ポリゴンを送信する
         ret = scatter_send_polygons();
         
-        // 自担当領域分のポリゴン情報取得する
-        std::vector<Triangle*>  tri_list;
-        ret = get_inbounded_polygons( tri_list );
+        // 自担当領域分のポリゴンを出力域に取り出す（複製しない）
+        //   自担当領域外のポリゴンは削除される
+        ret = detach_inbounded_polygons( tri_list_div_local );
 #ifdef DEBUG
-        PL_DBGOSH << "  get_inbounded_polygons() tri_list.size()="<<tri_list.size() <<endl;
+        PL_DBGOSH << "  detach_inbounded_polygons() tri_list_div_local.size()="<<tri_list_div_local.size() <<endl;
 #endif
 
-        // ポリゴンを出力域にコピーする
-        copy_polygons( tri_list, tri_list_div_local );
-#ifdef DEBUG
-        PL_DBGOSH << "  copy_polygons() tri_list_div_local.size()="<<tri_list_div_local.size() <<endl;
-#endif
-
-        // 一時的に登録したポリゴンを削除する
+        // 一時的に登録したポリゴンリストを削除する
+        //   ポリゴンは取り出し済みのため、リストのみ削除される
         delete_tri_list();
-        // 上記のdelete_tri_list()でtri_list_div_all内の
-        // ポリゴンは削除されているため、リストをクリア
+        // tri_list_div_all内のポリゴンは上記で取り出し、または削除されているため、リストをクリア
         tri_list_div_all.clear();
 
     }
@@ -801,8 +900,7 @@ PolygonGroup::scatter_polygons(
 
 // scatter ランク０の処理 ランク０以外に該当ポリゴンを送信する
 //    rank0のみで呼ばれる
-//      通信サイズをMPI_CHARで指定すると2GBまでしか送信できないため
-//      MPI_DOUBLE単位で送信する。
+//      通信サイズが2GBを超える場合は派生データ型で送信する(mpi_send_bytes())
 POLYLIB_STAT
 PolygonGroup::scatter_send_polygons( void )
 {
@@ -812,7 +910,6 @@ PolygonGroup::scatter_send_polygons( void )
     Polylib* p_inst = Polylib::get_instance();
     MPI_Comm comm   = p_inst->get_MPI_Comm();
     std::vector<ParallelAreaInfo>* p_other_procs_area = p_inst->get_other_procs_area();
-    std::vector<Triangle*>     tri_list;
 
     // その他のランク数ループ
 #ifdef DEBUG
@@ -836,92 +933,105 @@ PolygonGroup::scatter_send_polygons( void )
 #endif
     for( int i=0; i<p_other_procs_area->size(); i++ ) {
         int irank_send = (*p_other_procs_area)[i].m_rank;
-        int num_tri  = 0 ;  // トライアングル数
-        int pl_type  = PL_TYPE_UNKNOWN;
-        int numAtrI  = 0;
-        int numAtrR  = 0;
-        int nsize_pl = 0;           // 1ポリゴンのサイズ
-        int nsize_com_double = 0;   // 全体の通信サイズ(MPI_DOUBLE単位）
-        tri_list.clear();
+        long long int idata[6];
+        char* send_buff = NULL;
+        int iret;
+
+        // 該当ランク領域のポリゴンを送信バッファに詰める
+        scatter_pack_polygons( (*p_other_procs_area)[i], idata, send_buff );
+
+        // ヘッダ情報の送信
+        iret = MPI_Send( idata, 6, MPI_LONG_LONG_INT,
+                     irank_send, 1001, comm );
+    
+        // ポリゴン情報を送信
+        if( send_buff != NULL ) {
+            iret = mpi_send_bytes( send_buff, idata[5],
+                     irank_send, 1002, comm );
             
-        
-        // ポリゴン情報を持つグループだけ
-        if( m_tri_list != NULL && m_tri_list->size() > 0 ) {
-            for( int j=0; j<(*p_other_procs_area)[i].m_areas.size(); j++ ) {   // 複数担当領域
+            free( send_buff );
+        }
+    }
+
+    return PLSTAT_OK;
+}
+
+
+// scatter ランク０の処理 該当ランク領域のポリゴンを送信バッファに詰める
+//    rank0のみで呼ばれる
+POLYLIB_STAT
+PolygonGroup::scatter_pack_polygons(
+            const ParallelAreaInfo& area,
+            long long int           idata[6],
+            char*&                  send_buff
+    )
+{
+    int num_tri  = 0 ;  // トライアングル数
+    int pl_type  = PL_TYPE_UNKNOWN;
+    int numAtrI  = 0;
+    int numAtrR  = 0;
+    int nsize_pl = 0;           // 1ポリゴンのサイズ
+    size_t nsize_com = 0;       // 全体の通信サイズ(byte)
+    std::vector<Triangle*>     tri_list;
+
+    send_buff = NULL;
+
+    // ポリゴン情報を持つグループだけ
+    if( m_tri_list != NULL && m_tri_list->size() > 0 ) {
+        for( int j=0; j<area.m_areas.size(); j++ ) {   // 複数担当領域
 #ifdef DEBUG
     PL_DBGOSH << "pg->search() start" << endl;
 #endif
-                search( tri_list, (*p_other_procs_area)[i].m_areas[j].m_gcell_bbox, false );
+            search( tri_list, area.m_areas[j].m_gcell_bbox, false );
 #ifdef DEBUG
     PL_DBGOSH << "pg->search() end" << endl;
 #endif
-            }
-            // ID重複削除
-            //      IDでソート
+        }
+        // ID重複削除
+        //      IDでソート
 #ifdef DEBUG
     PL_DBGOSH << "std::sort() start" << endl;
 #endif
-            std::sort( tri_list.begin(), tri_list.end(), TriangleLess() );  // TriangleLess():比較用
-            //      ID重複分を削除
+        std::sort( tri_list.begin(), tri_list.end(), TriangleLess() );  // TriangleLess():比較用
+        //      ID重複分を削除
 #ifdef DEBUG
     PL_DBGOSH << "tri_list.erase() start" << endl;
 #endif
-            tri_list.erase(
-                            std::unique( tri_list.begin(), tri_list.end(), TriangleEqual() ), // TriangleEqual():比較用
-                            tri_list.end()
-                        );
-            
-            if( tri_list.size() > 0 ) {
-                num_tri  = tri_list.size();
-                pl_type = tri_list[0]->get_pl_type();
-                numAtrI = tri_list[0]->get_num_atrI();
-                numAtrR = tri_list[0]->get_num_atrR();
-                nsize_pl = tri_list[0]->serialized_size();   // 1ポリゴンのバッファサイズ
-            }
-            // 通信サイズ(MPI_DOUBLE単位）
-            size_t isize = (size_t)(num_tri)* (size_t)(nsize_pl);
-            if( (isize%sizeof(double)) == 0 ) {
-                nsize_com_double = isize/sizeof(double);    
-            } else {
-                nsize_com_double = isize/sizeof(double) + 1;
-            }
+        tri_list.erase(
+                        std::unique( tri_list.begin(), tri_list.end(), TriangleEqual() ), // TriangleEqual():比較用
+                        tri_list.end()
+                    );
+        
+        if( tri_list.size() > 0 ) {
+            num_tri  = tri_list.size();
+            pl_type = tri_list[0]->get_pl_type();
+            numAtrI = tri_list[0]->get_num_atrI();
+            numAtrR = tri_list[0]->get_num_atrR();
+            nsize_pl = tri_list[0]->serialized_size();   // 1ポリゴンのバッファサイズ（旧形式、統計用）
         }
+        // 通信サイズ(byte)  列指向形式
+        nsize_com = serialized_size_polygons( pl_type, numAtrI, numAtrR, num_tri );
+        Polylib::get_instance()->add_comm_stats( nsize_com, (size_t)(num_tri)*(size_t)(nsize_pl) );
+    }
 
-
-        // ヘッダ情報の送信
-        //    ポリゴン数、データタイプ(Triangle/NptTriangle)、
-        //    ユーザ定義属性(整数型）数、ユーザ定義属性(実数型）数  ポリゴングループ内ではユーザ定義属性数は同じ前提あり
-        //    1ポリゴンデータのサイズ(byte)
-        int idata[6];
-        idata[0] = num_tri;
-        idata[1] = pl_type;
-        idata[2] = numAtrI;
-        idata[3] = numAtrR;
-        idata[4] = nsize_pl;
-        idata[5] = nsize_com_double;
-        int iret;
-        
+    // ヘッダ情報
+    //    ポリゴン数、データタイプ(Triangle/NptTriangle)、
+    //    ユーザ定義属性(整数型）数、ユーザ定義属性(実数型）数  ポリゴングループ内ではユーザ定義属性数は同じ前提あり
+    //    1ポリゴンデータのサイズ(byte)、通信サイズ(byte)
+    idata[0] = num_tri;
+    idata[1] = pl_type;
+    idata[2] = numAtrI;
+    idata[3] = numAtrR;
+    idata[4] = nsize_pl;
+    idata[5] = nsize_com;
 #ifdef DEBUG
-    PL_DBGOSH <<"irank_send="<<irank_send<<" num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<nsize_pl<<" nsize_com_double="<<nsize_com_double<<endl;
+    PL_DBGOSH <<"irank_send="<<area.m_rank<<" num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<nsize_pl<<" nsize_com="<<nsize_com<<endl;
 #endif
-        iret = MPI_Send( idata, 6, MPI_INT,
-                     irank_send, 1001, comm );
-    
-        // ポリゴン情報を送信
-        if( num_tri > 0 ) {
-            // バッファに詰める
-            char*  send_buff = (char*)malloc( (size_t)(nsize_com_double)*sizeof(double) );
-            char*  pbuff = send_buff;
-            for(int j=0; j<num_tri; j++ ) {
-                pbuff = tri_list[j]->serialize( pbuff );
-            }
-            
-            // 送信
-            iret = MPI_Send( send_buff, nsize_com_double, MPI_DOUBLE,
-                     irank_send, 1002, comm );
-            
-            free( send_buff );
-        }
+
+    // ポリゴン情報をバッファに詰める
+    if( num_tri > 0 ) {
+        send_buff = (char*)malloc( nsize_com );
+        serialize_polygons( &tri_list[0], num_tri, pl_type, numAtrI, numAtrR, send_buff );
     }
 
     return PLSTAT_OK;
@@ -941,21 +1051,20 @@ PolygonGroup::scatter_receive_polygons(
     Polylib* p_inst = Polylib::get_instance();
     MPI_Comm comm   = p_inst->get_MPI_Comm();
     MPI_Status status;
-    int idata[6];
+    long long int idata[6];
     int iret;
 
     // ヘッダ受信
-    iret = MPI_Recv( idata, 6, MPI_INT, 
+    iret = MPI_Recv( idata, 6, MPI_LONG_LONG_INT, 
                      0, 1001, comm, &status );
 
     int num_tri  = idata[0];    // トライアングル数
     int pl_type  = idata[1];
     int numAtrI  = idata[2];
     int numAtrR  = idata[3];
-    int nsize_pl = idata[4];            // 1ポリゴンのサイズ
-    int nsize_com_double = idata[5];    // 全体の通信サイズ(MPI_DOUBLE単位）
+    size_t nsize_com = idata[5];        // 全体の通信サイズ(byte)
 #ifdef DEBUG
-    PL_DBGOSH << "receive  "<<" num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<nsize_pl<<" nsize_com_double="<<nsize_com_double<<endl;
+    PL_DBGOSH << "receive  "<<" num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<idata[4]<<" nsize_com="<<nsize_com<<endl;
 #endif
     
     if( num_tri == 0 ) {
@@ -963,21 +1072,16 @@ PolygonGroup::scatter_receive_polygons(
     }
 
     // ランク0より受信
-    char*  recv_buff = (char*)malloc( (size_t)(nsize_com_double)*sizeof(double) );
-    char*  pbuff = recv_buff;
+    char*  recv_buff = (char*)malloc( nsize_com );
 
-    iret = MPI_Recv( recv_buff, nsize_com_double, MPI_DOUBLE,
-                             0, 1002, comm, &status );
+    iret = mpi_recv_bytes( recv_buff, nsize_com,
+                             0, 1002, comm );
 
 #ifdef DEBUG
     PL_DBGOSH << "PolygonGroup::scatter_receive_polygons() deserialize start" << endl;
 #endif
-    for(int j=0; j<num_tri; j++ ) {
-        // deserialize: Triangle/NptTrinangleオブジェクト生成
-        Triangle* pTri = deserialize_polygon( pl_type, pbuff );
-        pbuff += nsize_pl;
-        tri_list.push_back( pTri );
-    }
+    // deserialize: Triangle/NptTrinangleオブジェクト生成
+    deserialize_polygons( pl_type, numAtrI, numAtrR, num_tri, recv_buff, tri_list );
 #ifdef DEBUG
     PL_DBGOSH << "PolygonGroup::scatter_receive_polygons() deserialize end" << endl;
 #endif
@@ -1025,8 +1129,7 @@ PolygonGroup::gather_polygons(
 
 // gather ランク０以外の処理 ランク０に該当ポリゴンを送信する
 //    rank0以外のみで呼ばれる
-//      通信サイズをMPI_CHARで指定すると2GBまでしか送信できないため
-//      MPI_DOUBLE単位で送信する。
+//      通信サイズが2GBを超える場合は派生データ型で送信する(mpi_send_bytes())
 POLYLIB_STAT
 PolygonGroup::gather_send_polygons( void )
 {
@@ -1044,7 +1147,7 @@ PolygonGroup::gather_send_polygons( void )
     int numAtrI  = 0;
     int numAtrR  = 0;
     int nsize_pl = 0;           // 1ポリゴンのサイズ
-    int nsize_com_double = 0;   // 全体の通信サイズ(MPI_DOUBLE単位）
+    size_t nsize_com = 0;       // 全体の通信サイズ(byte)
 
     std::vector<Triangle*>* tri_list = m_tri_list;
 #ifdef DEBUG
@@ -1060,19 +1163,15 @@ PolygonGroup::gather_send_polygons( void )
         pl_type = (*tri_list)[0]->get_pl_type();
         numAtrI = (*tri_list)[0]->get_num_atrI();
         numAtrR = (*tri_list)[0]->get_num_atrR();
-        // 1ポリゴンのサイズ
+        // 1ポリゴンのサイズ（旧形式、統計用）
         nsize_pl =  (*tri_list)[0]->serialized_size();
-        // 通信サイズ(MPI_DOUBLE単位）
-        size_t isize = (size_t)(num_tri)* (size_t)(nsize_pl);
-        if( (isize%sizeof(double)) == 0 ) {
-            nsize_com_double = isize/sizeof(double);    
-        } else {
-            nsize_com_double = isize/sizeof(double) + 1;
-        }
+        // 通信サイズ(byte)  列指向形式
+        nsize_com = serialized_size_polygons( pl_type, numAtrI, numAtrR, num_tri );
+        p_inst->add_comm_stats( nsize_com, (size_t)(num_tri)*(size_t)(nsize_pl) );
     }
 #ifdef DEBUG
     PL_DBGOSH << "PolygonGroup::gather_send_polygons() 1" << endl;
-    PL_DBGOSH << "  num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<nsize_pl<<" nsize_com_double="<<nsize_com_double <<endl;
+    PL_DBGOSH << "  num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<nsize_pl<<" nsize_com="<<nsize_com <<endl;
 #endif
 
     // ポリゴン情報を送信
@@ -1083,29 +1182,26 @@ PolygonGroup::gather_send_polygons( void )
             // ヘッダ情報の送信
             //    ポリゴン数、データタイプ(Triangle/NptTriangle)、
             //    ユーザ定義属性(整数型）数、ユーザ定義属性(実数型）数  ポリゴングループ内ではユーザ定義属性数は同じ前提あり
-            //    1ポリゴンデータのサイズ(byte)
-            int idata[6];
+            //    1ポリゴンデータのサイズ(byte)、通信サイズ(byte)
+            long long int idata[6];
             idata[0] = num_tri;
             idata[1] = pl_type;
             idata[2] = numAtrI;
             idata[3] = numAtrR;
             idata[4] = nsize_pl;
-            idata[5] = nsize_com_double;
+            idata[5] = nsize_com;
     
-            iret = MPI_Send( idata, 6, MPI_INT,
+            iret = MPI_Send( idata, 6, MPI_LONG_LONG_INT,
                  0, 1001, comm );
 
             // ポリゴン情報を送信
             if( num_tri > 0 ) {
                 // バッファに詰める
-                char*  send_buff = (char*)malloc( (size_t)(nsize_com_double)*sizeof(double) );
-                char*  pbuff = send_buff;
-                for(int i=0; i<num_tri; i++ ) {
-                    pbuff = (*tri_list)[i]->serialize( pbuff );
-                }
+                char*  send_buff = (char*)malloc( nsize_com );
+                serialize_polygons( &(*tri_list)[0], num_tri, pl_type, numAtrI, numAtrR, send_buff );
         
                 // 送信
-                iret = MPI_Send( send_buff, nsize_com_double, MPI_DOUBLE,
+                iret = mpi_send_bytes( send_buff, nsize_com,
                                0, 1002, comm );
         
                 free( send_buff );
@@ -1138,7 +1234,7 @@ PolygonGroup::gather_recv_polygons(
     int numproc     = p_inst->get_MPI_numproc();
     int iret;
     MPI_Status status;
-    int idata[6];
+    long long int idata[6];
     std::vector<Triangle*>  tri_list_tmp;
 
     // 自ランク(Rank0)の処理
@@ -1152,35 +1248,29 @@ PolygonGroup::gather_recv_polygons(
     for( int irank=1; irank<numproc; irank++ ) {
 
         // ヘッダ受信
-        iret = MPI_Recv( idata, 6, MPI_INT, 
+        iret = MPI_Recv( idata, 6, MPI_LONG_LONG_INT, 
                      irank, 1001, comm, &status );
 
         int num_tri  = idata[0];    // トライアングル数
         int pl_type  = idata[1];
         int numAtrI  = idata[2];
         int numAtrR  = idata[3];
-        int nsize_pl = idata[4];
-        int nsize_com_double = idata[5];
+        size_t nsize_com = idata[5];
 
 #ifdef DEBUG
     PL_DBGOSH << "PolygonGroup::gather_recv_polygons() 1 irank="<<irank <<endl;
-    PL_DBGOSH << "  num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<nsize_pl<<" nsize_com_double="<<nsize_com_double <<endl;
+    PL_DBGOSH << "  num_tri="<<num_tri<<" pl_type="<<pl_type<<" numAtrI="<<numAtrI<<" numAtrR="<<numAtrR<<" nsize_pl="<<idata[4]<<" nsize_com="<<nsize_com <<endl;
 #endif
     
         if( num_tri >  0 ) {
             // 受信
-            char*  recv_buff = (char*)malloc( (size_t)(nsize_com_double)*sizeof(double) );
-            char*  pbuff = recv_buff;
+            char*  recv_buff = (char*)malloc( nsize_com );
 
-            iret = MPI_Recv( recv_buff, nsize_com_double, MPI_DOUBLE,
-                             irank, 1002, comm, &status );
+            iret = mpi_recv_bytes( recv_buff, nsize_com,
+                             irank, 1002, comm );
 
-            for(int j=0; j<num_tri; j++ ) {
-                // deserialize: Triangle/NptTrinangleオブジェクト生成
-                Triangle* pTri = deserialize_polygon( pl_type, pbuff );
-                pbuff += nsize_pl;
-                tri_list_tmp.push_back( pTri );
-            }
+            // deserialize: Triangle/NptTrinangleオブジェクト生成
+            deserialize_polygons( pl_type, numAtrI, numAtrR, num_tri, recv_buff, tri_list_tmp );
             
             free(recv_buff);
         }
@@ -1236,20 +1326,32 @@ PolygonGroup::load_polygons_mem_reduced(
     MPI_Comm comm = p_inst->get_MPI_Comm();
     int myrank    = p_inst->get_MPI_myrank();
     POLYLIB_STAT ret;
-    int iend = 0;
 
 
     // ランク0
+    //   分割ポリゴンk の送信(非同期)中に、分割ポリゴンk+1 を読み込む
+    //   送信バッファは2面(ダブルバッファ)で、3つ目の読み込み前に
+    //   2つ前の分割ポリゴンの送信完了を待つ
+    //   異常時もランク0以外が受信待ちで止まらないよう、
+    //   送信完了待ちと終了判定フラグの送信は必ず行う
     if( myrank == 0 )
     {
+        std::vector<ParallelAreaInfo>* p_other_procs_area = p_inst->get_other_procs_area();
+        int num_other = p_other_procs_area->size();
         PL_REAL size_mem_init = size_mb*1024*1024; // ロード可能メモリサイズ（実数で表現）
         PL_REAL size_mem_cur;   // 現在の残メモリサイズ（実数で表現）
         std::vector<Triangle*>  *tri_list_regist = new std::vector<Triangle*>;
+        POLYLIB_STAT ret_load = PLSTAT_OK;  // 読み込み・送信処理の戻り値
+        int iret;
+
+        // 送信中の分割ポリゴン(ダブルバッファ)
+        ScatterChunk chunk[2];
+        int ichunk = 0;
 
         // ファイル数ループ
         //   １ポリゴングループに対して複数ファイルがあることあり
         map<string, string>::const_iterator it;
-        for (it = m_polygon_files.begin(); it != m_polygon_files.end(); it++) {
+        for (it = m_polygon_files.begin(); it != m_polygon_files.end() && ret_load == PLSTAT_OK; it++) {
             string fname    = it->first;
             string fmt      = it->second;
 
@@ -1264,7 +1366,11 @@ PolygonGroup::load_polygons_mem_reduced(
                 NptTriangle tri_tmp;
                 pl_size = tri_tmp.used_memory_size();
             } else {
-                return PLSTAT_NG;
+                // Polylibバイナリファイル(plb)は分割読み込み不可
+                PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():"
+                          << "Unsupported file format: " << fname << endl;
+                ret_load = PLSTAT_UNKNOWN_FILE_FORMAT;
+                break;
             }
             PL_REAL pl_size_r = pl_size;
 #ifdef DEBUG
@@ -1272,17 +1378,32 @@ PolygonGroup::load_polygons_mem_reduced(
 #endif
 
             // ファイルOpen
-            ifstream ifs;
+            PolygonIfstream ifs;
             ret = PolygonIO::load_file_open( ifs, fname, fmt ); 
+            if( ret != PLSTAT_OK ) {
+                PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():load_file_open() failed. returns:"
+                          << PolylibStat2::String(ret) << endl;
+                ret_load = ret;
+                break;
+            }
 
             bool eof = false;
             // ファイル終了まで読み込む
-            while ( !eof )  {
+            while ( !eof && ret_load == PLSTAT_OK )  {
                 std::vector<Triangle*>  tri_list_div_all;
                 std::vector<Triangle*>  tri_list_div_local;
 
-                // 残メモリサイズ
-                size_mem_cur = size_mem_init - pl_size_r*tri_list_regist->size();
+                // 2つ前の分割ポリゴンの送信完了待ち（送信バッファの再利用のため）
+                iret = scatter_chunk_wait( chunk[ichunk] );
+                if( iret != MPI_SUCCESS ) {
+                    PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():MPI_Waitall() failed." << endl;
+                    ret_load = PLSTAT_MPI_ERROR;
+                    break;
+                }
+
+                // 残メモリサイズ（登録済みポリゴンと送信中のバッファ分を除く）
+                size_mem_cur = size_mem_init - pl_size_r*tri_list_regist->size()
+                                             - (PL_REAL)chunk[1-ichunk].size_buff;
                 // 読み込み可能数
                 int num_read = size_mem_cur / pl_size_r;
 
@@ -1291,28 +1412,83 @@ PolygonGroup::load_polygons_mem_reduced(
 #endif
 
                 if( num_read <= 0 ) {
-                    ret = PLSTAT_LACK_OF_LOAD_MEMORY; // メモリ不足によりロード出来ない 
-                    PL_ERROSH << PolylibStat2::String(ret) <<endl;
-                    return ret;
+                    ret_load = PLSTAT_LACK_OF_LOAD_MEMORY; // メモリ不足によりロード出来ない 
+                    PL_ERROSH << PolylibStat2::String(ret_load) <<endl;
+                    break;
                 }
             
                 // 指定ポリゴン数読み込み
-                int num_tri; // 実際に読み込んだ数
-                ret = PolygonIO::load_file_read( ifs, fmt, 
-                          tri_list_div_all, num_read, num_tri, eof, scale );
+                //   送信中の分割ポリゴンの通信を進めるため、小分けに読み込む
+                int num_tri = 0; // 実際に読み込んだ数
+                int num_read_sub = num_read / M_LOAD_READ_DIV;
+                if( num_read_sub <= 0 ) num_read_sub = num_read;
+                while( !eof && num_tri < num_read ) {
+                    int num_tri_sub;
+                    if( num_read_sub > num_read-num_tri ) num_read_sub = num_read-num_tri;
+                    ret = PolygonIO::load_file_read( ifs, fmt, 
+                              tri_list_div_all, num_read_sub, num_tri_sub, eof, scale );
+                    if( ret != PLSTAT_OK ) {
+                        PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():load_file_read() failed. returns:"
+                                  << PolylibStat2::String(ret) << endl;
+                        ret_load = ret;
+                        break;
+                    }
+                    num_tri += num_tri_sub;
+                    scatter_chunk_test( chunk[1-ichunk] );
+                }
+                if( ret_load != PLSTAT_OK ) {
+                    // 読み込み途中のポリゴンを削除
+                    for(size_t i=0; i<tri_list_div_all.size(); i++ ) {
+                        delete tri_list_div_all[i];
+                    }
+                    break;
+                }
 #ifdef DEBUG
                 PL_DBGOSH << "   load_file_read() tri_list_div_all.size()="<<tri_list_div_all.size()<<" num_read="<<num_read<<" num_tri="<<num_tri <<endl;
 #endif
 
                 if( tri_list_div_all.size() > 0 )  {
-                    // 終了判定フラグ==0(終了なし） 送信
-                    iend = 0;
-                    MPI_Bcast( &iend, 1, MPI_INT, 0, comm );
-
-                    // ポリゴンのスキャタ
-                    ret = scatter_polygons( tri_list_div_all, tri_list_div_local );
+                    // ポリゴンを登録する(一時的に使用するため）・KDツリー等の構築
+                    set_triangles_ptr( tri_list_div_all, true );
+
+                    // ランク０以外に該当ポリゴンを非同期で送信する
+                    //   リクエスト数は送信開始できたものだけ数える
+                    ScatterChunk& ck = chunk[ichunk];
+                    ck.idata.resize( 7*num_other );
+                    ck.buffs.resize( num_other, NULL );
+                    ck.reqs.resize( 2*num_other );
+                    ck.num_req   = 0;
+                    ck.size_buff = 0;
+                    iret = MPI_SUCCESS;
+                    for( int i=0; i<num_other && iret == MPI_SUCCESS; i++ ) {
+                        int            irank_send = (*p_other_procs_area)[i].m_rank;
+                        long long int* idata      = &(ck.idata[7*i]);
+
+                        scatter_pack_polygons( (*p_other_procs_area)[i], idata, ck.buffs[i] );
+                        idata[6] = 0;   // 終了判定フラグ==0(終了なし）
+
+                        iret = MPI_Isend( idata, 7, MPI_LONG_LONG_INT, irank_send, 1011,
+                                   comm, &(ck.reqs[ck.num_req]) );
+                        if( iret != MPI_SUCCESS ) break;
+                        ck.num_req++;
+                        if( ck.buffs[i] != NULL ) {
+                            iret = mpi_isend_bytes( ck.buffs[i], idata[5], irank_send, 1012,
+                                       comm, &(ck.reqs[ck.num_req]) );
+                            if( iret != MPI_SUCCESS ) break;
+                            ck.num_req++;
+                            ck.size_buff += idata[5];
+                        }
+                    }
+                    if( iret != MPI_SUCCESS ) {
+                        PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():MPI_Isend() failed." << endl;
+                        ret_load = PLSTAT_MPI_ERROR;
+                    }
+
+                    // 自担当領域分のポリゴンを取り出す（それ以外は削除）
+                    ret = detach_inbounded_polygons( tri_list_div_local );
+                    delete_tri_list();
 #ifdef DEBUG
-                PL_DBGOSH << "   scatter_polygons() tri_list_div_all.size()="<<tri_list_div_all.size()<<" tri_list_div_local.size()="<<tri_list_div_local.size() <<endl;
+                PL_DBGOSH << "   scatter chunk="<<ichunk<<" tri_list_div_local.size()="<<tri_list_div_local.size()<<" size_buff="<<ck.size_buff <<endl;
 #endif
 
                     // 登録するポリゴンに追加
@@ -1320,6 +1496,9 @@ PolygonGroup::load_polygons_mem_reduced(
                     for(int i=0; i<tri_list_div_local.size();i++ ) {
                         tri_list_regist->push_back( tri_list_div_local[i] );
                     } 
+
+                    // 送信バッファを切り替え
+                    ichunk = 1-ichunk;
                 }
 
             }   // !eof
@@ -1329,42 +1508,104 @@ PolygonGroup::load_polygons_mem_reduced(
 
         } // !ファイル数
 #ifdef DEBUG
-        PL_DBGOSH << "   file read end. tri_list_regist->size()="<<tri_list_regist->size() <<endl;
+        PL_DBGOSH << "   file read end. tri_list_regist->size()="<<tri_list_regist->size()<<" ret_load="<<ret_load <<endl;
 #endif
 
-        // 終了判定フラグ==1 送信
-        iend = 1;
-        MPI_Bcast( &iend, 1, MPI_INT, 0, comm );
+        // 送信中の分割ポリゴンの完了待ち
+        //   異常時も送信中のバッファを解放する前に完了を待つ
+        iret = scatter_chunk_wait( chunk[0] );
+        int iret2 = scatter_chunk_wait( chunk[1] );
+        if( iret == MPI_SUCCESS ) iret = iret2;
+        if( iret != MPI_SUCCESS && ret_load == PLSTAT_OK ) {
+            PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():MPI_Waitall() failed." << endl;
+            ret_load = PLSTAT_MPI_ERROR;
+        }
+
+        // 終了判定フラグ送信
+        //   正常終了:1  異常終了:2（idata[0]に戻り値を設定）
+        std::vector<long long int> idata_end( 7, 0 );
+        idata_end[0] = ret_load;
+        idata_end[6] = (ret_load == PLSTAT_OK) ? 1 : 2;
+        for( int i=0; i<num_other; i++ ) {
+            iret = MPI_Send( &idata_end[0], 7, MPI_LONG_LONG_INT, (*p_other_procs_area)[i].m_rank, 1011, comm );
+            if( iret != MPI_SUCCESS && ret_load == PLSTAT_OK ) {
+                PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():MPI_Send() failed." << endl;
+                ret_load = PLSTAT_MPI_ERROR;
+            }
+        }
+
+        if( ret_load != PLSTAT_OK ) {
+            for(size_t i=0; i<tri_list_regist->size(); i++ ) {
+                delete (*tri_list_regist)[i];
+            }
+            delete tri_list_regist;
+            return ret_load;
+        }
 
         // ポリゴンの登録(登録したものは呼び出し側でdelete出来ない）
         set_triangles_ptr( tri_list_regist );
     }
     // ランク0以外
+    //   受信したポリゴンは直接登録リストに追加する
     else
     {
         std::vector<Triangle*>  *tri_list_regist = new std::vector<Triangle*>;
-        std::vector<Triangle*>  tri_list_div_all_empty;  // 空リスト
+        MPI_Status status;
+        long long int idata[7];
+        POLYLIB_STAT ret_load = PLSTAT_OK;  // 受信処理の戻り値
+        int iret;
 
         // 終了判定フラグ受信までループ
         while ( true )  {
-            std::vector<Triangle*>  tri_list_div_local;
-
-            // 終了判定フラグ受信
-            MPI_Bcast( &iend, 1, MPI_INT, 0, comm );
-            if( iend == 1 )  {
+            // ヘッダ受信
+            iret = MPI_Recv( idata, 7, MPI_LONG_LONG_INT, 0, 1011, comm, &status );
+            if( iret != MPI_SUCCESS ) {
+                PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():MPI_Recv() failed." << endl;
+                ret_load = PLSTAT_MPI_ERROR;
+                break;
+            }
+            if( idata[6] == 1 )  {
+                break;
+            }
+            if( idata[6] == 2 )  {
+                // ランク0で異常終了
+                ret_load = (POLYLIB_STAT)idata[0];
                 break;
             }
 
-            // ポリゴンのスキャタ
-            ret = scatter_polygons( tri_list_div_all_empty, tri_list_div_local );
+            int num_tri  = idata[0];            // トライアングル数
+            int pl_type  = idata[1];
+            int numAtrI  = idata[2];
+            int numAtrR  = idata[3];
+            size_t nsize_com = idata[5];        // 全体の通信サイズ(byte)
+            if( num_tri == 0 ) {
+                continue;
+            }
+
+            // ランク0より受信
+            char*  recv_buff = (char*)malloc( nsize_com );
+            iret = mpi_recv_bytes( recv_buff, nsize_com, 0, 1012, comm );
+            if( iret != MPI_SUCCESS ) {
+                PL_ERROSH << "[ERROR]PolygonGroup::load_polygons_mem_reduced():MPI_Recv() failed." << endl;
+                free( recv_buff );
+                ret_load = PLSTAT_MPI_ERROR;
+                break;
+            }
 
             // 登録するポリゴンに追加
-            tri_list_regist->reserve( tri_list_regist->size()+tri_list_div_local.size() );           
-            for(int i=0; i<tri_list_div_local.size();i++ ) {
-                tri_list_regist->push_back( tri_list_div_local[i] );
-            } 
+            //   deserialize: Triangle/NptTrinangleオブジェクト生成
+            deserialize_polygons( pl_type, numAtrI, numAtrR, num_tri, recv_buff, *tri_list_regist );
+            free( recv_buff );
         } 
 
+        if( ret_load != PLSTAT_OK ) {
+            for(size_t i=0; i<tri_list_regist->size(); i++ ) {
+                delete (*tri_list_regist)[i];
+            }
+            delete tri_list_regist;
+            return ret_load;
+        }
+
         // ポリゴンの登録(登録したものは呼び出し側でdelete出来ない）
         set_triangles_ptr( tri_list_regist );
     }
@@ -1373,6 +1614,5 @@ PolygonGroup::load_polygons_mem_reduced(
     return PLSTAT_OK;
 }
 
-
 #endif
 // eof
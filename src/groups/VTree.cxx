@@ -15,7 +15,10 @@
 #include "polygons/Triangle.h"
 #include "polygons/NptTriangle.h"
 #include "groups/VTree.h"
+#include "groups/LeafKernel.h"
+#include "util/StatsRegistry.h"
 #include <string>
+#include <algorithm>
 
 
 namespace PolylibNS {
@@ -26,6 +29,9 @@ using namespace std;
 static vector<VNode*> m_vnode;
 #endif
 
+/// リーフ判定カーネルの1回の判定要素数
+#define VTREE_LEAF_CHUNK    64
+
 /************************************************************************
  *  
  * VElementクラス
@@ -61,6 +67,7 @@ VNode::VNode()
     m_right = NULL;
     m_axis = AXIS_X;
     m_bbox_search.init();
+    m_soa_stride = 0;
 #ifdef USE_DEPTH
     m_depth = 0;
 #endif
@@ -128,6 +135,86 @@ void VNode::split(const int& max_elem)
     }
 }
 
+// public /////////////////////////////////////////////////////////////////////
+void VNode::build_soa()
+{
+    if (!is_leaf()) {
+        m_soa.clear();
+        m_soa_stride = 0;
+        m_left->build_soa();
+        m_right->build_soa();
+        return;
+    }
+
+    int num = (int)m_vlist.size();
+    int stride = (num + PL_LEAF_SOA_ALIGN - 1) / PL_LEAF_SOA_ALIGN * PL_LEAF_SOA_ALIGN;
+    m_soa.assign( 6*stride, 0.0 );
+    m_soa_stride = stride;
+    for (int i = 0; i < num; i++) {
+        BBox b = m_vlist[i]->get_bbox();
+        const PL_REAL *bmin = b.min;
+        const PL_REAL *bmax = b.max;
+        for (int j = 0; j < 3; j++) {
+            m_soa[ j   *stride + i] = bmin[j];
+            m_soa[(j+3)*stride + i] = bmax[j];
+        }
+    }
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT VNode::restore(
+    const VNodeFlat*        nodes,
+    long long int           num_node,
+    long long int           inode,
+    const long long int*    elem_idx,
+    long long int           num_elem,
+    vector<Triangle*>       *tri_list
+) {
+    const VNodeFlat& nd = nodes[inode];
+
+    m_bbox.setMinMax( Vec3<PL_REAL>(nd.bbox[0], nd.bbox[1], nd.bbox[2]),
+                      Vec3<PL_REAL>(nd.bbox[3], nd.bbox[4], nd.bbox[5]) );
+    m_bbox_search.setMinMax(
+                 Vec3<PL_REAL>(nd.bbox_search[0], nd.bbox_search[1], nd.bbox_search[2]),
+                 Vec3<PL_REAL>(nd.bbox_search[3], nd.bbox_search[4], nd.bbox_search[5]) );
+    if (nd.axis < AXIS_X || nd.axis > AXIS_Z) {
+        return PLSTAT_NG;
+    }
+    m_axis = (AxisEnum)nd.axis;
+
+    // リーフ
+    if (nd.left < 0 && nd.right < 0) {
+        if (nd.elem_begin < 0 || nd.elem_num < 0 || 
+            nd.elem_begin + nd.elem_num > num_elem) {
+            return PLSTAT_NG;
+        }
+        m_vlist.reserve( nd.elem_num );
+        for (long long int i = nd.elem_begin; i < nd.elem_begin+nd.elem_num; i++) {
+            m_vlist.push_back( new VElement( (*tri_list)[elem_idx[i]] ) );
+        }
+        return PLSTAT_OK;
+    }
+
+    // 子ノードは前順で親より後ろに格納されている（循環参照の防止）
+    if (nd.left <= inode || nd.right <= inode || nd.left == nd.right ||
+        nd.left >= num_node || nd.right >= num_node) {
+        return PLSTAT_NG;
+    }
+
+    m_left = new VNode();
+    m_right = new VNode();
+#ifdef USE_DEPTH
+    m_left->m_depth = m_depth+1;
+    m_right->m_depth = m_depth+1;
+#endif
+
+    POLYLIB_STAT ret = m_left->restore( nodes, num_node, nd.left, 
+                                        elem_idx, num_elem, tri_list );
+    if (ret != PLSTAT_OK) return ret;
+    return m_right->restore( nodes, num_node, nd.right, 
+                             elem_idx, num_elem, tri_list );
+}
+
 #ifdef USE_DEPTH
 // public /////////////////////////////////////////////////////////////////////
 void dump_depth(int n) {
@@ -168,6 +255,48 @@ VTree::VTree(
     create( max_elem, bbox, tri_list );
 }
 
+// public /////////////////////////////////////////////////////////////////////
+VTree::VTree(
+    int                 max_elem, 
+    const BBox          bbox, 
+    vector<Triangle*>   *tri_list,
+    const vector<VNodeFlat>&        nodes,
+    const vector<long long int>&    elem_idx
+) {
+    m_root = NULL;
+    m_max_elements = max_elem;
+
+    // 要素インデックスは全ポリゴンを重複なく参照していること
+    bool valid = ( nodes.size() > 0 && elem_idx.size() == tri_list->size() );
+    if (valid) {
+        vector<char> used( tri_list->size(), 0 );
+        for (size_t i = 0; i < elem_idx.size(); i++) {
+            long long int idx = elem_idx[i];
+            if (idx < 0 || idx >= (long long int)tri_list->size() || used[idx]) {
+                valid = false;
+                break;
+            }
+            used[idx] = 1;
+        }
+    }
+
+    if (valid) {
+        m_root = new VNode();
+        POLYLIB_STAT ret = m_root->restore( &nodes[0], nodes.size(), 0,
+                                elem_idx.empty() ? NULL : &elem_idx[0],
+                                elem_idx.size(), tri_list );
+        if (ret == PLSTAT_OK) {
+            m_root->build_soa();
+            return;
+        }
+        destroy();
+    }
+
+    // 復元できない場合は作成し直す
+    PL_ERROSH << "[ERROR]VTree::VTree():Invalid tree data. rebuild tree." << endl;
+    create( max_elem, bbox, tri_list );
+}
+
 // public /////////////////////////////////////////////////////////////////////
 VTree::~VTree()
 {
@@ -200,7 +329,12 @@ vector<Triangle*>* VTree::search(
         exit(1);
     }
     vector<VElement*> vlist;
-    search_recursive(m_root, *bbox, every, &vlist);
+    long long int cnt[2] = { 0, 0 };
+    search_recursive(m_root, *bbox, every, &vlist, cnt);
+    if( StatsRegistry::is_enable() ) {
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_NODES,  cnt[0] );
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_LEAVES, cnt[1] );
+    }
 
     vector<VElement*>::iterator itr=vlist.begin();
 
@@ -250,7 +384,12 @@ POLYLIB_STAT VTree::search(
         return PLSTAT_ROOT_NODE_NOT_EXIST;
     }
     vector<VElement*> vlist;
-    search_recursive(m_root, bbox, every, &vlist);
+    long long int cnt[2] = { 0, 0 };
+    search_recursive(m_root, bbox, every, &vlist, cnt);
+    if( StatsRegistry::is_enable() ) {
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_NODES,  cnt[0] );
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_LEAVES, cnt[1] );
+    }
 
     vector<VElement*>::iterator itr=vlist.begin();
 
@@ -314,9 +453,34 @@ size_t VTree::memory_size()
     size  = sizeof(VTree);
     size += sizeof(VNode)    * node_cnt;
     size += sizeof(VElement) * poly_cnt;
+    size += sizeof(PL_REAL)  * 12 * poly_cnt;  // リーフ判定用SoA配列（端数分は除く）
     return size;
 }
 
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT VTree::flatten(
+    const vector<Triangle*>     *tri_list,
+    vector<VNodeFlat>&          nodes,
+    vector<long long int>&      elem_idx
+) const {
+    nodes.clear();
+    elem_idx.clear();
+    if (m_root == NULL) {
+        return PLSTAT_ROOT_NODE_NOT_EXIST;
+    }
+
+    // ポリゴン -> tri_list内の位置 の対応表（ポインタでソートし二分探索）
+    vector< pair<Triangle*,long long int> > tri_index;
+    tri_index.reserve( tri_list->size() );
+    for (size_t i = 0; i < tri_list->size(); i++) {
+        tri_index.push_back( pair<Triangle*,long long int>((*tri_list)[i], i) );
+    }
+    sort( tri_index.begin(), tri_index.end() );
+
+    elem_idx.reserve( tri_list->size() );
+    return flatten_recursive( m_root, tri_index, nodes, elem_idx );
+}
+
 // public /////////////////////////////////////////////////////////////////////
 const Triangle* VTree::search_nearest(
             const Vec3<PL_REAL>&    pos
@@ -423,13 +587,37 @@ void VTree::search_recursive(
     VNode               *vn, 
     const BBox          &bbox, 
     bool                every, 
-    vector<VElement*>   *vlist
+    vector<VElement*>   *vlist,
+    long long int       cnt[2]
 ) const {
 #ifdef DEBUG_VTREE
 try{
     PL_DBGOSH << "VTree::search_recursive:@@@----------------------@@@" << endl;
 #endif
+    cnt[0]++;
     if (vn->is_leaf()) {
+        const vector<VElement*>& elems = vn->get_vlist();
+        int num    = (int)elems.size();
+        cnt[1] += num;
+        int stride = vn->get_soa_stride();
+        if (!every && num > 0 && stride >= num) {
+            // SoA配列で要素のBBoxが重なるかを一括判定する
+            //   everyの場合は現在の頂点座標で判定するため、SoA配列は使用しない
+            const PL_REAL *bmin = &(vn->get_soa()[0]);
+            const PL_REAL *bmax = bmin + 3*stride;
+            PL_REAL q[6] = { bbox.min.x, bbox.min.y, bbox.min.z,
+                             bbox.max.x, bbox.max.y, bbox.max.z };
+            int hit[VTREE_LEAF_CHUNK];
+            for (int off = 0; off < num; off += VTREE_LEAF_CHUNK) {
+                int cnt  = min( VTREE_LEAF_CHUNK, num - off );
+                int nhit = leaf_box_test( bmin+off, bmax+off, stride, cnt, q, false, hit );
+                for (int i = 0; i < nhit; i++) {
+                    vlist->push_back( elems[off+hit[i]] );
+                }
+            }
+            return;
+        }
+
         vector<VElement*>::const_iterator itr = vn->get_vlist().begin();
         for (; itr != vn->get_vlist().end(); itr++) {
             // determine between bbox and 3 vertices of each triangle.
@@ -478,14 +666,14 @@ try{
 #ifdef USE_DEPTH
         PL_DBGOSH << "VTree::search_recursive:left=" << vn->get_depth() << endl;
 #endif
-        search_recursive(vn->get_left(), bbox, every, vlist);
+        search_recursive(vn->get_left(), bbox, every, vlist, cnt);
     }
 
     if (rbox.crossed(bbox) == true) {
 #ifdef USE_DEPTH
     PL_DBGOSH << "VTree::search_recursive:right=" << vn->get_depth() << endl;
 #endif
-        search_recursive(vn->get_right(), bbox, every, vlist);
+        search_recursive(vn->get_right(), bbox, every, vlist, cnt);
     }
 #ifdef DEBUG_VTREE
 }
@@ -543,6 +731,9 @@ POLYLIB_STAT VTree::create(
         }
     }
 
+    // リーフ判定用のSoA配列
+    m_root->build_soa();
+
 #ifdef USE_DEPTH
     m_root->dump_depth(0);
 #endif
@@ -576,6 +767,56 @@ void VTree::node_count(
     }
 }
 
+// private ////////////////////////////////////////////////////////////////////
+POLYLIB_STAT VTree::flatten_recursive(
+    VNode           *vn,
+    const vector< pair<Triangle*,long long int> >& tri_index,
+    vector<VNodeFlat>&          nodes,
+    vector<long long int>&      elem_idx
+) const {
+    long long int inode = nodes.size();
+    nodes.push_back( VNodeFlat() );
+    {
+        VNodeFlat& nd = nodes[inode];
+        BBox bbox = vn->get_bbox();
+        BBox bbox_search = vn->get_bbox_search();
+        VEC3_TO_REAL( bbox.min,        (nd.bbox+0) );
+        VEC3_TO_REAL( bbox.max,        (nd.bbox+3) );
+        VEC3_TO_REAL( bbox_search.min, (nd.bbox_search+0) );
+        VEC3_TO_REAL( bbox_search.max, (nd.bbox_search+3) );
+        nd.axis       = vn->get_axis();
+        nd.left       = -1;
+        nd.right      = -1;
+        nd.elem_begin = elem_idx.size();
+        nd.elem_num   = 0;
+    }
+
+    if (vn->is_leaf()) {
+        vector<VElement*>& vlist = vn->get_vlist();
+        for (size_t i = 0; i < vlist.size(); i++) {
+            Triangle* tri = vlist[i]->get_triangle();
+            vector< pair<Triangle*,long long int> >::const_iterator it =
+                lower_bound( tri_index.begin(), tri_index.end(),
+                             pair<Triangle*,long long int>(tri, -1) );
+            if (it == tri_index.end() || it->first != tri) {
+                PL_ERROSH << "[ERROR]VTree::flatten():Triangle not found in tri_list." << endl;
+                return PLSTAT_NG;
+            }
+            elem_idx.push_back( it->second );
+        }
+        nodes[inode].elem_num = vlist.size();
+        return PLSTAT_OK;
+    }
+
+    // 子ノード追加でnodesが再配置されるため、添字で参照する
+    nodes[inode].left = nodes.size();
+    POLYLIB_STAT ret = flatten_recursive( vn->get_left(), tri_index, nodes, elem_idx );
+    if (ret != PLSTAT_OK) return ret;
+
+    nodes[inode].right = nodes.size();
+    return flatten_recursive( vn->get_right(), tri_index, nodes, elem_idx );
+}
+
 } //namespace PolylibNS
 // --- ims --->
 
@@ -0,0 +1,243 @@
+/*
+ * Polylib - Polygon Management Library
+ *
+ * Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+ * All rights reserved.
+ *
+ * Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+ * All rights reserved.
+ *
+ */
+
+#include "Polylib.h"
+#include "common/PolylibCommon.h"
+#include "common/Vec3.h"
+#include "common/BBox.h"
+#include "polygons/Triangle.h"
+#include "groups/VoxelGrid.h"
+#include "util/StatsRegistry.h"
+#include <algorithm>
+#include <math.h>
+
+namespace PolylibNS {
+
+using namespace std;
+
+/// ボクセル境界に揃っているとみなす許容誤差（セル幅に対する比）
+///     セル登録時はセルをこの分広げて判定する
+#define VOXEL_ALIGN_TOL 1.0e-4
+
+/// 矩形領域がセル範囲より小さいとみなす誤差（セル幅に対する比）
+#define VOXEL_INNER_TOL 1.0e-6
+
+
+/************************************************************************
+ *
+ * VoxelGridクラス
+ *
+ ***********************************************************************/
+// public /////////////////////////////////////////////////////////////////////
+VoxelGrid::VoxelGrid(
+        const Vec3<PL_REAL>&    org,
+        const Vec3<PL_REAL>&    dx,
+        const int               num[3]
+    )
+    : m_org(org), m_dx(dx)
+{
+    for( int i=0; i<3; i++ ) {
+        m_num[i] = (num[i] > 0) ? num[i] : 0;
+    }
+    m_tri = NULL;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT VoxelGrid::build(
+        const vector<Triangle*>     *tri_list
+    )
+{
+    m_tri = tri_list;
+    long long int ncell = (long long int)m_num[0] * m_num[1] * m_num[2];
+    m_cell_ptr.assign( ncell+1, 0 );
+    m_pair_cell.clear();
+    m_pair_tri.clear();
+    m_cell_tri.clear();
+    if( tri_list == NULL || ncell == 0 ) {
+        return PLSTAT_OK;
+    }
+
+    const PL_REAL *org = m_org;
+    const PL_REAL *dx  = m_dx;
+
+    // 三角形のBBoxと重なるセルの組を作成
+    //   木構造の検索(every=false)と同じくBBoxの重なりで登録する
+    //   covers()が許容する境界の誤差分、セルを広げて判定する
+    for( int n=0; n<(int)tri_list->size(); n++ ) {
+        BBox bbox_tri = (*tri_list)[n]->get_bbox( true );
+        const PL_REAL *vmin = bbox_tri.min;
+        const PL_REAL *vmax = bbox_tri.max;
+        int cmin[3], cmax[3];
+        bool outside = false;
+        for( int j=0; j<3; j++ ) {
+            double lo = ceil ( (vmin[j] - org[j]) / dx[j] - VOXEL_ALIGN_TOL ) - 1.0;
+            double hi = floor( (vmax[j] - org[j]) / dx[j] + VOXEL_ALIGN_TOL );
+            if( hi < 0.0 || lo > m_num[j]-1 ) {
+                outside = true;
+                break;
+            }
+            cmin[j] = (lo < 0.0)         ? 0          : (int)lo;
+            cmax[j] = (hi > m_num[j]-1)  ? m_num[j]-1 : (int)hi;
+        }
+        if( outside )   continue;
+
+        for( int k=cmin[2]; k<=cmax[2]; k++ ) {
+            for( int jj=cmin[1]; jj<=cmax[1]; jj++ ) {
+                for( int i=cmin[0]; i<=cmax[0]; i++ ) {
+                    long long int c = cell_index( i, jj, k );
+                    m_pair_cell.push_back( c );
+                    m_pair_tri.push_back( n );
+                    m_cell_ptr[c+1]++;
+                }
+            }
+        }
+    }
+
+    // セル毎に並べる（ポリゴン位置の順序は保持）
+    for( long long int c=0; c<ncell; c++ ) {
+        m_cell_ptr[c+1] += m_cell_ptr[c];
+    }
+    m_cell_tri.resize( m_pair_tri.size() );
+    vector<long long int> pos( m_cell_ptr.begin(), m_cell_ptr.end()-1 );
+    for( size_t p=0; p<m_pair_tri.size(); p++ ) {
+        m_cell_tri[ pos[ m_pair_cell[p] ]++ ] = m_pair_tri[p];
+    }
+
+#ifdef DEBUG
+    PL_DBGOSH << "VoxelGrid::build() num_cell=" << ncell
+              << " num_tri=" << tri_list->size()
+              << " num_entry=" << m_cell_tri.size() << endl;
+#endif
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void VoxelGrid::clear( void )
+{
+    m_tri = NULL;
+    m_cell_ptr.clear();
+    m_cell_tri.clear();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+bool VoxelGrid::covers(
+        const BBox&     bbox,
+        int             range[6]
+    ) const
+{
+    if( m_cell_ptr.empty() ) {
+        return false;
+    }
+    const PL_REAL *org = m_org;
+    const PL_REAL *dx  = m_dx;
+    const PL_REAL *bmin = bbox.min;
+    const PL_REAL *bmax = bbox.max;
+    for( int j=0; j<3; j++ ) {
+        double fmin = (bmin[j] - org[j]) / dx[j];
+        double fmax = (bmax[j] - org[j]) / dx[j];
+        double imin = floor( fmin + 0.5 );
+        double imax = floor( fmax + 0.5 );
+        if( fabs(fmin - imin) > VOXEL_ALIGN_TOL )   return false;
+        if( fabs(fmax - imax) > VOXEL_ALIGN_TOL )   return false;
+        // セル範囲より小さい矩形領域は木構造で検索する
+        if( fmin - imin > VOXEL_INNER_TOL )     return false;
+        if( imax - fmax > VOXEL_INNER_TOL )     return false;
+        if( imin < 0.0 || imax > m_num[j] || imin >= imax ) return false;
+        range[j]   = (int)imin;
+        range[j+3] = (int)imax;
+    }
+    return true;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT VoxelGrid::search(
+        vector<Triangle*>&  tri_list,
+        const BBox&         bbox,
+        const int           range[6],
+        bool                every
+    ) const
+{
+    if( m_tri == NULL ) {
+        return PLSTAT_OK;
+    }
+
+    // 範囲内のセルのポリゴン位置を集め、重複を除く
+    vector<int> idx;
+    for( int k=range[2]; k<range[5]; k++ ) {
+        for( int j=range[1]; j<range[4]; j++ ) {
+            for( int i=range[0]; i<range[3]; i++ ) {
+                long long int c = cell_index( i, j, k );
+                idx.insert( idx.end(), m_cell_tri.begin() + m_cell_ptr[c],
+                                       m_cell_tri.begin() + m_cell_ptr[c+1] );
+            }
+        }
+    }
+    if( range[3]-range[0] > 1 || range[4]-range[1] > 1 || range[5]-range[2] > 1 ) {
+        std::sort( idx.begin(), idx.end() );
+        idx.erase( std::unique( idx.begin(), idx.end() ), idx.end() );
+    }
+
+    // セルは境界の誤差分広げて登録しているため、木構造と同じ判定で絞り込む
+    for( size_t n=0; n<idx.size(); n++ ) {
+        Triangle *tri = (*m_tri)[ idx[n] ];
+        if( every ) {
+            const Vec3<PL_REAL> *v = tri->get_vertexes();
+            if( !bbox.contain(v[0]) || !bbox.contain(v[1]) || !bbox.contain(v[2]) ) {
+                continue;
+            }
+        } else {
+            if( !tri->get_bbox( true ).crossed( bbox ) )    continue;
+        }
+        tri_list.push_back( tri );
+    }
+
+    // セルをノード、セル内のポリゴンをリーフ要素として数える
+    if( StatsRegistry::is_enable() ) {
+        long long int num_cell = (long long int)(range[3]-range[0]) * (range[4]-range[1]) * (range[5]-range[2]);
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_NODES,  num_cell );
+        StatsRegistry::get_instance()->add_count( PL_STATS_SEARCH_LEAVES, (long long int)idx.size() );
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+POLYLIB_STAT VoxelGrid::search_cell(
+        vector<Triangle*>&  tri_list,
+        int                 i,
+        int                 j,
+        int                 k
+    ) const
+{
+    if( i < 0 || i >= m_num[0] || j < 0 || j >= m_num[1] || k < 0 || k >= m_num[2] ) {
+        PL_ERROSH << "[ERROR]VoxelGrid::search_cell():Cell out of range: "
+                  << i << " " << j << " " << k << endl;
+        return PLSTAT_NG;
+    }
+    if( m_tri == NULL ) {
+        return PLSTAT_OK;
+    }
+    long long int c = cell_index( i, j, k );
+    for( long long int p=m_cell_ptr[c]; p<m_cell_ptr[c+1]; p++ ) {
+        tri_list.push_back( (*m_tri)[ m_cell_tri[p] ] );
+    }
+    return PLSTAT_OK;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+size_t VoxelGrid::memory_size() const
+{
+    size_t size = sizeof(VoxelGrid);
+    size += sizeof(long long int) * ( m_cell_ptr.capacity() + m_pair_cell.capacity() );
+    size += sizeof(int) * ( m_cell_tri.capacity() + m_pair_tri.capacity() );
+    return size;
+}
+
+} //namespace PolylibNS
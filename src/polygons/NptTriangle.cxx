@@ -23,32 +23,6 @@
 using namespace std;
 using namespace PolylibNS;
 
-//  NpatchParam p  -> PL_REAL r[21]
-#define NPATCH_PARAM_TO_REAL21(p,r) \
-            {   \
-                (r)[ 0]=(p).cp_side1_1.x;  (r)[ 1]=(p).cp_side1_1.y;  (r)[ 2]=(p).cp_side1_1.z; \
-                (r)[ 3]=(p).cp_side1_2.x;  (r)[ 4]=(p).cp_side1_2.y;  (r)[ 5]=(p).cp_side1_2.z; \
-                (r)[ 6]=(p).cp_side2_1.x;  (r)[ 7]=(p).cp_side2_1.y;  (r)[ 8]=(p).cp_side2_1.z; \
-                (r)[ 9]=(p).cp_side2_2.x;  (r)[10]=(p).cp_side2_2.y;  (r)[11]=(p).cp_side2_2.z; \
-                (r)[12]=(p).cp_side3_1.x;  (r)[13]=(p).cp_side3_1.y;  (r)[14]=(p).cp_side3_1.z; \
-                (r)[15]=(p).cp_side3_2.x;  (r)[16]=(p).cp_side3_2.y;  (r)[17]=(p).cp_side3_2.z; \
-                (r)[18]=(p).cp_center.x;   (r)[19]=(p).cp_center.y;   (r)[20]=(p).cp_center.z;  \
-            }
-
-
-//  PL_REAL r[21]  ->  NpatchParam p
-#define REAL21_TO_NPATCH_PARAM(r,p) \
-            {   \
-                (p).cp_side1_1.x=(r)[ 0];  (p).cp_side1_1.y=(r)[ 1];  (p).cp_side1_1.z=(r)[ 2]; \
-                (p).cp_side1_2.x=(r)[ 3];  (p).cp_side1_2.y=(r)[ 4];  (p).cp_side1_2.z=(r)[ 5]; \
-                (p).cp_side2_1.x=(r)[ 6];  (p).cp_side2_1.y=(r)[ 7];  (p).cp_side2_1.z=(r)[ 8]; \
-                (p).cp_side2_2.x=(r)[ 9];  (p).cp_side2_2.y=(r)[10];  (p).cp_side2_2.z=(r)[11]; \
-                (p).cp_side3_1.x=(r)[12];  (p).cp_side3_1.y=(r)[13];  (p).cp_side3_1.z=(r)[14]; \
-                (p).cp_side3_2.x=(r)[15];  (p).cp_side3_2.y=(r)[16];  (p).cp_side3_2.z=(r)[17]; \
-                (p).cp_center.x =(r)[18];  (p).cp_center.y =(r)[19];  (p).cp_center.z =(r)[20]; \
-            }
-
-
 /************************************************************************
  *
  * NptTriangleクラス
@@ -229,6 +203,27 @@ void NptTriangle::set_vertexes(
     if(calc_area) this->calc_area();
 }
 
+/// ポリゴンのアフィン変換
+///     長田パッチの制御点は絶対座標のため、頂点と同様に変換する
+///
+void NptTriangle::transform(
+        const PL_REAL   mat[4][4],
+        const PL_REAL   nmat[3][3],
+        bool            update_normal,
+        bool            update_area
+     )
+{
+    Triangle::transform( mat, nmat, update_normal, update_area );
+
+    transform_point( mat, m_npatchParam.cp_side1_1 );
+    transform_point( mat, m_npatchParam.cp_side1_2 );
+    transform_point( mat, m_npatchParam.cp_side2_1 );
+    transform_point( mat, m_npatchParam.cp_side2_2 );
+    transform_point( mat, m_npatchParam.cp_side3_1 );
+    transform_point( mat, m_npatchParam.cp_side3_2 );
+    transform_point( mat, m_npatchParam.cp_center  );
+}
+
 
 #ifdef USE_NPATCH_LIB
 ///
@@ -13,6 +13,7 @@
 #include <string>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 #include "polygons/Triangle.h"
 
@@ -181,6 +182,37 @@ void Triangle::set_vertexes(
 }
 
 
+/// ポリゴンのアフィン変換
+///     外積は (a*L)x(b*L) = (axb)*cof(L) となるため、
+///     法線ベクトルは余因子行列で変換し、面積は変換後の長さの比で更新する
+///
+///  仮想関数のため、ヘッダでのinline展開は止める
+///
+void Triangle::transform(
+        const PL_REAL   mat[4][4],
+        const PL_REAL   nmat[3][3],
+        bool            update_normal,
+        bool            update_area
+     )
+{
+    transform_point( mat, m_vertex[0] );
+    transform_point( mat, m_vertex[1] );
+    transform_point( mat, m_vertex[2] );
+    if( !update_normal && !update_area ) return;
+
+    PL_REAL x = m_normal.x, y = m_normal.y, z = m_normal.z;
+    PL_REAL nx = x*nmat[0][0] + y*nmat[1][0] + z*nmat[2][0];
+    PL_REAL ny = x*nmat[0][1] + y*nmat[1][1] + z*nmat[2][1];
+    PL_REAL nz = x*nmat[0][2] + y*nmat[1][2] + z*nmat[2][2];
+    PL_REAL len = sqrt( nx*nx + ny*ny + nz*nz );
+    if( update_normal && len > 0.0 ) {
+        m_normal.assign( nx/len, ny/len, nz/len );
+    }
+    if( update_area ) {
+        m_area *= len;
+    }
+}
+
 
 // protected //////////////////////////////////////////////////////////////////
 // システムで一意のポリゴンIDを作成する
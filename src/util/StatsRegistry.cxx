@@ -0,0 +1,247 @@
+/*
+* Polylib - Polygon Management Library
+*
+* Copyright (c) 2010-2011 VCAD System Research Program, RIKEN.
+* All rights reserved.
+*
+* Copyright (c) 2012-2016 Advanced Institute for Computational Science, RIKEN.
+* All rights reserved.
+*
+*/
+
+#include <string>
+#include <iomanip>
+#include "util/StatsRegistry.h"
+
+namespace PolylibNS {
+
+using namespace std;
+
+/// 処理区分の名称（JSON出力のキー）
+static const char* stats_phase_names[PL_STATS_NUM_PHASE] = {
+    "load", "build", "refit", "search", "move", "migrate", "save"
+};
+
+/// カウンタ区分の名称（JSON出力のキー）
+static const char* stats_counter_names[PL_STATS_NUM_COUNTER] = {
+    "search_nodes", "search_leaves", "search_results",
+    "migrate_bytes", "migrate_msgs", "save_bytes"
+};
+
+bool StatsRegistry::m_enable = false;
+
+/************************************************************************
+ *
+ * StatsRegistryクラス
+ *
+ ***********************************************************************/
+// static & public ////////////////////////////////////////////////////////////
+StatsRegistry* StatsRegistry::get_instance()
+{
+    static StatsRegistry m_instance;
+    return &m_instance;
+}
+
+// private ////////////////////////////////////////////////////////////////////
+StatsRegistry::StatsRegistry()
+{
+    reset();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::reset( void )
+{
+    for( int i=0; i<PL_STATS_NUM_PHASE; i++ ) {
+        m_time[i]  = 0.0;
+        m_calls[i] = 0;
+    }
+    for( int i=0; i<PL_STATS_NUM_COUNTER; i++ ) {
+        m_count[i] = 0;
+    }
+    m_nbr_bytes.clear();
+    m_nbr_msgs.clear();
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::add_time( int phase, double time )
+{
+    if( phase < 0 || phase >= PL_STATS_NUM_PHASE )  return;
+
+    // 並列移動時は複数スレッドから呼ばれる
+#ifdef _OPENMP
+#pragma omp critical (polylib_stats)
+#endif
+    {
+        m_time[phase] += time;
+        m_calls[phase]++;
+    }
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::add_count( int counter, long long int num )
+{
+    if( counter < 0 || counter >= PL_STATS_NUM_COUNTER )    return;
+
+#ifdef _OPENMP
+#pragma omp critical (polylib_stats)
+#endif
+    m_count[counter] += num;
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::add_neighbour( int rank, long long int bytes, long long int msgs )
+{
+#ifdef _OPENMP
+#pragma omp critical (polylib_stats)
+#endif
+    {
+        m_nbr_bytes[rank] += bytes;
+        m_nbr_msgs[rank]  += msgs;
+        m_count[PL_STATS_MIGRATE_BYTES] += bytes;
+        m_count[PL_STATS_MIGRATE_MSGS]  += msgs;
+    }
+}
+
+// public /////////////////////////////////////////////////////////////////////
+double StatsRegistry::get_time( int phase ) const
+{
+    if( phase < 0 || phase >= PL_STATS_NUM_PHASE )  return 0.0;
+    return m_time[phase];
+}
+
+// public /////////////////////////////////////////////////////////////////////
+long long int StatsRegistry::get_calls( int phase ) const
+{
+    if( phase < 0 || phase >= PL_STATS_NUM_PHASE )  return 0;
+    return m_calls[phase];
+}
+
+// public /////////////////////////////////////////////////////////////////////
+long long int StatsRegistry::get_count( int counter ) const
+{
+    if( counter < 0 || counter >= PL_STATS_NUM_COUNTER )    return 0;
+    return m_count[counter];
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::get_neighbours(
+        vector<int>&            ranks,
+        vector<long long int>&  bytes,
+        vector<long long int>&  msgs
+    ) const
+{
+    ranks.clear();
+    bytes.clear();
+    msgs.clear();
+    map<int,long long int>::const_iterator it;
+    for( it = m_nbr_bytes.begin(); it != m_nbr_bytes.end(); it++ ) {
+        ranks.push_back( it->first );
+        bytes.push_back( it->second );
+        msgs.push_back( m_nbr_msgs.find(it->first)->second );
+    }
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::get_values( vector<double>& vals ) const
+{
+    vals.resize( num_values() );
+    for( int i=0; i<PL_STATS_NUM_PHASE; i++ ) {
+        vals[i]                      = m_time[i];
+        vals[PL_STATS_NUM_PHASE + i] = (double)m_calls[i];
+    }
+    for( int i=0; i<PL_STATS_NUM_COUNTER; i++ ) {
+        vals[2*PL_STATS_NUM_PHASE + i] = (double)m_count[i];
+    }
+}
+
+// static & public ////////////////////////////////////////////////////////////
+const char* StatsRegistry::phase_name( int phase )
+{
+    if( phase < 0 || phase >= PL_STATS_NUM_PHASE )  return "";
+    return stats_phase_names[phase];
+}
+
+// static & public ////////////////////////////////////////////////////////////
+const char* StatsRegistry::counter_name( int counter )
+{
+    if( counter < 0 || counter >= PL_STATS_NUM_COUNTER )    return "";
+    return stats_counter_names[counter];
+}
+
+// public /////////////////////////////////////////////////////////////////////
+void StatsRegistry::write_json( ostream& os, int rank, int indent ) const
+{
+    string sp( indent, ' ' );
+    streamsize prec = os.precision( 9 );
+
+    os << sp << "{" << endl;
+    os << sp << "  \"rank\": " << rank << "," << endl;
+    os << sp << "  \"phases\": {" << endl;
+    for( int i=0; i<PL_STATS_NUM_PHASE; i++ ) {
+        os << sp << "    \"" << stats_phase_names[i] << "\": { \"calls\": " << m_calls[i]
+           << ", \"time\": " << m_time[i] << " }"
+           << ( i < PL_STATS_NUM_PHASE-1 ? "," : "" ) << endl;
+    }
+    os << sp << "  }," << endl;
+    os << sp << "  \"counters\": {" << endl;
+    for( int i=0; i<PL_STATS_NUM_COUNTER; i++ ) {
+        os << sp << "    \"" << stats_counter_names[i] << "\": " << m_count[i]
+           << ( i < PL_STATS_NUM_COUNTER-1 ? "," : "" ) << endl;
+    }
+    os << sp << "  }," << endl;
+    os << sp << "  \"neighbours\": [";
+    map<int,long long int>::const_iterator it;
+    for( it = m_nbr_bytes.begin(); it != m_nbr_bytes.end(); it++ ) {
+        os << ( it == m_nbr_bytes.begin() ? "" : "," ) << endl;
+        os << sp << "    { \"rank\": " << it->first << ", \"bytes\": " << it->second
+           << ", \"msgs\": " << m_nbr_msgs.find(it->first)->second << " }";
+    }
+    os << ( m_nbr_bytes.empty() ? "" : "\n" + sp + "  " ) << "]" << endl;
+    os << sp << "}";
+
+    os.precision( prec );
+}
+
+// static & public ////////////////////////////////////////////////////////////
+void StatsRegistry::write_json_summary(
+        ostream&                os,
+        const vector<double>&   vmin,
+        const vector<double>&   vmax,
+        const vector<double>&   vavg,
+        int                     indent
+    )
+{
+    if( (int)vmin.size() < num_values() || (int)vmax.size() < num_values()
+     || (int)vavg.size() < num_values() ) {
+        return;
+    }
+    string sp( indent, ' ' );
+    streamsize prec = os.precision( 9 );
+
+    os << sp << "{" << endl;
+    os << sp << "  \"phases\": {" << endl;
+    for( int i=0; i<PL_STATS_NUM_PHASE; i++ ) {
+        int it = i;
+        int ic = PL_STATS_NUM_PHASE + i;
+        os << sp << "    \"" << stats_phase_names[i] << "\": {" << endl;
+        os << sp << "      \"calls\": { \"min\": " << vmin[ic] << ", \"max\": " << vmax[ic]
+           << ", \"avg\": " << vavg[ic] << " }," << endl;
+        os << sp << "      \"time\": { \"min\": " << vmin[it] << ", \"max\": " << vmax[it]
+           << ", \"avg\": " << vavg[it] << " }" << endl;
+        os << sp << "    }" << ( i < PL_STATS_NUM_PHASE-1 ? "," : "" ) << endl;
+    }
+    os << sp << "  }," << endl;
+    os << sp << "  \"counters\": {" << endl;
+    for( int i=0; i<PL_STATS_NUM_COUNTER; i++ ) {
+        int ic = 2*PL_STATS_NUM_PHASE + i;
+        os << sp << "    \"" << stats_counter_names[i] << "\": { \"min\": " << vmin[ic]
+           << ", \"max\": " << vmax[ic] << ", \"avg\": " << vavg[ic] << " }"
+           << ( i < PL_STATS_NUM_COUNTER-1 ? "," : "" ) << endl;
+    }
+    os << sp << "  }" << endl;
+    os << sp << "}";
+
+    os.precision( prec );
+}
+
+} //namespace PolylibNS
@@ -49,4 +49,16 @@ bool getrusage_sec(double *usr_time, double *sys_time, double *total)
 #endif
 }
 
+double get_wall_time( void )
+{
+#ifdef WIN32
+	return (double)clock()/CLOCKS_PER_SEC;
+#else
+	struct timeval	tt;
+
+	gettimeofday(&tt, NULL);
+	return tt.tv_sec + (double)tt.tv_usec*1.e-6;
+#endif
+}
+
 } //namespace PolylibNS
@@ -122,6 +122,113 @@ void move_func_c (
 #endif
 }
 
+//----------------------------------------------------
+//  一括取得・設定の確認
+//    グループ指定の一括取得が１ポリゴン毎の取得と一致すること
+//    一括設定した値が一括取得で戻ること
+//    戻り値は不一致の数
+//----------------------------------------------------
+
+int check_bulk_access (
+          PL_GRP_TAG      pg_tag
+       )
+{
+    int  num_tri;
+    int  num_atr = 2;
+    int  i,j,n;
+    int  nerr = 0;
+    PL_ELM_TAG* tags_tri;
+    PL_REAL *vtx_org, *vtx_set, *vtx_get, *nrm;
+    int     *atrI;
+    PL_REAL *atrR;
+    PL_REAL vertex[9];
+    PL_REAL normal[3];
+
+    polylib_group_get_triangles( pg_tag, &num_tri, &tags_tri );
+    if( num_tri != polylib_group_get_num_triangles( pg_tag ) ) {
+        free(tags_tri);
+        return 1;
+    }
+    if( num_tri == 0 ) {
+        free(tags_tri);
+        return 0;
+    }
+
+    vtx_org = (PL_REAL*)malloc( 9*num_tri*sizeof(PL_REAL) );
+    vtx_set = (PL_REAL*)malloc( 9*num_tri*sizeof(PL_REAL) );
+    vtx_get = (PL_REAL*)malloc( 9*num_tri*sizeof(PL_REAL) );
+    nrm     = (PL_REAL*)malloc( 3*num_tri*sizeof(PL_REAL) );
+    atrI    = (int*)    malloc( num_atr*num_tri*sizeof(int) );
+    atrR    = (PL_REAL*)malloc( num_atr*num_tri*sizeof(PL_REAL) );
+
+    // 一括取得（グループ指定）と１ポリゴン毎の取得
+    polylib_group_get_vertexes( pg_tag, vtx_org );
+    polylib_group_get_normals( pg_tag, nrm );
+    for( i=0; i<num_tri; i++ ) {
+        polylib_triangle_get_vertexes( tags_tri[i], vertex );
+        polylib_triangle_get_normal( tags_tri[i], normal );
+        for( j=0; j<9; j++ ) {
+            if( vtx_org[9*i+j] != vertex[j] )  nerr++;
+        }
+        for( j=0; j<3; j++ ) {
+            if( nrm[3*i+j] != normal[j] )  nerr++;
+        }
+    }
+
+    // 一括設定（グループ指定）-> 一括取得（タグ配列指定）
+    for( i=0; i<9*num_tri; i++ ) {
+        vtx_set[i] = vtx_org[i] + 0.5;
+    }
+    polylib_group_set_vertexes( pg_tag, vtx_set );
+    polylib_triangles_get_vertexes( num_tri, tags_tri, vtx_get );
+    for( i=0; i<9*num_tri; i++ ) {
+        if( vtx_get[i] != vtx_set[i] )  nerr++;
+    }
+
+    // 一括設定（タグ配列指定）で元に戻す -> 一括取得（グループ指定）
+    polylib_triangles_set_vertexes( num_tri, tags_tri, vtx_org );
+    polylib_group_get_vertexes( pg_tag, vtx_get );
+    for( i=0; i<9*num_tri; i++ ) {
+        if( vtx_get[i] != vtx_org[i] )  nerr++;
+    }
+
+    // ユーザ定義属性
+    //   ポリゴンの属性数を超える分は設定されず、取得時は0となる
+    for( i=0; i<num_atr*num_tri; i++ ) {
+        atrI[i] = i + 1;
+        atrR[i] = (PL_REAL)(i + 1);
+    }
+    polylib_group_set_atrI( pg_tag, num_atr, atrI );
+    polylib_group_set_atrR( pg_tag, num_atr, atrR );
+    polylib_triangles_get_atrI( num_tri, tags_tri, num_atr, atrI );
+    polylib_triangles_get_atrR( num_tri, tags_tri, num_atr, atrR );
+    for( i=0; i<num_tri; i++ ) {
+        for( j=0; j<num_atr; j++ ) {
+            n = num_atr*i + j;
+            if( j < polylib_triangle_get_num_atrI( tags_tri[i] ) ) {
+                if( atrI[n] != n + 1 )  nerr++;
+            } else {
+                if( atrI[n] != 0 )      nerr++;
+            }
+            if( j < polylib_triangle_get_num_atrR( tags_tri[i] ) ) {
+                if( atrR[n] != (PL_REAL)(n + 1) )  nerr++;
+            } else {
+                if( atrR[n] != 0.0 )    nerr++;
+            }
+        }
+    }
+
+    free(vtx_org);
+    free(vtx_set);
+    free(vtx_get);
+    free(nrm);
+    free(atrI);
+    free(atrR);
+    free(tags_tri);
+
+    return nerr;
+}
+
 //----------------------------------------------------
 //  メインルーチン
 //----------------------------------------------------
@@ -222,6 +329,13 @@ int main(int argc, char** argv )
         //printf( "(rk:%d) vertex p3=%f %f %f\n",myrank,vertex[6],vertex[7],vertex[8] );
 
 
+        // 一括取得・設定の確認
+        iret = check_bulk_access( pg_tags[i] );
+        if( iret != 0 ) {
+           printf( "# ERROR :check_bulk_access() pg_name=%s  nerr=%d\n",pg_name,iret);
+           exit(1);
+        }
+
         // 移動関数登録
         if( movable ) {
             polylib_group_set_move_func_c( pg_tags[i], move_func_c );
@@ -16,6 +16,11 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "Polylib.h"
+#ifdef USE_ZLIB
+#include <fstream>
+#include <sstream>
+#include <zlib.h>
+#endif
 
 using namespace PolylibNS;
 using namespace std;
@@ -176,6 +181,26 @@ int main(int argc, char** argv )
         exit(1);
     }
 
+    //-------------------------------------------
+    //  非同期セーブ（バイナリファイルで保存）
+    //-------------------------------------------
+
+    fmt_out = PolygonIO::FMT_STL_B;
+    std::string  extend_async = "out_async";
+    PL_DBGOSH << "save_async() binary start" <<endl;
+    ret = p_polylib->save_async( fmt_out, extend_async );
+    if( ret != PLSTAT_OK ) {
+        PL_ERROSH <<"[ERROR] save_async() binary ret="<<ret <<endl;
+        exit(1);
+    }
+    std::string  config_name_async;
+    ret = p_polylib->wait_save( config_name_async );
+    PL_DBGOSH << "wait_save() end   config_name_out="<<config_name_async <<endl;
+    if( ret != PLSTAT_OK || (myrank == 0 && config_name_async.empty()) ) {
+        PL_ERROSH <<"[ERROR] wait_save() binary ret="<<ret <<endl;
+        exit(1);
+    }
+
     //-------------------------------------------
     //  妥当性の検証
     //-------------------------------------------
@@ -229,18 +254,26 @@ int main(int argc, char** argv )
         std::vector<Triangle* > tri_list_sphere_bin;
         PolygonIO::load( &tri_list_sphere_bin, file_name_bin, fmt_out );
 
+        //  非同期保存したファイルを再度読み込み
+        std::string file_name_async = "sphere_1_out_async.stlb";
+        std::vector<Triangle* > tri_list_sphere_async;
+        PolygonIO::load( &tri_list_sphere_async, file_name_async, fmt_out );
+
         //---- ポリゴン数の確認　-------
-        int num_tri_sphere_1   = tri_list_sphere_1.size();
-        int num_tri_sphere_2   = tri_list_sphere_2.size();
-        int num_tri_sphere_bin = tri_list_sphere_bin.size();
-        if( num_tri_sphere_1 != num_tri_sphere_2   ) err_flg = true;
-        if( num_tri_sphere_1 != num_tri_sphere_bin ) err_flg = true;
+        int num_tri_sphere_1     = tri_list_sphere_1.size();
+        int num_tri_sphere_2     = tri_list_sphere_2.size();
+        int num_tri_sphere_bin   = tri_list_sphere_bin.size();
+        int num_tri_sphere_async = tri_list_sphere_async.size();
+        if( num_tri_sphere_1 != num_tri_sphere_2     ) err_flg = true;
+        if( num_tri_sphere_1 != num_tri_sphere_bin   ) err_flg = true;
+        if( num_tri_sphere_1 != num_tri_sphere_async ) err_flg = true;
         if( err_flg ) {
             PL_ERROSH << "#### ERROR number of polygons ####" << endl;
             PL_DBGOSH << "#### ERROR number of polygons ####" << endl;
-            PL_DBGOSH << "  num_tri_sphere_1   = "<<num_tri_sphere_1   <<endl;
-            PL_DBGOSH << "  num_tri_sphere_2   = "<<num_tri_sphere_2   <<endl;
-            PL_DBGOSH << "  num_tri_sphere_bin = "<<num_tri_sphere_bin <<endl;
+            PL_DBGOSH << "  num_tri_sphere_1     = "<<num_tri_sphere_1     <<endl;
+            PL_DBGOSH << "  num_tri_sphere_2     = "<<num_tri_sphere_2     <<endl;
+            PL_DBGOSH << "  num_tri_sphere_bin   = "<<num_tri_sphere_bin   <<endl;
+            PL_DBGOSH << "  num_tri_sphere_async = "<<num_tri_sphere_async <<endl;
             exit(1);
         }
 
@@ -250,6 +283,7 @@ int main(int argc, char** argv )
             Vec3<PL_REAL>* v1 = tri_list_sphere_1  [i]->get_vertexes();
             Vec3<PL_REAL>* v2 = tri_list_sphere_2  [i]->get_vertexes();
             Vec3<PL_REAL>* v3 = tri_list_sphere_bin[i]->get_vertexes();
+            Vec3<PL_REAL>* v4 = tri_list_sphere_async[i]->get_vertexes();
 
             for(int j=0; j<3; j++ )  {
                 if( fabs(v1[j].x-v2[j].x) > eps ) err_flg=true; 
@@ -258,6 +292,9 @@ int main(int argc, char** argv )
                 if( fabs(v1[j].x-v3[j].x) > eps ) err_flg=true; 
                 if( fabs(v1[j].y-v3[j].y) > eps ) err_flg=true; 
                 if( fabs(v1[j].z-v3[j].z) > eps ) err_flg=true; 
+                if( v3[j].x != v4[j].x ) err_flg=true;
+                if( v3[j].y != v4[j].y ) err_flg=true;
+                if( v3[j].z != v4[j].z ) err_flg=true;
             }
 
             if( err_flg )  {
@@ -283,6 +320,67 @@ int main(int argc, char** argv )
         for(int i=0; i<tri_list_sphere_bin.size(); i++ ) {
             delete tri_list_sphere_bin[i];
         }
+        for(int i=0; i<tri_list_sphere_async.size(); i++ ) {
+            delete tri_list_sphere_async[i];
+        }
+
+#ifdef USE_ZLIB
+        //---- gzip圧縮したテキストSTLの読み込み確認 -------
+        //  入力のテキストSTLをgzip圧縮して書き出し、伸長しながら読み込む
+        std::string file_name_txt = "sphere_in_txt.stl";
+        std::string file_name_gz  = "sphere_in_txt_gz.stl.gz";
+        {
+            std::ifstream ifs( file_name_txt.c_str(), std::ios::in | std::ios::binary );
+            std::stringstream ss;
+            ss << ifs.rdbuf();
+            std::string data = ss.str();
+            gzFile gz = gzopen( file_name_gz.c_str(), "wb" );
+            if( gz == NULL || gzwrite( gz, data.c_str(), (unsigned)data.size() ) != (int)data.size() ) {
+                PL_ERROSH << "#### ERROR can't write "<<file_name_gz <<endl;
+                exit(1);
+            }
+            gzclose( gz );
+        }
+
+        std::string fmt_gz = PolygonIO::input_file_format( file_name_gz );
+        if( fmt_gz != PolygonIO::FMT_STL_A ) {
+            PL_ERROSH << "#### ERROR format of "<<file_name_gz<<" : "<<fmt_gz <<endl;
+            PL_DBGOSH << "#### ERROR format of "<<file_name_gz<<" : "<<fmt_gz <<endl;
+            exit(1);
+        }
+        std::vector<Triangle* > tri_list_txt;
+        std::vector<Triangle* > tri_list_gz;
+        if( PolygonIO::load( &tri_list_txt, file_name_txt, PolygonIO::FMT_STL_A ) != PLSTAT_OK ||
+            PolygonIO::load( &tri_list_gz,  file_name_gz,  fmt_gz ) != PLSTAT_OK ) {
+            PL_ERROSH << "#### ERROR load "<<file_name_gz <<endl;
+            PL_DBGOSH << "#### ERROR load "<<file_name_gz <<endl;
+            exit(1);
+        }
+        if( tri_list_gz.size() == 0 || tri_list_gz.size() != tri_list_txt.size() ) {
+            PL_ERROSH << "#### ERROR number of polygons (gzip) ####" << endl;
+            PL_DBGOSH << "#### ERROR number of polygons (gzip) ####" << endl;
+            PL_DBGOSH << "  num_tri_txt = "<<tri_list_txt.size() <<endl;
+            PL_DBGOSH << "  num_tri_gz  = "<<tri_list_gz.size()  <<endl;
+            exit(1);
+        }
+        for(int i=0; i<tri_list_gz.size(); i++ )  {
+            Vec3<PL_REAL>* v1 = tri_list_txt[i]->get_vertexes();
+            Vec3<PL_REAL>* v2 = tri_list_gz [i]->get_vertexes();
+            for(int j=0; j<3; j++ )  {
+                if( v1[j].x != v2[j].x || v1[j].y != v2[j].y || v1[j].z != v2[j].z ) {
+                    PL_ERROSH << "#### ERROR coordinates (gzip) i="<<i <<endl;
+                    PL_DBGOSH << "#### ERROR coordinates (gzip) i="<<i <<endl;
+                    exit(1);
+                }
+            }
+        }
+        for(int i=0; i<tri_list_txt.size(); i++ ) {
+            delete tri_list_txt[i];
+        }
+        for(int i=0; i<tri_list_gz.size(); i++ ) {
+            delete tri_list_gz[i];
+        }
+#endif
 
 #ifdef MPI_PL
     }  //! if( myrank == 0 ) {
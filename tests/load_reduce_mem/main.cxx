@@ -15,6 +15,9 @@
 ///
 ////////////////////////////////////////////////////////////////////////////
 
+#include <math.h>
+#include <string.h>
+#include <fstream>
 #include "Polylib.h"
 
 using namespace PolylibNS;
@@ -71,6 +74,103 @@ static MyParallelInfo myParaInfos[4] = {
 const int num_global_polygon = 192;  // sphereのポリゴン数
 
 
+#ifdef MPI_PL
+//----------------------------------------------------
+//  異常系テスト用のファイル作成（ランク0のみ）
+//----------------------------------------------------
+
+// ランク0の担当領域（ガイドセル含む）に小さな三角形を敷き詰めた
+// バイナリSTLファイル
+//   ランク0の登録ポリゴンだけでnum_tri個以上となるため、
+//   num_tri個分のメモリではロード出来ない
+static void write_dense_stl_b( const std::string& fname, int num_tri )
+{
+    int n = (int)sqrt( (double)num_tri / 2.0 ) + 1;
+    PL_REAL x0 = -45.0, y0 = -45.0, len = 60.0;
+    PL_REAL h  = len / n;
+
+    std::ofstream ofs( fname.c_str(), std::ios::out | std::ios::binary );
+    char header[80];
+    memset( header, 0, sizeof(header) );
+    ofs.write( header, sizeof(header) );
+    unsigned int num = 2*n*n;
+    ofs.write( (const char*)&num, sizeof(num) );
+    for( int i=0; i<n; i++ ) {
+        for( int j=0; j<n; j++ ) {
+            float x = x0 + h*i, y = y0 + h*j;
+            float tri[2][12] = {
+                { 0,0,1,  x,y,0,  x+h,y,0,    x+h,y+h,0 },
+                { 0,0,1,  x,y,0,  x+h,y+h,0,  x,y+h,0   }
+            };
+            unsigned short attr = 0;
+            for( int k=0; k<2; k++ ) {
+                ofs.write( (const char*)tri[k], sizeof(tri[k]) );
+                ofs.write( (const char*)&attr, sizeof(attr) );
+            }
+        }
+    }
+}
+
+// 途中に読み込めない頂点座標があるアスキーSTLファイル
+static void write_broken_stl_a( const std::string& fname )
+{
+    std::ofstream ofs( fname.c_str() );
+    ofs << "solid broken" << endl;
+    for( int i=0; i<10; i++ ) {
+        ofs << "facet normal 0 0 1" << endl;
+        ofs << "outer loop" << endl;
+        ofs << "vertex " << i << " 0 0" << endl;
+        ofs << "vertex " << i+1 << " 0 0" << endl;
+        ofs << "vertex " << i << " 1 0" << endl;
+        ofs << "endloop" << endl;
+        ofs << "endfacet" << endl;
+    }
+    ofs << "facet normal 0 0 1" << endl;
+    ofs << "outer loop" << endl;
+    ofs << "vertex broken 0 0" << endl;
+    ofs << "endloop" << endl;
+    ofs << "endfacet" << endl;
+    ofs << "endsolid broken" << endl;
+}
+
+//----------------------------------------------------
+//  メモリ削減版ロードの異常系
+//    ランク0でエラーとなった場合も他ランクが受信待ちで止まらず、
+//    全ランクが同じ戻り値で終了し、ポリゴンが残らないこと
+//----------------------------------------------------
+static void check_load_error(
+        const std::string&  fname,
+        const std::string&  fmt,
+        int                 size_mb,
+        POLYLIB_STAT        ret_reference
+    )
+{
+    PolygonGroup pg;
+    std::map<std::string, std::string> files;
+    files[fname] = fmt;
+    pg.set_file_name( files );
+
+    PL_DBGOSH << "load_polygons_mem_reduced() start fname="<<fname <<endl;
+    POLYLIB_STAT ret = pg.load_polygons_mem_reduced( 1.0, size_mb );
+    PL_DBGOSH << "load_polygons_mem_reduced() end   ret="<<PolylibStat2::String(ret) <<endl;
+
+    int ret_rank = ret;
+    int ret_min, ret_max;
+    MPI_Allreduce( &ret_rank, &ret_min, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD );
+    MPI_Allreduce( &ret_rank, &ret_max, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+    if( ret_min != ret_reference || ret_max != ret_reference ) {
+        PL_ERROSH <<"[ERROR] "<<fname<<": ret_min="<<ret_min<<" ret_max="<<ret_max<<"  ret_reference="<<ret_reference <<endl;
+        exit(1);
+    }
+    std::vector<Triangle*>* tri_list = pg.get_triangles();
+    if( tri_list != NULL && tri_list->size() != 0 ) {
+        PL_ERROSH <<"[ERROR] "<<fname<<": polygons remain after error. tri_list->size()="<<tri_list->size() <<endl;
+        exit(1);
+    }
+}
+#endif
+
+
 //----------------------------------------------------
 //  メインルーチン
 //----------------------------------------------------
@@ -214,6 +314,34 @@ int main(int argc, char** argv )
     PL_DBGOSH << "save() end   config_name_out="<<config_name_out <<endl;
 
 
+    //-------------------------------------------
+    //  異常系
+    //-------------------------------------------
+#ifdef MPI_PL
+    {
+        std::string fname_dense  = "dense_in.stl";
+        std::string fname_broken = "broken_in.stl";
+        int size_mb = 1;
+        Triangle tri_tmp;
+        int num_tri_mem = size_mb*1024*1024 / tri_tmp.used_memory_size();
+        if( myrank == 0 ) {
+            write_dense_stl_b( fname_dense, 2*num_tri_mem );
+            write_broken_stl_a( fname_broken );
+        }
+        MPI_Barrier( MPI_COMM_WORLD );
+
+        // ファイルOpenエラー
+        check_load_error( "not_exist_in.stl", PolygonIO::FMT_STL_A, size_mb, PLSTAT_STL_IO_ERROR );
+        // 分割読み込み不可のファイルフォーマット
+        check_load_error( "not_exist_in.plb", PolygonIO::FMT_PLB, size_mb, PLSTAT_UNKNOWN_FILE_FORMAT );
+        // ファイル読み込みエラー
+        check_load_error( fname_broken, PolygonIO::FMT_STL_A, size_mb, PLSTAT_STL_IO_ERROR );
+        // メモリ不足（送信中の分割ポリゴンがある状態で発生）
+        check_load_error( fname_dense, PolygonIO::FMT_STL_B, size_mb, PLSTAT_LACK_OF_LOAD_MEMORY );
+    }
+#endif
+
+
     //-------------------------------------------
     //  終了化
     //-------------------------------------------
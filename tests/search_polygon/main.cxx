@@ -16,6 +16,8 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "Polylib.h"
+#include <algorithm>
+#include <fstream>
 
 using namespace PolylibNS;
 using namespace std;
@@ -69,6 +71,87 @@ const int num_srch_rank0_reference = 36;
 // rank3検索ポリゴン数
 const int num_srch_rank3_reference = 36;  
 
+//----------------------------------------------------
+//  検索インデックスの比較用
+//----------------------------------------------------
+
+// 比較に使う矩形領域
+//   ボクセル(10x10x10)境界に揃ったもの、揃っていないもの、
+//   ボクセル境界よりわずかに大きいもの・小さいもの
+static void make_srch_boxes( std::vector<BBox>& boxes )
+{
+    const PL_REAL shift[4] = { 0.0, 3.7, -0.5e-3, +0.5e-3 };
+    for( int s=0; s<4; s++ ) {
+        for( int n=1; n<=3; n++ ) {
+            for( int j=0; j+n<=10; j+=2 ) {
+                for( int i=0; i+n<=10; i+=3 ) {
+                    BBox bbox;
+                    bbox.min.x = -50.0 + 10.0*i     + shift[s];
+                    bbox.min.y = -50.0 + 10.0*j     + shift[s];
+                    bbox.min.z = -50.0 + 10.0*(n-1) + shift[s];
+                    bbox.max.x = -50.0 + 10.0*(i+n) - shift[s];
+                    bbox.max.y = -50.0 + 10.0*(j+n) - shift[s];
+                    bbox.max.z = +50.0 - 10.0*(n-1) - shift[s];
+                    boxes.push_back( bbox );
+                }
+            }
+        }
+    }
+}
+
+// 比較する検索の種類
+//   every=false, every=true, 厳密な交差判定
+enum { SRCH_CROSS, SRCH_EVERY, SRCH_EXACT, NUM_SRCH };
+static const char* srch_name[NUM_SRCH] = { "every=false", "every=true", "exact" };
+
+// 全矩形領域の検索結果（ポリゴンIDの昇順）
+static void search_srch_boxes(
+    PolygonGroup*                                   pg,
+    const std::vector<BBox>&                        boxes,
+    int                                             srch,
+    std::vector< std::vector<long long int> >&      ids
+)
+{
+    ids.assign( boxes.size(), std::vector<long long int>() );
+    for( size_t n=0; n<boxes.size(); n++ ) {
+        std::vector<Triangle* > srch_tri_list;
+        POLYLIB_STAT ret;
+        if( srch == SRCH_EXACT ) {
+            ret = pg->search_exact( srch_tri_list, boxes[n] );
+        } else {
+            ret = pg->search( srch_tri_list, boxes[n], srch == SRCH_EVERY );
+        }
+        if( ret != PLSTAT_OK )  {
+            PL_ERROSH <<"[ERROR] pg->search() "<<srch_name[srch] <<endl;
+            exit(1);
+        }
+        for( size_t i=0; i<srch_tri_list.size(); i++ ) {
+            ids[n].push_back( srch_tri_list[i]->get_id() );
+        }
+        std::sort( ids[n].begin(), ids[n].end() );
+    }
+}
+
+// 検索結果がリファレンス（KD木の検索結果）と一致すること
+static void check_srch_boxes(
+    const char*                                         label,
+    int                                                 srch,
+    const std::vector<BBox>&                            boxes,
+    const std::vector< std::vector<long long int> >&    ids,
+    const std::vector< std::vector<long long int> >&    ids_reference
+)
+{
+    for( size_t n=0; n<boxes.size(); n++ ) {
+        if( ids[n] != ids_reference[n] ) {
+            PL_ERROSH <<"[ERROR] "<<label<<" "<<srch_name[srch]<<" box=("<<boxes[n].min<<")-("<<boxes[n].max<<")"
+                      <<" num="<<ids[n].size()<<"  reference="<<ids_reference[n].size() <<endl;
+            PL_DBGOSH <<"[ERROR] "<<label<<" "<<srch_name[srch]<<" box=("<<boxes[n].min<<")-("<<boxes[n].max<<")"
+                      <<" num="<<ids[n].size()<<"  reference="<<ids_reference[n].size() <<endl;
+            exit(1);
+        }
+    }
+}
+
 //----------------------------------------------------
 //  メインルーチン
 //----------------------------------------------------
@@ -176,6 +259,24 @@ int main(int argc, char** argv )
             PL_DBGOSH <<"[ERROR] srch_tri_list.size()="<<srch_tri_list.size()<<"  num_srch_rank0_reference="<<num_srch_rank0_reference <<endl;
             exit(1);
         }
+
+        // 最近傍ポリゴン検索
+        //   Polylib経由の検索結果がグループの検索結果と一致すること
+        Vec3<PL_REAL> pos;
+        pos.x=-30.0;  pos.y=-30.0;  pos.z=0.0;
+        Triangle* tri_nearest = NULL;
+        ret = p_polylib->search_nearest_polygon( tri_nearest, pg_sphere_path, pos );
+        if( ret != PLSTAT_OK )  {
+            PL_ERROSH <<"[ERROR] p_polylib->search_nearest_polygon()" <<endl;
+            exit(1);
+        }
+        Triangle* tri_nearest_pg = NULL;
+        pg_sphere->search_nearest( tri_nearest_pg, pos );
+        if( tri_nearest == NULL || tri_nearest != tri_nearest_pg ) {
+            PL_ERROSH <<"[ERROR] search_nearest_polygon() tri="<<tri_nearest<<"  reference="<<tri_nearest_pg <<endl;
+            PL_DBGOSH <<"[ERROR] search_nearest_polygon() tri="<<tri_nearest<<"  reference="<<tri_nearest_pg <<endl;
+            exit(1);
+        }
     }
 
     if( myrank == 3 ) {
@@ -206,6 +307,178 @@ int main(int argc, char** argv )
         }
     }
 
+    //-------------------------------------------
+    //  検索インデックスの比較（全ランク）
+    //-------------------------------------------
+
+    std::vector<BBox> boxes;
+    make_srch_boxes( boxes );
+
+    // KD木の検索結果（リファレンス）
+    std::vector< std::vector<long long int> > ids_reference[NUM_SRCH];
+    for( int srch=0; srch<NUM_SRCH; srch++ ) {
+        search_srch_boxes( pg_sphere, boxes, srch, ids_reference[srch] );
+    }
+
+    // 線形BVH
+    ret = pg_sphere->set_index_type( PL_INDEX_LBVH );
+    if( ret != PLSTAT_OK )  {
+        PL_ERROSH <<"[ERROR] pg_sphere->set_index_type(PL_INDEX_LBVH)" <<endl;
+        exit(1);
+    }
+    for( int srch=0; srch<NUM_SRCH; srch++ ) {
+        std::vector< std::vector<long long int> > ids;
+        search_srch_boxes( pg_sphere, boxes, srch, ids );
+        check_srch_boxes( "LBVH", srch, boxes, ids, ids_reference[srch] );
+    }
+    ret = pg_sphere->set_index_type( PL_INDEX_VTREE );
+    if( ret != PLSTAT_OK )  {
+        PL_ERROSH <<"[ERROR] pg_sphere->set_index_type(PL_INDEX_VTREE)" <<endl;
+        exit(1);
+    }
+
+    // ボクセル格子インデックス（ボクセル境界に揃った領域は格子で検索）
+    Vec3<PL_REAL> grid_org( -50.0, -50.0, -50.0 );
+    Vec3<PL_REAL> grid_dx ( 10.0, 10.0, 10.0 );
+    int grid_num[3] = { 10, 10, 10 };
+    ret = pg_sphere->add_voxel_index( grid_org, grid_dx, grid_num );
+    if( ret != PLSTAT_OK )  {
+        PL_ERROSH <<"[ERROR] pg_sphere->add_voxel_index()" <<endl;
+        exit(1);
+    }
+    for( int srch=0; srch<NUM_SRCH; srch++ ) {
+        std::vector< std::vector<long long int> > ids;
+        search_srch_boxes( pg_sphere, boxes, srch, ids );
+        check_srch_boxes( "VoxelGrid", srch, boxes, ids, ids_reference[srch] );
+    }
+    pg_sphere->clear_voxel_index();
+
+    //-------------------------------------------
+    //  詳細度レベル（LOD）の検索（全ランク）
+    //-------------------------------------------
+
+    const int num_lod_level = 2;
+    ret = p_polylib->build_lod( pg_sphere_path, num_lod_level, 0.5 );
+    if( ret != PLSTAT_OK || pg_sphere->get_num_lod_level() != num_lod_level )  {
+        PL_ERROSH <<"[ERROR] p_polylib->build_lod() num_level="<<pg_sphere->get_num_lod_level() <<endl;
+        exit(1);
+    }
+    {
+        // 全領域を検索し、レベル毎の簡略化ポリゴンが全て抽出されること
+        //   粗いレベルほどポリゴン数が少なく、元の三角形IDは元のポリゴンに含まれること
+        Vec3<PL_REAL> min_pos( -50.0, -50.0, -50.0 );
+        Vec3<PL_REAL> max_pos( +50.0, +50.0, +50.0 );
+        std::vector<long long int> ids_level0;
+        for( size_t i=0; i<tri_list->size(); i++ ) {
+            ids_level0.push_back( (*tri_list)[i]->get_id() );
+        }
+        std::sort( ids_level0.begin(), ids_level0.end() );
+
+        size_t num_prev = tri_list->size();
+        for( int level=0; level<=num_lod_level+1; level++ ) {
+            std::vector<Triangle* > srch_tri_list;
+            ret = p_polylib->search_polygons( srch_tri_list, pg_sphere_path,
+                                              min_pos, max_pos, false, level );
+            if( ret != PLSTAT_OK )  {
+                PL_ERROSH <<"[ERROR] p_polylib->search_polygons() level="<<level <<endl;
+                exit(1);
+            }
+            int lod = std::min( level, num_lod_level );
+            std::vector<Triangle* >* lod_list = pg_sphere->get_lod_triangles( lod );
+            bool err_flg = ( lod_list == NULL || srch_tri_list.size() != lod_list->size() );
+            if( lod == 0 ) {
+                err_flg = err_flg || srch_tri_list.size() != tri_list->size();
+            } else if( lod == 1 ) {
+                err_flg = err_flg || srch_tri_list.size() == 0 || srch_tri_list.size() >= num_prev;
+            } else {
+                err_flg = err_flg || srch_tri_list.size() == 0 || srch_tri_list.size() > num_prev;
+            }
+            for( size_t i=0; i<srch_tri_list.size() && !err_flg && lod > 0; i++ ) {
+                std::vector<long long int> src_ids;
+                ret = pg_sphere->get_lod_source_ids( lod, srch_tri_list[i]->get_id(), src_ids );
+                if( ret != PLSTAT_OK || src_ids.empty() ) err_flg = true;
+                for( size_t k=0; k<src_ids.size(); k++ ) {
+                    if( !std::binary_search( ids_level0.begin(), ids_level0.end(), src_ids[k] ) ) {
+                        err_flg = true;
+                    }
+                }
+            }
+            if( err_flg ) {
+                PL_ERROSH <<"[ERROR] LOD search level="<<level<<" num="<<srch_tri_list.size()
+                          <<" num_prev_level="<<num_prev <<endl;
+                PL_DBGOSH <<"[ERROR] LOD search level="<<level<<" num="<<srch_tri_list.size()
+                          <<" num_prev_level="<<num_prev <<endl;
+                exit(1);
+            }
+            num_prev = srch_tri_list.size();
+        }
+    }
+
+    //-------------------------------------------
+    //  検索統計情報（全ランク）
+    //-------------------------------------------
+
+    StatsRegistry::set_enable( true );
+    StatsRegistry::get_instance()->reset();
+    {
+        // 全領域を検索し、検索回数と検索結果数が集計されること
+        Vec3<PL_REAL> min_pos( -50.0, -50.0, -50.0 );
+        Vec3<PL_REAL> max_pos( +50.0, +50.0, +50.0 );
+        std::vector<Triangle* > srch_tri_list;
+        ret = p_polylib->search_polygons( srch_tri_list, pg_sphere_path,
+                                          min_pos, max_pos, false );
+        if( ret != PLSTAT_OK || srch_tri_list.size() == 0 )  {
+            PL_ERROSH <<"[ERROR] p_polylib->search_polygons() with stats" <<endl;
+            exit(1);
+        }
+        StatsRegistry* stats = StatsRegistry::get_instance();
+        long long int num_search  = stats->get_calls( PL_STATS_SEARCH );
+        long long int num_results = stats->get_count( PL_STATS_SEARCH_RESULTS );
+        if( num_search != 1 || num_results != (long long int)srch_tri_list.size() ) {
+            PL_ERROSH <<"[ERROR] search stats calls="<<num_search
+                      <<" results="<<num_results<<" reference="<<srch_tri_list.size() <<endl;
+            PL_DBGOSH <<"[ERROR] search stats calls="<<num_search
+                      <<" results="<<num_results<<" reference="<<srch_tri_list.size() <<endl;
+            exit(1);
+        }
+
+        // 全ランク集計（最小<=平均<=最大）
+        std::vector<double> vmin, vmax, vavg;
+        ret = p_polylib->reduce_stats( vmin, vmax, vavg );
+        int idx_calls   = PL_STATS_NUM_PHASE + PL_STATS_SEARCH;
+        int idx_results = 2*PL_STATS_NUM_PHASE + PL_STATS_SEARCH_RESULTS;
+        if( ret != PLSTAT_OK || (int)vavg.size() != StatsRegistry::num_values() ||
+            vmin[idx_calls] != 1.0 || vmax[idx_calls] != 1.0 ||
+            vmax[idx_results] <= 0.0 ||
+            vmin[idx_results] > vavg[idx_results] || vavg[idx_results] > vmax[idx_results] ) {
+            PL_ERROSH <<"[ERROR] p_polylib->reduce_stats() ret="<<ret <<endl;
+            PL_DBGOSH <<"[ERROR] p_polylib->reduce_stats() ret="<<ret <<endl;
+            exit(1);
+        }
+
+        // JSONファイル出力（ランク0が出力する）
+        std::string stats_fname = "search_stats.json";
+        ret = p_polylib->write_stats_json( stats_fname );
+        if( ret != PLSTAT_OK )  {
+            PL_ERROSH <<"[ERROR] p_polylib->write_stats_json() ret="<<ret <<endl;
+            exit(1);
+        }
+        if( myrank == 0 ) {
+            std::ifstream ifs( stats_fname.c_str() );
+            std::string line;
+            bool found = false;
+            while( ifs && std::getline( ifs, line ) ) {
+                if( line.find( "\"summary\"" ) != std::string::npos ) found = true;
+            }
+            if( !found ) {
+                PL_ERROSH <<"[ERROR] stats file not written: "<<stats_fname <<endl;
+                PL_DBGOSH <<"[ERROR] stats file not written: "<<stats_fname <<endl;
+                exit(1);
+            }
+        }
+    }
+    StatsRegistry::set_enable( false );
+
     //-------------------------------------------
     //  終了化
     //-------------------------------------------